@@ -9,7 +9,7 @@
 #define _CHANNELMAPPER_HPP_
 
 #include <JuceHeader.h>
-#include <set>
+#include <bitset>
 
 #include "Utils.hpp"
 #include "ChannelSet.hpp"
@@ -128,17 +128,20 @@ class ChannelMapper : public LogTagDelegate {
         if (src == dst) {
             return;
         }
-        std::set<int> mapped;
+        // a fixed size set, as this is called on the audio thread
+        std::bitset<Defaults::PLUGIN_CHANNELS_MAX> mapped;
         for (int ch = 0; ch < src->getNumChannels(); ch++) {
             int chMapped = reverse ? getMappedChannelReverse(ch) : getMappedChannel(ch);
             if (chMapped > -1) {
                 copyChannel(src, ch, dst, chMapped);
-                mapped.insert(chMapped);
+                if (chMapped < Defaults::PLUGIN_CHANNELS_MAX) {
+                    mapped.set((size_t)chMapped);
+                }
             }
         }
         // clear any other channel in the dst buffer, that can't be mapped
         for (int ch = 0; ch < dst->getNumChannels(); ch++) {
-            if (mapped.find(ch) == mapped.end()) {
+            if (ch >= Defaults::PLUGIN_CHANNELS_MAX || !mapped.test((size_t)ch)) {
                 traceln("clearing unmapped channel " << ch);
                 dst->clear(ch, 0, dst->getNumSamples());
             }
@@ -25,7 +25,7 @@ static const String PLUGIN_TRAY_SOCK = "plugin-tray.sock";
 static const String SERVER_SOCK = "server-{id}.sock";
 static const String WORKER_SOCK = "worker-{id}-{n}.sock";
 
-static constexpr int SCAN_WORKERS = 8;
+static constexpr int SCAN_WORKERS = 16;
 static constexpr int SCAN_ID_START = 1000;
 
 static constexpr int SCAREA_STEPS = 30;
@@ -33,6 +33,14 @@ static constexpr int SCAREA_FULLSCREEN = 0xFFFF;
 
 static constexpr int PLUGIN_CHANNELS_MAX = 64;
 
+static constexpr int PLUGIN_POOL_MEMORY_MB = 2048;
+static constexpr int SANDBOX_POOL_MAX_IDLE = 4;
+static constexpr int SANDBOX_GROUP_SIZE = 8;
+static constexpr int SESSION_GRACE_SECS = 10;
+static constexpr int SESSION_RESUME_TIMEOUT_SECS = 10;
+static constexpr int NUM_AUX_BUSES = 8;
+static constexpr int BUSY_POLL_USEC = 50;
+
 static constexpr int PLUGIN_FX_CHANNELS_IN = 30;
 static constexpr int PLUGIN_FX_CHANNELS_OUT = 32;
 static constexpr int PLUGIN_FX_CHANNELS_SC = 2;
@@ -68,10 +76,14 @@ static const String SERVERS_STARTUP_FILE = "~/.audiogridder/serverstartup.cfg";
 static const String PLUGIN_CONFIG_FILE = "~/.audiogridder/audiogridderplugin.cfg";
 static const String PLUGIN_TRAY_CONFIG_FILE = "~/.audiogridder/audiogridderplugintray.cfg";
 static const String KNOWN_PLUGINS_FILE = "~/.audiogridder/audiogridderserver{id}.cache";
+static const String PLUGIN_CATALOG_FILE = "~/.audiogridder/audiogridderserver{id}.catalog";
+static const String PLUGIN_FINGERPRINTS_FILE = "~/.audiogridder/audiogridderserver{id}.fingerprints";
 static const String DEAD_MANS_FILE = "~/.audiogridder/audiogridderserver{id}.crash";
 static const String SCAN_ERROR_FILE = "~/.audiogridder/audiogridderserver{id}.scanerror";
 static const String SCAN_LAYOUT_ERROR_FILE = "~/.audiogridder/audiogridderserver{id}.scanlayout";
 static const String PLUGIN_LAYOUTS_FILE = "~/.audiogridder/audiogridderserver{id}.layouts";
+static const String PLUGIN_LAYOUTS_CACHE_FILE = "~/.audiogridder/audiogridderserver{id}.layoutcache";
+static const String PLUGIN_POOL_SESSIONS_FILE = "~/.audiogridder/audiogridderserver{id}.pool";
 static const String SERVER_RUN_FILE = "~/.audiogridder/audiogridderserver{id}.running";
 static const String SERVER_WINDOW_POSITIONS_FILE = "~/.audiogridder/audiogridderserver{id}.winpos";
 static const String PLUGIN_WINDOW_POSITIONS_FILE = "~/.audiogridder/audiogridderplugin.winpos";
@@ -103,6 +115,12 @@ static const String PLUGIN_TRAY_CONFIG_FILE =
 static const String KNOWN_PLUGINS_FILE =
     File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
     "\\AudioGridder\\audiogridderserver{id}.cache";
+static const String PLUGIN_CATALOG_FILE =
+    File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
+    "\\AudioGridder\\audiogridderserver{id}.catalog";
+static const String PLUGIN_FINGERPRINTS_FILE =
+    File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
+    "\\AudioGridder\\audiogridderserver{id}.fingerprints";
 static const String DEAD_MANS_FILE = File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
                                      "\\AudioGridder\\audiogridderserver{id}.crash";
 static const String SCAN_ERROR_FILE = File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
@@ -113,6 +131,12 @@ static const String SCAN_LAYOUT_ERROR_FILE =
 static const String PLUGIN_LAYOUTS_FILE =
     File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
     "\\AudioGridder\\audiogridderserver{id}.layouts";
+static const String PLUGIN_LAYOUTS_CACHE_FILE =
+    File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
+    "\\AudioGridder\\audiogridderserver{id}.layoutcache";
+static const String PLUGIN_POOL_SESSIONS_FILE =
+    File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
+    "\\AudioGridder\\audiogridderserver{id}.pool";
 static const String SERVER_RUN_FILE = File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
                                       "\\AudioGridder\\audiogridderserver{id}.running";
 static const String SERVER_WINDOW_POSITIONS_FILE =
@@ -134,13 +158,17 @@ enum ConfigFileType {
     ConfigServerRun,
     ConfigPlugin,
     ConfigPluginCache,
+    ConfigPluginCatalog,
+    PluginFingerprints,
     ConfigPluginTray,
     ConfigDeadMan,
     WindowPositionsServer,
     WindowPositionsPlugin,
     ScanError,
     ScanLayoutError,
-    PluginLayouts
+    PluginLayouts,
+    PluginLayoutsCache,
+    PluginPoolSessions
 };
 
 inline String getLogDirName() {
@@ -241,6 +269,12 @@ inline String getConfigFileName(ConfigFileType type, const std::unordered_map<St
             file = KNOWN_PLUGINS_FILE;
             fileOld = KNOWN_PLUGINS_FILE_OLD;
             break;
+        case ConfigPluginCatalog:
+            file = PLUGIN_CATALOG_FILE;
+            break;
+        case PluginFingerprints:
+            file = PLUGIN_FINGERPRINTS_FILE;
+            break;
         case ConfigPluginTray:
             file = PLUGIN_TRAY_CONFIG_FILE;
             break;
@@ -265,6 +299,12 @@ inline String getConfigFileName(ConfigFileType type, const std::unordered_map<St
         case PluginLayouts:
             file = PLUGIN_LAYOUTS_FILE;
             break;
+        case PluginLayoutsCache:
+            file = PLUGIN_LAYOUTS_CACHE_FILE;
+            break;
+        case PluginPoolSessions:
+            file = PLUGIN_POOL_SESSIONS_FILE;
+            break;
     }
     if (fileOld.isNotEmpty()) {
         File fOld(fileOld);
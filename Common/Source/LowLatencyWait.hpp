@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef LowLatencyWait_hpp
+#define LowLatencyWait_hpp
+
+#include <JuceHeader.h>
+
+#include "Metrics.hpp"
+
+namespace e47 {
+
+/*
+ * Waits for an event by polling it in a busy loop first and blocking only, if it did not happen within the spin
+ * window. The window follows the average wait time, so it covers the usual wait, as long as that is below
+ * MAX_SPIN_US. Longer waits reduce spinning to a minimum, as it would only burn CPU. This trades a CPU core for wakeup
+ * latency and is meant for dedicated cores.
+ *
+ * The deviation of the interval between two wakeups from its average can be recorded as wakeup jitter. This happens
+ * with spinning disabled as well, so both modes can be compared.
+ */
+class LowLatencyWait {
+  public:
+    LowLatencyWait(bool recordJitter = false) {
+        if (recordJitter) {
+            m_jitter = getJitterStatistic();
+        }
+    }
+
+    // The wakeup jitter of all waits, that record it (50us bins)
+    static std::shared_ptr<TimeStatistic> getJitterStatistic() {
+        return Metrics::getStatistic<TimeStatistic>("WakeupJitter", (size_t)10, 0.05);
+    }
+
+    // Waits until isReady returns true or the timeout expires. isReady gets a timeout in milliseconds, that is 0 while
+    // spinning, and returns true if the event happened.
+    template <typename Fn>
+    bool wait(bool spin, int timeoutMs, Fn isReady) {
+        auto start = Time::getHighResolutionTicks();
+        bool ready = false;
+        if (spin) {
+            auto spinTicks = Time::secondsToHighResolutionTicks(m_spinUs / 1000000.0);
+            do {
+                ready = isReady(0);
+            } while (!ready && Time::getHighResolutionTicks() - start < spinTicks);
+        }
+        if (!ready) {
+            auto passedMs = (int)(Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000);
+            ready = isReady(jmax(0, timeoutMs - passedMs));
+        }
+        if (ready) {
+            update(start, Time::getHighResolutionTicks());
+        }
+        return ready;
+    }
+
+    double getSpinMicros() const { return m_spinUs; }
+
+  private:
+    static constexpr double MIN_SPIN_US = 10.0;
+    static constexpr double MAX_SPIN_US = 2000.0;
+    static constexpr double ALPHA = 0.05;
+
+    double m_spinUs = MIN_SPIN_US;
+    double m_avgWaitUs = 0.0;
+    double m_avgIntervalMs = 0.0;
+    int64 m_lastWakeup = 0;
+    std::shared_ptr<TimeStatistic> m_jitter;
+
+    void update(int64 start, int64 now) {
+        double waitUs = Time::highResolutionTicksToSeconds(now - start) * 1000000;
+        m_avgWaitUs = m_avgWaitUs * (1 - ALPHA) + waitUs * ALPHA;
+        double target = m_avgWaitUs * 1.25;
+        m_spinUs = target <= MAX_SPIN_US ? jmax(MIN_SPIN_US, target) : MIN_SPIN_US;
+
+        if (nullptr != m_jitter && m_lastWakeup > 0) {
+            double intervalMs = Time::highResolutionTicksToSeconds(now - m_lastWakeup) * 1000;
+            if (m_avgIntervalMs > 0.0) {
+                // ignore pauses of the stream
+                if (intervalMs < m_avgIntervalMs * 4) {
+                    m_jitter->update(std::abs(intervalMs - m_avgIntervalMs));
+                }
+                m_avgIntervalMs = m_avgIntervalMs * (1 - ALPHA) + intervalMs * ALPHA;
+            } else {
+                m_avgIntervalMs = intervalMs;
+            }
+        }
+        m_lastWakeup = now;
+    }
+};
+
+}  // namespace e47
+
+#endif /* LowLatencyWait_hpp */
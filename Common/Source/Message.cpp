@@ -136,6 +136,18 @@ bool setNonBlocking(int handle) noexcept {
 #endif
 }
 
+bool setBusyPoll(StreamingSocket* socket, int usec) noexcept {
+#if defined(JUCE_LINUX) && defined(SO_BUSY_POLL)
+    if (nullptr == socket) {
+        return false;
+    }
+    return setsockopt(socket->getRawSocketHandle(), SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) == 0;
+#else
+    ignoreUnused(socket, usec);
+    return false;
+#endif
+}
+
 StreamingSocket* accept(StreamingSocket* master, int timeoutMs, std::function<bool()> abortFn) {
     if (nullptr != master) {
         TimeStatistic::Timeout timeout(timeoutMs);
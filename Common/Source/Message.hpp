@@ -84,6 +84,8 @@ bool read(StreamingSocket* socket, void* data, int size, int timeoutMilliseconds
           Meter* metric = nullptr);
 
 bool setNonBlocking(int handle) noexcept;
+// Lets reads on the socket busy poll the device queue (SO_BUSY_POLL), returns false if not supported
+bool setBusyPoll(StreamingSocket* socket, int usec) noexcept;
 StreamingSocket* accept(StreamingSocket*, int timeoutMs = 1000, std::function<bool()> abortFn = nullptr);
 
 /*
@@ -105,7 +107,9 @@ struct HandshakeRequest {
     uint64 activeChannels;
     uint16 unused2;
 
-    enum FLAGS : uint8 { NO_PLUGINLIST_FILTER = 1 };
+    // If RESUME_SESSION is set, the session token of the previous connection follows the request (uint64).
+    // CHAIN_HOP is set by servers, that forward a part of their chain to another server.
+    enum FLAGS : uint8 { NO_PLUGINLIST_FILTER = 1, OFFLINE_RENDER = 2, RESUME_SESSION = 4, CHAIN_HOP = 8 };
     void setFlag(uint8 f) { flags |= f; }
     bool isFlag(uint8 f) { return (flags & f) == f; }
 
@@ -149,9 +153,27 @@ struct HandshakeResponse {
     uint32 unused5;
     uint32 unused6;
 
-    enum FLAGS : uint32 { SANDBOX_ENABLED = 1, LOCAL_MODE = 2 };
+    enum FLAGS : uint32 {
+        SANDBOX_ENABLED = 1,
+        LOCAL_MODE = 2,
+        ASYNC_ADD_PLUGIN = 4,
+        INCREMENTAL_SETTINGS = 8,
+        CHUNKED_SETTINGS = 16,
+        BATCH_RESTORE = 32,
+        OFFLINE_RENDER = 64,
+        RECONFIGURE = 128,
+        SESSION_RESUMED = 256,
+        AUX_BUSES = 512
+    };
     void setFlag(uint32 f) { flags |= f; }
     bool isFlag(uint32 f) { return (flags & f) == f; }
+
+    // A token != 0 means, that the server keeps the chain alive for a while after a disconnect
+    void setSessionToken(uint64 token) {
+        unused1 = (uint32)(token & 0xffffffff);
+        unused2 = (uint32)(token >> 32);
+    }
+    uint64 getSessionToken() const { return ((uint64)unused2 << 32) | unused1; }
 };
 
 /*
@@ -169,7 +191,12 @@ class AudioMessage : public LogTagDelegate {
         int numMidiEvents;
         bool isDouble;
         Uuid traceId;
+        uint8 flags;  // Only valid if OFFLINE_RENDER has been negotiated, older clients leave it uninitialized
+
+        enum FLAGS : uint8 { OFFLINE = 1 };
     };
+    // flags lives in the former tail padding, the wire format must not change for older peers
+    static_assert(sizeof(RequestHeader) == 40, "RequestHeader size changed");
 
     struct ResponseHeader {
         int channels;
@@ -188,13 +215,14 @@ class AudioMessage : public LogTagDelegate {
     int getSamples() const { return m_reqHeader.samples; }
     int getSamplesRequested() const { return m_reqHeader.samplesRequested; }
     bool isDouble() const { return m_reqHeader.isDouble; }
+    bool isOffline() const { return (m_reqHeader.flags & RequestHeader::OFFLINE) != 0; }
 
     int getLatencySamples() const { return m_resHeader.latencySamples; }
 
     template <typename T>
     bool sendToServer(StreamingSocket* socket, AudioBuffer<T>& buffer, MidiBuffer& midi,
                       AudioPlayHead::PositionInfo& posInfo, int channelsRequested, int samplesRequested,
-                      MessageHelper::Error* e, Meter& metric) {
+                      MessageHelper::Error* e, Meter& metric, bool offline = false) {
         traceScope();
         m_reqHeader.channels = buffer.getNumChannels();
         m_reqHeader.samples = buffer.getNumSamples();
@@ -203,6 +231,7 @@ class AudioMessage : public LogTagDelegate {
         m_reqHeader.isDouble = std::is_same<T, double>::value;
         m_reqHeader.numMidiEvents = midi.getNumEvents();
         m_reqHeader.traceId = TimeTrace::getTraceId();
+        m_reqHeader.flags = offline ? RequestHeader::OFFLINE : 0;
         if (nullptr != socket && socket->isConnected()) {
             if (!send(socket, reinterpret_cast<const char*>(&m_reqHeader), sizeof(m_reqHeader), e, &metric)) {
                 return false;
@@ -266,10 +295,10 @@ class AudioMessage : public LogTagDelegate {
 
     template <typename T>
     bool readFromServer(StreamingSocket* socket, AudioBuffer<T>& buffer, MidiBuffer& midi, MessageHelper::Error* e,
-                        Meter& metric) {
+                        Meter& metric, int timeoutMs = 1000) {
         traceScope();
         if (nullptr != socket && socket->isConnected()) {
-            if (!read(socket, &m_resHeader, sizeof(m_resHeader), 1000, e, &metric)) {
+            if (!read(socket, &m_resHeader, sizeof(m_resHeader), timeoutMs, e, &metric)) {
                 MessageHelper::seterrstr(e, "response header");
                 return false;
             }
@@ -650,6 +679,27 @@ class AddPluginResult : public JsonPayload {
     AddPluginResult() : JsonPayload(Type) {}
 };
 
+// Restores a whole chain at once ({"plugins": [{"id", "settings", "layout", "monoChannels", "settingsChunks"}]}). The
+// settings chunks of all plugins follow the request in order. The server loads the plugins concurrently and sends a
+// RestorePluginsProgress message for each loaded plugin, followed by a RestorePluginsResult message.
+class RestorePlugins : public JsonPayload {
+  public:
+    static constexpr int Type = 22;
+    RestorePlugins() : JsonPayload(Type) {}
+};
+
+class RestorePluginsProgress : public JsonPayload {
+  public:
+    static constexpr int Type = 23;
+    RestorePluginsProgress() : JsonPayload(Type) {}
+};
+
+class RestorePluginsResult : public JsonPayload {
+  public:
+    static constexpr int Type = 24;
+    RestorePluginsResult() : JsonPayload(Type) {}
+};
+
 class DelPlugin : public NumberPayload {
   public:
     static constexpr int Type = 30;
@@ -662,6 +712,13 @@ class PluginStatus : public JsonPayload {
     PluginStatus() : JsonPayload(Type) {}
 };
 
+// Sent by the server, when a plugin, that has been added asynchronously, finished loading
+class PluginLoaded : public JsonPayload {
+  public:
+    static constexpr int Type = 41;
+    PluginLoaded() : JsonPayload(Type) {}
+};
+
 struct setmonochannels_t {
     int idx;
     uint64 channels;
@@ -804,6 +861,14 @@ class PluginSettings : public StringPayload {
   public:
     static constexpr int Type = 72;
     PluginSettings() : StringPayload(Type) {}
+
+    // Used to find out if the settings on both sides are equal without transferring them
+    static String getHash(const String& settings) {
+        if (settings.isEmpty()) {
+            return {};
+        }
+        return SHA256(settings.toUTF8()).toHexString();
+    }
 };
 
 class BypassPlugin : public NumberPayload {
@@ -818,6 +883,123 @@ class UnbypassPlugin : public NumberPayload {
     UnbypassPlugin() : NumberPayload(Type) {}
 };
 
+// Like GetPluginSettings, but carries the hash of the settings known to the client ({"idx", "hash"}). The server
+// replies with a PluginSettingsState message ({"changed", "hash"}), the settings follow only if they changed. If the
+// client sets "chunked", the server replies with the number of chunks ("chunks") instead and the client fetches them
+// via GetPluginSettingsChunk.
+class GetPluginSettingsIfChanged : public JsonPayload {
+  public:
+    static constexpr int Type = 75;
+    GetPluginSettingsIfChanged() : JsonPayload(Type) {}
+};
+
+class PluginSettingsState : public JsonPayload {
+  public:
+    static constexpr int Type = 76;
+    PluginSettingsState() : JsonPayload(Type) {}
+};
+
+// Compressed plugin settings, split into chunks of CHUNK_SIZE bytes. Chunks are sent by the server as reply to
+// GetPluginSettingsChunk and by the client to set the settings of a plugin. When adding a plugin, the chunks follow the
+// AddPlugin message (idx is -1 in this case). All chunks of a transfer carry its id, the server returns the id of a get
+// transfer with the PluginSettingsState reply, the client picks the id of a set transfer.
+class PluginSettingsChunk : public Payload {
+  public:
+    static constexpr int Type = 77;
+    static constexpr int CHUNK_SIZE = 1024 * 1024;
+    // Limits for settings received from a peer
+    static constexpr int MAX_CHUNKS = 256;
+    static constexpr int64 MAX_SETTINGS_SIZE = 1024ll * 1024 * 1024;
+
+    struct hdr_t {
+        int idx;
+        // id of the transfer, that the chunk belongs to
+        int transfer;
+        int seq;
+        int total;
+        int size;
+    };
+    hdr_t* hdr;
+    char* data;
+
+    PluginSettingsChunk() : Payload(Type, sizeof(hdr_t)) { realignInternal(); }
+
+    void setChunk(int idx, int transfer, int seq, int total, const char* src, int len) {
+        setSize(static_cast<int>(sizeof(hdr_t)) + len);
+        hdr->idx = idx;
+        hdr->transfer = transfer;
+        hdr->seq = seq;
+        hdr->total = total;
+        hdr->size = len;
+        if (len > 0) {
+            memcpy(data, src, static_cast<size_t>(len));
+        }
+    }
+
+    // Checks, that the header is complete and matches the received payload
+    bool isValid() const {
+        if ((size_t)getSize() < sizeof(hdr_t)) {
+            return false;
+        }
+        return hdr->size >= 0 && hdr->size <= CHUNK_SIZE && (size_t)getSize() == sizeof(hdr_t) + (size_t)hdr->size &&
+               hdr->total > 0 && hdr->total <= MAX_CHUNKS && hdr->seq >= 0 && hdr->seq < hdr->total;
+    }
+
+    static int getNumChunks(const MemoryBlock& block) {
+        return (int)((block.getSize() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    }
+
+    // Set chunk number seq of the given block
+    void setChunk(int idx, int transfer, int seq, const MemoryBlock& block) {
+        size_t offset = (size_t)seq * CHUNK_SIZE;
+        int len = (int)jmin((size_t)CHUNK_SIZE, block.getSize() - jmin(offset, block.getSize()));
+        setChunk(idx, transfer, seq, getNumChunks(block), static_cast<const char*>(block.getData()) + offset, len);
+    }
+
+    static MemoryBlock compress(const String& settings) {
+        MemoryBlock block;
+        {
+            MemoryOutputStream out(block, false);
+            GZIPCompressorOutputStream gz(out, 1);
+            gz.write(settings.toRawUTF8(), settings.getNumBytesAsUTF8());
+        }
+        return block;
+    }
+
+    // Fails, if the settings exceed MAX_SETTINGS_SIZE
+    static bool decompress(const MemoryBlock& block, String& settings) {
+        MemoryInputStream in(block, false);
+        GZIPDecompressorInputStream gz(in);
+        MemoryOutputStream out;
+        if (out.writeFromInputStream(gz, MAX_SETTINGS_SIZE + 1) > MAX_SETTINGS_SIZE) {
+            return false;
+        }
+        settings = out.toUTF8();
+        return true;
+    }
+
+    virtual void realign() override { realignInternal(); }
+
+  private:
+    void realignInternal() {
+        hdr = reinterpret_cast<hdr_t*>(payloadBuffer.data());
+        data = (size_t)getSize() > sizeof(hdr_t) ? reinterpret_cast<char*>(payloadBuffer.data()) + sizeof(hdr_t)
+                                                  : nullptr;
+    }
+};
+
+struct getsettingschunk_t {
+    int idx;
+    int transfer;
+    int seq;
+};
+
+class GetPluginSettingsChunk : public DataPayload<getsettingschunk_t> {
+  public:
+    static constexpr int Type = 78;
+    GetPluginSettingsChunk() : DataPayload<getsettingschunk_t>(Type) {}
+};
+
 struct exchange_t {
     int idxA;
     int idxB;
@@ -921,6 +1103,22 @@ class CPULoad : public FloatPayload {
     CPULoad() : FloatPayload(Type) {}
 };
 
+// Changes the sample rate and block size of a running chain ({"sampleRate", "samplesPerBlock"}) without reloading the
+// plugins. The client has to stop streaming audio before. The server responds with a Result message with the new
+// latency or -1, if the chain could not be reconfigured.
+class Reconfigure : public JsonPayload {
+  public:
+    static constexpr int Type = 140;
+    Reconfigure() : JsonPayload(Type) {}
+};
+
+// Connects the chain to shared aux buses of the server ({"send", "sendLevel", "receive"}), empty names disconnect
+class SetAuxBuses : public JsonPayload {
+  public:
+    static constexpr int Type = 141;
+    SetAuxBuses() : JsonPayload(Type) {}
+};
+
 class ServerError : public StringPayload {
   public:
     static constexpr int Type = 200;
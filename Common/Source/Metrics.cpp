@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <memory>
 #include "SharedInstance.hpp"
+#include "RealtimeCheck.hpp"
 
 namespace e47 {
 
@@ -186,6 +187,9 @@ void Metrics::aggregate1s() {
 
 void Metrics::run() {
     traceScope();
+    if (RealtimeCheck::isEnabled()) {
+        getStatistic<RealtimeViolations>("RealtimeViolations");
+    }
     int count = 1;
     while (!threadShouldExit()) {
         int sleepstep = 50;
@@ -364,6 +364,15 @@ class TimeTrace {
 
         void finishGroup(const String& name) { add(name, Record::FINISH_GROUP); }
 
+        // Avoids building a temporary string on the audio thread
+        void finishGroup(const char* prefix, const String& name) {
+            Record r;
+            r.timeSpentMs = durationInc.update();
+            r.type = Record::FINISH_GROUP;
+            snprintf(r.name, sizeof(r.name), "%s%s", prefix, name.toRawUTF8());
+            records.add(std::move(r));
+        }
+
         void calcTotalMs() { total = durationTotal.update(); }
 
         double summary(const LogTag* tag, const String& name, double treshold) {
@@ -441,6 +450,12 @@ class TimeTrace {
         }
     }
 
+    static inline void finishGroup(const char* prefix, const String& name) {
+        if (auto ctx = getTraceContext()) {
+            ctx->finishGroup(prefix, name);
+        }
+    }
+
     static inline Uuid getTraceId() {
         if (auto ctx = getTraceContext()) {
             return ctx->uuid;
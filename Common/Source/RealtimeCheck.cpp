@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "RealtimeCheck.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if AG_RT_CHECKS_ENABLED
+#if JUCE_WINDOWS
+#include <intrin.h>
+#define AG_RETURN_ADDRESS() _ReturnAddress()
+#else
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#define AG_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+// On Linux we interpose the malloc family as well, as JUCE's HeapBlock (and with it AudioBuffer, MemoryBlock etc.)
+// does not use operator new. This only works in executables, so it's not available for the plugin.
+#if JUCE_LINUX && !defined(AG_PLUGIN)
+#define AG_RT_CHECK_MALLOC 1
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void __libc_free(void*);
+}
+#define AG_MALLOC(s) __libc_malloc(s)
+#define AG_FREE(p) __libc_free(p)
+#else
+#define AG_RT_CHECK_MALLOC 0
+#define AG_MALLOC(s) std::malloc(s)
+#define AG_FREE(p) std::free(p)
+#endif
+#endif
+
+namespace e47 {
+
+namespace {
+
+// The table of call sites has a fixed size, as we can't allocate or lock while recording a violation
+constexpr size_t MAX_CALL_SITES = 256;
+
+struct CallSiteSlot {
+    std::atomic<uintptr_t> key{0};
+    std::atomic<uint64> count{0};
+};
+
+CallSiteSlot g_callSites[MAX_CALL_SITES];
+std::atomic<uint64> g_violations{0};
+
+thread_local int t_realtimeDepth = 0;
+thread_local int t_suspendDepth = 0;
+
+inline uintptr_t makeKey(RealtimeCheck::Type type, void* addr) { return ((uintptr_t)addr << 2) | (uintptr_t)type; }
+
+}  // namespace
+
+void RealtimeCheck::enter() { t_realtimeDepth++; }
+
+void RealtimeCheck::leave() { t_realtimeDepth--; }
+
+void RealtimeCheck::suspend() { t_suspendDepth++; }
+
+void RealtimeCheck::resume() { t_suspendDepth--; }
+
+bool RealtimeCheck::isRealtimeThread() { return t_realtimeDepth > 0 && t_suspendDepth == 0; }
+
+void RealtimeCheck::check(Type type, void* addr) {
+    if (!isRealtimeThread()) {
+        return;
+    }
+
+    g_violations.fetch_add(1, std::memory_order_relaxed);
+
+    auto key = makeKey(type, addr);
+    auto idx = (size_t)((key >> 2) ^ (key >> 9)) % MAX_CALL_SITES;
+    for (size_t i = 0; i < MAX_CALL_SITES; i++) {
+        auto& slot = g_callSites[(idx + i) % MAX_CALL_SITES];
+        uintptr_t cur = slot.key.load(std::memory_order_acquire);
+        if (cur == 0 && slot.key.compare_exchange_strong(cur, key, std::memory_order_acq_rel)) {
+            cur = key;
+        }
+        if (cur == key) {
+            slot.count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    // table full, the violation is only counted
+}
+
+uint64 RealtimeCheck::getViolationCount() { return g_violations.load(std::memory_order_relaxed); }
+
+std::vector<RealtimeCheck::CallSite> RealtimeCheck::getCallSites() {
+    std::vector<CallSite> ret;
+    for (auto& slot : g_callSites) {
+        auto key = slot.key.load(std::memory_order_acquire);
+        if (key != 0) {
+            ret.push_back({(void*)(key >> 2), (Type)(key & 3), slot.count.load(std::memory_order_relaxed)});
+        }
+    }
+    std::sort(ret.begin(), ret.end(), [](const CallSite& a, const CallSite& b) { return a.count > b.count; });
+    return ret;
+}
+
+void RealtimeCheck::reset() {
+    for (auto& slot : g_callSites) {
+        slot.count = 0;
+        slot.key = 0;
+    }
+    g_violations = 0;
+}
+
+String RealtimeCheck::describe(const CallSite& cs) {
+    String ret;
+    switch (cs.type) {
+        case ALLOC:
+            ret << "alloc";
+            break;
+        case FREE:
+            ret << "free";
+            break;
+        case LOCK:
+            ret << "lock";
+            break;
+    }
+    ret << " at " << String::toHexString((pointer_sized_int)cs.addr);
+#if AG_RT_CHECKS_ENABLED && !JUCE_WINDOWS
+    Dl_info info;
+    if (dladdr(cs.addr, &info) != 0) {
+        if (nullptr != info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            ret << " " << (status == 0 && nullptr != demangled ? demangled : info.dli_sname);
+            std::free(demangled);
+            ret << "+" << String::toHexString((pointer_sized_int)cs.addr - (pointer_sized_int)info.dli_saddr);
+        }
+        if (nullptr != info.dli_fname) {
+            ret << " (" << File(info.dli_fname).getFileName() << ")";
+        }
+    }
+#endif
+    ret << ": " << (int64)cs.count << "x";
+    return ret;
+}
+
+String RealtimeCheck::describeViolations(size_t maxCallSites) {
+    String ret;
+    ret << (int64)getViolationCount() << " realtime violation(s)";
+    size_t n = 0;
+    for (auto& cs : getCallSites()) {
+        if (n++ == maxCallSites) {
+            break;
+        }
+        ret << newLine << "  " << describe(cs);
+    }
+    return ret;
+}
+
+void RealtimeViolations::aggregate1s() {
+    auto count = RealtimeCheck::getViolationCount();
+    if (count >= m_lastCount) {
+        m_meter.increment((uint32)jmin(count - m_lastCount, (uint64)std::numeric_limits<uint32>::max()));
+    }
+    m_lastCount = count;
+    m_meter.aggregate1s();
+}
+
+void RealtimeViolations::log(const String& name) {
+    if (RealtimeCheck::getViolationCount() > 0) {
+        logln(name << ": rate " << String(m_meter.rate_1min(), 2) << ", "
+                   << RealtimeCheck::describeViolations(5).replace(newLine, ", "));
+    }
+}
+
+}  // namespace e47
+
+#if AG_RT_CHECKS_ENABLED
+
+void* operator new(std::size_t size) {
+    e47::RealtimeCheck::check(e47::RealtimeCheck::ALLOC, AG_RETURN_ADDRESS());
+    if (auto* p = AG_MALLOC(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    e47::RealtimeCheck::check(e47::RealtimeCheck::ALLOC, AG_RETURN_ADDRESS());
+    if (auto* p = AG_MALLOC(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    e47::RealtimeCheck::check(e47::RealtimeCheck::ALLOC, AG_RETURN_ADDRESS());
+    return AG_MALLOC(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    e47::RealtimeCheck::check(e47::RealtimeCheck::ALLOC, AG_RETURN_ADDRESS());
+    return AG_MALLOC(size == 0 ? 1 : size);
+}
+
+void operator delete(void* p) noexcept {
+    if (nullptr != p) {
+        e47::RealtimeCheck::check(e47::RealtimeCheck::FREE, AG_RETURN_ADDRESS());
+        AG_FREE(p);
+    }
+}
+
+void operator delete[](void* p) noexcept {
+    if (nullptr != p) {
+        e47::RealtimeCheck::check(e47::RealtimeCheck::FREE, AG_RETURN_ADDRESS());
+        AG_FREE(p);
+    }
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    if (nullptr != p) {
+        e47::RealtimeCheck::check(e47::RealtimeCheck::FREE, AG_RETURN_ADDRESS());
+        AG_FREE(p);
+    }
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    if (nullptr != p) {
+        e47::RealtimeCheck::check(e47::RealtimeCheck::FREE, AG_RETURN_ADDRESS());
+        AG_FREE(p);
+    }
+}
+
+#if AG_RT_CHECK_MALLOC
+extern "C" void* malloc(size_t size) {
+    e47::RealtimeCheck::check(e47::RealtimeCheck::ALLOC, AG_RETURN_ADDRESS());
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t num, size_t size) {
+    e47::RealtimeCheck::check(e47::RealtimeCheck::ALLOC, AG_RETURN_ADDRESS());
+    return __libc_calloc(num, size);
+}
+
+extern "C" void* realloc(void* p, size_t size) {
+    e47::RealtimeCheck::check(e47::RealtimeCheck::ALLOC, AG_RETURN_ADDRESS());
+    return __libc_realloc(p, size);
+}
+
+extern "C" void free(void* p) {
+    if (nullptr != p) {
+        e47::RealtimeCheck::check(e47::RealtimeCheck::FREE, AG_RETURN_ADDRESS());
+    }
+    __libc_free(p);
+}
+#endif
+
+#if JUCE_LINUX
+// Blocking locks of std::mutex, JUCE's CriticalSection and friends end up in pthread_mutex_lock. Trying a lock is
+// fine on a realtime thread, so pthread_mutex_trylock is not checked.
+extern "C" int pthread_mutex_lock(pthread_mutex_t* m) {
+    using LockFn = int (*)(pthread_mutex_t*);
+    static std::atomic<LockFn> s_next{nullptr};
+    auto next = s_next.load(std::memory_order_acquire);
+    if (nullptr == next) {
+        next = (LockFn)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        s_next.store(next, std::memory_order_release);
+    }
+    e47::RealtimeCheck::check(e47::RealtimeCheck::LOCK, AG_RETURN_ADDRESS());
+    return next(m);
+}
+#endif
+
+#endif  // AG_RT_CHECKS_ENABLED
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef RealtimeCheck_hpp
+#define RealtimeCheck_hpp
+
+#include <JuceHeader.h>
+
+#include "Metrics.hpp"
+
+#ifndef AG_RT_CHECKS_ENABLED
+#define AG_RT_CHECKS_ENABLED 0
+#endif
+
+namespace e47 {
+
+/*
+ * Detects heap allocations and blocking mutex locks on threads, that have been marked as realtime. This is a
+ * diagnostic mode, that has to be enabled at build time (AG_ENABLE_RT_CHECKS). When disabled, all calls are no-ops.
+ */
+class RealtimeCheck {
+  public:
+    enum Type : uint8 { ALLOC, FREE, LOCK };
+
+    struct CallSite {
+        void* addr;
+        Type type;
+        uint64 count;
+    };
+
+    // Marks the current thread as realtime for the lifetime of the scope
+    class Scope {
+      public:
+        Scope() { enter(); }
+        ~Scope() { leave(); }
+    };
+
+    // Suspends the checks of the current thread for the lifetime of the scope, e.g. for known non realtime code paths
+    // like error handling
+    class SuspendScope {
+      public:
+        SuspendScope() { suspend(); }
+        ~SuspendScope() { resume(); }
+    };
+
+    static constexpr bool isEnabled() { return AG_RT_CHECKS_ENABLED != 0; }
+
+    static void enter();
+    static void leave();
+    static void suspend();
+    static void resume();
+    static bool isRealtimeThread();
+
+    // Called from the interposed functions
+    static void check(Type type, void* addr);
+
+    static uint64 getViolationCount();
+    static std::vector<CallSite> getCallSites();
+    static void reset();
+
+    static String describe(const CallSite& cs);
+    static String describeViolations(size_t maxCallSites = 10);
+};
+
+class RealtimeViolations : public BasicStatistic, public LogTag {
+  public:
+    RealtimeViolations() : LogTag("stats") {}
+    ~RealtimeViolations() override {}
+
+    Meter& getMeter() { return m_meter; }
+
+    void aggregate() override {}
+    void aggregate1s() override;
+    void log(const String& name) override;
+
+  private:
+    Meter m_meter;
+    uint64 m_lastCount = 0;
+};
+
+}  // namespace e47
+
+#endif /* RealtimeCheck_hpp */
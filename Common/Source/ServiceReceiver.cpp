@@ -110,7 +110,7 @@ bool ServiceReceiver::updateServers() {
             bool exists = false;
             for (auto& s2 : m_servers) {
                 if (s1 == s2) {
-                    s2.refresh(s1.getLoad());
+                    s2.refresh(s1);
                     exists = true;
                     break;
                 }
@@ -140,6 +140,13 @@ bool ServiceReceiver::updateServers() {
             m_servers.remove(idx);
             changed = true;
         } else {
+            std::lock_guard<std::mutex> lock(m_serversMtx);
+            for (auto& s : m_servers) {
+                if (s == srv) {
+                    s.setRttMs(srv.getRttMs());
+                    break;
+                }
+            }
             idx++;
         }
     }
@@ -166,16 +173,18 @@ bool ServiceReceiver::updateServers() {
     return changed;
 }
 
-bool ServiceReceiver::isReachable(const ServerInfo& srv) {
+bool ServiceReceiver::isReachable(ServerInfo& srv) {
     auto now = Time::currentTimeMillis();
     String host = srv.getHost();
     int port = Defaults::SERVER_PORT + srv.getID();
     String key = host + String(port);
     if (m_lastReachableChecks.count(key) == 0 || m_lastReachableChecks[key] + 30000 < now) {
         StreamingSocket sock;
+        auto start = Time::getMillisecondCounterHiRes();
         if (!sock.connect(host, port, 500) || (srv.getLocalMode() && !sock.isLocal())) {
             return false;
         }
+        srv.setRttMs(Time::getMillisecondCounterHiRes() - start);
         sock.close();
         m_lastReachableChecks[key] = now;
     }
@@ -225,6 +234,10 @@ int ServiceReceiver::handleRecord(int /*sock*/, const struct sockaddr* from, siz
                         m_curLoad = jsonGetValue(j, "LOAD", 0.0f);
                         m_curLocalMode = jsonGetValue(j, "LM", false);
                         m_curVersion = jsonGetValue(j, "V", String("unknown"));
+                        m_curProtocolVersion = jsonGetValue(j, "PV", 0);
+                        m_curClients = jsonGetValue(j, "CL", -1);
+                        m_curDeadlineMisses = jsonGetValue(j, "DM", 0);
+                        m_curFreeMemoryMB = jsonGetValue(j, "MEM", (int64)-1);
                         complete = true;
                     }
                 }
@@ -234,9 +247,13 @@ int ServiceReceiver::handleRecord(int /*sock*/, const struct sockaddr* from, siz
     }
     if (complete) {
         auto host = mDNSConnector::ipToString(from, addrlen, true);
-        m_currentResult.add(ServerInfo(host, m_curName, from->sa_family == AF_INET6, m_curId,
-                                       m_curUuid.isNotEmpty() ? m_curUuid : Uuid::null(), m_curLoad, m_curLocalMode,
-                                       m_curVersion));
+        ServerInfo srv(host, m_curName, from->sa_family == AF_INET6, m_curId,
+                       m_curUuid.isNotEmpty() ? m_curUuid : Uuid::null(), m_curLoad, m_curLocalMode, m_curVersion);
+        srv.setProtocolVersion(m_curProtocolVersion);
+        srv.setClients(m_curClients);
+        srv.setDeadlineMisses(m_curDeadlineMisses);
+        srv.setFreeMemoryMB(m_curFreeMemoryMB);
+        m_currentResult.add(srv);
     }
     return 0;
 }
@@ -53,6 +53,10 @@ class ServiceReceiver : public Thread, public LogTag {
     float m_curLoad;
     bool m_curLocalMode;
     String m_curVersion;
+    int m_curProtocolVersion = 0;
+    int m_curClients = -1;
+    int m_curDeadlineMisses = 0;
+    int64 m_curFreeMemoryMB = -1;
     Array<ServerInfo> m_currentResult;
 
     Array<ServerInfo> m_servers;
@@ -64,7 +68,8 @@ class ServiceReceiver : public Thread, public LogTag {
     Array<ServerInfo> getServersInternal();
     bool updateServers();
 
-    bool isReachable(const ServerInfo& srv);
+    // Updates the rtt of the server, if it connects
+    bool isReachable(ServerInfo& srv);
 };
 
 }  // namespace e47
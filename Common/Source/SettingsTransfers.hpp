@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef SettingsTransfers_hpp
+#define SettingsTransfers_hpp
+
+#include <JuceHeader.h>
+#include <map>
+
+#include "Message.hpp"
+
+namespace e47 {
+
+/*
+ * Keeps track of chunked plugin settings transfers. Every transfer has its own id, so a second transfer for the same
+ * plugin, that starts in between the chunks of another one, can't mix up the chunks of both.
+ */
+class SettingsTransfers {
+  public:
+    enum Result { PENDING, COMPLETE, FAILED };
+
+    // Keeps the compressed settings until the last chunk has been fetched and returns the id of the transfer
+    int addOutgoing(int idx, const String& settings) {
+        int transfer = nextId();
+        auto& out = m_out[transfer];
+        out.idx = idx;
+        out.block = PluginSettingsChunk::compress(settings);
+        dropAbandoned(m_out);
+        return transfer;
+    }
+
+    int getNumChunks(int transfer) const {
+        auto it = m_out.find(transfer);
+        return it != m_out.end() ? PluginSettingsChunk::getNumChunks(it->second.block) : 0;
+    }
+
+    // Fills in chunk seq of an outgoing transfer, fails if the transfer does not exist or belongs to another plugin
+    bool getChunk(int transfer, int idx, int seq, PluginSettingsChunk& chunk) {
+        auto it = m_out.find(transfer);
+        if (it == m_out.end() || it->second.idx != idx || seq < 0 ||
+            seq >= PluginSettingsChunk::getNumChunks(it->second.block)) {
+            return false;
+        }
+        chunk.setChunk(idx, transfer, seq, it->second.block);
+        if (seq == PluginSettingsChunk::getNumChunks(it->second.block) - 1) {
+            m_out.erase(it);
+        }
+        return true;
+    }
+
+    // Collects a chunk of an incoming transfer, the settings are set when the transfer is complete
+    Result addIncoming(const PluginSettingsChunk& chunk, String& settings, String& err) {
+        auto* hdr = chunk.hdr;
+        auto it = m_in.find(hdr->transfer);
+        if (hdr->seq == 0) {
+            if (it != m_in.end()) {
+                err = "settings transfer " + String(hdr->transfer) + " has been started twice";
+                m_in.erase(it);
+                return FAILED;
+            }
+            it = m_in.emplace(hdr->transfer, In()).first;
+            it->second.idx = hdr->idx;
+            it->second.total = hdr->total;
+            dropAbandoned(m_in);
+            it = m_in.find(hdr->transfer);
+            if (it == m_in.end()) {
+                err = "too many settings transfers";
+                return FAILED;
+            }
+        } else if (it == m_in.end() || hdr->seq != it->second.seq || hdr->total != it->second.total ||
+                   hdr->idx != it->second.idx) {
+            err = "settings chunk " + String(hdr->seq) + "/" + String(hdr->total) + " of transfer " +
+                  String(hdr->transfer) + " for idx " + String(hdr->idx) + " does not match the transfer";
+            if (it != m_in.end()) {
+                m_in.erase(it);
+            }
+            return FAILED;
+        }
+        auto& in = it->second;
+        in.seq = hdr->seq + 1;
+        in.block.append(chunk.data, (size_t)hdr->size);
+        if (in.seq < in.total) {
+            return PENDING;
+        }
+        bool ok = PluginSettingsChunk::decompress(in.block, settings);
+        m_in.erase(it);
+        if (!ok) {
+            err = "settings for idx " + String(hdr->idx) + " exceed the size limit";
+            return FAILED;
+        }
+        return COMPLETE;
+    }
+
+    size_t getNumOutgoing() const { return m_out.size(); }
+    size_t getNumIncoming() const { return m_in.size(); }
+
+  private:
+    // Transfers, that the peer never finished, get dropped oldest first
+    static constexpr size_t MAX_TRANSFERS = 16;
+
+    struct Out {
+        int idx = -1;
+        MemoryBlock block;
+    };
+
+    struct In {
+        int idx = -1;
+        int seq = 0;
+        int total = 0;
+        MemoryBlock block;
+    };
+
+    // ordered by id, so the oldest transfer comes first
+    std::map<int, Out> m_out;
+    std::map<int, In> m_in;
+    int m_nextId = 0;
+
+    int nextId() {
+        m_nextId = m_nextId < std::numeric_limits<int>::max() ? m_nextId + 1 : 1;
+        return m_nextId;
+    }
+
+    template <typename T>
+    static void dropAbandoned(std::map<int, T>& transfers) {
+        while (transfers.size() > MAX_TRANSFERS) {
+            transfers.erase(transfers.begin());
+        }
+    }
+};
+
+}  // namespace e47
+
+#endif /* SettingsTransfers_hpp */
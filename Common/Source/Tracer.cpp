@@ -32,7 +32,7 @@ setLogTagStatic("tracer");
         dst[len] = 0;                                       \
     } while (0)
 
-Scope::Scope(const LogTag* t, const String& f, int l, const String& ff) {
+Scope::Scope(const LogTag* t, const char* f, int l, const char* ff) {
     if (l_tracerEnabled) {
         enabled = true;
         tagId = t->getTagId();
@@ -46,7 +46,7 @@ Scope::Scope(const LogTag* t, const String& f, int l, const String& ff) {
     }
 }
 
-Scope::Scope(const LogTagDelegate* t, const String& f, int l, const String& ff)
+Scope::Scope(const LogTagDelegate* t, const char* f, int l, const char* ff)
     : Scope(t->getLogTagSource(), f, l, ff) {}
 
 void initialize(const String& appName, const String& filePrefix, bool linkLatest) {
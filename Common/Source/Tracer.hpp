@@ -39,8 +39,9 @@ struct Scope {
     String func;
     int64 start;
 
-    Scope(const LogTag* t, const String& f, int l, const String& ff);
-    Scope(const LogTagDelegate* t, const String& f, int l, const String& ff);
+    // file and function are passed as raw pointers to not allocate, if tracing is disabled
+    Scope(const LogTag* t, const char* f, int l, const char* ff);
+    Scope(const LogTagDelegate* t, const char* f, int l, const char* ff);
     ~Scope() {
         if (enabled) {
             auto end = Time::getHighResolutionTicks();
@@ -137,7 +137,12 @@ class ServerInfo {
           m_uuid(other.m_uuid),
           m_load(other.m_load),
           m_localMode(other.m_localMode),
-          m_version(other.m_version) {
+          m_version(other.m_version),
+          m_protocolVersion(other.m_protocolVersion),
+          m_clients(other.m_clients),
+          m_deadlineMisses(other.m_deadlineMisses),
+          m_freeMemoryMB(other.m_freeMemoryMB),
+          m_rttMs(other.m_rttMs) {
         refresh();
     }
 
@@ -150,6 +155,11 @@ class ServerInfo {
         m_load = other.m_load;
         m_localMode = other.m_localMode;
         m_version = other.m_version;
+        m_protocolVersion = other.m_protocolVersion;
+        m_clients = other.m_clients;
+        m_deadlineMisses = other.m_deadlineMisses;
+        m_freeMemoryMB = other.m_freeMemoryMB;
+        m_rttMs = other.m_rttMs;
         refresh();
         return *this;
     }
@@ -185,6 +195,17 @@ class ServerInfo {
     void setLoad(float l) { m_load = l; }
     bool getLocalMode() const { return m_localMode; }
     void setLocalMode(bool b) { m_localMode = b; }
+    int getProtocolVersion() const { return m_protocolVersion; }
+    void setProtocolVersion(int v) { m_protocolVersion = v; }
+    int getClients() const { return m_clients; }
+    void setClients(int c) { m_clients = c; }
+    int getDeadlineMisses() const { return m_deadlineMisses; }
+    void setDeadlineMisses(int m) { m_deadlineMisses = m; }
+    int64 getFreeMemoryMB() const { return m_freeMemoryMB; }
+    void setFreeMemoryMB(int64 m) { m_freeMemoryMB = m; }
+    // The connect time of the last reachable check, < 0 if unknown
+    double getRttMs() const { return m_rttMs; }
+    void setRttMs(double rtt) { m_rttMs = rtt; }
 
     String getHostAndID() const {
         String ret = m_host;
@@ -216,6 +237,12 @@ class ServerInfo {
         if (m_load > 0.0f) {
             ret << ", load=" << m_load;
         }
+        if (m_clients > -1) {
+            ret << ", clients=" << m_clients;
+        }
+        if (m_deadlineMisses > 0) {
+            ret << ", deadlinemisses=" << m_deadlineMisses;
+        }
         ret << ")";
         return ret;
     }
@@ -236,6 +263,14 @@ class ServerInfo {
         m_load = load;
     }
 
+    // Update the live stats, that the server announces with every mDNS answer
+    void refresh(const ServerInfo& other) {
+        refresh(other.m_load);
+        m_clients = other.m_clients;
+        m_deadlineMisses = other.m_deadlineMisses;
+        m_freeMemoryMB = other.m_freeMemoryMB;
+    }
+
   private:
     String m_host, m_name;
     bool m_isIpv6 = false;
@@ -244,6 +279,11 @@ class ServerInfo {
     float m_load = 0.0f;
     bool m_localMode = false;
     String m_version;
+    int m_protocolVersion = 0;
+    int m_clients = -1;
+    int m_deadlineMisses = 0;
+    int64 m_freeMemoryMB = -1;
+    double m_rttMs = -1.0;
     Time m_updated;
 };
 
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef AudioConcealer_hpp
+#define AudioConcealer_hpp
+
+#include <JuceHeader.h>
+
+namespace e47 {
+
+// Strategies to fill a block, that did not arrive from the server in time
+enum ConcealmentMode : int { CONCEAL_SILENCE, CONCEAL_REPEAT, CONCEAL_EXTRAPOLATE, CONCEAL_DRY };
+
+inline String getConcealmentModeName(int mode) {
+    switch (mode) {
+        case CONCEAL_REPEAT:
+            return "Repeat Last Block";
+        case CONCEAL_EXTRAPOLATE:
+            return "Extrapolate Waveform";
+        case CONCEAL_DRY:
+            return "Dry Signal";
+        default:
+            return "Silence";
+    }
+}
+
+/*
+ * Replaces lost blocks on the audio thread. Repeat and extrapolate continue the last output received from the server
+ * and fade it out, if the server does not respond for a longer time. Extrapolate repeats the last pitch period, that
+ * gets found by a waveform similarity search, to avoid the discontinuity of repeating a whole block. Dry outputs the
+ * input delayed by the latency reported to the host. When the server responds again, the concealed signal gets cross
+ * faded into the received one. All buffers are allocated in prepare().
+ */
+template <typename T>
+class AudioConcealer {
+  public:
+    void prepare(int channels, double sampleRate, int samplesPerBlock, int maxDelaySamples) {
+        m_minPeriod = jmax(1, (int)(sampleRate / 1000));
+        m_maxPeriod = jmax(m_minPeriod, (int)(sampleRate / 50));
+        m_matchSamples = jmax(16, (int)(sampleRate * MATCH_MS / 1000));
+        m_holdSamples = (int)(sampleRate * HOLD_MS / 1000);
+        m_fadeSamples = jmax(1, (int)(sampleRate * FADE_MS / 1000));
+
+        m_history.setSize(channels, jmax(samplesPerBlock, m_maxPeriod + m_matchSamples));
+        m_history.clear();
+        m_historySamples = 0;
+
+        m_dry.setSize(channels, jmax(0, maxDelaySamples) + samplesPerBlock);
+        m_dry.clear();
+        m_dryPos = 0;
+
+        m_scratch.setSize(channels, CROSSFADE_SAMPLES);
+        m_lostSamples = 0;
+    }
+
+    // Records the input of a block for the dry mode
+    void pushInput(const AudioBuffer<T>& buffer) {
+        int size = m_dry.getNumSamples();
+        if (size == 0) {
+            return;
+        }
+        int numSamples = jmin(buffer.getNumSamples(), size);
+        int offset = buffer.getNumSamples() - numSamples;
+        int first = jmin(numSamples, size - m_dryPos);
+        for (int ch = 0; ch < m_dry.getNumChannels(); ch++) {
+            if (ch < buffer.getNumChannels()) {
+                m_dry.copyFrom(ch, m_dryPos, buffer, ch, offset, first);
+                m_dry.copyFrom(ch, 0, buffer, ch, offset + first, numSamples - first);
+            } else {
+                m_dry.clear(ch, m_dryPos, first);
+                m_dry.clear(ch, 0, numSamples - first);
+            }
+        }
+        m_dryPos = (m_dryPos + numSamples) % size;
+    }
+
+    // Called for every block received from the server
+    void received(AudioBuffer<T>& buffer, int delaySamples) {
+        if (m_lostSamples > 0) {
+            int xfade = jmin(buffer.getNumSamples(), m_scratch.getNumSamples());
+            if (m_mode != CONCEAL_SILENCE && xfade > 0 &&
+                generate(m_scratch, xfade, buffer.getNumSamples(), m_mode, delaySamples)) {
+                int channels = jmin(buffer.getNumChannels(), m_scratch.getNumChannels());
+                for (int ch = 0; ch < channels; ch++) {
+                    auto* dst = buffer.getWritePointer(ch);
+                    auto* src = m_scratch.getReadPointer(ch);
+                    for (int i = 0; i < xfade; i++) {
+                        T gain = (T)(i + 1) / (T)(xfade + 1);
+                        dst[i] = dst[i] * gain + src[i] * (1 - gain);
+                    }
+                }
+            }
+            m_lostSamples = 0;
+        }
+        addHistory(buffer);
+    }
+
+    // Fills a block, that got lost
+    void conceal(AudioBuffer<T>& buffer, int mode, int delaySamples) {
+        int numSamples = buffer.getNumSamples();
+        if (m_lostSamples == 0 || mode != m_mode) {
+            m_mode = mode;
+            m_phase = 0;
+            m_period = mode == CONCEAL_EXTRAPOLATE ? findPeriod() : jmin(numSamples, m_history.getNumSamples());
+        }
+        if (mode == CONCEAL_SILENCE || !generate(buffer, numSamples, numSamples, mode, delaySamples)) {
+            buffer.clear();
+        }
+        m_lostSamples += numSamples;
+    }
+
+  private:
+    static constexpr int MATCH_MS = 3;
+    static constexpr int HOLD_MS = 10;
+    static constexpr int FADE_MS = 50;
+    static constexpr int CROSSFADE_SAMPLES = 128;
+    // The search runs on the audio thread, a surround layout would multiply its costs without improving the match
+    static constexpr int MAX_PERIOD_CHANNELS = 2;
+
+    AudioBuffer<T> m_history, m_dry, m_scratch;
+    int m_historySamples = 0;
+    int m_dryPos = 0;
+    int m_minPeriod = 1, m_maxPeriod = 1, m_matchSamples = 16, m_holdSamples = 0, m_fadeSamples = 1;
+
+    int m_mode = CONCEAL_SILENCE;
+    int m_lostSamples = 0;
+    int m_period = 1;
+    int m_phase = 0;
+
+    void addHistory(const AudioBuffer<T>& buffer) {
+        int size = m_history.getNumSamples();
+        int numSamples = jmin(buffer.getNumSamples(), size);
+        int offset = buffer.getNumSamples() - numSamples;
+        for (int ch = 0; ch < m_history.getNumChannels(); ch++) {
+            auto* dst = m_history.getWritePointer(ch);
+            if (numSamples < size) {
+                std::memmove(dst, dst + numSamples, (size_t)(size - numSamples) * sizeof(T));
+            }
+            if (ch < buffer.getNumChannels()) {
+                FloatVectorOperations::copy(dst + size - numSamples, buffer.getReadPointer(ch, offset), numSamples);
+            } else {
+                FloatVectorOperations::clear(dst + size - numSamples, numSamples);
+            }
+        }
+        m_historySamples = jmin(size, m_historySamples + numSamples);
+    }
+
+    // Finds the lag, at which the history is most similar to its end
+    int findPeriod() const {
+        int size = m_history.getNumSamples();
+        int maxPeriod = jmin(m_maxPeriod, m_historySamples - m_matchSamples);
+        if (maxPeriod < m_minPeriod) {
+            return jmax(1, jmin(m_historySamples, size));
+        }
+        int best = maxPeriod;
+        double bestScore = 0.0;
+        int channels = jmin(m_history.getNumChannels(), MAX_PERIOD_CHANNELS);
+        for (int p = m_minPeriod; p <= maxPeriod; p++) {
+            double corr = 0.0, energy = 0.0;
+            for (int ch = 0; ch < channels; ch++) {
+                auto* x = m_history.getReadPointer(ch, size - m_matchSamples);
+                auto* y = x - p;
+                for (int i = 0; i < m_matchSamples; i++) {
+                    corr += (double)x[i] * y[i];
+                    energy += (double)y[i] * y[i];
+                }
+            }
+            if (corr > 0.0 && energy > 0.0) {
+                double score = corr / std::sqrt(energy);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = p;
+                }
+            }
+        }
+        return best;
+    }
+
+    bool generate(AudioBuffer<T>& dst, int numSamples, int blockSamples, int mode, int delaySamples) {
+        if (mode == CONCEAL_DRY) {
+            int size = m_dry.getNumSamples();
+            if (delaySamples < 0 || delaySamples + blockSamples > size) {
+                return false;
+            }
+            // the input of the current block has been recorded already
+            int start = ((m_dryPos - blockSamples - delaySamples) % size + size) % size;
+            int first = jmin(numSamples, size - start);
+            for (int ch = 0; ch < dst.getNumChannels(); ch++) {
+                if (ch < m_dry.getNumChannels()) {
+                    dst.copyFrom(ch, 0, m_dry, ch, start, first);
+                    dst.copyFrom(ch, first, m_dry, ch, 0, numSamples - first);
+                } else {
+                    dst.clear(ch, 0, numSamples);
+                }
+            }
+            return true;
+        }
+
+        int size = m_history.getNumSamples();
+        if ((mode != CONCEAL_REPEAT && mode != CONCEAL_EXTRAPOLATE) || m_historySamples == 0 || m_period <= 0) {
+            return false;
+        }
+        for (int ch = 0; ch < dst.getNumChannels(); ch++) {
+            auto* out = dst.getWritePointer(ch);
+            if (ch >= m_history.getNumChannels()) {
+                FloatVectorOperations::clear(out, numSamples);
+                continue;
+            }
+            auto* src = m_history.getReadPointer(ch, size - m_period);
+            for (int i = 0; i < numSamples; i++) {
+                int pos = m_lostSamples + i - m_holdSamples;
+                T gain = pos <= 0 ? (T)1 : (T)jmax(0.0, 1.0 - (double)pos / m_fadeSamples);
+                out[i] = src[(m_phase + i) % m_period] * gain;
+            }
+        }
+        m_phase = (m_phase + numSamples) % m_period;
+        return true;
+    }
+};
+
+}  // namespace e47
+
+#endif /* AudioConcealer_hpp */
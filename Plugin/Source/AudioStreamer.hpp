@@ -12,6 +12,7 @@
 
 #include "Client.hpp"
 #include "Metrics.hpp"
+#include "LowLatencyWait.hpp"
 
 namespace e47 {
 
@@ -30,7 +31,9 @@ class AudioStreamer : public Thread, public LogTagDelegate {
           m_durationGlobal(TimeStatistic::getDuration("audio_stream")),
           m_durationLocal(TimeStatistic::getDuration(String("audio_stream.") + String(getTagId()), false, false)),
           m_readQMeter((size_t)(clnt->getSampleRate() / clnt->getSamplesPerBlock()) + 1),
-          m_readTimeoutMs((int)(clnt->getSamplesPerBlock() / clnt->getSampleRate() * 1000 - 1)) {
+          m_readTimeoutMs((int)(clnt->getSamplesPerBlock() / clnt->getSampleRate() * 1000 - 1)),
+          m_inflightQ(m_queueSize),
+          m_inflightReader([this] { readInflight(); }, "AudioStreamerReader") {
         traceScope();
 
         for (int i = 0; i < clnt->NUM_OF_BUFFERS; i++) {
@@ -43,25 +46,38 @@ class AudioStreamer : public Thread, public LogTagDelegate {
         }
         m_readBuffer.audio.clear();
 
+        // leave room for the latency of the chain, that is reported by the server later
+        m_concealer.prepare(jmax(clnt->getChannelsIn() + clnt->getChannelsSC(), clnt->getChannelsOut()),
+                            clnt->getSampleRate(), clnt->getSamplesPerBlock(),
+                            clnt->getLatencySamples() + (int)clnt->getSampleRate());
+
         m_bytesOutMeter = Metrics::getStatistic<Meter>("NetBytesOut");
         m_bytesInMeter = Metrics::getStatistic<Meter>("NetBytesIn");
+        m_concealmentMeter = Metrics::getStatistic<Meter>("AudioConcealments");
+
+        if (clnt->LOW_LATENCY && !setBusyPoll(sock, Defaults::BUSY_POLL_USEC)) {
+            logln("busy polling is not available for the audio socket, spinning only");
+        }
     }
 
     ~AudioStreamer() {
         traceScope();
         logln("audio streamer cleaning up");
         signalThreadShouldExit();
+        m_inflightReader.signalThreadShouldExit();
         if (m_queueSize > 0) {
             notifyWrite();
             notifyRead();
+            notifyInflight();
         }
         waitForThreadAndLog(getLogTagSource(), this);
+        waitForThreadAndLog(getLogTagSource(), &m_inflightReader);
         logln("audio streamer cleanup done");
     }
 
     bool isOk() {
         traceScope();
-        if (!m_error) {
+        if (!m_error && nullptr != m_socket) {
             return m_socket->isConnected();
         }
         return false;
@@ -71,6 +87,31 @@ class AudioStreamer : public Thread, public LogTagDelegate {
     int getReadTimeoutMs() const { return m_readTimeoutMs; }
     uint64_t getReadErrors() const { return m_readErrors; }
 
+    // Stops streaming after all queued blocks have been processed and hands over the connection, so that a new
+    // streamer can continue on it. Returns nullptr, if the connection is not in a clean state.
+    StreamingSocket* releaseSocket() {
+        traceScope();
+        if (m_queueSize == 0) {
+            // blocks are sent by the audio thread, there is no way to know if a response is pending
+            return nullptr;
+        }
+        signalThreadShouldExit();
+        notifyWrite();
+        waitForThreadAndLog(getLogTagSource(), this);
+        {
+            std::unique_lock<std::mutex> lock(m_inflightMtx);
+            m_inflightCv.wait_for(lock, std::chrono::milliseconds(OFFLINE_READ_TIMEOUT_MS),
+                                  [this] { return m_inflight == 0 || m_error; });
+        }
+        m_inflightReader.signalThreadShouldExit();
+        notifyInflight();
+        waitForThreadAndLog(getLogTagSource(), &m_inflightReader);
+        if (m_error || m_inflight > 0 || m_writeQ.read_available() > 0 || !m_socket->isConnected()) {
+            return nullptr;
+        }
+        return m_socket.release();
+    }
+
     void run() {
         traceScope();
         bool isDouble = std::is_same<T, double>::value;
@@ -80,6 +121,36 @@ class AudioStreamer : public Thread, public LogTagDelegate {
                 while (m_writeQ.read_available() > 0) {
                     AudioMidiBuffer buf;
                     m_writeQ.pop(buf);
+                    if (buf.offline && !buf.skip) {
+                        // Offline blocks are pipelined: the next block gets sent while the server is still
+                        // processing the previous one and the responses are read by the reader thread. The depth is
+                        // limited by NUM_OF_BUFFERS, as the host consumes a block only after sending another one.
+                        if (!m_inflightReader.isThreadRunning()) {
+                            m_inflightReader.startThread();
+                        }
+                        // a block leaves the queue after its response has been read, a response for a block that is
+                        // not in the queue would be assigned to the next block
+                        if (!waitInflightSpace()) {
+                            return;
+                        }
+                        if (!sendInternal(buf)) {
+                            logln("error: " << getInstanceString() << ": send failed");
+                            setError();
+                            return;
+                        }
+                        m_inflight++;
+                        if (!m_inflightQ.push(std::move(buf))) {
+                            logln("error: " << getInstanceString() << ": inflight queue full");
+                            setError();
+                            return;
+                        }
+                        notifyInflight();
+                        continue;
+                    }
+                    // keep the order of the blocks and the read queue single producer
+                    if (!waitInflight()) {
+                        return;
+                    }
                     if (!buf.skip) {
                         m_durationLocal.reset();
                         m_durationGlobal.reset();
@@ -89,21 +160,12 @@ class AudioStreamer : public Thread, public LogTagDelegate {
                             return;
                         }
                         MessageHelper::Error err;
-                        if (!readInternal(buf, &err)) {
+                        if (!readResponse(buf, &err)) {
                             logln("error: " << getInstanceString() << ": read failed: " << err.toString());
                             setError();
                             return;
                         }
-                        // drop samples in case we had read error(s)
-                        if (m_dropSamples > 0) {
-                            int samples = m_dropSamples.exchange(0);
-                            if (samples < buf.workingSamples) {
-                                buf.consume(samples);
-                            } else {
-                                m_dropSamples += samples - buf.workingSamples;
-                                buf.workingSamples = 0;
-                            }
-                        }
+                        dropSamples(buf);
                         m_durationLocal.update();
                         m_durationGlobal.update();
                     } else {
@@ -122,7 +184,7 @@ class AudioStreamer : public Thread, public LogTagDelegate {
                 if (waitRead()) {
                     m_ioThreadBusy = true;
                     MessageHelper::Error err;
-                    if (!readInternal(m_readBuffer, &err)) {
+                    if (!readResponse(m_readBuffer, &err)) {
                         logln("error: " << getInstanceString() << ": read failed: " << err.toString());
                         if (err.code != MessageHelper::E_TIMEOUT) {
                             setError();
@@ -153,8 +215,24 @@ class AudioStreamer : public Thread, public LogTagDelegate {
 
         TimeTrace::addTracePoint("as_prep");
 
+        // the host renders offline, blocks must not be dropped as the output has to be identical to a realtime
+        // render and the host waits for the data as long as it takes
+        bool offline = m_client->isOfflineRender();
+        if (offline != m_offline) {
+            logln(getInstanceString() << ": offline render " << (offline ? "started" : "finished"));
+            m_offline = offline;
+        }
+
+        if (m_client->isFx() && !offline) {
+            m_concealer.pushInput(buffer);
+        }
+
         if (m_client->NUM_OF_BUFFERS > 0) {
-            if ((m_client->LIVE_MODE && m_writeQ.read_available() > (size_t)m_client->NUM_OF_BUFFERS) ||
+            if (offline) {
+                // the host is not bound to realtime, so we wait for the writer instead of dropping a block
+                waitWriteQueue();
+            }
+            if ((m_client->LIVE_MODE && !offline && m_writeQ.read_available() > (size_t)m_client->NUM_OF_BUFFERS) ||
                 m_writeQ.read_available() > m_queueHighWaterMark) {
                 logln("error: " << getInstanceString() << ": write queue full, dropping samples");
                 m_readErrors++;
@@ -191,6 +269,7 @@ class AudioStreamer : public Thread, public LogTagDelegate {
 
                 AudioMidiBuffer buf;
                 buf.posInfo = m_writeBuffer.posInfo;
+                buf.offline = offline;
                 buf.copyFromAndConsume(m_writeBuffer, samples);
 
                 TimeTrace::addTracePoint("as_copy_from_wbuf");
@@ -214,15 +293,16 @@ class AudioStreamer : public Thread, public LogTagDelegate {
                 TimeTrace::addTracePoint("as_notify");
             }
         } else {
-            if (m_client->LIVE_MODE && m_ioThreadBusy) {
+            if (m_client->LIVE_MODE && !offline && m_ioThreadBusy) {
                 logln("error: " << getInstanceString() << ": io thread busy, dropping samples");
                 m_readErrors++;
-                buffer.clear();
+                conceal(buffer);
                 return false;
             }
 
             AudioMidiBuffer buf;
             buf.posInfo = posInfo;
+            buf.offline = offline;
 
             if (m_client->isFx()) {
                 buf.copyFrom(buffer, midi);
@@ -265,6 +345,9 @@ class AudioStreamer : public Thread, public LogTagDelegate {
         AudioMidiBuffer buf;
 
         if (m_client->NUM_OF_BUFFERS > 0) {
+            // blocks, that have been skipped because of a full write queue, come back as silence
+            bool skipped = false;
+
             if (m_readBuffer.workingSamples < buffer.getNumSamples()) {
                 traceln("  buffer (read): working samples=" << m_readBuffer.workingSamples << ",");
                 traceln("    channels=" << m_readBuffer.audio.getNumChannels()
@@ -275,10 +358,11 @@ class AudioStreamer : public Thread, public LogTagDelegate {
 
             while (m_readBuffer.workingSamples < buffer.getNumSamples()) {
                 traceln("  waiting for data...");
-                if (!waitRead()) {
+                if (!waitRead(m_offline)) {
                     m_dropSamples += buffer.getNumSamples();
                     m_readErrors++;
                     logln("error: " << getInstanceString() << ": waitRead failed");
+                    concealLive(buffer);
                     TimeTrace::finishGroup("as_wait_read_failed");
                     return;
                 }
@@ -291,11 +375,13 @@ class AudioStreamer : public Thread, public LogTagDelegate {
                     traceln("  pop buffer: channels=" << buf.audio.getNumChannels() << ", samples="
                                                       << buf.audio.getNumSamples() << ", skip=" << (int)buf.skip);
 
+                    skipped |= buf.skip;
                     m_readBuffer.copyFrom(buf);
 
                     TimeTrace::addTracePoint("as_copy_to_rbuf");
                 } else {
                     logln("error: " << getInstanceString() << ": read queue empty");
+                    concealLive(buffer);
                     return;
                 }
             }
@@ -322,6 +408,12 @@ class AudioStreamer : public Thread, public LogTagDelegate {
 
             TimeTrace::addTracePoint("as_consume");
 
+            if (skipped && m_client->LIVE_MODE && !m_offline) {
+                conceal(buffer);
+            } else {
+                m_concealer.received(buffer, m_client->getLatencySamples());
+            }
+
             traceln("  consumed " << buffer.getNumSamples() << " samples");
         } else {
             m_readBuffer.channelsRequested = buffer.getNumChannels();
@@ -329,26 +421,27 @@ class AudioStreamer : public Thread, public LogTagDelegate {
             m_readBuffer.audio.setSize(buffer.getNumChannels(), buffer.getNumSamples());
             m_readBuffer.midi.clear();
 
-            if (m_client->LIVE_MODE) {
+            if (m_client->LIVE_MODE && !m_offline) {
                 if (m_ioThreadBusy) {
                     traceln("io thread busy");
                     m_readErrors++;
-                    buffer.clear();
+                    conceal(buffer);
                     TimeTrace::addTracePoint("as_io_busy");
                     return;
                 } else {
                     notifyRead();
-                    if (!m_ioDataReady.wait(m_readTimeoutMs)) {
+                    if (!m_dataWait.wait(m_client->LOW_LATENCY, m_readTimeoutMs,
+                                         [this](int timeoutMs) { return m_ioDataReady.wait(timeoutMs); })) {
                         logln("error: " << getInstanceString() << ": read timeout, dropping samples");
                         m_readErrors++;
-                        buffer.clear();
+                        conceal(buffer);
                         TimeTrace::addTracePoint("as_io_timeout");
                         return;
                     }
                 }
             } else {
                 MessageHelper::Error err;
-                if (!readInternal(m_readBuffer, &err)) {
+                if (!readInternal(m_readBuffer, &err, m_offline ? OFFLINE_READ_TIMEOUT_MS : 1000)) {
                     logln("error: " << getInstanceString() << ": read failed: " << err.toString());
                     setError();
                     return;
@@ -360,6 +453,7 @@ class AudioStreamer : public Thread, public LogTagDelegate {
             m_durationLocal.update();
             m_durationGlobal.update();
             m_readBuffer.copyToAndConsume(buffer, midi, buffer.getNumChannels(), buffer.getNumSamples());
+            m_concealer.received(buffer, m_client->getLatencySamples());
 
             TimeTrace::addTracePoint("as_consume");
         }
@@ -375,6 +469,7 @@ class AudioStreamer : public Thread, public LogTagDelegate {
         AudioPlayHead::PositionInfo posInfo;
         bool needsPositionUpdate = true;
         bool skip = false;
+        bool offline = false;
 
         LogTag tag = LogTag("audiomidibuffer");
 
@@ -532,7 +627,7 @@ class AudioStreamer : public Thread, public LogTagDelegate {
     std::mutex m_writeMtx, m_readMtx, m_sockMtx;
     std::condition_variable m_writeCv, m_readCv;
     TimeStatistic::Duration m_durationGlobal, m_durationLocal;
-    std::shared_ptr<Meter> m_bytesOutMeter, m_bytesInMeter;
+    std::shared_ptr<Meter> m_bytesOutMeter, m_bytesInMeter, m_concealmentMeter;
     SizeMeter m_readQMeter;
     const int m_readTimeoutMs;
     std::atomic_int m_dropSamples{0};
@@ -541,6 +636,20 @@ class AudioStreamer : public Thread, public LogTagDelegate {
     std::atomic_bool m_ioThreadBusy{false};
     WaitableEvent m_ioDataReady;
 
+    AudioConcealer<T> m_concealer;
+
+    // the streamer thread waits for the server, the audio thread for the streamer thread
+    LowLatencyWait m_socketWait{true}, m_dataWait;
+
+    // offline render
+    static constexpr int OFFLINE_READ_TIMEOUT_MS = 30000;
+    bool m_offline = false;
+    boost::lockfree::spsc_queue<AudioMidiBuffer> m_inflightQ;
+    std::atomic_int m_inflight{0};
+    std::mutex m_inflightMtx;
+    std::condition_variable m_inflightCv;
+    FnThread m_inflightReader;
+
     AudioMidiBuffer m_readBuffer, m_writeBuffer;
 
     std::atomic_bool m_error{false};
@@ -555,6 +664,21 @@ class AudioStreamer : public Thread, public LogTagDelegate {
         if (m_queueSize > 0) {
             notifyRead();
             notifyWrite();
+            notifyInflight();
+        }
+    }
+
+    void conceal(AudioBuffer<T>& buffer) {
+        traceScope();
+        m_concealer.conceal(buffer, m_client->CONCEALMENT, m_client->getLatencySamples());
+        m_concealmentMeter->increment();
+        TimeTrace::addTracePoint("as_conceal");
+    }
+
+    // Without live mode a failed read leaves the input untouched, a dry pass through like before the concealment
+    void concealLive(AudioBuffer<T>& buffer) {
+        if (m_client->LIVE_MODE && !m_offline) {
+            conceal(buffer);
         }
     }
 
@@ -593,24 +717,28 @@ class AudioStreamer : public Thread, public LogTagDelegate {
         m_readCv.notify_one();
     }
 
-    bool waitRead() {
+    bool waitRead(bool offline = false) {
         traceScope();
         if (m_queueSize > 0) {
             m_readQMeter.update(m_readQ.read_available());
-            if (m_client->NUM_OF_BUFFERS > 1 && m_readQ.read_available() < (size_t)(m_client->NUM_OF_BUFFERS / 2) &&
-                m_readQ.read_available() > 0) {
+            // an offline render runs as fast as the server allows, so the queue runs empty all the time
+            if (!offline && m_client->NUM_OF_BUFFERS > 1 &&
+                m_readQ.read_available() < (size_t)(m_client->NUM_OF_BUFFERS / 2) && m_readQ.read_available() > 0) {
                 logln("warning: " << getInstanceString() << ": input buffer below 50% (" << m_readQ.read_available()
                                   << "/" << m_client->NUM_OF_BUFFERS << ")");
             } else if (m_readQ.read_available() == 0) {
-                if (m_client->NUM_OF_BUFFERS > 1) {
+                if (!offline && m_client->NUM_OF_BUFFERS > 1) {
                     logln("warning: " << getInstanceString()
                                       << ": read queue empty, waiting for data, try to increase the buffer");
                 }
                 if (!m_error && !threadShouldExit()) {
-                    int timeout = m_client->LIVE_MODE ? m_readTimeoutMs : 1000;
-                    std::unique_lock<std::mutex> lock(m_readMtx);
-                    return m_readCv.wait_for(lock, std::chrono::milliseconds(timeout),
-                                             [this] { return m_readQ.read_available() > 0 || threadShouldExit(); });
+                    int timeout = offline ? OFFLINE_READ_TIMEOUT_MS : m_client->LIVE_MODE ? m_readTimeoutMs : 1000;
+                    return m_dataWait.wait(m_client->LOW_LATENCY && !offline, timeout, [this](int timeoutMs) {
+                        std::unique_lock<std::mutex> lock(m_readMtx);
+                        return m_readCv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] {
+                            return m_readQ.read_available() > 0 || threadShouldExit();
+                        });
+                    });
                 }
             }
         } else {
@@ -622,21 +750,117 @@ class AudioStreamer : public Thread, public LogTagDelegate {
         return true;
     }
 
+    void notifyInflight() {
+        traceScope();
+        std::lock_guard<std::mutex> lock(m_inflightMtx);
+        m_inflightCv.notify_all();
+    }
+
+    // Waits until all pipelined offline blocks have been read
+    bool waitInflight() {
+        traceScope();
+        std::unique_lock<std::mutex> lock(m_inflightMtx);
+        while (m_inflight > 0) {
+            if (m_error || threadShouldExit()) {
+                return false;
+            }
+            m_inflightCv.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        return true;
+    }
+
+    // Waits until the inflight queue can take another block
+    bool waitInflightSpace() {
+        traceScope();
+        std::unique_lock<std::mutex> lock(m_inflightMtx);
+        while (m_inflightQ.write_available() == 0) {
+            if (m_error || threadShouldExit()) {
+                return false;
+            }
+            m_inflightCv.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        return true;
+    }
+
+    // Waits until the write queue dropped below the high water mark, only used for offline rendering
+    void waitWriteQueue() {
+        traceScope();
+        TimeStatistic::Timeout timeout(OFFLINE_READ_TIMEOUT_MS);
+        while (m_writeQ.read_available() > m_queueHighWaterMark && !m_error && timeout.getMillisecondsLeft() > 0) {
+            notifyWrite();
+            Thread::sleep(1);
+        }
+    }
+
+    void readInflight() {
+        traceScope();
+        while (!m_inflightReader.threadShouldExit() && !threadShouldExit() && !m_error) {
+            {
+                std::unique_lock<std::mutex> lock(m_inflightMtx);
+                m_inflightCv.wait_for(lock, std::chrono::seconds(1), [this] {
+                    return m_inflightQ.read_available() > 0 || m_inflightReader.threadShouldExit() || m_error;
+                });
+            }
+            AudioMidiBuffer buf;
+            while (!m_error && m_inflightQ.pop(buf)) {
+                MessageHelper::Error err;
+                if (!readInternal(buf, &err, OFFLINE_READ_TIMEOUT_MS)) {
+                    logln("error: " << getInstanceString() << ": read failed: " << err.toString());
+                    setError();
+                    return;
+                }
+                dropSamples(buf);
+                if (buf.workingSamples > 0) {
+                    m_readQ.push(std::move(buf));
+                    notifyRead();
+                }
+                m_inflight--;
+                notifyInflight();
+            }
+        }
+    }
+
+    // drop samples in case we had read error(s)
+    void dropSamples(AudioMidiBuffer& buf) {
+        if (m_dropSamples > 0) {
+            int samples = m_dropSamples.exchange(0);
+            if (samples < buf.workingSamples) {
+                buf.consume(samples);
+            } else {
+                m_dropSamples += samples - buf.workingSamples;
+                buf.workingSamples = 0;
+            }
+        }
+    }
+
     bool sendInternal(AudioMidiBuffer& buffer) {
         traceScope();
         AudioMessage msg(m_client);
         return msg.sendToServer(m_socket.get(), buffer.audio, buffer.midi, buffer.posInfo, buffer.channelsRequested,
-                                buffer.samplesRequested, nullptr, *m_bytesOutMeter);
+                                buffer.samplesRequested, nullptr, *m_bytesOutMeter, buffer.offline);
+    }
+
+    // Waits for the response of the server and reads it, errors of the socket are left to the read
+    bool readResponse(AudioMidiBuffer& buffer, MessageHelper::Error* e) {
+        traceScope();
+        bool ready = m_socketWait.wait(m_client->LOW_LATENCY, 1000, [this](int timeoutMs) {
+            return m_socket->waitUntilReady(true, timeoutMs) != 0;
+        });
+        if (!ready) {
+            MessageHelper::seterr(e, MessageHelper::E_TIMEOUT);
+            return false;
+        }
+        return readInternal(buffer, e);
     }
 
-    bool readInternal(AudioMidiBuffer& buffer, MessageHelper::Error* e) {
+    bool readInternal(AudioMidiBuffer& buffer, MessageHelper::Error* e, int timeoutMs = 1000) {
         traceScope();
         AudioMessage msg(m_client);
         if (buffer.audio.getNumChannels() < buffer.channelsRequested ||
             buffer.audio.getNumSamples() < buffer.samplesRequested) {
             buffer.audio.setSize(buffer.channelsRequested, buffer.samplesRequested);
         }
-        bool success = msg.readFromServer(m_socket.get(), buffer.audio, buffer.midi, e, *m_bytesInMeter);
+        bool success = msg.readFromServer(m_socket.get(), buffer.audio, buffer.midi, e, *m_bytesInMeter, timeoutMs);
         if (success) {
             buffer.workingSamples = buffer.audio.getNumSamples();
             m_client->setLatency(msg.getLatencySamples());
@@ -7,6 +7,7 @@
 
 #include "Client.hpp"
 #include <memory>
+#include <tuple>
 #include "PluginProcessor.hpp"
 #include "ServiceReceiver.hpp"
 #include "AudioStreamer.hpp"
@@ -71,11 +72,12 @@ void Client::run() {
         auto srvInfo = getServer();
         auto servers = m_processor->getServersMDNS();
 
-        // Try to auto connect to the first available host discovered via mDNS
+        // Try to auto connect to a host discovered via mDNS
         if (!srvInfo.isValid()) {
-            if (servers.size() > 0) {
-                setServer(servers[0]);
-                srvInfo = servers[0];
+            auto selected = selectServer(servers);
+            if (selected.isValid()) {
+                setServer(selected);
+                srvInfo = selected;
             }
         } else {
             // if a server has multiple IPs we have to make sure that we don't trigger reconnects every time
@@ -111,10 +113,30 @@ void Client::run() {
             }
         }
 
+        // Sample rate/block size changes without reconnecting
+        if (m_needsReconfigure && !threadShouldExit()) {
+            if (!reconfigure()) {
+                logln("reconfigure failed, triggering reconnect");
+                LockByID lock(*this, RECONFIGURE);
+                m_needsReconnect = true;
+            }
+        }
+
+        // Move the chain to another server
+        if (m_needsMigrate && !threadShouldExit()) {
+            if (!runMigration()) {
+                logln("migration failed, the chain stays on " << srvInfo.getNameAndID());
+            }
+            srvInfo = getServer();
+        }
+
+        releaseRetiredStreamers();
+
         // Health check & reconnect
         if ((!isReady(LOAD_PLUGIN_TIMEOUT + 5000) || m_needsReconnect) && srvInfo.isValid() && !threadShouldExit()) {
             logln("(re)connecting...");
-            close();
+            // a connection loss can be recovered by resuming the session, config changes need a new one
+            close(m_needsReconnect);
             init();
             bool newState = m_ready;
             if (newState) {
@@ -164,6 +186,9 @@ void Client::run() {
                         case PluginStatus::Type:
                             handleMessage(Message<Any>::convert<PluginStatus>(msg));
                             break;
+                        case PluginLoaded::Type:
+                            handleMessage(Message<Any>::convert<PluginLoaded>(msg));
+                            break;
                         case HidePlugin::Type:
                             handleMessage(Message<Any>::convert<HidePlugin>(msg));
                             break;
@@ -250,6 +275,30 @@ void Client::handleMessage(std::shared_ptr<Message<PluginStatus>> msg) {
     }
 }
 
+void Client::handleMessage(std::shared_ptr<Message<PluginLoaded>> msg) {
+    traceScope();
+    auto jresult = pPLD(msg).getJson();
+    try {
+        int idx = jresult["idx"].get<int>();
+        bool success = jresult["success"].get<bool>();
+        String err = jresult["err"].get<std::string>();
+        logln("plugin " << idx << " loaded: " << (success ? "ok" : "failed: " + err));
+        StringArray presets;
+        ParameterByChannelList params;
+        bool hasEditor = false, scDisabled = false;
+        if (success) {
+            presets = StringArray::fromTokens(String(jresult["presets"].get<std::string>()), "|", "");
+            readParameters(jresult["parameters"], jresult["channelInstances"].get<int>(), params);
+            m_latency = jresult["latency"].get<int>();
+            hasEditor = jresult["hasEditor"].get<bool>();
+            scDisabled = jresult["disabledSideChain"].get<bool>();
+        }
+        m_processor->updatePluginLoaded(idx, success, err, presets, params, hasEditor, scDisabled);
+    } catch (const json::exception& e) {
+        logln("failed to handle loaded plugin: " << e.what());
+    }
+}
+
 void Client::handleMessage(std::shared_ptr<Message<HidePlugin>> msg) {
     m_processor->hidePluginFromServer(pPLD(msg).getNumber());
 }
@@ -282,6 +331,74 @@ void Client::setServer(const ServerInfo& srv) {
     }
 }
 
+ServerInfo Client::selectServer(const Array<ServerInfo>& servers) {
+    traceScope();
+
+    auto mode = m_processor->getServerSelection();
+    if (mode == PluginProcessor::SS_MANUAL || servers.size() < 2) {
+        return servers.isEmpty() ? ServerInfo() : servers[0];
+    }
+
+    // a server with a newer protocol would reject us, a low memory server is likely to fail loading plugins
+    Array<ServerInfo> candidates;
+    for (auto& s : servers) {
+        if (s.getProtocolVersion() <= AG_PROTOCOL_VERSION &&
+            (s.getFreeMemoryMB() < 0 || s.getFreeMemoryMB() >= MIN_FREE_MEMORY_MB)) {
+            candidates.add(s);
+        }
+    }
+    if (candidates.isEmpty()) {
+        logln("no server passed the selection criteria, falling back to the first server");
+        return servers[0];
+    }
+
+    if (mode == PluginProcessor::SS_LOWEST_RTT) {
+        // the rtt is taken from the reachable checks of the mDNS receiver, probing the servers here would show up as
+        // failed handshakes on the servers
+        ServerInfo best;
+        for (auto& s : candidates) {
+            if (s.getRttMs() < 0.0) {
+                continue;
+            }
+            logln("  " << s.getNameAndID() << ": rtt=" << String(s.getRttMs(), 2) << "ms");
+            if (!best.isValid() || s.getRttMs() < best.getRttMs()) {
+                best = s;
+            }
+        }
+        if (best.isValid()) {
+            logln("selected server " << best.getNameAndID() << " with the lowest rtt");
+            return best;
+        }
+        return candidates[0];
+    }
+
+    struct SortSrvByLoad {
+        static int compareElements(const ServerInfo& lhs, const ServerInfo& rhs) {
+            return compareServerLoad(lhs, rhs);
+        }
+    };
+
+    SortSrvByLoad comp;
+    candidates.sort(comp, true);
+
+    for (auto& s : candidates) {
+        logln("  " << s.toString());
+    }
+    logln("selected least loaded server " << candidates[0].getNameAndID());
+    return candidates[0];
+}
+
+int Client::compareServerLoad(const ServerInfo& lhs, const ServerInfo& rhs) {
+    // comparing the loads by a threshold is not transitive (1 ~ 4 ~ 8, but 1 < 8), which breaks sorting, so compare
+    // buckets instead
+    auto key = [](const ServerInfo& s) {
+        return std::make_tuple(s.getDeadlineMisses() > 0, (int)(jmax(0.0f, s.getLoad()) / LOAD_BUCKET), s.getClients(),
+                               s.getLoad());
+    };
+    auto l = key(lhs), r = key(rhs);
+    return l < r ? -1 : r < l ? 1 : 0;
+}
+
 ServerInfo Client::getServer() {
     std::lock_guard<std::mutex> lock(m_srvMtx);
     return m_srvInfo;
@@ -312,8 +429,18 @@ void Client::init(int channelsIn, int channelsOut, int channelsSC, double rate,
                               << " rate=" << rate << " samplesPerBlock=" << samplesPerBlock
                               << " doublePrecision=" << (int)doublePrecission);
     LockByID lock(*this, INIT1);
-    if (!m_ready || m_channelsIn != channelsIn || m_channelsOut != channelsOut || m_channelsSC != channelsSC ||
-        m_sampleRate != rate || m_samplesPerBlock != samplesPerBlock || m_doublePrecission != doublePrecission) {
+    if (m_ready && m_srvReconfigure && !m_needsReconnect && m_channelsIn == channelsIn &&
+        m_channelsOut == channelsOut && m_channelsSC == channelsSC && m_doublePrecission == doublePrecission &&
+        (m_sampleRate != rate || m_samplesPerBlock != samplesPerBlock)) {
+        // the plugins stay loaded on the server, only the audio connection has to be restarted
+        m_sampleRate = rate;
+        m_samplesPerBlock = samplesPerBlock;
+        m_needsReconfigure = true;
+        m_ready = false;
+        logln("init: sample rate/block size change, requesting reconfigure");
+    } else if (!m_ready || m_channelsIn != channelsIn || m_channelsOut != channelsOut ||
+               m_channelsSC != channelsSC || m_sampleRate != rate || m_samplesPerBlock != samplesPerBlock ||
+               m_doublePrecission != doublePrecission) {
         m_channelsIn = channelsIn;
         m_channelsOut = channelsOut;
         m_channelsSC = channelsSC;
@@ -321,6 +448,7 @@ void Client::init(int channelsIn, int channelsOut, int channelsSC, double rate,
         m_samplesPerBlock = samplesPerBlock;
         m_doublePrecission = doublePrecission;
         m_needsReconnect = true;
+        m_needsReconfigure = false;
         m_ready = false;
         logln("init: paramater change, requesting reconnect");
     }
@@ -329,8 +457,6 @@ void Client::init(int channelsIn, int channelsOut, int channelsSC, double rate,
 void Client::init() {
     traceScope();
     auto srvInfo = getServer();
-    bool useUnixDomain = srvInfo.getLocalMode() && Defaults::unixDomainSocketsSupported();
-    int port = Defaults::SERVER_PORT + srvInfo.getID();
 
     LockByID lock(*this, INIT2);
 
@@ -341,129 +467,419 @@ void Client::init() {
 #endif
 
     m_error = true;
-    m_cmdOut = std::make_unique<StreamingSocket>();
+
+    uint64 sessionToken = m_sessionToken;
+    ServerConnection conn;
+    if (!connectServer(srvInfo, sessionToken, conn)) {
+        return;
+    }
+
+    setServerFlags(conn.resp);
+    m_sessionResumed = sessionToken != 0 && conn.resp.isFlag(HandshakeResponse::SESSION_RESUMED);
+    m_sessionToken = conn.resp.getSessionToken();
+    if (sessionToken != 0) {
+        logln("session " << (m_sessionResumed ? "resumed" : "could not be resumed"));
+    }
+
+    m_cmdOut = std::move(conn.cmdOut);
+    m_cmdIn = std::move(conn.cmdIn);
+    m_screenSocket = std::move(conn.screenSocket);
+
+    if (nullptr != conn.audioSocket) {
+        startAudioStreamer(conn.audioSocket.release());
+    } else {
+        return;
+    }
+
+    if (nullptr != m_screenSocket) {
+        m_screenWorker = std::make_unique<ScreenReceiver>(this, m_screenSocket.get());
+        m_screenWorker->startThread();
+    } else {
+        return;
+    }
+
+    // receive plugin list
+    updatePluginList();
+
+    m_ready = true;
+    m_error = false;
+    m_needsReconnect = false;
+    m_needsReconfigure = false;
+}
+
+bool Client::connectServer(const ServerInfo& srvInfo, uint64 sessionToken, ServerConnection& conn) {
+    traceScope();
+    bool useUnixDomain = srvInfo.getLocalMode() && Defaults::unixDomainSocketsSupported();
+    int port = Defaults::SERVER_PORT + srvInfo.getID();
+
+    conn.cmdOut = std::make_unique<StreamingSocket>();
 
     if (useUnixDomain) {
         auto socketPath = Defaults::getSocketPath(Defaults::SERVER_SOCK, {{"id", String(srvInfo.getID())}});
         logln("connecting server: " << socketPath.getFullPathName());
-        if (!m_cmdOut->connect(socketPath, 1000)) {
+        if (!conn.cmdOut->connect(socketPath, 1000)) {
             logln("local connection to server failed");
             useUnixDomain = false;
         }
     }
 
-    if (!m_cmdOut->isConnected()) {
+    if (!conn.cmdOut->isConnected()) {
         logln("connecting server: " << srvInfo.getHostAndID());
-        m_cmdOut->connect(srvInfo.getHost(), port, 1000);
-    }
-
-    if (m_cmdOut->isConnected()) {
-        HandshakeRequest cfg = {AG_PROTOCOL_VERSION,
-                                m_channelsIn,
-                                m_channelsOut,
-                                m_channelsSC,
-                                m_sampleRate,
-                                m_samplesPerBlock,
-                                m_doublePrecission,
-                                getTagId(),
-                                0,
-                                0,
-                                m_processor->getActiveChannels().toInt(),
-                                0};
-        if (m_processor->getNoSrvPluginListFilter()) {
-            cfg.setFlag(HandshakeRequest::NO_PLUGINLIST_FILTER);
-        }
-
-        if (!send(m_cmdOut.get(), reinterpret_cast<const char*>(&cfg), sizeof(cfg))) {
-            m_cmdOut->close();
-            return;
-        }
+        conn.cmdOut->connect(srvInfo.getHost(), port, 1000);
+    }
 
-        HandshakeResponse resp;
-        MessageHelper::Error err;
-        if (!read(m_cmdOut.get(), &resp, sizeof(resp), LOAD_PLUGIN_TIMEOUT, &err)) {
-            logln("handshake error: " << err.toString());
-            m_cmdOut->close();
-            return;
-        }
-        m_cmdOut->close();
+    if (!conn.cmdOut->isConnected()) {
+        logln("connection to server failed");
+        return false;
+    }
+
+    HandshakeRequest cfg = {AG_PROTOCOL_VERSION,
+                            m_channelsIn,
+                            m_channelsOut,
+                            m_channelsSC,
+                            m_sampleRate,
+                            m_samplesPerBlock,
+                            m_doublePrecission,
+                            getTagId(),
+                            0,
+                            0,
+                            m_processor->getActiveChannels().toInt(),
+                            0};
+    if (m_processor->getNoSrvPluginListFilter()) {
+        cfg.setFlag(HandshakeRequest::NO_PLUGINLIST_FILTER);
+    }
+    cfg.setFlag(HandshakeRequest::OFFLINE_RENDER);
+    if (sessionToken != 0) {
+        cfg.setFlag(HandshakeRequest::RESUME_SESSION);
+    }
+
+    if (!send(conn.cmdOut.get(), reinterpret_cast<const char*>(&cfg), sizeof(cfg))) {
+        conn.cmdOut->close();
+        return false;
+    }
+    if (sessionToken != 0 &&
+        !send(conn.cmdOut.get(), reinterpret_cast<const char*>(&sessionToken), sizeof(sessionToken))) {
+        conn.cmdOut->close();
+        return false;
+    }
+
+    MessageHelper::Error err;
+    if (!read(conn.cmdOut.get(), &conn.resp, sizeof(conn.resp), LOAD_PLUGIN_TIMEOUT, &err)) {
+        logln("handshake error: " << err.toString());
+        conn.cmdOut->close();
+        return false;
+    }
+    conn.cmdOut->close();
+
+    File workerSocketPath;
 
-        m_srvLocalMode = resp.isFlag(HandshakeResponse::LOCAL_MODE);
-        logln("server local mode is " << (int)m_srvLocalMode);
+    if (useUnixDomain) {
+        workerSocketPath = Defaults::getSocketPath(Defaults::WORKER_SOCK,
+                                                   {{"id", String(srvInfo.getID())}, {"n", String(conn.resp.port)}});
+        logln("connecting worker: " << workerSocketPath.getFullPathName());
+        conn.cmdOut->connect(workerSocketPath);
+    } else {
+        logln("connecting worker: " << srvInfo.getHost() << ":" << conn.resp.port);
+        conn.cmdOut->connect(srvInfo.getHost(), conn.resp.port);
+    }
 
-        File workerSocketPath;
+    if (!conn.cmdOut->isConnected()) {
+        logln("connection to server failed");
+        conn.cmdOut.reset();
+        return false;
+    }
 
-        if (useUnixDomain) {
-            workerSocketPath = Defaults::getSocketPath(Defaults::WORKER_SOCK,
-                                                       {{"id", String(srvInfo.getID())}, {"n", String(resp.port)}});
-            logln("connecting worker: " << workerSocketPath.getFullPathName());
-            m_cmdOut->connect(workerSocketPath);
+    auto connectWorker = [&](std::unique_ptr<StreamingSocket>& sock, const String& name) {
+        sock = std::make_unique<StreamingSocket>();
+        if (useUnixDomain ? !sock->connect(workerSocketPath) : !sock->connect(srvInfo.getHost(), conn.resp.port)) {
+            logln("failed to setup " << name << " connection");
+            sock.reset();
         } else {
-            logln("connecting worker: " << srvInfo.getHost() << ":" << resp.port);
-            m_cmdOut->connect(srvInfo.getHost(), resp.port);
+            logln(name << " connection established");
         }
+    };
 
-        if (!m_cmdOut->isConnected()) {
-            logln("connection to server failed");
-            m_cmdOut.reset();
-            return;
-        }
+    connectWorker(conn.cmdIn, "command receive");
+    connectWorker(conn.audioSocket, "audio");
+    connectWorker(conn.screenSocket, "screen");
+
+    return true;
+}
+
+void Client::setServerFlags(HandshakeResponse& resp) {
+    m_srvLocalMode = resp.isFlag(HandshakeResponse::LOCAL_MODE);
+    logln("server local mode is " << (int)m_srvLocalMode);
+    m_srvAsyncAddPlugin = resp.isFlag(HandshakeResponse::ASYNC_ADD_PLUGIN);
+    m_srvIncrementalSettings = resp.isFlag(HandshakeResponse::INCREMENTAL_SETTINGS);
+    m_srvChunkedSettings = resp.isFlag(HandshakeResponse::CHUNKED_SETTINGS);
+    m_srvBatchRestore = resp.isFlag(HandshakeResponse::BATCH_RESTORE);
+    m_srvOfflineRender = resp.isFlag(HandshakeResponse::OFFLINE_RENDER);
+    m_srvReconfigure = resp.isFlag(HandshakeResponse::RECONFIGURE);
+    m_srvAuxBuses = resp.isFlag(HandshakeResponse::AUX_BUSES);
+    m_srvSandboxEnabled = resp.isFlag(HandshakeResponse::SANDBOX_ENABLED);
+    if (m_srvSandboxEnabled) {
+        logln("aux buses are not available, the server runs the chains in sandboxes");
+    }
+}
+
+void Client::startAudioStreamer(StreamingSocket* audioSock, bool migrationTarget) {
+    traceScope();
+    RealtimeOptions opts;
+    opts.workDurationMs = (uint32)round(m_samplesPerBlock / m_sampleRate * 1000) - 1;
+    std::lock_guard<std::mutex> audiolck(m_audioMtx);
+    if (m_doublePrecission) {
+        auto& streamer = migrationTarget ? m_migrationStreamerD : m_audioStreamerD;
+        streamer = std::make_shared<AudioStreamer<double>>(this, audioSock);
+        streamer->startRealtimeThread(opts);
+    } else {
+        auto& streamer = migrationTarget ? m_migrationStreamerF : m_audioStreamerF;
+        streamer = std::make_shared<AudioStreamer<float>>(this, audioSock);
+        streamer->startRealtimeThread(opts);
+    }
+}
+
+bool Client::reconfigure() {
+    traceScope();
+    LockByID lock(*this, RECONFIGURE);
 
-        m_cmdIn = std::make_unique<StreamingSocket>();
-        if (useUnixDomain ? !m_cmdIn->connect(workerSocketPath) : !m_cmdIn->connect(srvInfo.getHost(), resp.port)) {
-            logln("failed to setup command receive connection");
-            m_cmdIn.reset();
+    if (!m_needsReconfigure) {
+        return true;
+    }
+    m_needsReconfigure = false;
+
+    if (m_error || nullptr == m_cmdOut || !m_cmdOut->isConnected()) {
+        return false;
+    }
+
+    logln("reconfiguring: rate=" << m_sampleRate << " samplesPerBlock=" << m_samplesPerBlock);
+
+    // stop streaming, the pending blocks still get processed with the old settings
+    std::shared_ptr<AudioStreamer<float>> streamerF;
+    std::shared_ptr<AudioStreamer<double>> streamerD;
+    {
+        std::lock_guard<std::mutex> audiolck(m_audioMtx);
+        streamerF = std::move(m_audioStreamerF);
+        streamerD = std::move(m_audioStreamerD);
+    }
+    StreamingSocket* audioSock = nullptr;
+    if (nullptr != streamerF) {
+        audioSock = streamerF->releaseSocket();
+    } else if (nullptr != streamerD) {
+        audioSock = streamerD->releaseSocket();
+    }
+    streamerF.reset();
+    streamerD.reset();
+    if (nullptr == audioSock) {
+        logln("failed to release the audio connection");
+        return false;
+    }
+
+    Message<Reconfigure> msg(this);
+    PLD(msg).setJson({{"sampleRate", m_sampleRate}, {"samplesPerBlock", m_samplesPerBlock}});
+    if (!msg.send(m_cmdOut.get())) {
+        delete audioSock;
+        return false;
+    }
+    // preparing the plugins can take a while
+    auto result = m_msgFactory.getResult(m_cmdOut.get(), LOAD_PLUGIN_TIMEOUT / 1000 + 1);
+    if (nullptr == result || result->getReturnCode() < 0) {
+        logln("server failed to reconfigure the chain");
+        delete audioSock;
+        return false;
+    }
+    m_latency = result->getReturnCode();
+
+    startAudioStreamer(audioSock);
+    m_ready = true;
+
+    logln("reconfigure done, latency=" << m_latency);
+    return true;
+}
+
+void Client::migrate(const ServerInfo& target) {
+    traceScope();
+    logln("migration to " << target.getNameAndID() << " requested");
+    std::lock_guard<std::mutex> lock(m_srvMtx);
+    m_migrationTarget = target;
+    m_needsMigrate = true;
+}
+
+bool Client::runMigration() {
+    traceScope();
+    m_needsMigrate = false;
+
+    ServerInfo target;
+    {
+        std::lock_guard<std::mutex> lock(m_srvMtx);
+        target = m_migrationTarget;
+    }
+
+    if (!isReadyLockFree() || isOfflineRender() || getServer().getHostAndID() == target.getHostAndID()) {
+        logln("migration to " << target.getNameAndID() << " not possible right now");
+        return false;
+    }
+
+    logln("migrating chain to " << target.getNameAndID() << "...");
+
+    // the chain as it currently sounds, the settings are fetched from the current server
+    auto plugins = m_processor->getChainForMigration();
+
+    ServerConnection conn;
+    auto fail = [this, &conn](const String& reason) {
+        logln("migration: " << reason);
+        stopMigrationStreamer();
+        if (nullptr != conn.cmdOut && conn.cmdOut->isConnected()) {
+            Message<Quit> msg(this);
+            msg.send(conn.cmdOut.get());
         }
-        logln("command connection established");
+        return false;
+    };
+
+    if (!connectServer(target, 0, conn) || nullptr == conn.cmdIn || nullptr == conn.audioSocket ||
+        nullptr == conn.screenSocket) {
+        return fail("connection to the target failed");
+    }
+    if (!conn.resp.isFlag(HandshakeResponse::BATCH_RESTORE)) {
+        return fail("the target server does not support restoring a chain");
+    }
 
-        StreamingSocket* audioSock = nullptr;
-        audioSock = new StreamingSocket;
-        if (useUnixDomain ? !audioSock->connect(workerSocketPath) : !audioSock->connect(srvInfo.getHost(), resp.port)) {
-            logln("failed to setup audio connection");
-            delete audioSock;
-            audioSock = nullptr;
+    std::vector<ServerPlugin> pluginList;
+    if (!readPluginList(conn.cmdOut.get(), pluginList)) {
+        return fail("failed to read the plugin list of the target");
+    }
+
+    int latency = 0;
+    String err;
+    if (!restorePlugins(conn.cmdOut.get(), conn.resp.isFlag(HandshakeResponse::CHUNKED_SETTINGS), plugins, latency,
+                        err)) {
+        return fail("failed to load the chain on the target: " + err);
+    }
+    for (size_t i = 0; i < plugins.size(); i++) {
+        auto& p = plugins[i];
+        if (!p.ok) {
+            return fail("failed to load " + p.id + " on the target: " + p.err);
         }
+        if (p.bypassed) {
+            Message<BypassPlugin> msg(this);
+            PLD(msg).setNumber((int)i);
+            msg.send(conn.cmdOut.get());
+        }
+    }
 
-        m_screenSocket = std::make_unique<StreamingSocket>();
-        if (useUnixDomain ? !m_screenSocket->connect(workerSocketPath)
-                          : !m_screenSocket->connect(srvInfo.getHost(), resp.port)) {
-            logln("failed to setup screen connection");
-            m_screenSocket.reset();
+    // the target chain processes the same input as the current chain, but stays silent
+    startAudioStreamer(conn.audioSocket.release(), true);
+    m_migrationState = MIGRATE_PREROLL;
+
+    int blockMs = (int)(m_samplesPerBlock / m_sampleRate * 1000) + 1;
+    int prerollMs = jmax(MIGRATION_PREROLL_MS, NUM_OF_BUFFERS * blockMs * 2);
+    sleepExitAware(prerollMs);
+
+    {
+        std::lock_guard<std::mutex> audiolck(m_audioMtx);
+        bool targetOk = m_doublePrecission ? nullptr != m_migrationStreamerD && m_migrationStreamerD->isOk()
+                                           : nullptr != m_migrationStreamerF && m_migrationStreamerF->isOk();
+        if (!targetOk || threadShouldExit()) {
+            return fail("the audio connection to the target failed");
         }
+    }
+
+    // the audio thread fades over at the next block boundary
+    m_migrationState = MIGRATE_SWITCH;
+    auto switched = [this] { return m_migrationState == MIGRATE_DONE; };
+    sleepExitAwareWithCondition(MIGRATION_SWITCH_TIMEOUT_MS, switched);
+    if (!switched()) {
+        // the host is not processing audio, so there is nothing to fade
+        logln("migration: no audio processed, switching without crossfade");
+        m_migrationState = MIGRATE_DONE;
+    }
+
+    std::shared_ptr<AudioStreamer<float>> oldStreamerF;
+    std::shared_ptr<AudioStreamer<double>> oldStreamerD;
+    {
+        LockByID lock(*this, MIGRATE);
 
-        if (nullptr != audioSock) {
-            logln("audio connection established");
-            RealtimeOptions opts;
-            opts.workDurationMs = (uint32)round(m_samplesPerBlock / m_sampleRate * 1000) - 1;
+        {
             std::lock_guard<std::mutex> audiolck(m_audioMtx);
-            if (m_doublePrecission) {
-                m_audioStreamerD = std::make_shared<AudioStreamer<double>>(this, audioSock);
-                m_audioStreamerD->startRealtimeThread(opts);
-            } else {
-                m_audioStreamerF = std::make_shared<AudioStreamer<float>>(this, audioSock);
-                m_audioStreamerF->startRealtimeThread(opts);
-            }
-        } else {
-            return;
+            oldStreamerF = std::move(m_audioStreamerF);
+            oldStreamerD = std::move(m_audioStreamerD);
+            m_audioStreamerF = std::move(m_migrationStreamerF);
+            m_audioStreamerD = std::move(m_migrationStreamerD);
         }
+        m_migrationState = MIGRATE_NONE;
 
-        if (nullptr != m_screenSocket) {
-            logln("screen connection established");
-            m_screenWorker = std::make_unique<ScreenReceiver>(this, m_screenSocket.get());
-            m_screenWorker->startThread();
-        } else {
-            return;
+        // retire the old chain
+        quit();
+        if (nullptr != m_screenSocket && m_screenSocket->isConnected()) {
+            m_screenSocket->close();
         }
+        m_screenWorker.reset();
+        m_cmdOut->close();
 
-        // receive plugin list
-        updatePluginList();
+        m_cmdOut = std::move(conn.cmdOut);
+        m_cmdIn = std::move(conn.cmdIn);
+        m_screenSocket = std::move(conn.screenSocket);
+        m_screenWorker = std::make_unique<ScreenReceiver>(this, m_screenSocket.get());
+        m_screenWorker->startThread();
+        m_plugins = std::move(pluginList);
 
-        m_ready = true;
-        m_error = false;
-        m_needsReconnect = false;
-    } else {
-        logln("connection to server failed");
+        setServerFlags(conn.resp);
+        m_sessionToken = conn.resp.getSessionToken();
+        m_sessionResumed = false;
+        m_latency = latency;
+
+        std::lock_guard<std::mutex> srvlck(m_srvMtx);
+        m_srvInfo = target;
     }
+
+    // the audio thread might still hold the old streamers for the current block
+    retireStreamer(std::move(oldStreamerF));
+    retireStreamer(std::move(oldStreamerD));
+
+    m_processor->migrationDone(plugins);
+
+    logln("migration to " << target.getNameAndID() << " done, latency=" << m_latency);
+    return true;
+}
+
+void Client::stopMigrationStreamer() {
+    traceScope();
+    m_migrationState = MIGRATE_NONE;
+    std::shared_ptr<AudioStreamer<float>> streamerF;
+    std::shared_ptr<AudioStreamer<double>> streamerD;
+    {
+        std::lock_guard<std::mutex> audiolck(m_audioMtx);
+        streamerF = std::move(m_migrationStreamerF);
+        streamerD = std::move(m_migrationStreamerD);
+    }
+    // make sure the streamer does not get destroyed by the audio thread
+    retireStreamer(std::move(streamerF));
+    retireStreamer(std::move(streamerD));
+}
+
+void Client::retireStreamer(std::shared_ptr<void> streamer) {
+    if (nullptr != streamer) {
+        std::lock_guard<std::mutex> lock(m_retiredStreamersMtx);
+        m_retiredStreamers.push_back(std::move(streamer));
+    }
+}
+
+void Client::releaseRetiredStreamers() {
+    traceScope();
+    std::vector<std::shared_ptr<void>> released;
+    {
+        std::lock_guard<std::mutex> lock(m_retiredStreamersMtx);
+        // a retired streamer can't be picked up again, so once the list is the last owner it stays the last owner
+        for (auto it = m_retiredStreamers.begin(); it != m_retiredStreamers.end();) {
+            if (it->use_count() == 1) {
+                released.push_back(std::move(*it));
+                it = m_retiredStreamers.erase(it);
+            } else {
+                it++;
+            }
+        }
+    }
+    // destroy outside of the lock, as stopping a streamer can take a moment
+    released.clear();
 }
 
 bool Client::isReady(int timeout) {
@@ -491,7 +907,7 @@ bool Client::isReady(int timeout) {
 
 bool Client::isReadyLockFree() { return !m_error && m_ready; }
 
-void Client::close() {
+void Client::close(bool endSession) {
     traceScope();
     if (m_ready) {
         logln("closing");
@@ -501,6 +917,13 @@ void Client::close() {
     }
     m_ready = false;
     LockByID lock(*this, CLOSE);
+    if (endSession && m_sessionToken != 0) {
+        // let the server free the chain right away
+        if (nullptr != m_cmdOut && m_cmdOut->isConnected()) {
+            quit();
+        }
+        m_sessionToken = 0;
+    }
     m_plugins.clear();
     if (nullptr != m_screenSocket && m_screenSocket->isConnected()) {
         m_screenSocket->close();
@@ -528,6 +951,9 @@ void Client::close() {
         m_audioStreamerF->waitForThreadToExit(100);
         m_audioStreamerF.reset();
     }
+    m_migrationStreamerF.reset();
+    m_migrationStreamerD.reset();
+    m_migrationState = MIGRATE_NONE;
     m_audioMtx.unlock();
 }
 
@@ -555,10 +981,11 @@ void Client::quit() {
 
 bool Client::addPlugin(String id, StringArray& presets, ParameterByChannelList& params, bool& hasEditor,
                        bool& scDisabled, const String& settings, const String& layout, uint64 monoChannels,
-                       String& err) {
+                       const String& host, String& err) {
     traceScope();
 
     if (!isReadyLockFree()) {
+        dropSession();
         err = "client not ready";
         return false;
     };
@@ -566,16 +993,27 @@ bool Client::addPlugin(String id, StringArray& presets, ParameterByChannelList&
     err.clear();
     MessageHelper::Error e;
     Message<AddPlugin> msg(this);
-    PLD(msg).setJson({{"id", id.toStdString()},
-                      {"settings", settings.toStdString()},
-                      {"layout", layout.toStdString()},
-                      {"monoChannels", monoChannels}});
+    json jmsg = {{"id", id.toStdString()}, {"layout", layout.toStdString()}, {"monoChannels", monoChannels}};
+    if (host.isNotEmpty()) {
+        jmsg["host"] = host.toStdString();
+    }
+
+    // large settings are sent compressed and chunked after the request
+    MemoryBlock settingsBlock;
+    if (m_srvChunkedSettings && settings.length() > PluginSettingsChunk::CHUNK_SIZE) {
+        settingsBlock = PluginSettingsChunk::compress(settings);
+        jmsg["settings"] = "";
+        jmsg["settingsChunks"] = PluginSettingsChunk::getNumChunks(settingsBlock);
+    } else {
+        jmsg["settings"] = settings.toStdString();
+    }
+    PLD(msg).setJson(jmsg);
 
     LockByID lock(*this, ADDPLUGIN);
 
     TimeStatistic::Timeout timeout(LOAD_PLUGIN_TIMEOUT);
 
-    if (msg.send(m_cmdOut.get())) {
+    if (msg.send(m_cmdOut.get()) && sendSettingsChunks(m_cmdOut.get(), -1, settingsBlock)) {
         Message<AddPluginResult> msgResult(this);
         if (!msgResult.read(m_cmdOut.get(), &e, timeout.getMillisecondsLeft())) {
             err = "seems like the plugin crashed the server or did not load (" + e.toString() + ")";
@@ -617,31 +1055,182 @@ bool Client::addPlugin(String id, StringArray& presets, ParameterByChannelList&
             logln(err);
             return false;
         }
-        auto jparams = msgParams.payload.getJson();
-        ParameterByChannelList paramsBak(std::move(params));
-        params.resize((size_t)pluginChannels);
-        for (auto& jparam : jparams) {
-            auto newParam = Parameter::fromJson(jparam);
+        readParameters(msgParams.payload.getJson(), pluginChannels, params);
 
-            for (size_t ch = 0; ch < (size_t)pluginChannels; ch++) {
-                params[ch].push_back(newParam);
-                auto& newAddedParam = params[ch].back();
+        m_latency = jresult["latency"].get<int>();
+        hasEditor = jresult["hasEditor"].get<bool>();
+        scDisabled = jresult["disabledSideChain"].get<bool>();
 
-                if (paramsBak.size() == (size_t)pluginChannels) {
-                    for (auto& oldParam : paramsBak[ch]) {
-                        if (newAddedParam.idx == oldParam.idx) {
-                            newAddedParam.automationSlot = oldParam.automationSlot;
-                            break;
-                        }
+        return true;
+    }
+
+    return false;
+}
+
+bool Client::restorePlugins(std::vector<RestorePlugin>& plugins, String& err) {
+    traceScope();
+
+    if (!isReadyLockFree()) {
+        dropSession();
+        err = "client not ready";
+        return false;
+    };
+
+    LockByID lock(*this, ADDPLUGIN);
+    int latency = 0;
+    if (!restorePlugins(m_cmdOut.get(), m_srvChunkedSettings, plugins, latency, err)) {
+        return false;
+    }
+    m_latency = latency;
+    return true;
+}
+
+bool Client::restorePlugins(StreamingSocket* sock, bool chunkedSettings, std::vector<RestorePlugin>& plugins,
+                            int& latency, String& err) {
+    traceScope();
+
+    err.clear();
+    MessageHelper::Error e;
+    Message<RestorePlugins> msg(this);
+
+    auto jplugs = json::array();
+    std::vector<MemoryBlock> settingsBlocks(plugins.size());
+    for (size_t i = 0; i < plugins.size(); i++) {
+        auto& p = plugins[i];
+        json jplug = {{"id", p.id.toStdString()}, {"layout", p.layout.toStdString()}, {"monoChannels", p.monoChannels}};
+        if (p.host.isNotEmpty()) {
+            jplug["host"] = p.host.toStdString();
+        }
+        if (chunkedSettings && p.settings.length() > PluginSettingsChunk::CHUNK_SIZE) {
+            settingsBlocks[i] = PluginSettingsChunk::compress(p.settings);
+            jplug["settings"] = "";
+            jplug["settingsChunks"] = PluginSettingsChunk::getNumChunks(settingsBlocks[i]);
+        } else {
+            jplug["settings"] = p.settings.toStdString();
+        }
+        jplugs.push_back(jplug);
+    }
+    PLD(msg).setJson({{"plugins", jplugs}});
+
+    if (!msg.send(sock)) {
+        err = "failed to send request";
+        return false;
+    }
+    for (auto& block : settingsBlocks) {
+        if (!sendSettingsChunks(sock, -1, block)) {
+            err = "failed to send settings";
+            return false;
+        }
+    }
+
+    // progress messages arrive for each loaded plugin, so the timeout applies to each plugin, not the whole chain
+    while (true) {
+        auto res = std::make_shared<Message<Any>>(this);
+        if (!res->read(sock, &e, LOAD_PLUGIN_TIMEOUT)) {
+            err = "seems like a plugin crashed the server or did not load (" + e.toString() + ")";
+            logln("error: " << err);
+            return false;
+        }
+        if (res->getType() == RestorePluginsProgress::Type) {
+            auto jprogress = pPLD(Message<Any>::convert<RestorePluginsProgress>(res)).getJson();
+            logln("restored " << jsonGetValue(jprogress, "done", 0) << "/" << jsonGetValue(jprogress, "total", 0)
+                              << ": " << jsonGetValue(jprogress, "name", String())
+                              << (jsonGetValue(jprogress, "success", false)
+                                      ? String(" ok")
+                                      : " failed: " + jsonGetValue(jprogress, "err", String())));
+        } else if (res->getType() == RestorePluginsResult::Type) {
+            auto jresult = pPLD(Message<Any>::convert<RestorePluginsResult>(res)).getJson();
+            try {
+                auto& jresplugs = jresult["plugins"];
+                if (jresplugs.size() != plugins.size()) {
+                    err = "invalid number of plugins in the result";
+                    logln("error: " << err);
+                    return false;
+                }
+                for (size_t i = 0; i < plugins.size(); i++) {
+                    auto& p = plugins[i];
+                    auto& jplug = jresplugs[i];
+                    p.ok = jplug["success"].get<bool>();
+                    p.err = jplug["err"].get<std::string>();
+                    if (p.ok) {
+                        p.presets = StringArray::fromTokens(String(jplug["presets"].get<std::string>()), "|", "");
+                        readParameters(jplug["parameters"], jplug["channelInstances"].get<int>(), p.params);
+                        p.hasEditor = jplug["hasEditor"].get<bool>();
+                        p.scDisabled = jplug["disabledSideChain"].get<bool>();
+                    }
+                }
+                latency = jresult["latency"].get<int>();
+            } catch (const json::exception& ex) {
+                err = "failed to read result: " + String(ex.what());
+                logln("error: " << err);
+                return false;
+            }
+            return true;
+        } else {
+            err = "unexpected message type " + String(res->getType());
+            logln("error: " << err);
+            return false;
+        }
+    }
+}
+
+void Client::readParameters(const json& jparams, int pluginChannels, ParameterByChannelList& params) {
+    ParameterByChannelList paramsBak(std::move(params));
+    params.clear();
+    params.resize((size_t)pluginChannels);
+    for (auto& jparam : jparams) {
+        auto newParam = Parameter::fromJson(jparam);
+
+        for (size_t ch = 0; ch < (size_t)pluginChannels; ch++) {
+            params[ch].push_back(newParam);
+            auto& newAddedParam = params[ch].back();
+
+            if (paramsBak.size() == (size_t)pluginChannels) {
+                for (auto& oldParam : paramsBak[ch]) {
+                    if (newAddedParam.idx == oldParam.idx) {
+                        newAddedParam.automationSlot = oldParam.automationSlot;
+                        break;
                     }
                 }
             }
         }
+    }
+}
 
-        m_latency = jresult["latency"].get<int>();
-        hasEditor = jresult["hasEditor"].get<bool>();
-        scDisabled = jresult["disabledSideChain"].get<bool>();
+bool Client::addPluginAsync(String id, const String& settings, const String& layout, uint64 monoChannels,
+                            String& err) {
+    traceScope();
+
+    if (!isReadyLockFree()) {
+        dropSession();
+        err = "client not ready";
+        return false;
+    };
 
+    err.clear();
+    MessageHelper::Error e;
+    Message<AddPlugin> msg(this);
+    PLD(msg).setJson({{"id", id.toStdString()},
+                      {"settings", settings.toStdString()},
+                      {"layout", layout.toStdString()},
+                      {"monoChannels", monoChannels},
+                      {"async", true}});
+
+    LockByID lock(*this, ADDPLUGIN);
+
+    if (msg.send(m_cmdOut.get())) {
+        Message<AddPluginResult> msgResult(this);
+        if (!msgResult.read(m_cmdOut.get(), &e, LOAD_PLUGIN_TIMEOUT)) {
+            err = "failed to read result (" + e.toString() + ")";
+            logln("error: " << err);
+            return false;
+        }
+        auto jresult = PLD(msgResult).getJson();
+        if (!jresult["success"].get<bool>()) {
+            err = jresult["err"].get<std::string>();
+            logln("load error: " << err);
+            return false;
+        }
         return true;
     }
 
@@ -651,6 +1240,7 @@ bool Client::addPlugin(String id, StringArray& presets, ParameterByChannelList&
 void Client::delPlugin(int idx) {
     traceScope();
     if (!isReadyLockFree()) {
+        dropSession();
         return;
     };
     Message<DelPlugin> msg(this);
@@ -711,8 +1301,141 @@ String Client::getPluginSettings(int idx) {
     return {};
 }
 
+String Client::getPluginSettings(int idx, const String& knownSettings) {
+    traceScope();
+    if (!m_srvIncrementalSettings) {
+        return getPluginSettings(idx);
+    }
+    if (!isReadyLockFree()) {
+        return {};
+    };
+    auto knownHash = PluginSettings::getHash(knownSettings);
+    Message<GetPluginSettingsIfChanged> msg(this);
+    PLD(msg).setJson({{"idx", idx}, {"hash", knownHash.toStdString()}, {"chunked", m_srvChunkedSettings}});
+    MessageHelper::Error err;
+    int chunks = -1, transfer = 0;
+    {
+        LockByID lock(*this, GETPLUGINSETTINGS);
+        if (!msg.send(m_cmdOut.get())) {
+            m_error = true;
+            return {};
+        }
+        Message<PluginSettingsState> resState(this);
+        if (!resState.read(m_cmdOut.get(), &err, LOAD_PLUGIN_TIMEOUT)) {
+            logln(getLoadedPluginsString()
+                  << ": failed to read PluginSettingsState message for idx " << idx << ": " << err.toString());
+            m_error = true;
+            return {};
+        }
+        auto jstate = PLD(resState).getJson();
+        if (!jsonGetValue(jstate, "changed", true)) {
+            traceln("settings for idx " << idx << " unchanged");
+            return knownSettings;
+        }
+        chunks = jsonGetValue(jstate, "chunks", -1);
+        transfer = jsonGetValue(jstate, "transfer", 0);
+        if (chunks < 0) {
+            Message<PluginSettings> res(this);
+            if (res.read(m_cmdOut.get(), &err, LOAD_PLUGIN_TIMEOUT)) {
+                return PLD(res).getString();
+            } else {
+                logln(getLoadedPluginsString()
+                      << ": failed to read PluginSettings message for idx " << idx << ": " << err.toString());
+                m_error = true;
+                return {};
+            }
+        }
+    }
+    String settings;
+    if (!readSettingsChunks(idx, transfer, chunks, settings)) {
+        m_error = true;
+        return {};
+    }
+    return settings;
+}
+
+bool Client::readSettingsChunks(int idx, int transfer, int numChunks, String& settings) {
+    traceScope();
+    if (numChunks > PluginSettingsChunk::MAX_CHUNKS) {
+        logln("too many settings chunks for idx " << idx << ": " << numChunks);
+        return false;
+    }
+    MemoryBlock block;
+    int seq = 0;
+    while (seq < numChunks) {
+        // request a window of chunks at once and release the lock in between, so that other commands don't have to
+        // wait for large transfers
+        LockByID lock(*this, GETPLUGINSETTINGS);
+        int end = jmin(numChunks, seq + SETTINGS_CHUNK_WINDOW);
+        for (int i = seq; i < end; i++) {
+            Message<GetPluginSettingsChunk> msg(this);
+            DATA(msg)->idx = idx;
+            DATA(msg)->transfer = transfer;
+            DATA(msg)->seq = i;
+            if (!msg.send(m_cmdOut.get())) {
+                logln("failed to request settings chunk " << i << " for idx " << idx);
+                return false;
+            }
+        }
+        for (; seq < end; seq++) {
+            Message<PluginSettingsChunk> res(this);
+            MessageHelper::Error err;
+            if (!res.read(m_cmdOut.get(), &err, LOAD_PLUGIN_TIMEOUT)) {
+                logln("failed to read settings chunk " << seq << " for idx " << idx << ": " << err.toString());
+                return false;
+            }
+            if (!PLD(res).isValid()) {
+                logln("invalid settings chunk " << seq << " for idx " << idx);
+                return false;
+            }
+            if (PLD(res).hdr->transfer != transfer || PLD(res).hdr->total != numChunks || PLD(res).hdr->seq != seq) {
+                logln("invalid settings chunk " << PLD(res).hdr->seq << "/" << PLD(res).hdr->total << " for idx "
+                                                << idx);
+                return false;
+            }
+            block.append(PLD(res).data, (size_t)PLD(res).hdr->size);
+        }
+    }
+    if (!PluginSettingsChunk::decompress(block, settings)) {
+        logln("settings for idx " << idx << " exceed the size limit");
+        return false;
+    }
+    return true;
+}
+
+bool Client::sendSettingsChunks(StreamingSocket* sock, int idx, const MemoryBlock& block) {
+    traceScope();
+    int numChunks = PluginSettingsChunk::getNumChunks(block);
+    for (int seq = 0; seq < numChunks; seq++) {
+        Message<PluginSettingsChunk> msg(this);
+        PLD(msg).setChunk(idx, 0, seq, block);
+        if (!msg.send(sock)) {
+            logln("failed to send settings chunk " << seq << " for idx " << idx);
+            return false;
+        }
+    }
+    return true;
+}
+
 void Client::setPluginSettings(int idx, String settings) {
     traceScope();
+    if (m_srvChunkedSettings) {
+        auto block = PluginSettingsChunk::compress(settings);
+        int numChunks = PluginSettingsChunk::getNumChunks(block);
+        int transfer = ++m_settingsTransfer;
+        for (int seq = 0; seq < numChunks; seq++) {
+            // chunks don't need a reply, so other commands can go in between
+            Message<PluginSettingsChunk> msg(this);
+            PLD(msg).setChunk(idx, transfer, seq, block);
+            LockByID lock(*this, SETPLUGINSETTINGS);
+            if (!msg.send(m_cmdOut.get())) {
+                logln("failed to send settings chunk " << seq << " for idx " << idx);
+                m_error = true;
+                return;
+            }
+        }
+        return;
+    }
     Message<SetPluginSettings> msg(this);
     PLD(msg).setNumber(idx);
     LockByID lock(*this, SETPLUGINSETTINGS);
@@ -731,6 +1454,7 @@ void Client::setPluginSettings(int idx, String settings) {
 void Client::bypassPlugin(int idx) {
     traceScope();
     if (!isReadyLockFree()) {
+        dropSession();
         return;
     };
     Message<BypassPlugin> msg(this);
@@ -742,6 +1466,7 @@ void Client::bypassPlugin(int idx) {
 void Client::unbypassPlugin(int idx) {
     traceScope();
     if (!isReadyLockFree()) {
+        dropSession();
         return;
     };
     Message<UnbypassPlugin> msg(this);
@@ -753,6 +1478,7 @@ void Client::unbypassPlugin(int idx) {
 void Client::exchangePlugins(int idxA, int idxB) {
     traceScope();
     if (!isReadyLockFree()) {
+        dropSession();
         return;
     };
     Message<ExchangePlugins> msg(this);
@@ -790,6 +1516,7 @@ Array<ServerPlugin> Client::getRecents() {
 void Client::setPreset(int idx, int channel, int preset) {
     traceScope();
     if (!isReadyLockFree()) {
+        dropSession();
         return;
     };
     Message<Preset> msg(this);
@@ -803,6 +1530,7 @@ void Client::setPreset(int idx, int channel, int preset) {
 void Client::setMonoChannels(int idx, uint64 channels) {
     traceScope();
     if (!isReadyLockFree()) {
+        dropSession();
         return;
     };
     logln("updating mono channels for plugin " << idx << ": " << ChannelSet::toString(channels, 0, m_channelsOut));
@@ -813,6 +1541,17 @@ void Client::setMonoChannels(int idx, uint64 channels) {
     msg.send(m_cmdOut.get());
 }
 
+void Client::setAuxBuses(const String& send, float sendLevel, const String& receive) {
+    traceScope();
+    if (!isReadyLockFree() || !m_srvAuxBuses) {
+        return;
+    };
+    Message<SetAuxBuses> msg(this);
+    PLD(msg).setJson({{"send", send.toStdString()}, {"sendLevel", sendLevel}, {"receive", receive.toStdString()}});
+    LockByID lock(*this, SETAUXBUSES);
+    msg.send(m_cmdOut.get());
+}
+
 float Client::getParameterValue(int idx, int channel, int paramIdx) {
     traceScope();
     if (!isReadyLockFree()) {
@@ -840,6 +1579,7 @@ float Client::getParameterValue(int idx, int channel, int paramIdx) {
 void Client::setParameterValue(int idx, int channel, int paramIdx, float val) {
     traceScope();
     if (!isReadyLockFree()) {
+        dropSession();
         return;
     };
     Message<ParameterValue> msg(this);
@@ -1190,17 +1930,24 @@ void Client::updatePluginList(bool sendRequest) {
         msg.send(m_cmdOut.get());
     }
     m_plugins.clear();
+    readPluginList(m_cmdOut.get(), m_plugins);
+}
+
+bool Client::readPluginList(StreamingSocket* sock, std::vector<ServerPlugin>& plugins) {
+    traceScope();
+    Message<PluginList> msg(this);
     MessageHelper::Error err;
-    if (!msg.read(m_cmdOut.get(), &err, LOAD_PLUGIN_TIMEOUT)) {
+    if (!msg.read(sock, &err, LOAD_PLUGIN_TIMEOUT)) {
         logln("failed reading plugin list: " << err.toString());
-        return;
+        return false;
     }
     auto jlist = PLD(msg).getJson();
     if (jsonHasValue(jlist, "plugins")) {
         for (auto jplug : jlist["plugins"]) {
-            m_plugins.push_back(ServerPlugin::fromJson(jplug));
+            plugins.push_back(ServerPlugin::fromJson(jplug));
         }
     }
+    return true;
 }
 
 void Client::updateCPULoad() {
@@ -1260,6 +2007,34 @@ std::shared_ptr<AudioStreamer<double>> Client::getStreamer() {
     return m_audioStreamerD;
 }
 
+template <>
+void Client::getStreamers(std::shared_ptr<AudioStreamer<float>>& streamer,
+                          std::shared_ptr<AudioStreamer<float>>& migration) {
+    std::lock_guard<std::mutex> lock(m_audioMtx);
+    streamer = m_audioStreamerF;
+    migration = m_migrationStreamerF;
+}
+
+template <>
+void Client::getStreamers(std::shared_ptr<AudioStreamer<double>>& streamer,
+                          std::shared_ptr<AudioStreamer<double>>& migration) {
+    std::lock_guard<std::mutex> lock(m_audioMtx);
+    streamer = m_audioStreamerD;
+    migration = m_migrationStreamerD;
+}
+
+template <>
+std::shared_ptr<AudioStreamer<float>> Client::getMigrationStreamer() {
+    std::lock_guard<std::mutex> lock(m_audioMtx);
+    return m_migrationStreamerF;
+}
+
+template <>
+std::shared_ptr<AudioStreamer<double>> Client::getMigrationStreamer() {
+    std::lock_guard<std::mutex> lock(m_audioMtx);
+    return m_migrationStreamerD;
+}
+
 bool Client::audioConnectionOk() {
     traceScope();
     std::lock_guard<std::mutex> lock(m_audioMtx);
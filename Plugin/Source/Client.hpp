@@ -16,6 +16,7 @@
 #include "Utils.hpp"
 #include "Metrics.hpp"
 #include "ImageReader.hpp"
+#include "AudioConcealer.hpp"
 
 JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE("-Wzero-as-null-pointer-constant", "-Wsign-conversion", "-Wshadow")
 #include <boost/lockfree/spsc_queue.hpp>
@@ -150,11 +151,30 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
     // for processing the audio in realtime, even if it has to drop samples
     std::atomic_bool LIVE_MODE{false};
 
+    // How to fill blocks, that have been dropped or did not arrive in time
+    std::atomic_int CONCEALMENT{CONCEAL_SILENCE};
+
+    // Spin instead of blocking when waiting for audio data, this keeps a core busy but reduces the wakeup latency
+    std::atomic_bool LOW_LATENCY{false};
+
     void run() override;
 
     void setServer(const ServerInfo& srv);
+    // Picks a server from the mDNS results according to the server selection mode of the processor
+    ServerInfo selectServer(const Array<ServerInfo>& servers);
+    // Orders servers for the least loaded selection: servers, that miss deadlines, go last, then by the load rounded
+    // to LOAD_BUCKET percent, by the number of clients and finally by the exact load
+    static int compareServerLoad(const ServerInfo& lhs, const ServerInfo& rhs);
     ServerInfo getServer();
     bool isServerLocalMode() const { return m_srvLocalMode; }
+    bool isServerAsyncAddPlugin() const { return m_srvAsyncAddPlugin; }
+    bool isServerBatchRestore() const { return m_srvBatchRestore; }
+    bool isServerAuxBuses() const { return m_srvAuxBuses; }
+    bool isServerSandboxEnabled() const { return m_srvSandboxEnabled; }
+
+    // The host renders offline (bounce/export), the audio streamer pipelines blocks if the server supports it
+    void setNonRealtime(bool b) { m_nonRealtime = b; }
+    bool isOfflineRender() const { return m_nonRealtime && m_srvOfflineRender; }
     int getChannelsIn() const { return m_channelsIn; }
     int getChannelsOut() const { return m_channelsOut; }
     int getChannelsSC() const { return m_channelsSC; }
@@ -181,11 +201,43 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
     void init(int channelsIn, int channelsOut, int channelsSC, double rate, int samplesPerBlock, bool doublePrecission);
 
     void reconnect() { m_needsReconnect = true; }
-    void close();
+    void close(bool endSession = true);
+
+    // True if the server kept the chain of the previous connection alive, so that nothing has to be loaded
+    bool isSessionResumed() const { return m_sessionResumed; }
+
+    // Moves the chain to another server without a dropout: the chain gets loaded on the target and runs in parallel
+    // until the audio stream switches over with a short crossfade, then the old chain gets retired
+    void migrate(const ServerInfo& target);
+    bool isMigrating() const { return m_needsMigrate || m_migrationState != MIGRATE_NONE; }
+
+    enum MigrationState : int { MIGRATE_NONE, MIGRATE_PREROLL, MIGRATE_SWITCH, MIGRATE_DONE };
+    int getMigrationState() const { return m_migrationState; }
+    // Called by the audio thread, when the output has been faded over to the target server
+    void setMigrationSwitched() {
+        int expected = MIGRATE_SWITCH;
+        m_migrationState.compare_exchange_strong(expected, MIGRATE_DONE);
+    }
+
+    template <typename T>
+    std::shared_ptr<AudioStreamer<T>> getMigrationStreamer();
 
     template <typename T>
     std::shared_ptr<AudioStreamer<T>> getStreamer();
 
+    // Both streamers with a single lock, so that the audio thread does not see a half done switch
+    template <typename T>
+    void getStreamers(std::shared_ptr<AudioStreamer<T>>& streamer, std::shared_ptr<AudioStreamer<T>>& migration);
+
+    // Streamers, that have been replaced, might still be in use by the audio thread for the current block. They must
+    // not be destroyed there, so they get released by the client thread, once nobody else holds them anymore.
+    void retireStreamer(std::shared_ptr<void> streamer);
+    void releaseRetiredStreamers();
+
+#ifdef AG_UNIT_TESTS
+    void setMigrationState(int state) { m_migrationState = state; }
+#endif
+
     const auto& getPlugins() const { return m_plugins; }
     Image getPluginScreen();  // create copy
     void setPluginScreen(std::shared_ptr<Image> img, int w, int h);
@@ -199,12 +251,37 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
     using OnCloseCallback = std::function<void()>;
     void setOnCloseCallback(OnCloseCallback fn);
 
+    // A non empty host (host:id) makes the server forward the audio to the plugin on that server
     bool addPlugin(String id, StringArray& presets, ParameterByChannelList& params, bool& hasEditor, bool& scDisabled,
-                   const String& settings, const String& layout, uint64 monoChannels, String& err);
+                   const String& settings, const String& layout, uint64 monoChannels, const String& host,
+                   String& err);
+    struct RestorePlugin {
+        String id;
+        String settings;
+        String layout;
+        uint64 monoChannels = 0;
+        String host;
+        bool bypassed = false;
+        // results, existing parameters are used to keep the automation slots
+        bool ok = false;
+        String err;
+        StringArray presets;
+        ParameterByChannelList params;
+        bool hasEditor = false;
+        bool scDisabled = false;
+    };
+
+    // Restores a whole chain with one request, the server loads the plugins concurrently
+    bool restorePlugins(std::vector<RestorePlugin>& plugins, String& err);
+
+    // Asks the server to load the plugin in the background, the result is delivered via PluginLoaded
+    bool addPluginAsync(String id, const String& settings, const String& layout, uint64 monoChannels, String& err);
     void delPlugin(int idx);
     void editPlugin(int idx, int channel, int x, int y);
     void hidePlugin();
     String getPluginSettings(int idx);
+    // Returns the known settings, if they did not change on the server, otherwise fetches them
+    String getPluginSettings(int idx, const String& knownSettings);
     void setPluginSettings(int idx, String settings);
     void bypassPlugin(int idx);
     void unbypassPlugin(int idx);
@@ -214,6 +291,9 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
 
     void setMonoChannels(int idx, uint64 channels);
 
+    // Connects the chain to shared aux buses on the server, empty names disconnect
+    void setAuxBuses(const String& send, float sendLevel, const String& receive);
+
     float getParameterValue(int idx, int channel, int paramIdx);
     void setParameterValue(int idx, int channel, int paramIdx, float val);
 
@@ -266,8 +346,20 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
     ServerInfo m_srvInfo;
     float m_srvLoad = 0.0f;
     bool m_srvLocalMode = false;
+    bool m_srvAsyncAddPlugin = false;
+    bool m_srvIncrementalSettings = false;
+    bool m_srvChunkedSettings = false;
+    bool m_srvBatchRestore = false;
+    std::atomic_bool m_srvOfflineRender{false};
+    std::atomic_bool m_nonRealtime{false};
+    bool m_srvReconfigure = false;
+    std::atomic_bool m_srvAuxBuses{false};
+    std::atomic_bool m_srvSandboxEnabled{false};
     int m_srvLoadLastUpdated = 0;
     bool m_needsReconnect = false;
+    std::atomic_bool m_needsReconfigure{false};
+    std::atomic<uint64> m_sessionToken{0};
+    std::atomic_bool m_sessionResumed{false};
     double m_sampleRate = 0;
     bool m_doublePrecission = false;
 
@@ -312,7 +404,10 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
         UPDATECPULOAD2,
         GETLOADEDPLUGINSSTRING,
         UPDATEPLUGINLIST,
-        SETMONOCHANNELS
+        SETMONOCHANNELS,
+        RECONFIGURE,
+        MIGRATE,
+        SETAUXBUSES
     };
 
     struct LockByID : public LogTagDelegate {
@@ -408,20 +503,74 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
 
     void quit();
     void init();
+    bool reconfigure();
+
+    struct ServerConnection {
+        std::unique_ptr<StreamingSocket> cmdOut;
+        std::unique_ptr<StreamingSocket> cmdIn;
+        std::unique_ptr<StreamingSocket> audioSocket;
+        std::unique_ptr<StreamingSocket> screenSocket;
+        HandshakeResponse resp;
+    };
+
+    // Handshake and worker connections, sockets that could not be connected stay empty
+    bool connectServer(const ServerInfo& srvInfo, uint64 sessionToken, ServerConnection& conn);
+    void setServerFlags(HandshakeResponse& resp);
+
+    bool restorePlugins(StreamingSocket* sock, bool chunkedSettings, std::vector<RestorePlugin>& plugins, int& latency,
+                        String& err);
+
+    std::atomic_bool m_needsMigrate{false};
+    ServerInfo m_migrationTarget;
+    std::atomic_int m_migrationState{MIGRATE_NONE};
+
+    std::vector<std::shared_ptr<void>> m_retiredStreamers;
+    std::mutex m_retiredStreamersMtx;
+
+    // The target chain needs some blocks to fill its buffers and settle, before it's audible
+    static constexpr int MIGRATION_PREROLL_MS = 500;
+    static constexpr int MIGRATION_SWITCH_TIMEOUT_MS = 1000;
+
+    bool runMigration();
+    void stopMigrationStreamer();
+
+    // Any change to the chain while disconnected makes the session useless
+    void dropSession() { m_sessionToken = 0; }
+    void startAudioStreamer(StreamingSocket* audioSock, bool migrationTarget = false);
 
     StreamingSocket* accept(StreamingSocket& sock) const;
 
     std::mutex m_audioMtx;
     std::shared_ptr<AudioStreamer<float>> m_audioStreamerF;
     std::shared_ptr<AudioStreamer<double>> m_audioStreamerD;
+    std::shared_ptr<AudioStreamer<float>> m_migrationStreamerF;
+    std::shared_ptr<AudioStreamer<double>> m_migrationStreamerD;
 
     bool audioConnectionOk();
 
+    static void readParameters(const json& jparams, int pluginChannels, ParameterByChannelList& params);
+
+    // Servers with less free memory are skipped by the automatic server selection
+    static constexpr int64 MIN_FREE_MEMORY_MB = 512;
+
+    // Servers with a load difference within the same bucket count as equally loaded
+    static constexpr float LOAD_BUCKET = 5.0f;
+
+    // Number of settings chunks requested at once
+    static constexpr int SETTINGS_CHUNK_WINDOW = 4;
+    // Id of the last settings transfer to the server
+    std::atomic_int m_settingsTransfer{0};
+
+    bool readSettingsChunks(int idx, int transfer, int numChunks, String& settings);
+    bool sendSettingsChunks(StreamingSocket* sock, int idx, const MemoryBlock& block);
+    bool readPluginList(StreamingSocket* sock, std::vector<ServerPlugin>& plugins);
+
     void handleMessage(std::shared_ptr<Message<Key>> msg);
     void handleMessage(std::shared_ptr<Message<Clipboard>> msg);
     void handleMessage(std::shared_ptr<Message<ParameterValue>> msg);
     void handleMessage(std::shared_ptr<Message<ParameterGesture>> msg);
     void handleMessage(std::shared_ptr<Message<PluginStatus>> msg);
+    void handleMessage(std::shared_ptr<Message<PluginLoaded>> msg);
     void handleMessage(std::shared_ptr<Message<HidePlugin>> msg);
     void handleMessage(std::shared_ptr<Message<ServerError>> msg);
 
@@ -343,8 +343,14 @@ void PluginEditor::buttonClicked(Button* button, const ModifierKeys& modifiers,
                                                  "Failed to add " + plug.getName() + " plugin!\n\nError: " + err, "OK");
             }
             auto* b = addPluginButton(plug.getId(), plug.getName());
-            if (success) {
-                editPlugin((int)m_pluginButtons.size() - 1);
+            int idx = (int)m_pluginButtons.size() - 1;
+            if (success && !m_processor.getLoadedPlugin(idx).ok) {
+                // loading in the background, open the editor when it's done
+                b->setEnabled(false);
+                b->setTooltip("loading...");
+                m_editWhenLoaded = idx;
+            } else if (success) {
+                editPlugin(idx);
             } else {
                 b->setEnabled(false);
                 b->setTooltip(err);
@@ -405,6 +411,7 @@ void PluginEditor::buttonClicked(Button* button, const ModifierKeys& modifiers,
                                              "Are you sure to delete >" + m_processor.getLoadedPlugin(idx).name + "< ?",
                                              "Yes", "No")) {
                 m_processor.unloadPlugin(idx);
+                m_editWhenLoaded = -1;
                 int i = 0;
                 for (auto it = m_pluginButtons.begin(); it < m_pluginButtons.end(); it++) {
                     if (i++ == idx) {
@@ -526,6 +533,24 @@ void PluginEditor::buttonClicked(Button* button, const ModifierKeys& modifiers,
                 });
             }
             m.addSubMenu("Automation", mParams);
+
+            PopupMenu mHosts;
+            mHosts.addItem("Connected Server", true, loadedPlug.host.isEmpty(), [this, idx] {
+                traceScope();
+                m_processor.setPluginHost(idx, {});
+            });
+            auto activeServer = m_processor.getActiveServerHost();
+            for (auto& s : m_processor.getServersMDNS()) {
+                auto host = s.getHostAndID();
+                if (host == activeServer) {
+                    continue;
+                }
+                mHosts.addItem(s.getNameAndID(), true, loadedPlug.host == host, [this, idx, host] {
+                    traceScope();
+                    m_processor.setPluginHost(idx, host);
+                });
+            }
+            m.addSubMenu("Run on Server", mHosts);
             m.showAt(button);
         }
     }
@@ -869,7 +894,11 @@ void PluginEditor::showServerMenu() {
             if (showIp) {
                 name << " (" << s.getHost() << ")";
             }
-            name << " [load: " << lround(s.getLoad()) << "%]";
+            name << " [load: " << lround(s.getLoad()) << "%";
+            if (s.getClients() > -1) {
+                name << ", clients: " << s.getClients();
+            }
+            name << "]";
             if (s.getHostAndID() == active) {
                 PopupMenu srvMenu;
                 srvMenu.addItem("Rescan", [this] {
@@ -884,6 +913,18 @@ void PluginEditor::showServerMenu() {
                     traceScope();
                     m_processor.getClient().reconnect();
                 });
+                PopupMenu migrateMenu;
+                for (auto& target : serversMDNS) {
+                    if (target.getHostAndID() != active) {
+                        migrateMenu.addItem(target.getNameAndID(), [this, target] {
+                            traceScope();
+                            m_processor.getClient().migrate(target);
+                        });
+                    }
+                }
+                srvMenu.addSubMenu("Migrate Chain To", migrateMenu,
+                                   migrateMenu.getNumItems() > 0 && !m_processor.getClient().isMigrating() &&
+                                       m_processor.getClient().isReadyLockFree());
                 subm.addSubMenu(name, srvMenu, true, nullptr, true, 0);
             } else {
                 subm.addItem(name, [this, s] {
@@ -953,6 +994,19 @@ void PluginEditor::showServerMenu() {
         w->runModalLoop();
     });
 
+    PopupMenu selectionMenu;
+    auto addSelectionItem = [this, &selectionMenu](const String& name, PluginProcessor::ServerSelection sel) {
+        selectionMenu.addItem(name, true, m_processor.getServerSelection() == sel, [this, sel] {
+            traceScope();
+            m_processor.setServerSelection(sel);
+            m_processor.saveConfig();
+        });
+    };
+    addSelectionItem("Off", PluginProcessor::SS_MANUAL);
+    addSelectionItem("Least Loaded", PluginProcessor::SS_LEAST_LOADED);
+    addSelectionItem("Lowest Latency", PluginProcessor::SS_LOWEST_RTT);
+    subm.addSubMenu("Automatic Selection", selectionMenu);
+
     m.addSubMenu("Servers", subm);
     subm.clear();
 
@@ -1211,10 +1265,70 @@ void PluginEditor::showSettingsMenu() {
         m_processor.getClient().LIVE_MODE = !m_processor.getClient().LIVE_MODE;
         m_processor.saveConfig();
     });
+    subm.addItem("Low Latency Mode (Busy Polling)", true, m_processor.getClient().LOW_LATENCY, [this] {
+        traceScope();
+        m_processor.getClient().LOW_LATENCY = !m_processor.getClient().LOW_LATENCY;
+        m_processor.saveConfig();
+    });
+
+    PopupMenu concealMenu;
+    for (int mode = CONCEAL_SILENCE; mode <= CONCEAL_DRY; mode++) {
+        bool ticked = m_processor.getClient().CONCEALMENT == mode;
+        concealMenu.addItem(getConcealmentModeName(mode), true, ticked, [this, mode] {
+            traceScope();
+            m_processor.getClient().CONCEALMENT = mode;
+            m_processor.saveConfig();
+        });
+    }
+    subm.addSubMenu("Dropped Blocks", concealMenu);
 
     m.addSubMenu("Transfer Audio/MIDI", subm);
     subm.clear();
 
+    auto auxBuses = m_processor.getAuxBuses();
+    PopupMenu sendMenu, levelMenu, receiveMenu;
+    auto addBusItems = [this, &auxBuses](PopupMenu& menu, bool isSend) {
+        auto& current = isSend ? auxBuses.send : auxBuses.receive;
+        menu.addItem("Off", true, current.isEmpty(), [this, auxBuses, isSend] {
+            traceScope();
+            auto buses = auxBuses;
+            (isSend ? buses.send : buses.receive).clear();
+            m_processor.setAuxBuses(buses);
+        });
+        for (int i = 1; i <= Defaults::NUM_AUX_BUSES; i++) {
+            String name = "Aux " + String(i);
+            auto& other = isSend ? auxBuses.receive : auxBuses.send;
+            menu.addItem(name, name != other, name == current, [this, auxBuses, isSend, name] {
+                traceScope();
+                auto buses = auxBuses;
+                (isSend ? buses.send : buses.receive) = name;
+                m_processor.setAuxBuses(buses);
+            });
+        }
+    };
+    addBusItems(sendMenu, true);
+    addBusItems(receiveMenu, false);
+    for (int db : {0, -3, -6, -12, -18, -24}) {
+        float level = Decibels::decibelsToGain((float)db);
+        levelMenu.addItem(String(db) + " dB", true, std::abs(auxBuses.sendLevel - level) < 0.001f,
+                          [this, auxBuses, level] {
+                              traceScope();
+                              auto buses = auxBuses;
+                              buses.sendLevel = level;
+                              m_processor.setAuxBuses(buses);
+                          });
+    }
+    subm.addSubMenu("Send To", sendMenu);
+    subm.addSubMenu("Send Level", levelMenu, auxBuses.send.isNotEmpty());
+    subm.addSubMenu("Receive From", receiveMenu);
+    if (m_processor.getClient().isServerSandboxEnabled()) {
+        // chains in sandboxes can't share buses, tell the user why the menu is disabled
+        m.addItem("Aux Buses (not available with sandboxes)", false, false, nullptr);
+    } else {
+        m.addSubMenu("Aux Buses", subm, m_processor.getClient().isServerAuxBuses());
+    }
+    subm.clear();
+
     int latencyManual = m_processor.getClient().getLatencySamplesManual();
     int latency = m_processor.getClient().getLatencySamples() - latencyManual;
     int blockSize = m_processor.getClient().getSamplesPerBlock();
@@ -1607,6 +1721,16 @@ void PluginEditor::updatePluginStatus(int idx, bool ok, const String& err) {
     }
 }
 
+void PluginEditor::updatePluginLoaded(int idx, bool ok, const String& err) {
+    updatePluginStatus(idx, ok, err);
+    if (idx == m_editWhenLoaded) {
+        m_editWhenLoaded = -1;
+        if (ok) {
+            editPlugin(idx);
+        }
+    }
+}
+
 void PluginEditor::hidePluginFromServer(int idx) {
     int active = m_processor.getActivePlugin();
     if (active == idx) {
@@ -39,6 +39,7 @@ class PluginEditor : public AudioProcessorEditor,
 
     void updateParamValue(int paramIdx);
     void updatePluginStatus(int idx, bool ok, const String& err);
+    void updatePluginLoaded(int idx, bool ok, const String& err);
     void hidePluginFromServer(int idx);
 
     void setShouldExit() { m_shouldExit = true; }
@@ -46,6 +47,7 @@ class PluginEditor : public AudioProcessorEditor,
   private:
     PluginProcessor& m_processor;
     std::atomic_bool m_shouldExit = false;
+    int m_editWhenLoaded = -1;
 
     const int SCREENTOOLS_HEIGHT = 17;
     const int SCREENTOOLS_MARGIN = 3;
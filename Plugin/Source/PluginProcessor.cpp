@@ -15,6 +15,7 @@
 #include "Sentry.hpp"
 #include "AudioStreamer.hpp"
 #include "WindowPositions.hpp"
+#include "RealtimeCheck.hpp"
 
 #if !defined(JUCE_WINDOWS)
 #include <signal.h>
@@ -108,17 +109,64 @@ PluginProcessor::PluginProcessor(AudioProcessor::WrapperType wt)
     m_client->setOnConnectCallback(safeLambda([this] {
         traceScope();
         logln("connected");
+        if (m_client->isSessionResumed()) {
+            logln("session resumed, the plugins are still loaded on the server");
+            {
+                std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+                bool allOk = true;
+                for (auto& p : m_loadedPlugins) {
+                    allOk = allOk && p.ok;
+                }
+                m_loadedPluginsOk = allOk;
+            }
+            m_client->setLoadedPluginsString(getLoadedPluginsString());
+            updateAuxBuses();
+            runOnMsgThreadAsync([this] {
+                traceScope();
+                auto* editor = getActiveEditor();
+                if (editor != nullptr) {
+                    dynamic_cast<PluginEditor*>(editor)->setConnected(true);
+                }
+            });
+            return;
+        }
         bool updLatency = false;
         std::vector<std::tuple<int, int, int, int>> automationParams;
         int idx = 0;
         {
             std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
             bool allOk = true;
+            // let the server load the whole chain at once, if it supports it
+            std::vector<Client::RestorePlugin> restored;
+            if (m_client->isServerBatchRestore() && m_loadedPlugins.size() > 1) {
+                for (auto& p : m_loadedPlugins) {
+                    restored.push_back(p.toRestorePlugin());
+                }
+                logln("restoring " << restored.size() << " plugins [on connect]...");
+                String err;
+                if (!m_client->restorePlugins(restored, err)) {
+                    for (auto& r : restored) {
+                        r.ok = false;
+                        r.err = err;
+                    }
+                }
+            }
             for (auto& p : m_loadedPlugins) {
                 logln("loading " << p.name << " (" << p.id << ") [on connect]... ");
-                bool scDisabled;
-                p.ok = m_client->addPlugin(p.id, p.presets, p.params, p.hasEditor, scDisabled, p.settings, p.layout,
-                                           p.monoChannels.toInt(), p.error);
+                if (!restored.empty()) {
+                    auto& r = restored[(size_t)idx];
+                    p.ok = r.ok;
+                    p.error = r.err;
+                    if (r.ok) {
+                        p.presets = std::move(r.presets);
+                        p.params = std::move(r.params);
+                        p.hasEditor = r.hasEditor;
+                    }
+                } else {
+                    bool scDisabled;
+                    p.ok = m_client->addPlugin(p.id, p.presets, p.params, p.hasEditor, scDisabled, p.settings,
+                                               p.layout, p.monoChannels.toInt(), p.host, p.error);
+                }
                 if (p.ok) {
                     logln("...ok");
                     updLatency = true;
@@ -146,6 +194,7 @@ PluginProcessor::PluginProcessor(AudioProcessor::WrapperType wt)
             m_loadedPluginsOk = allOk;
         }
         m_client->setLoadedPluginsString(getLoadedPluginsString());
+        updateAuxBuses();
 
         if (updLatency) {
             updateLatency();
@@ -179,10 +228,13 @@ PluginProcessor::PluginProcessor(AudioProcessor::WrapperType wt)
         });
     }));
 
-    if (m_activeServerFromCfg.isNotEmpty()) {
-        m_client->setServer(m_activeServerFromCfg);
-    } else if (m_activeServerLegacyFromCfg > -1 && m_activeServerLegacyFromCfg < m_servers.size()) {
-        m_client->setServer(m_servers[m_activeServerLegacyFromCfg]);
+    // with automatic server selection the server stays unset, so that the client picks one
+    if (getServerSelection() == SS_MANUAL) {
+        if (m_activeServerFromCfg.isNotEmpty()) {
+            m_client->setServer(m_activeServerFromCfg);
+        } else if (m_activeServerLegacyFromCfg > -1 && m_activeServerLegacyFromCfg < m_servers.size()) {
+            m_client->setServer(m_servers[m_activeServerLegacyFromCfg]);
+        }
     }
 
 #if !JucePlugin_IsSynth && !JucePlugin_IsMidiEffect
@@ -300,6 +352,7 @@ void PluginProcessor::loadConfig(const json& j, bool isUpdate) {
         m_noSrvPluginListFilter = noSrvPluginListFilter;
         m_client->reconnect();
     }
+    m_serverSelection = jsonGetValue(j, "ServerSelection", m_serverSelection.load());
     m_crashReporting = jsonGetValue(j, "CrashReporting", m_crashReporting);
     m_showSidechainDisabledInfo = jsonGetValue(j, "ShowSidechainDisabledInfo", m_showSidechainDisabledInfo);
     m_disableTray = jsonGetValue(j, "DisableTray", m_disableTray);
@@ -309,6 +362,9 @@ void PluginProcessor::loadConfig(const json& j, bool isUpdate) {
     m_client->FIXED_OUTBOUND_BUFFER = jsonGetValue(j, "FixedOutboundBuffer", m_client->FIXED_OUTBOUND_BUFFER.load());
     m_processingTraceTresholdMs = jsonGetValue(j, "ProcessingTraceTresholdMs", m_processingTraceTresholdMs);
     m_client->LIVE_MODE = jsonGetValue(j, "LiveMode", m_client->LIVE_MODE.load());
+    m_client->CONCEALMENT = jlimit((int)CONCEAL_SILENCE, (int)CONCEAL_DRY,
+                                   jsonGetValue(j, "Concealment", m_client->CONCEALMENT.load()));
+    m_client->LOW_LATENCY = jsonGetValue(j, "LowLatencyMode", m_client->LOW_LATENCY.load());
 
     int newBlockSize = jsonGetValue(j, "CustomBlockSize", m_customBlockSize);
     if (newBlockSize != m_customBlockSize) {
@@ -348,6 +404,7 @@ void PluginProcessor::saveConfig(int numOfBuffers, bool saveBufferDefaults) {
     jcfg["Logger"] = Logger::isEnabled();
     jcfg["SyncRemoteMode"] = m_syncRemote;
     jcfg["NoSrvPluginListFilter"] = m_noSrvPluginListFilter;
+    jcfg["ServerSelection"] = m_serverSelection.load();
     jcfg["ZoomFactor"] = m_scale;
     jcfg["PresetsDir"] = m_presetsDir.toStdString();
     jcfg["DefaultPreset"] = m_defaultPreset.toStdString();
@@ -361,6 +418,8 @@ void PluginProcessor::saveConfig(int numOfBuffers, bool saveBufferDefaults) {
     jcfg["BufferSettingByPlugin"] = m_bufferSizeByPlugin;
     jcfg["ProcessingTraceTresholdMs"] = m_processingTraceTresholdMs;
     jcfg["LiveMode"] = m_client->LIVE_MODE.load();
+    jcfg["Concealment"] = m_client->CONCEALMENT.load();
+    jcfg["LowLatencyMode"] = m_client->LOW_LATENCY.load();
 
     if (!m_bufferSizeByPlugin) {
         jcfg["NumberOfBuffers"] = numOfBuffers;
@@ -400,6 +459,26 @@ void PluginProcessor::setNumBuffers(int n) {
     }
 }
 
+PluginProcessor::AuxBuses PluginProcessor::getAuxBuses() {
+    std::lock_guard<std::mutex> lock(m_auxBusesMtx);
+    return m_auxBuses;
+}
+
+void PluginProcessor::setAuxBuses(const AuxBuses& buses) {
+    traceScope();
+    {
+        std::lock_guard<std::mutex> lock(m_auxBusesMtx);
+        m_auxBuses = buses;
+    }
+    updateAuxBuses();
+}
+
+void PluginProcessor::updateAuxBuses() {
+    traceScope();
+    auto buses = getAuxBuses();
+    m_client->setAuxBuses(buses.send, buses.sendLevel, buses.receive);
+}
+
 void PluginProcessor::storePreset(const File& file) {
     logln("storing preset " << file.getFullPathName());
     auto j = getState(false);
@@ -537,6 +616,12 @@ void PluginProcessor::prepareToPlay(double sampleRate, int blckSize) {
 
     m_client->init(channelsIn, channelsOut, channelsSC, sampleRate, clientBlockSize, isUsingDoublePrecision());
 
+    // a chain migration copies the send buffer on the audio thread
+    int migrationChannels = jmax(channelsIn + channelsSC, channelsOut);
+    m_migrationBufferF.setSize(migrationChannels, blckSize);
+    m_migrationBufferD.setSize(migrationChannels, blckSize);
+    m_migrationMidi.ensureSize(MIGRATION_MIDI_BYTES);
+
     m_prepared = true;
 
     updateLatency();
@@ -620,6 +705,7 @@ void PluginProcessor::setCustomBlockSize(int b) {
 template <typename T>
 void PluginProcessor::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& midiMessages) {
     traceScope();
+    RealtimeCheck::Scope rtScope;
 
     auto traceCtx = TimeTrace::createTraceContext();
     m_processingDurationGlobal.reset();
@@ -746,13 +832,16 @@ void PluginProcessor::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& m
     if (transfer) {
         if ((buffer.getNumChannels() > 0 && buffer.getNumSamples() > 0) || midiMessages.getNumEvents() > 0) {
             if (m_client->isReadyLockFree()) {
-                auto streamer = m_client->getStreamer<T>();
+                std::shared_ptr<AudioStreamer<T>> streamer, migration;
+                m_client->getStreamers<T>(streamer, migration);
 
                 traceCtx->add("pb_get_streamer");
 
                 if (nullptr != streamer && m_loadedPluginsOk) {
                     readTimeoutMs = streamer->getReadTimeoutMs();
 
+                    m_client->setNonRealtime(isNonRealtime());
+
                     m_channelMapper.map(&buffer, sendBuffer);
 
                     traceCtx->add("pb_ch_map");
@@ -760,6 +849,17 @@ void PluginProcessor::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& m
 
                     bool sendOk = streamer->send(*sendBuffer, midiMessages, posInfo);
 
+                    // the target of a chain migration processes the same input in parallel, the buffers have been
+                    // allocated in prepareToPlay
+                    auto& migrationBuffer = getMigrationBuffer(buffer);
+                    bool migrationOk = false;
+                    if (nullptr != migration) {
+                        migrationBuffer.makeCopyOf(*sendBuffer, true);
+                        m_migrationMidi.clear();
+                        m_migrationMidi.addEvents(midiMessages, 0, -1, 0);
+                        migrationOk = migration->send(migrationBuffer, m_migrationMidi, posInfo);
+                    }
+
                     traceCtx->finishGroup("pb_send");
                     traceCtx->startGroup();
 
@@ -767,6 +867,11 @@ void PluginProcessor::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& m
                         streamer->read(*sendBuffer, midiMessages);
                     }
 
+                    if (migrationOk) {
+                        migration->read(migrationBuffer, m_migrationMidi);
+                        processMigration(*sendBuffer, midiMessages, migrationBuffer, m_migrationMidi);
+                    }
+
                     traceCtx->finishGroup("pb_read");
 
                     m_channelMapper.mapReverse(sendBuffer, &buffer);
@@ -827,6 +932,35 @@ void PluginProcessor::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& m
     m_processingDurationLocal.update();
 }
 
+template <typename T>
+void PluginProcessor::processMigration(AudioBuffer<T>& buffer, MidiBuffer& midi, AudioBuffer<T>& target,
+                                       MidiBuffer& targetMidi) {
+    auto state = m_client->getMigrationState();
+    if (state == Client::MIGRATE_PREROLL) {
+        // the target output is not audible yet
+        m_migrationFadePos = 0;
+        return;
+    }
+
+    if (state == Client::MIGRATE_SWITCH) {
+        int fadeSamples = jmax(1, (int)(getSampleRate() * MIGRATION_CROSSFADE_MS / 1000));
+        if (!crossfade(buffer, target, m_migrationFadePos, fadeSamples)) {
+            return;
+        }
+        m_migrationFadePos = 0;
+        m_client->setMigrationSwitched();
+    } else {
+        int numSamples = jmin(buffer.getNumSamples(), target.getNumSamples());
+        int numChannels = jmin(buffer.getNumChannels(), target.getNumChannels());
+        for (int ch = 0; ch < numChannels; ch++) {
+            buffer.copyFrom(ch, 0, target, ch, 0, numSamples);
+        }
+    }
+    // copy instead of swapping, so that the preallocated buffer stays with the migration
+    midi.clear();
+    midi.addEvents(targetMidi, 0, -1, 0);
+}
+
 template <typename T>
 void PluginProcessor::processBlockBypassedInternal(AudioBuffer<T>& buffer, AudioRingBuffer<T>& bypassBuffer) {
     traceScope();
@@ -912,7 +1046,7 @@ void PluginProcessor::setStateInformation(const void* data, int sizeInBytes) {
 json PluginProcessor::getState(bool withActiveServer) {
     traceScope();
     json j;
-    j["version"] = 6;
+    j["version"] = 7;
     j["Mode"] = m_mode.toStdString();
 
     if (withActiveServer) {
@@ -927,13 +1061,22 @@ json PluginProcessor::getState(bool withActiveServer) {
         j["CustomBlockSize"] = m_customBlockSize;
     }
 
+    auto auxBuses = getAuxBuses();
+    if (auxBuses.send.isNotEmpty()) {
+        j["AuxSendBus"] = auxBuses.send.toStdString();
+        j["AuxSendLevel"] = auxBuses.sendLevel;
+    }
+    if (auxBuses.receive.isNotEmpty()) {
+        j["AuxReceiveBus"] = auxBuses.receive.toStdString();
+    }
+
     auto jplugs = json::array();
     {
         std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
         for (int i = 0; i < (int)m_loadedPlugins.size(); i++) {
             auto& plug = m_loadedPlugins[(size_t)i];
             if (m_loadedPluginsOk && m_client->isReadyLockFree()) {
-                auto settings = m_client->getPluginSettings(i);
+                auto settings = m_client->getPluginSettings(i, plug.settings);
                 if (!m_client->isReadyLockFree()) {
                     logln("error in getState: getPluginSettings for " << plug.name << " (" << plug.id << ") failed");
                 }
@@ -982,6 +1125,13 @@ bool PluginProcessor::setState(const json& j) {
 
     m_customBlockSize = jsonGetValue(j, "CustomBlockSize", m_customBlockSize);
 
+    {
+        std::lock_guard<std::mutex> lock(m_auxBusesMtx);
+        m_auxBuses.send = jsonGetValue(j, "AuxSendBus", String());
+        m_auxBuses.sendLevel = jsonGetValue(j, "AuxSendLevel", 1.0f);
+        m_auxBuses.receive = jsonGetValue(j, "AuxReceiveBus", String());
+    }
+
     {
         std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
         m_loadedPluginsCount = 0;
@@ -1025,7 +1175,7 @@ void PluginProcessor::sync() {
             for (int i = 0; i < (int)m_loadedPlugins.size(); i++) {
                 auto& plug = m_loadedPlugins[(size_t)i];
                 if (plug.ok && m_client->isReadyLockFree()) {
-                    auto settings = m_client->getPluginSettings(i);
+                    auto settings = m_client->getPluginSettings(i, plug.settings);
                     if (!m_client->isReadyLockFree()) {
                         logln("error in sync: getPluginSettings for " << plug.name << " (" << plug.id << ") failed");
                     }
@@ -1110,9 +1260,35 @@ bool PluginProcessor::loadPlugin(const ServerPlugin& plugin, const String& layou
         monoChannels = monoChannelSet.toInt();
     }
 
+    if (m_client->isServerAsyncAddPlugin()) {
+        // The server loads the plugin in the background and the audio keeps running, the plugin details follow with
+        // a PluginLoaded message (see updatePluginLoaded)
+        bool success = m_client->addPluginAsync(plugin.getId(), {}, layout, monoChannels, err);
+
+        if (success) {
+            logln("...pending");
+        } else {
+            logln("...error: " << err);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+            m_loadedPlugins.emplace_back(plugin.getId(), plugin.getIdDeprecated(), plugin.getName(), layout,
+                                         monoChannelSet, 0, "", presets, params, false, false, false,
+                                         success ? "loading..." : err);
+            m_loadedPluginsCount++;
+        }
+
+        if (success) {
+            updateRecents(plugin);
+        }
+        m_client->setLoadedPluginsString(getLoadedPluginsString());
+        return success;
+    }
+
     suspendProcessing(true);
-    bool success =
-        m_client->addPlugin(plugin.getId(), presets, params, hasEditor, scDisabled, {}, layout, monoChannels, err);
+    bool success = m_client->addPlugin(plugin.getId(), presets, params, hasEditor, scDisabled, {}, layout, monoChannels,
+                                       {}, err);
     suspendProcessing(false);
 
     if (success) {
@@ -1132,28 +1308,81 @@ bool PluginProcessor::loadPlugin(const ServerPlugin& plugin, const String& layou
     if (success) {
         updateLatency();
         updateRecents(plugin);
-        if (scDisabled && m_showSidechainDisabledInfo) {
-            struct cb : ModalComponentManager::Callback {
-                PluginProcessor* p;
-                cb(PluginProcessor* p_) : p(p_) {}
-                void modalStateFinished(int returnValue) override {
-                    if (returnValue == 0) {
-                        p->m_showSidechainDisabledInfo = false;
-                        p->saveConfig();
-                    }
-                }
-            };
-            AlertWindow::showOkCancelBox(AlertWindow::InfoIcon, "Sidechain Disabled",
-                                         "The server had to disable the sidechain input of the chain to make >" +
-                                             plugin.getName() +
-                                             "< load.\n\nPress CANCEL to permanently hide this message.",
-                                         "OK", "Cancel", nullptr, new cb(this));
+        if (scDisabled) {
+            showSidechainDisabledInfo(plugin.getName());
         }
     }
     m_client->setLoadedPluginsString(getLoadedPluginsString());
     return success;
 }
 
+void PluginProcessor::setPluginHost(int idx, const String& host) {
+    traceScope();
+
+    {
+        std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+        if (idx < 0 || (size_t)idx >= m_loadedPlugins.size() || m_loadedPlugins[(size_t)idx].host == host) {
+            return;
+        }
+        auto& plug = m_loadedPlugins[(size_t)idx];
+        if (m_client->isReadyLockFree()) {
+            plug.settings = m_client->getPluginSettings(idx, plug.settings);
+        }
+        plug.host = host;
+        logln("moving " << plug.name << " to " << (host.isNotEmpty() ? host : String("the connected server")));
+    }
+
+    // the chain gets reloaded with the new placement
+    m_client->reconnect();
+}
+
+std::vector<Client::RestorePlugin> PluginProcessor::getChainForMigration() {
+    traceScope();
+
+    std::vector<Client::RestorePlugin> plugins;
+    std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+    for (int i = 0; i < (int)m_loadedPlugins.size(); i++) {
+        auto& plug = m_loadedPlugins[(size_t)i];
+        if (plug.ok && m_client->isReadyLockFree()) {
+            auto settings = m_client->getPluginSettings(i, plug.settings);
+            if (settings.length() > 0) {
+                plug.settings = std::move(settings);
+            }
+        }
+        plugins.push_back(plug.toRestorePlugin());
+    }
+    return plugins;
+}
+
+void PluginProcessor::migrationDone(std::vector<Client::RestorePlugin>& plugins) {
+    traceScope();
+
+    {
+        std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+        for (size_t i = 0; i < plugins.size() && i < m_loadedPlugins.size(); i++) {
+            auto& p = m_loadedPlugins[i];
+            auto& r = plugins[i];
+            p.ok = r.ok;
+            p.error = r.err;
+            p.presets = std::move(r.presets);
+            p.params = std::move(r.params);
+            p.hasEditor = r.hasEditor;
+        }
+    }
+    m_client->setLoadedPluginsString(getLoadedPluginsString());
+    updateAuxBuses();
+    updateLatency();
+
+    runOnMsgThreadAsync([this] {
+        traceScope();
+        saveConfig();
+        auto* editor = getActiveEditor();
+        if (editor != nullptr) {
+            dynamic_cast<PluginEditor*>(editor)->setConnected(true);
+        }
+    });
+}
+
 void PluginProcessor::unloadPlugin(int idx) {
     traceScope();
 
@@ -1544,6 +1773,68 @@ void PluginProcessor::updateParameterGestureTracking(int idx, int channel, int p
     });
 }
 
+void PluginProcessor::showSidechainDisabledInfo(const String& name) {
+    if (!m_showSidechainDisabledInfo) {
+        return;
+    }
+    struct cb : ModalComponentManager::Callback {
+        PluginProcessor* p;
+        cb(PluginProcessor* p_) : p(p_) {}
+        void modalStateFinished(int returnValue) override {
+            if (returnValue == 0) {
+                p->m_showSidechainDisabledInfo = false;
+                p->saveConfig();
+            }
+        }
+    };
+    AlertWindow::showOkCancelBox(AlertWindow::InfoIcon, "Sidechain Disabled",
+                                 "The server had to disable the sidechain input of the chain to make >" + name +
+                                     "< load.\n\nPress CANCEL to permanently hide this message.",
+                                 "OK", "Cancel", nullptr, new cb(this));
+}
+
+void PluginProcessor::updatePluginLoaded(int idx, bool ok, const String& err, const StringArray& presets,
+                                         const Client::ParameterByChannelList& params, bool hasEditor,
+                                         bool scDisabled) {
+    traceScope();
+    String name;
+    {
+        std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+
+        if (idx < 0 || idx >= (int)m_loadedPlugins.size()) {
+            logln("updatePluginLoaded failed: idx out of range");
+            return;
+        }
+
+        auto& plug = m_loadedPlugins[(size_t)idx];
+        plug.presets = presets;
+        plug.params = params;
+        plug.hasEditor = hasEditor;
+        plug.ok = ok;
+        plug.error = err;
+        name = plug.name;
+    }
+
+    if (ok) {
+        logln("loaded " << name << " at idx " << idx);
+        updateLatency();
+    } else {
+        logln("loading " << name << " at idx " << idx << " failed: " << err);
+        m_loadedPluginsOk = false;
+    }
+
+    m_client->setLoadedPluginsString(getLoadedPluginsString());
+
+    runOnMsgThreadAsync([this, idx, ok, err, scDisabled, name] {
+        if (ok && scDisabled) {
+            showSidechainDisabledInfo(name);
+        }
+        if (auto* e = dynamic_cast<PluginEditor*>(getActiveEditor())) {
+            e->updatePluginLoaded(idx, ok, err);
+        }
+    });
+}
+
 void PluginProcessor::updatePluginStatus(int idx, bool ok, const String& err) {
     {
         std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
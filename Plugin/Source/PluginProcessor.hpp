@@ -136,7 +136,8 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
             LAYOUT,
             MONO_CHANNELS,
             ACTIVE_CHANNEL,
-            PARAMSLIST
+            PARAMSLIST,
+            HOST
         };
         enum Indexes_v1 : uint8 { BYPASSED_V1 = 3 };
 
@@ -150,11 +151,25 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
         Client::ParameterByChannelList params;
         bool bypassed = false;
         String id;
+        // the server running the plugin, if it's not the connected server (chain hop)
+        String host;
 
         bool hasEditor = true;
         bool ok = false;
         String error;
 
+        Client::RestorePlugin toRestorePlugin() const {
+            Client::RestorePlugin r;
+            r.id = id;
+            r.settings = settings;
+            r.layout = layout;
+            r.monoChannels = monoChannels.toInt();
+            r.host = host;
+            r.bypassed = bypassed;
+            r.params = params;
+            return r;
+        }
+
         json toJson() {
             auto jpresets = json::array();
             for (auto& p : presets) {
@@ -184,7 +199,8 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
                     layout.toStdString(),
                     monoChannels.toInt(),
                     activeChannel,
-                    jparams};
+                    jparams,
+                    host.toStdString()};
         }
 
         LoadedPlugin() {}
@@ -230,6 +246,9 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
                         }
                     }
                 }
+                if (version >= 7) {
+                    host = j[HOST].get<std::string>();
+                }
             } catch (const json::exception& e) {
                 setLogTagStatic("loadedplugin");
                 logln("failed to deserialize loaded plugin: " << e.what());
@@ -308,6 +327,9 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
     void updateParameterValue(int idx, int channel, int paramIdx, float val, bool updateServer = true);
     void updateParameterGestureTracking(int idx, int channel, int paramIdx, bool starting);
     void updatePluginStatus(int idx, bool ok, const String& err);
+    void updatePluginLoaded(int idx, bool ok, const String& err, const StringArray& presets,
+                            const Client::ParameterByChannelList& params, bool hasEditor, bool scDisabled);
+    void showSidechainDisabledInfo(const String& name);
     void increaseSCArea();
     void decreaseSCArea();
     void toggleFullscreenSCArea();
@@ -330,8 +352,37 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
     void setConfirmDelete(bool b) { m_confirmDelete = b; }
     bool getShowSidechainDisabledInfo() const { return m_showSidechainDisabledInfo; }
     void setShowSidechainDisabledInfo(bool b) { m_showSidechainDisabledInfo = b; }
+    // Moves a plugin to another server, the connected server streams the audio to it (empty host: connected server)
+    void setPluginHost(int idx, const String& host);
+
+    // The current chain with up to date settings, used to load it on another server
+    std::vector<Client::RestorePlugin> getChainForMigration();
+    // Takes over the results of loading the chain on the new server
+    void migrationDone(std::vector<Client::RestorePlugin>& plugins);
+
+    // Fades the buffer linearly over to the target, continuing at fadePos. Returns true, when the fade is complete.
+    template <typename T>
+    static bool crossfade(AudioBuffer<T>& buffer, const AudioBuffer<T>& target, int& fadePos, int fadeSamples) {
+        int numSamples = jmin(buffer.getNumSamples(), target.getNumSamples());
+        int numChannels = jmin(buffer.getNumChannels(), target.getNumChannels());
+        for (int ch = 0; ch < numChannels; ch++) {
+            auto* out = buffer.getWritePointer(ch);
+            auto* in = target.getReadPointer(ch);
+            for (int i = 0; i < numSamples; i++) {
+                auto gain = (T)jmin(1.0, (double)(fadePos + i) / fadeSamples);
+                out[i] = out[i] * ((T)1 - gain) + in[i] * gain;
+            }
+        }
+        fadePos += numSamples;
+        return fadePos >= fadeSamples;
+    }
+
     bool getNoSrvPluginListFilter() const { return m_noSrvPluginListFilter; }
     void setNoSrvPluginListFilter(bool b) { m_noSrvPluginListFilter = b; }
+
+    enum ServerSelection : int { SS_MANUAL, SS_LEAST_LOADED, SS_LOWEST_RTT };
+    ServerSelection getServerSelection() const { return (ServerSelection)m_serverSelection.load(); }
+    void setServerSelection(ServerSelection s) { m_serverSelection = s; }
     float getScaleFactor() const { return m_scale; }
     void setScaleFactor(float f) { m_scale = f; }
     bool getCrashReporting() const { return m_crashReporting; }
@@ -397,6 +448,17 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
     int getNumBuffers() const { return m_client->NUM_OF_BUFFERS; }
     void setNumBuffers(int n);
 
+    // Shared aux buses on the server: the output of the chain gets mixed into the send bus, the receive bus gets
+    // mixed into the input of the chain
+    struct AuxBuses {
+        String send;
+        float sendLevel = 1.0f;
+        String receive;
+    };
+    AuxBuses getAuxBuses();
+    void setAuxBuses(const AuxBuses& buses);
+    void updateAuxBuses();
+
     // AudioProcessorParameter::Listener
     void parameterValueChanged(int parameterIndex, float newValue) override;
     void parameterGestureChanged(int, bool) override {}
@@ -520,6 +582,7 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
     bool m_confirmDelete = true;
     bool m_showSidechainDisabledInfo = true;
     bool m_noSrvPluginListFilter = false;
+    std::atomic_int m_serverSelection{SS_MANUAL};
     float m_scale = 1.0;
     bool m_crashReporting = true;
 
@@ -532,6 +595,9 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
     std::atomic_bool m_bypassWhenNotConnected{false};
     bool m_bufferSizeByPlugin = false;
 
+    AuxBuses m_auxBuses;
+    std::mutex m_auxBusesMtx;
+
     TrackProperties m_trackProperties;
     std::mutex m_trackPropertiesMtx;
 
@@ -616,6 +682,20 @@ class PluginProcessor : public AudioProcessor, public AudioProcessorParameter::L
     template <typename T>
     void processBlockBypassedInternal(AudioBuffer<T>& buf, AudioRingBuffer<T>& bypassBuffer);
 
+    // Crossfade to the output of the migration target, only used by the audio thread
+    static constexpr int MIGRATION_CROSSFADE_MS = 20;
+    static constexpr size_t MIGRATION_MIDI_BYTES = 4096;
+    int m_migrationFadePos = 0;
+    AudioBuffer<float> m_migrationBufferF;
+    AudioBuffer<double> m_migrationBufferD;
+    MidiBuffer m_migrationMidi;
+
+    AudioBuffer<float>& getMigrationBuffer(const AudioBuffer<float>&) { return m_migrationBufferF; }
+    AudioBuffer<double>& getMigrationBuffer(const AudioBuffer<double>&) { return m_migrationBufferD; }
+
+    template <typename T>
+    void processMigration(AudioBuffer<T>& buf, MidiBuffer& midi, AudioBuffer<T>& target, MidiBuffer& targetMidi);
+
     LoadedPlugin& getLoadedPluginNoLock(int idx) {
         return idx > -1 && idx < (int)m_loadedPlugins.size() ? m_loadedPlugins[(size_t)idx] : m_unusedDummyPlugin;
     }
@@ -8,6 +8,7 @@
 #include "StatisticsWindow.hpp"
 #include "Client.hpp"
 #include "Metrics.hpp"
+#include "LowLatencyWait.hpp"
 #include "PluginEditor.hpp"
 #include "WindowPositions.hpp"
 
@@ -130,13 +131,29 @@ StatisticsWindow::StatisticsWindow()
 
     row++;
 
+    addLabel("Concealed blocks (per minute):", getLabelBounds(row, 15));
+    m_audioConcealments.setBounds(getFieldBounds(row));
+    m_audioConcealments.setJustificationType(Justification::right);
+    addChildAndSetID(&m_audioConcealments, "netconceal");
+
+    row++;
+
+    addLabel("Wakeup jitter (95th percentile):", getLabelBounds(row, 15));
+    m_audioWakeupJitter.setBounds(getFieldBounds(row));
+    m_audioWakeupJitter.setJustificationType(Justification::right);
+    addChildAndSetID(&m_audioWakeupJitter, "netjitter");
+
+    row++;
+
     totalHeight += row * rowHeight;
 
     auto audioTime = Metrics::getStatistic<TimeStatistic>("audio_stream");
     auto bytesOutMeter = Metrics::getStatistic<Meter>("NetBytesOut");
     auto bytesInMeter = Metrics::getStatistic<Meter>("NetBytesIn");
+    auto concealmentMeter = Metrics::getStatistic<Meter>("AudioConcealments");
+    auto wakeupJitter = LowLatencyWait::getJitterStatistic();
 
-    m_updater.set([this, audioTime, bytesOutMeter, bytesInMeter] {
+    m_updater.set([this, audioTime, bytesOutMeter, bytesInMeter, concealmentMeter, wakeupJitter] {
         traceScope();
         m_totalClients.setText(String(Client::count), NotificationType::dontSendNotification);
         auto hist = audioTime->get1minHistogram();
@@ -169,6 +186,10 @@ StatisticsWindow::StatisticsWindow()
         }
         m_audioBytesOut.setText(String(netOut, 2) + dataUnitOut, NotificationType::dontSendNotification);
         m_audioBytesIn.setText(String(netIn, 2) + dataUnitIn, NotificationType::dontSendNotification);
+        m_audioConcealments.setText(String(lround(concealmentMeter->rate_1min() * 60)),
+                                    NotificationType::dontSendNotification);
+        m_audioWakeupJitter.setText(String(wakeupJitter->get1minHistogram().nintyFifth, 3) + " ms",
+                                    NotificationType::dontSendNotification);
     });
     m_updater.startThread();
 
@@ -17,6 +17,7 @@
 #include "PluginListWindow.hpp"
 #include "StatisticsWindow.hpp"
 #include "SplashWindow.hpp"
+#include "BatchProcessor.hpp"
 
 #ifdef JUCE_WINDOWS
 #include <windows.h>
@@ -31,22 +32,30 @@ App::~App() { stopAsyncFunctors(); }
 
 void App::initialise(const String& commandLineParameters) {
     auto args = getCommandLineParameterArray();
-    enum Modes { SCAN, MASTER, SERVER, SANDBOX_CHAIN, SANDBOX_PLUGIN };
+    enum Modes { SCAN, SCAN_WORKER, MASTER, SERVER, SANDBOX_CHAIN, SANDBOX_PLUGIN, BATCH };
     Modes mode = MASTER;
     String fileToScan, pluginId, clientId, error;
     int workerPort = 0, srvId = -1;
     json jconfig;
-    bool log = false, isLocal = false, secondRun = false;
+    bool log = false, isLocal = false, secondRun = false, host = false, fullStartup = false;
     for (int i = 0; i < args.size(); i++) {
         if (!args[i].compare("-scan") && args.size() >= i + 2) {
             fileToScan = args[++i];
             mode = SCAN;
+        } else if (!args[i].compare("-scanworker")) {
+            mode = SCAN_WORKER;
         } else if (!args[i].compare("-server")) {
             mode = SERVER;
+        } else if (!args[i].compare("-batch")) {
+            mode = BATCH;
         } else if (args[i].startsWith("--" + Defaults::SANDBOX_CMD_PREFIX)) {
             mode = SANDBOX_CHAIN;
         } else if (!args[i].compare("-load")) {
             mode = SANDBOX_PLUGIN;
+        } else if (!args[i].compare("-host")) {
+            host = true;
+        } else if (!args[i].compare("-fullstartup")) {
+            fullStartup = true;
         } else if (!args[i].compare("-log")) {
             log = true;
         } else if (!args[i].compare("-secondrun")) {
@@ -87,9 +96,13 @@ void App::initialise(const String& commandLineParameters) {
             logName = fileToScan + "_";
             logName = logName.replaceCharacters(":/\\|. ", "------").trimCharactersAtStart("-");
             break;
+        case SCAN_WORKER:
+            appName = "Scan";
+            logName = "worker-" + String(srvId) + "_";
+            break;
         case SANDBOX_PLUGIN:
             appName = "Sandbox-Plugin";
-            logName = pluginId + "_";
+            logName = (host ? "host-" + String(workerPort) : pluginId) + "_";
             linkLatest = false;
             break;
         case SANDBOX_CHAIN:
@@ -100,6 +113,10 @@ void App::initialise(const String& commandLineParameters) {
         case SERVER:
             appName = "Server";
             break;
+        case BATCH:
+            appName = "Batch";
+            logName = "batch_";
+            break;
     }
     Logger::initialize(appName, logName, cfgFile, linkLatest);
     Tracer::initialize(appName, logName, linkLatest);
@@ -143,6 +160,26 @@ void App::initialise(const String& commandLineParameters) {
                 quit();
             }
             break;
+        case SCAN_WORKER:
+#ifdef JUCE_MAC
+            Process::setDockIconVisible(false);
+#endif
+            Logger::setEnabled(true);
+            setApplicationReturnValue(ScanWorker::runWorkerProcess(srvId > -1 ? srvId : 0));
+            quit();
+            break;
+        case BATCH:
+#ifdef JUCE_MAC
+            Process::setDockIconVisible(false);
+#endif
+            Logger::setEnabled(true);
+            Logger::setLogToErr(true);
+            // the plugins get instantiated on the message thread, so the processing has to run in the background
+            m_child = std::make_unique<std::thread>([this, srvId, args] {
+                m_exitCode = (uint32)BatchProcessor::runBatchProcess(srvId > -1 ? srvId : 0, args);
+                quit();
+            });
+            break;
         case SERVER: {
             traceScope();
             showSplashWindow();
@@ -196,6 +233,8 @@ void App::initialise(const String& commandLineParameters) {
                          {"commandLine", commandLineParameters.toStdString()},
                          {"pluginId", pluginId.toStdString()},
                          {"workerPort", workerPort},
+                         {"host", host},
+                         {"fullStartup", fullStartup},
                          {"config", jconfig}};
             if (srvId > -1) {
                 opts["ID"] = srvId;
@@ -13,6 +13,7 @@
 #include "Server.hpp"
 #include "Metrics.hpp"
 #include "Processor.hpp"
+#include "RealtimeCheck.hpp"
 
 namespace e47 {
 
@@ -30,8 +31,15 @@ AudioWorker::~AudioWorker() {
         m_socket->close();
     }
     waitForThreadAndLog(getLogTagSource(), this);
+    m_pluginLoader.reset();
     m_socket.reset();
     m_chain.reset();
+    if (nullptr != m_auxSend) {
+        m_auxSend->removeSender(getTagId());
+    }
+    if (nullptr != m_auxReceive) {
+        m_auxReceive->removeReceiver(getTagId());
+    }
 }
 
 void AudioWorker::init(std::unique_ptr<StreamingSocket> s, HandshakeRequest cfg) {
@@ -44,6 +52,11 @@ void AudioWorker::init(std::unique_ptr<StreamingSocket> s, HandshakeRequest cfg)
     m_channelsOut = cfg.channelsOut;
     m_channelsSC = cfg.channelsSC;
     m_activeChannels = cfg.activeChannels;
+    m_offlineRender = cfg.isFlag(HandshakeRequest::OFFLINE_RENDER);
+    if (auto srv = getApp()->getServer()) {
+        m_lowLatency = srv->getLowLatencyMode();
+    }
+    enableBusyPoll();
     m_activeChannels.setWithInput(m_channelsIn > 0);
     m_activeChannels.setNumChannels(m_channelsIn + m_channelsSC, m_channelsOut);
     m_channelMapper.createServerMapping(m_activeChannels);
@@ -56,9 +69,79 @@ void AudioWorker::init(std::unique_ptr<StreamingSocket> s, HandshakeRequest cfg)
     m_chain->updateChannels(m_channelsIn, m_channelsOut, m_channelsSC);
 }
 
-bool AudioWorker::waitForData() {
+void AudioWorker::resume(std::unique_ptr<StreamingSocket> s) {
+    traceScope();
     std::lock_guard<std::mutex> lock(m_mtx);
-    return m_socket->waitUntilReady(true, 50);
+    m_socket = std::move(s);
+    m_error.clear();
+    m_wasOk = true;
+    enableBusyPoll();
+}
+
+void AudioWorker::reconfigure(double sampleRate, int samplesPerBlock) {
+    traceScope();
+    logln("reconfiguring: rate=" << m_sampleRate << "->" << sampleRate << ", samplesPerBlock=" << m_samplesPerBlock
+                                 << "->" << samplesPerBlock);
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_chain->releaseResources();
+    m_sampleRate = sampleRate;
+    m_samplesPerBlock = samplesPerBlock;
+    m_chain->setConfig(sampleRate, samplesPerBlock);
+    m_chain->prepareToPlay(sampleRate, samplesPerBlock);
+    m_chain->update();
+    registerAuxBuses();
+}
+
+void AudioWorker::setAuxBuses(const String& send, float sendLevel, const String& receive) {
+    traceScope();
+    logln("aux buses: send=" << (send.isNotEmpty() ? send : String("off")) << " (level " << sendLevel
+                             << "), receive=" << (receive.isNotEmpty() ? receive : String("off")));
+    if (send.isNotEmpty() && send == receive) {
+        logln("error: sending to the receive bus would create a feedback loop, ignoring the aux buses");
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (nullptr == m_auxSend || m_auxSend->getName() != send) {
+        if (nullptr != m_auxSend) {
+            m_auxSend->removeSender(getTagId());
+        }
+        m_auxSend = send.isNotEmpty() ? AuxBus::getBus(send) : nullptr;
+    }
+    m_auxSendLevel = sendLevel;
+    if (nullptr == m_auxReceive || m_auxReceive->getName() != receive) {
+        if (nullptr != m_auxReceive) {
+            m_auxReceive->removeReceiver(getTagId());
+        }
+        m_auxReceive = receive.isNotEmpty() ? AuxBus::getBus(receive) : nullptr;
+    }
+    registerAuxBuses();
+}
+
+void AudioWorker::registerAuxBuses() {
+    // the FIFOs get sized here, the audio thread must not allocate
+    if (nullptr != m_auxSend && !m_auxSend->addSender(getTagId(), m_channelsOut, m_samplesPerBlock, m_sampleRate)) {
+        logln("error: sample rate mismatch, not sending to aux bus '" << m_auxSend->getName() << "'");
+        m_auxSend.reset();
+    }
+    if (nullptr != m_auxReceive && !m_auxReceive->addReceiver(getTagId(), m_samplesPerBlock, m_sampleRate)) {
+        logln("error: sample rate mismatch, not receiving from aux bus '" << m_auxReceive->getName() << "'");
+        m_auxReceive.reset();
+    }
+}
+
+bool AudioWorker::waitForData() {
+    // no lock while waiting, as the other threads would have to wait for the spinning. The socket gets replaced only,
+    // when the audio thread is not running, and closing it from another thread makes the wait return.
+    return m_dataWait.wait(m_lowLatency, 50, [this](int timeoutMs) {
+        // an error has to be handled by the reader
+        return m_socket->waitUntilReady(true, timeoutMs) != 0;
+    });
+}
+
+void AudioWorker::enableBusyPoll() {
+    if (m_lowLatency && !setBusyPoll(m_socket.get(), Defaults::BUSY_POLL_USEC)) {
+        logln("busy polling is not available for the audio socket, spinning only");
+    }
 }
 
 void AudioWorker::run() {
@@ -73,6 +156,7 @@ void AudioWorker::run() {
     auto duration = TimeStatistic::getDuration("audio");
     auto bytesIn = Metrics::getStatistic<Meter>("NetBytesIn");
     auto bytesOut = Metrics::getStatistic<Meter>("NetBytesOut");
+    auto deadlineMisses = Metrics::getStatistic<Meter>("DeadlineMisses");
 
     ProcessorChain::PlayHead playHead(&posInfo);
     m_chain->prepareToPlay(m_sampleRate, m_samplesPerBlock);
@@ -85,9 +169,7 @@ void AudioWorker::run() {
     if (auto srv = getApp()->getServer()) {
         processingThresholdMs = srv->getProcessingTraceTresholdMs();
     }
-    if (processingThresholdMs <= 0.0) {
-        processingThresholdMs = m_samplesPerBlock / m_sampleRate * 1000 - 1;
-    }
+    bool blockThreshold = processingThresholdMs <= 0.0;
 
     MessageHelper::Error e;
     while (!threadShouldExit() && isOk()) {
@@ -111,18 +193,20 @@ void AudioWorker::run() {
                     m_socket->close();
                     break;
                 }
+                // offline blocks get processed back to back as fast as possible, there is no deadline to meet
+                bool offline = m_offlineRender && msg.isOffline();
                 bool sendOk;
                 if (msg.isDouble()) {
                     if (m_chain->supportsDoublePrecisionProcessing()) {
                         traceCtx->add("aw_prep");
                         traceCtx->startGroup();
-                        processBlock(bufferD, midi);
+                        processBlock(bufferD, midi, offline);
                         traceCtx->finishGroup("aw_process");
                     } else {
                         bufferF.makeCopyOf(bufferD);
                         traceCtx->add("aw_prep");
                         traceCtx->startGroup();
-                        processBlock(bufferF, midi);
+                        processBlock(bufferF, midi, offline);
                         traceCtx->finishGroup("aw_process");
                         bufferD.makeCopyOf(bufferF);
                     }
@@ -132,17 +216,25 @@ void AudioWorker::run() {
                 } else {
                     traceCtx->add("aw_prep");
                     traceCtx->startGroup();
-                    processBlock(bufferF, midi);
+                    processBlock(bufferF, midi, offline);
                     traceCtx->finishGroup("aw_process");
                     sendOk = msg.sendToClient(m_socket.get(), bufferF, midi, m_chain->getLatencySamples(),
                                               bufferF.getNumChannels(), &e, *bytesOut);
                 }
-                traceCtx->summary(getLogTagSource(), "process audio", processingThresholdMs);
+                if (!offline) {
+                    // the block size can change at runtime
+                    traceCtx->summary(getLogTagSource(), "process audio",
+                                      blockThreshold ? m_samplesPerBlock / m_sampleRate * 1000 - 1
+                                                     : processingThresholdMs);
+                }
                 if (!sendOk) {
                     logln("error: failed to send audio data to client: " << e.toString());
                     m_socket->close();
                 }
-                duration.update();
+                // a block that takes longer than its own duration can't be played back in time
+                if (duration.update() > m_samplesPerBlock / m_sampleRate * 1000 && !offline) {
+                    deadlineMisses->increment();
+                }
             } else {
                 logln("error: failed to read audio message: " << e.toString());
                 m_socket->close();
@@ -153,9 +245,10 @@ void AudioWorker::run() {
     TimeTrace::deleteTraceContext();
 
     m_chain->setPlayHead(nullptr);
+    // the chain outlives the connection, if the session gets resumed
+    m_chain->releaseResources();
 
     duration.clear();
-    clear();
 
     if (m_error.isNotEmpty()) {
         logln("audio processor error: " << m_error);
@@ -170,10 +263,20 @@ AudioBuffer<double>* AudioWorker::getProcBuffer() {
 }
 
 template <typename T>
-void AudioWorker::processBlock(AudioBuffer<T>& buffer, MidiBuffer& midi) {
+void AudioWorker::processBlock(AudioBuffer<T>& buffer, MidiBuffer& midi, bool offline) {
+    if (offline) {
+        processBlockInternal(buffer, midi);
+    } else {
+        RealtimeCheck::Scope rtScope;
+        processBlockInternal(buffer, midi);
+    }
+}
+
+template <typename T>
+void AudioWorker::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& midi) {
     int numChannels = jmax(m_channelsIn + m_channelsSC, m_channelsOut) + m_chain->getExtraChannels();
     if (numChannels <= buffer.getNumChannels()) {
-        m_chain->processBlock(buffer, midi);
+        processChain(buffer, midi);
     } else {
         // we received fewer channels, now we need to map the input/output data
         auto* procBuffer = getProcBuffer<T>();
@@ -184,28 +287,130 @@ void AudioWorker::processBlock(AudioBuffer<T>& buffer, MidiBuffer& midi) {
         } else {
             procBuffer->clear();
         }
-        m_chain->processBlock(*procBuffer, midi);
+        processChain(*procBuffer, midi);
         m_channelMapper.mapReverse(procBuffer, &buffer);
         TimeTrace::addTracePoint("pb_ch_map_reverse");
     }
 }
 
+template <typename T>
+void AudioWorker::processChain(AudioBuffer<T>& buffer, MidiBuffer& midi) {
+    // the workers of a bus are not ordered, so the bus input can be from the previous cycle of a sender (see AuxBus)
+    if (nullptr != m_auxReceive) {
+        m_auxReceive->receive(getTagId(), buffer, m_channelsIn);
+        TimeTrace::addTracePoint("aw_aux_receive");
+    }
+    m_chain->processBlock(buffer, midi);
+    if (nullptr != m_auxSend) {
+        m_auxSend->send(getTagId(), buffer, m_channelsOut, m_auxSendLevel);
+        TimeTrace::addTracePoint("aw_aux_send");
+    }
+}
+
 void AudioWorker::shutdown() {
     traceScope();
     signalThreadShouldExit();
 }
 
+void AudioWorker::closeSocket() {
+    traceScope();
+    // no lock, the audio thread might be waiting for data while holding it, closing a socket that another thread
+    // reads from is safe
+    if (nullptr != m_socket) {
+        m_socket->close();
+    }
+}
+
 void AudioWorker::clear() {
     traceScope();
+    m_pluginLoader.reset();
     if (nullptr != m_chain) {
         m_chain->clear();
     }
 }
 
 bool AudioWorker::addPlugin(const String& id, const String& settings, const String& layout, uint64 monoChannels,
-                            String& err) {
+                            const String& host, String& err) {
     traceScope();
-    return m_chain->addPluginProcessor(id, settings, layout, monoChannels, err);
+    return m_chain->addPluginProcessor(id, settings, layout, monoChannels, host, err);
+}
+
+int AudioWorker::addPluginAsync(const String& id, const String& settings, const String& layout, uint64 monoChannels,
+                                const String& host, PluginLoadedCallback fn) {
+    traceScope();
+    if (nullptr == m_pluginLoader) {
+        m_pluginLoader = std::make_unique<PluginLoader>();
+    }
+    auto proc = m_chain->reserveProcessor(id, host);
+    int idx = getSize() - 1;
+    m_pluginLoader->add([this, chain = m_chain, proc, settings, layout, monoChannels, fn] {
+        traceScope();
+        String err;
+        bool success = proc->load(settings, layout, monoChannels, err);
+        auto name = proc->getName();
+        if (name.isEmpty()) {
+            name = proc->getPluginId();
+        }
+        logln("loading a plugin instance of '" << name << "' in the background "
+                                               << (success ? "succeeded" : "failed: " + err));
+        int finalIdx = chain->spliceProcessor(proc);
+        if (finalIdx < 0) {
+            logln("plugin '" << name << "' has been removed while loading");
+            proc->unload();
+        }
+        fn(proc, finalIdx, success, err);
+    });
+    return idx;
+}
+
+std::vector<std::shared_ptr<Processor>> AudioWorker::restorePlugins(const std::vector<PluginSpec>& plugins,
+                                                                    PluginRestoredCallback fn) {
+    traceScope();
+
+    // reserve the slots first, so the order is kept no matter which plugin finishes first
+    std::vector<std::shared_ptr<Processor>> procs;
+    for (auto& spec : plugins) {
+        procs.push_back(m_chain->reserveProcessor(spec.id, spec.host));
+    }
+
+    // plugin instantiation happens on the message thread, but looking up descriptions, preparing, setting the
+    // state and sandbox startup can run in parallel
+    int numThreads = jlimit(1, jmax(1, SystemStats::getNumCpus()), (int)plugins.size());
+    logln("restoring " << plugins.size() << " plugins using " << numThreads << " thread(s)");
+
+    std::atomic_int next{0};
+    std::mutex fnMtx;
+    std::vector<std::unique_ptr<FnThread>> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::make_unique<FnThread>(
+            [&] {
+                int num;
+                while ((num = next++) < (int)plugins.size()) {
+                    auto& spec = plugins[(size_t)num];
+                    auto& proc = procs[(size_t)num];
+                    String err = spec.err;
+                    bool success = err.isEmpty() && proc->load(spec.settings, spec.layout, spec.monoChannels, err);
+                    auto name = proc->getName();
+                    if (name.isEmpty()) {
+                        name = spec.id;
+                    }
+                    logln("loading a plugin instance of '" << name << "' "
+                                                           << (success ? "succeeded" : "failed: " + err));
+                    std::lock_guard<std::mutex> lock(fnMtx);
+                    fn(num, proc, success, err);
+                }
+            },
+            "RestoreThread", true));
+    }
+    for (auto& t : threads) {
+        t->waitForThreadToExit(-1);
+    }
+
+    for (auto& proc : procs) {
+        m_chain->spliceProcessor(proc);
+    }
+
+    return procs;
 }
 
 void AudioWorker::delPlugin(int idx) {
@@ -234,6 +439,20 @@ String AudioWorker::getRecentsList(String host) const {
     return list;
 }
 
+StringArray AudioWorker::getRecentsIds(const String& host) {
+    setLogTagStatic("audioworker");
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_recentsMtx);
+    StringArray ids;
+    auto it = m_recents.find(host);
+    if (it != m_recents.end()) {
+        for (auto& r : it->second) {
+            ids.add(Processor::createPluginID(r));
+        }
+    }
+    return ids;
+}
+
 void AudioWorker::addToRecentsList(const String& id, const String& host) {
     traceScope();
     auto plug = Processor::findPluginDescription(id);
@@ -11,11 +11,15 @@
 #include <JuceHeader.h>
 #include <thread>
 #include <unordered_map>
+#include <deque>
+#include <condition_variable>
 
 #include "ProcessorChain.hpp"
 #include "Message.hpp"
 #include "Utils.hpp"
 #include "ChannelMapper.hpp"
+#include "AuxBus.hpp"
+#include "LowLatencyWait.hpp"
 
 namespace e47 {
 
@@ -34,10 +38,23 @@ class AudioWorker : public Thread, public LogTagDelegate {
 
     void init(std::unique_ptr<StreamingSocket> s, HandshakeRequest cfg);
 
+    // Continues processing with the existing chain on a new connection of a resumed session
+    void resume(std::unique_ptr<StreamingSocket> s);
+
+    // Prepares the existing chain for a new sample rate and block size, the plugins stay loaded
+    void reconfigure(double sampleRate, int samplesPerBlock);
+
+    // Shared aux buses: the output of the chain gets mixed into the send bus and the receive bus gets mixed into the
+    // input of the chain. Empty names disable the send/receive.
+    void setAuxBuses(const String& send, float sendLevel, const String& receive);
+
     void run() override;
     void shutdown();
     void clear();
 
+    // Drops the client connection, the processing loop terminates as soon as it notices
+    void closeSocket();
+
     bool isOk() {
         std::lock_guard<std::mutex> lock(m_mtx);
         if (nullptr == m_socket) {
@@ -58,10 +75,38 @@ class AudioWorker : public Thread, public LogTagDelegate {
     int getChannelsOut() const { return m_channelsOut; }
     int getChannelsSC() const { return m_channelsSC; }
 
-    bool addPlugin(const String& id, const String& settings, const String& layout, uint64 monoChannels, String& err);
+    // A non empty host makes the plugin run on another server (chain hop)
+    bool addPlugin(const String& id, const String& settings, const String& layout, uint64 monoChannels,
+                   const String& host, String& err);
+
+    // Loads a plugin in the background and splices it into the chain, while audio keeps running. Returns the reserved
+    // index. The callback is called from the loader thread with the final index, that is -1 if the plugin has been
+    // removed before it finished loading.
+    using PluginLoadedCallback =
+        std::function<void(std::shared_ptr<Processor> proc, int idx, bool success, const String& err)>;
+    int addPluginAsync(const String& id, const String& settings, const String& layout, uint64 monoChannels,
+                       const String& host, PluginLoadedCallback fn);
+
+    struct PluginSpec {
+        String id;
+        String settings;
+        String layout;
+        uint64 monoChannels = 0;
+        String host;
+        // a plugin, that has been rejected already, keeps its slot but does not get loaded
+        String err;
+    };
+
+    // Loads the given plugins concurrently and appends them to the chain in the given order. Returns the processors,
+    // failed ones are appended as well. The callback gets called for each plugin, when it finished loading.
+    using PluginRestoredCallback =
+        std::function<void(int num, std::shared_ptr<Processor> proc, bool success, const String& err)>;
+    std::vector<std::shared_ptr<Processor>> restorePlugins(const std::vector<PluginSpec>& plugins,
+                                                           PluginRestoredCallback fn);
     void delPlugin(int idx);
     void exchangePlugins(int idxA, int idxB);
     std::shared_ptr<Processor> getProcessor(int idx) const { return m_chain->getProcessor(idx); }
+    std::shared_ptr<Processor> getLoadingProcessor(int idx) const { return m_chain->getLoadingProcessor(idx); }
     int getSize() const { return static_cast<int>(m_chain->getSize()); }
     int getLatencySamples() const { return m_chain->getLatencySamples(); }
     void update() { m_chain->update(); }
@@ -79,6 +124,7 @@ class AudioWorker : public Thread, public LogTagDelegate {
     using RecentsListType = Array<ComparablePluginDescription>;
     String getRecentsList(String host) const;
     void addToRecentsList(const String& id, const String& host);
+    static StringArray getRecentsIds(const String& host);
 
   private:
     std::mutex m_mtx;
@@ -93,14 +139,62 @@ class AudioWorker : public Thread, public LogTagDelegate {
     double m_sampleRate;
     int m_samplesPerBlock;
     bool m_doublePrecision;
+    bool m_offlineRender = false;
+    bool m_lowLatency = false;
+    LowLatencyWait m_dataWait{true};
     std::shared_ptr<ProcessorChain> m_chain;
+    std::shared_ptr<AuxBus> m_auxSend;
+    float m_auxSendLevel = 1.0f;
+    std::shared_ptr<AuxBus> m_auxReceive;
     static std::unordered_map<String, RecentsListType> m_recents;
     static std::mutex m_recentsMtx;
 
+    struct PluginLoader : Thread {
+        std::deque<std::function<void()>> jobs;
+        std::mutex mtx;
+        std::condition_variable cv;
+
+        PluginLoader() : Thread("PluginLoader") { startThread(); }
+
+        ~PluginLoader() override {
+            signalThreadShouldExit();
+            cv.notify_one();
+            stopThread(-1);
+        }
+
+        void add(std::function<void()> fn) {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                jobs.push_back(std::move(fn));
+            }
+            cv.notify_one();
+        }
+
+        void run() override {
+            while (!threadShouldExit()) {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [this] { return threadShouldExit() || !jobs.empty(); });
+                    if (threadShouldExit()) {
+                        break;
+                    }
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                }
+                job();
+            }
+        }
+    };
+
+    std::unique_ptr<PluginLoader> m_pluginLoader;
+
     AudioBuffer<float> m_procBufferF;
     AudioBuffer<double> m_procBufferD;
 
     bool waitForData();
+    void enableBusyPoll();
+    void registerAuxBuses();
 
     template <typename T>
     AudioBuffer<T>* getProcBuffer() {
@@ -108,7 +202,13 @@ class AudioWorker : public Thread, public LogTagDelegate {
     }
 
     template <typename T>
-    void processBlock(AudioBuffer<T>& buffer, MidiBuffer& midi);
+    void processBlock(AudioBuffer<T>& buffer, MidiBuffer& midi, bool offline);
+
+    template <typename T>
+    void processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& midi);
+
+    template <typename T>
+    void processChain(AudioBuffer<T>& buffer, MidiBuffer& midi);
 
     ENABLE_ASYNC_FUNCTORS();
 };
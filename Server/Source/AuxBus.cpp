@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "AuxBus.hpp"
+
+namespace e47 {
+
+std::mutex AuxBus::m_busesMtx;
+std::unordered_map<String, std::weak_ptr<AuxBus>> AuxBus::m_buses;
+
+AuxBus::AuxBus(const String& name) : LogTag("auxbus"), m_name(name) {
+    traceScope();
+    logln("aux bus '" << m_name << "' created");
+}
+
+AuxBus::~AuxBus() {
+    traceScope();
+    logln("aux bus '" << m_name << "' removed (underruns: " << (int64)m_underruns.load() << ")");
+}
+
+std::shared_ptr<AuxBus> AuxBus::getBus(const String& name) {
+    std::lock_guard<std::mutex> lock(m_busesMtx);
+    auto& weak = m_buses[name];
+    auto bus = weak.lock();
+    if (nullptr == bus) {
+        bus = std::make_shared<AuxBus>(name);
+        weak = bus;
+    }
+    // drop buses, that are not referenced anymore
+    for (auto it = m_buses.begin(); it != m_buses.end();) {
+        if (it->second.expired()) {
+            it = m_buses.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return bus;
+}
+
+bool AuxBus::checkSampleRate(uint64 id, double sampleRate) {
+    bool hasOthers = false;
+    for (auto& s : m_senders) {
+        hasOthers |= s->id != id;
+    }
+    for (auto& r : m_receivers) {
+        hasOthers |= r.id != id;
+    }
+    if (hasOthers && sampleRate != m_sampleRate) {
+        logln("error: client " << String::toHexString(id) << " runs at " << sampleRate << " Hz, but aux bus '"
+                               << m_name << "' runs at " << m_sampleRate << " Hz");
+        return false;
+    }
+    m_sampleRate = sampleRate;
+    return true;
+}
+
+int AuxBus::getFifoSize(int blockSize) const {
+    // the reader consumes and skips in its own block size, so the FIFO has to cover the larger of both
+    for (auto& r : m_receivers) {
+        blockSize = jmax(blockSize, r.blockSize);
+    }
+    return blockSize * FIFO_BLOCKS;
+}
+
+void AuxBus::resetFifo(Sender& s, int numChannels) {
+    s.fifo.setSize(numChannels, getFifoSize(s.blockSize));
+    s.fifo.clear();
+    s.writePos = 0;
+    s.readPos.clear();
+    for (auto& r : m_receivers) {
+        s.readPos.push_back({r.id, 0});
+    }
+}
+
+AuxBus::Sender* AuxBus::findSender(uint64 senderId) {
+    for (auto& s : m_senders) {
+        if (s->id == senderId) {
+            return s.get();
+        }
+    }
+    return nullptr;
+}
+
+AuxBus::ReadPos* AuxBus::findReadPos(Sender& s, uint64 receiverId) {
+    for (auto& rp : s.readPos) {
+        if (rp.receiverId == receiverId) {
+            return &rp;
+        }
+    }
+    return nullptr;
+}
+
+bool AuxBus::addSender(uint64 senderId, int numChannels, int blockSize, double sampleRate) {
+    traceScope();
+    if (numChannels <= 0 || blockSize <= 0) {
+        removeSender(senderId);
+        return true;
+    }
+    Update update(*this);
+    if (!checkSampleRate(senderId, sampleRate)) {
+        return false;
+    }
+    auto* s = findSender(senderId);
+    if (nullptr == s) {
+        m_senders.push_back(std::make_unique<Sender>());
+        s = m_senders.back().get();
+        s->id = senderId;
+    }
+    s->blockSize = blockSize;
+    resetFifo(*s, numChannels);
+    return true;
+}
+
+void AuxBus::removeSender(uint64 senderId) {
+    traceScope();
+    Update update(*this);
+    m_senders.erase(std::remove_if(m_senders.begin(), m_senders.end(),
+                                   [senderId](const std::unique_ptr<Sender>& s) { return s->id == senderId; }),
+                    m_senders.end());
+}
+
+bool AuxBus::addReceiver(uint64 receiverId, int blockSize, double sampleRate) {
+    traceScope();
+    if (blockSize <= 0) {
+        removeReceiver(receiverId);
+        return true;
+    }
+    Update update(*this);
+    if (!checkSampleRate(receiverId, sampleRate)) {
+        return false;
+    }
+    bool found = false;
+    for (auto& r : m_receivers) {
+        if (r.id == receiverId) {
+            r.blockSize = blockSize;
+            found = true;
+        }
+    }
+    if (!found) {
+        m_receivers.push_back({receiverId, blockSize});
+    }
+    for (auto& s : m_senders) {
+        if (s->fifo.getNumSamples() < getFifoSize(s->blockSize)) {
+            resetFifo(*s, s->fifo.getNumChannels());
+        } else if (auto* rp = findReadPos(*s, receiverId)) {
+            rp->pos = s->writePos;
+        } else {
+            // start with the next block of the sender
+            s->readPos.push_back({receiverId, s->writePos});
+        }
+    }
+    return true;
+}
+
+void AuxBus::removeReceiver(uint64 receiverId) {
+    traceScope();
+    Update update(*this);
+    m_receivers.erase(std::remove_if(m_receivers.begin(), m_receivers.end(),
+                                     [receiverId](const Receiver& r) { return r.id == receiverId; }),
+                      m_receivers.end());
+    for (auto& s : m_senders) {
+        s->readPos.erase(std::remove_if(s->readPos.begin(), s->readPos.end(),
+                                        [receiverId](const ReadPos& rp) { return rp.receiverId == receiverId; }),
+                         s->readPos.end());
+    }
+}
+
+template <typename T>
+void AuxBus::send(uint64 senderId, const AudioBuffer<T>& buffer, int numChannels, float gain) {
+    Access access(*this);
+    if (!access.isOpen()) {
+        return;
+    }
+    auto* s = findSender(senderId);
+    if (nullptr == s) {
+        return;
+    }
+
+    numChannels = jmin(numChannels, buffer.getNumChannels(), s->fifo.getNumChannels());
+    int numSamples = buffer.getNumSamples();
+    int size = s->fifo.getNumSamples();
+    if (numChannels <= 0 || numSamples <= 0 || numSamples > size) {
+        return;
+    }
+
+    // the readers skip ahead, if we overwrite samples, that they did not read yet
+    auto writePos = s->writePos.load(std::memory_order_relaxed);
+    int start = (int)(writePos % size);
+    for (int ch = 0; ch < numChannels; ch++) {
+        auto* src = buffer.getReadPointer(ch);
+        auto* dst = s->fifo.getWritePointer(ch);
+        int pos = start;
+        for (int i = 0; i < numSamples; i++) {
+            dst[pos] = (float)src[i] * gain;
+            if (++pos == size) {
+                pos = 0;
+            }
+        }
+    }
+    s->writePos.store(writePos + numSamples, std::memory_order_release);
+}
+
+template <typename T>
+void AuxBus::receive(uint64 receiverId, AudioBuffer<T>& buffer, int numChannels) {
+    numChannels = jmin(numChannels, buffer.getNumChannels());
+    int numSamples = buffer.getNumSamples();
+    if (numChannels <= 0 || numSamples <= 0) {
+        return;
+    }
+
+    Access access(*this);
+    if (!access.isOpen()) {
+        return;
+    }
+    for (auto& s : m_senders) {
+        auto* rp = findReadPos(*s, receiverId);
+        int size = s->fifo.getNumSamples();
+        auto maxQueued = (int64)numSamples * MAX_QUEUED_BLOCKS;
+        if (nullptr == rp || maxQueued > size) {
+            continue;
+        }
+
+        // the sender runs ahead of us, skip the oldest samples
+        auto writePos = s->writePos.load(std::memory_order_acquire);
+        if (writePos - rp->pos > maxQueued) {
+            rp->pos = writePos - maxQueued;
+        }
+
+        int toRead = (int)jmin((int64)numSamples, writePos - rp->pos);
+        if (toRead < numSamples) {
+            m_underruns++;
+        }
+
+        int start = (int)(rp->pos % size);
+        for (int ch = 0; ch < numChannels; ch++) {
+            // a mono sender feeds all channels
+            auto* src = s->fifo.getReadPointer(ch % s->fifo.getNumChannels());
+            auto* dst = buffer.getWritePointer(ch);
+            int pos = start;
+            for (int i = 0; i < toRead; i++) {
+                dst[i] += (T)src[pos];
+                if (++pos == size) {
+                    pos = 0;
+                }
+            }
+        }
+
+        rp->pos += toRead;
+    }
+}
+
+template void AuxBus::send<float>(uint64, const AudioBuffer<float>&, int, float);
+template void AuxBus::send<double>(uint64, const AudioBuffer<double>&, int, float);
+template void AuxBus::receive<float>(uint64, AudioBuffer<float>&, int);
+template void AuxBus::receive<double>(uint64, AudioBuffer<double>&, int);
+
+}  // namespace e47
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef AuxBus_hpp
+#define AuxBus_hpp
+
+#include <JuceHeader.h>
+#include <unordered_map>
+#include <thread>
+
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * A named bus shared by the clients of a server. Senders mix the output of their chain into the bus, a bus chain reads
+ * the sum as its input. Every sender has its own FIFO, that it writes to without waiting for anyone, and every receiver
+ * has its own read position in it, so the mix happens within the processing cycle of the reader and no client has to
+ * wait for another one.
+ *
+ * There is no ordering between the clients. A receiver mixes what the senders have written when it runs, so a sender,
+ * that runs later in the same cycle, arrives one block late. The bus adds up to MAX_QUEUED_BLOCKS blocks of latency
+ * that way. If a sender has not written a full block yet, the receiver takes what is there, counts an underrun and
+ * gets the rest in its next cycle.
+ *
+ * Senders and receivers register from a non realtime thread, that's where the FIFOs get allocated. send() and
+ * receive() neither lock nor allocate, a block of an unregistered sender or receiver gets ignored.
+ */
+class AuxBus : public LogTag {
+  public:
+    AuxBus(const String& name);
+    ~AuxBus() override;
+
+    // Returns the bus with the given name, it gets created if needed and lives as long as it is referenced
+    static std::shared_ptr<AuxBus> getBus(const String& name);
+
+    const String& getName() const { return m_name; }
+
+    // Registers a sender or updates its format. Returns false and leaves the bus untouched, if the sample rate does
+    // not match the other clients of the bus.
+    bool addSender(uint64 senderId, int numChannels, int blockSize, double sampleRate);
+    void removeSender(uint64 senderId);
+
+    // Registers a receiver or updates its format, see addSender()
+    bool addReceiver(uint64 receiverId, int blockSize, double sampleRate);
+    void removeReceiver(uint64 receiverId);
+
+    // Adds the first numChannels channels of the buffer scaled by gain to the FIFO of the sender
+    template <typename T>
+    void send(uint64 senderId, const AudioBuffer<T>& buffer, int numChannels, float gain);
+
+    // Mixes the signals of all senders into the first numChannels channels of the buffer
+    template <typename T>
+    void receive(uint64 receiverId, AudioBuffer<T>& buffer, int numChannels);
+
+    uint64 getUnderruns() const { return m_underruns; }
+
+  private:
+    // The FIFO of a sender holds up to this many blocks, if the reader does not keep up, the oldest samples get lost
+    static constexpr int FIFO_BLOCKS = 8;
+    // Samples the reader lets queue up, before skipping ahead to keep the latency of the bus low
+    static constexpr int MAX_QUEUED_BLOCKS = 2;
+
+    struct ReadPos {
+        uint64 receiverId;
+        int64 pos;
+    };
+
+    struct Sender {
+        uint64 id;
+        int blockSize;
+        AudioBuffer<float> fifo;
+        // total number of samples written, only the sender thread updates it
+        std::atomic<int64> writePos{0};
+        std::vector<ReadPos> readPos;
+    };
+
+    struct Receiver {
+        uint64 id;
+        int blockSize;
+    };
+
+    // Audio threads enter the bus without locking. A registration waits until all of them have left and makes them
+    // skip the bus meanwhile.
+    class Access {
+      public:
+        Access(AuxBus& bus) : m_bus(bus) {
+            m_bus.m_users++;
+            m_open = !m_bus.m_updating;
+        }
+        ~Access() { m_bus.m_users--; }
+        bool isOpen() const { return m_open; }
+
+      private:
+        AuxBus& m_bus;
+        bool m_open;
+    };
+
+    class Update {
+      public:
+        Update(AuxBus& bus) : m_lock(bus.m_regMtx), m_bus(bus) {
+            m_bus.m_updating = true;
+            while (m_bus.m_users > 0) {
+                std::this_thread::yield();
+            }
+        }
+        ~Update() { m_bus.m_updating = false; }
+
+      private:
+        std::lock_guard<std::mutex> m_lock;
+        AuxBus& m_bus;
+    };
+
+    bool checkSampleRate(uint64 id, double sampleRate);
+    int getFifoSize(int blockSize) const;
+    void resetFifo(Sender& s, int numChannels);
+    Sender* findSender(uint64 senderId);
+    static ReadPos* findReadPos(Sender& s, uint64 receiverId);
+
+    String m_name;
+    // serializes registrations, audio threads never take it
+    std::mutex m_regMtx;
+    std::atomic_bool m_updating{false};
+    std::atomic_int m_users{0};
+    double m_sampleRate = 0.0;
+    std::vector<std::unique_ptr<Sender>> m_senders;
+    std::vector<Receiver> m_receivers;
+    std::atomic<uint64> m_underruns{0};
+
+    static std::mutex m_busesMtx;
+    static std::unordered_map<String, std::weak_ptr<AuxBus>> m_buses;
+};
+
+}  // namespace e47
+
+#endif /* AuxBus_hpp */
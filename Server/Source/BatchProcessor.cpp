@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "BatchProcessor.hpp"
+#include "Server.hpp"
+#include "Processor.hpp"
+#include "ProcessorChain.hpp"
+#include "Message.hpp"
+#include "Defaults.hpp"
+
+namespace e47 {
+
+static const String BATCH_FILE_PATTERN = "*.wav;*.flac;*.aif;*.aiff";
+
+BatchProcessor::BatchProcessor(int srvId) : LogTag("batch"), m_srvId(srvId) {}
+
+String BatchProcessor::getUsage() {
+    return "usage: AudioGridderServer -batch -plugin <id> [-state <file>] [-plugin <id> ...] [Options] <files/dirs>\n"
+           "  -plugin <id>      add a plugin to the chain (AG or JUCE plugin ID, as listed by the server)\n"
+           "  -state <file>     load the state of the previous plugin from a file\n"
+           "  -outdir <dir>     write the processed files to a directory (default: next to the input files)\n"
+           "  -suffix <str>     file name suffix of the processed files (default: -processed)\n"
+           "  -blocksize <n>    block size (default: 512)\n"
+           "  -jobs <n>         number of files processed in parallel (default: number of CPUs)\n"
+           "  -notail           do not append the tail of the chain\n"
+           "  -nowrite          benchmark mode, process only without writing any files\n"
+           "  -id <n>           use the plugin list of server <n>";
+}
+
+bool BatchProcessor::parseArgs(const StringArray& args) {
+    traceScope();
+
+    auto cwd = File::getCurrentWorkingDirectory();
+
+    for (int i = 0; i < args.size(); i++) {
+        auto arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "-batch" || arg == "-log") {
+            continue;
+        } else if (arg == "-id" && hasValue) {
+            i++;  // handled by the app
+        } else if (arg == "-plugin" && hasValue) {
+            m_plugins.add({args[++i], {}});
+        } else if (arg == "-state" && hasValue) {
+            if (m_plugins.isEmpty()) {
+                logln("error: -state has to follow a -plugin parameter");
+                return false;
+            }
+            m_plugins.getReference(m_plugins.size() - 1).stateFile = cwd.getChildFile(args[++i]);
+        } else if (arg == "-outdir" && hasValue) {
+            m_outDir = cwd.getChildFile(args[++i]);
+        } else if (arg == "-suffix" && hasValue) {
+            m_suffix = args[++i];
+        } else if (arg == "-blocksize" && hasValue) {
+            m_blockSize = args[++i].getIntValue();
+        } else if (arg == "-jobs" && hasValue) {
+            m_jobs = args[++i].getIntValue();
+        } else if (arg == "-notail") {
+            m_tail = false;
+        } else if (arg == "-nowrite") {
+            m_write = false;
+        } else if (arg.startsWith("-")) {
+            logln("error: invalid parameter " << arg);
+            return false;
+        } else {
+            auto f = cwd.getChildFile(arg);
+            if (f.isDirectory()) {
+                auto files = f.findChildFiles(File::findFiles, false, BATCH_FILE_PATTERN);
+                files.sort();
+                m_files.addArray(files);
+            } else if (f.existsAsFile()) {
+                m_files.add(f);
+            } else {
+                logln("error: file " << f.getFullPathName() << " not found");
+                return false;
+            }
+        }
+    }
+
+    if (m_plugins.isEmpty()) {
+        logln("error: no plugins given");
+        return false;
+    }
+    if (m_files.isEmpty()) {
+        logln("error: no audio files given");
+        return false;
+    }
+    if (m_blockSize < 16 || m_blockSize > 8192) {
+        logln("error: invalid block size " << m_blockSize);
+        return false;
+    }
+    for (auto& spec : m_plugins) {
+        if (spec.stateFile != File() && !spec.stateFile.existsAsFile()) {
+            logln("error: state file " << spec.stateFile.getFullPathName() << " not found");
+            return false;
+        }
+    }
+    if (m_write) {
+        if (m_outDir == File() && m_suffix.isEmpty()) {
+            logln("error: the suffix can't be empty without an output directory, the input files would be replaced");
+            return false;
+        }
+        if (m_outDir != File() && !m_outDir.isDirectory() && !m_outDir.createDirectory()) {
+            logln("error: failed to create output directory " << m_outDir.getFullPathName());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BatchProcessor::loadPlugins() {
+    traceScope();
+
+    // the layouts are read from the cache of the server directly, the json copy of the list is not needed
+    json playouts;
+    Server::loadKnownPluginList(m_pluginList, playouts, m_srvId);
+
+    m_layoutCache = std::make_unique<LayoutCache>(
+        File(Defaults::getConfigFileName(Defaults::PluginLayoutsCache, {{"id", String(m_srvId)}})));
+    m_layoutCache->load();
+
+    for (auto& spec : m_plugins) {
+        auto desc = Processor::findPluginDescription(spec.id, m_pluginList);
+        if (nullptr == desc) {
+            logln("error: plugin with ID " << spec.id << " not found, the plugin has to be scanned by server "
+                                           << m_srvId << " first");
+            return false;
+        }
+
+        // without the cached layouts every job would probe the plugin for every file
+        LayoutCache::Layouts layouts;
+        auto pluginId = Processor::createPluginID(*desc);
+        if (!m_layoutCache->get(pluginId, desc->version, layouts) || layouts.isEmpty()) {
+            logln("no cached layouts for " << spec.id << ", checking now...");
+            String err;
+            auto inst = Processor::loadPlugin(*desc, 48000.0, m_blockSize, err);
+            if (nullptr == inst) {
+                logln("error: failed to load plugin " << spec.id << ": " << err);
+                return false;
+            }
+            layouts = Processor::findSupportedLayouts(inst);
+            runOnMsgThreadSync([&] { inst.reset(); });
+            m_layoutCache->put(pluginId, desc->version, layouts);
+            if (!m_layoutCache->save()) {
+                logln("failed to store plugin layouts");
+            }
+        }
+        m_layouts.push_back(layouts);
+
+        String settings;
+        if (spec.stateFile != File()) {
+            MemoryBlock block;
+            if (!spec.stateFile.loadFileAsData(block)) {
+                logln("error: failed to read state file " << spec.stateFile.getFullPathName());
+                return false;
+            }
+            settings = block.toBase64Encoding();
+        }
+        m_settings.add(settings);
+    }
+
+    return true;
+}
+
+File BatchProcessor::getOutputFile(const File& in) const {
+    auto ext = in.getFileExtension().toLowerCase();
+    if (!StringArray({".wav", ".flac", ".aif", ".aiff"}).contains(ext)) {
+        ext = ".wav";
+    }
+    auto dir = m_outDir != File() ? m_outDir : in.getParentDirectory();
+    return dir.getChildFile(in.getFileNameWithoutExtension() + m_suffix + ext);
+}
+
+BatchProcessor::Result BatchProcessor::processFile(const File& in) {
+    traceScope();
+
+    Result res;
+    auto startTime = Time::getMillisecondCounterHiRes();
+
+    AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<AudioFormatReader> reader(formats.createReaderFor(in));
+    if (nullptr == reader) {
+        res.error = "unsupported audio file";
+        return res;
+    }
+
+    int channels = (int)reader->numChannels;
+    double sampleRate = reader->sampleRate;
+    int64 length = reader->lengthInSamples;
+
+    if (channels < 1 || sampleRate <= 0.0) {
+        res.error = "invalid audio file";
+        return res;
+    }
+
+    std::unique_ptr<AudioFormatWriter> writer;
+    if (m_write) {
+        auto out = getOutputFile(in);
+        auto* fmt = formats.findFormatForFileExtension(out.getFileExtension());
+        if (nullptr == fmt) {
+            res.error = "no writer for " + out.getFileName();
+            return res;
+        }
+        auto bitDepths = fmt->getPossibleBitDepths();
+        int bits = bitDepths.contains((int)reader->bitsPerSample) ? (int)reader->bitsPerSample : bitDepths.getLast();
+        out.deleteFile();
+        auto stream = std::make_unique<FileOutputStream>(out);
+        if (stream->failedToOpen()) {
+            res.error = "failed to open " + out.getFullPathName() + ": " + stream->getStatus().getErrorMessage();
+            return res;
+        }
+        writer.reset(fmt->createWriterFor(stream.get(), sampleRate, (unsigned int)channels, bits,
+                                          reader->metadataValues, 0));
+        if (nullptr == writer) {
+            res.error = "failed to create writer for " + out.getFullPathName();
+            return res;
+        }
+        stream.release();  // owned by the writer
+    }
+
+    HandshakeRequest cfg = {AG_PROTOCOL_VERSION, channels, channels, 0, sampleRate, m_blockSize, false, 0, 0, 0, 0, 0};
+
+    auto chain =
+        std::make_unique<ProcessorChain>(this, ProcessorChain::createBussesProperties(channels, channels, 0), cfg);
+    chain->updateChannels(channels, channels, 0);
+    chain->prepareToPlay(sampleRate, m_blockSize);
+
+    AudioPlayHead::PositionInfo posInfo;
+    posInfo.setBpm(makeOptional(120.0));
+    posInfo.setIsPlaying(true);
+    ProcessorChain::PlayHead playHead(&posInfo);
+    chain->setPlayHead(&playHead);
+
+    auto cleanup = [&] {
+        chain->setPlayHead(nullptr);
+        chain->releaseResources();
+        chain->clear();
+    };
+
+    for (int i = 0; i < m_plugins.size(); i++) {
+        auto& spec = m_plugins.getReference(i);
+        auto desc = Processor::findPluginDescription(spec.id, m_pluginList);
+        auto proc = std::make_shared<Processor>(*chain, spec.id, sampleRate, m_blockSize);
+        proc->setSupportedBusLayouts(m_layouts[(size_t)i]);
+        String err;
+        if (!proc->load(m_settings[i], {}, 0, err, desc.get())) {
+            res.error = "failed to load plugin " + spec.id + ": " + err;
+            cleanup();
+            return res;
+        }
+        chain->addProcessor(std::move(proc));
+    }
+
+    // the output gets shifted by the latency of the chain, so it lines up with the input
+    int64 latency = chain->getLatencySamples();
+    int64 tail = m_tail ? (int64)(jlimit(0.0, MAX_TAIL_SECS, chain->getTailLengthSeconds()) * sampleRate) : 0;
+    int64 total = length + latency + tail;
+
+    AudioBuffer<float> fileBuffer(channels, m_blockSize);
+    AudioBuffer<float> buffer(channels + chain->getExtraChannels(), m_blockSize);
+    MidiBuffer midi;
+    double processMs = 0.0;
+
+    for (int64 pos = 0; pos < total; pos += m_blockSize) {
+        int samples = (int)jmin((int64)m_blockSize, total - pos);
+
+        buffer.setSize(buffer.getNumChannels(), samples, false, false, true);
+        buffer.clear();
+
+        if (pos < length) {
+            int toRead = (int)jmin((int64)samples, length - pos);
+            fileBuffer.setSize(channels, toRead, false, false, true);
+            if (!reader->read(&fileBuffer, 0, toRead, pos, true, true)) {
+                res.error = "failed to read audio data at sample " + String(pos);
+                cleanup();
+                return res;
+            }
+            for (int ch = 0; ch < channels; ch++) {
+                buffer.copyFrom(ch, 0, fileBuffer, ch, 0, toRead);
+            }
+        }
+
+        posInfo.setTimeInSamples(makeOptional(pos));
+        posInfo.setTimeInSeconds(makeOptional((double)pos / sampleRate));
+
+        auto procStart = Time::getMillisecondCounterHiRes();
+        chain->processBlock(buffer, midi);
+        processMs += Time::getMillisecondCounterHiRes() - procStart;
+        midi.clear();
+
+        int skip = (int)jlimit((int64)0, (int64)samples, latency - pos);
+        if (nullptr != writer && samples > skip) {
+            if (!writer->writeFromAudioSampleBuffer(buffer, skip, samples - skip)) {
+                res.error = "failed to write audio data";
+                cleanup();
+                return res;
+            }
+        }
+    }
+
+    cleanup();
+    writer.reset();
+
+    res.success = true;
+    res.audioSecs = (double)length / sampleRate;
+    res.processSecs = processMs / 1000;
+    res.totalSecs = (Time::getMillisecondCounterHiRes() - startTime) / 1000;
+    return res;
+}
+
+int BatchProcessor::run() {
+    traceScope();
+
+    int jobs = jlimit(1, m_files.size(), m_jobs > 0 ? m_jobs : SystemStats::getNumCpus());
+
+    StringArray chain;
+    for (auto& spec : m_plugins) {
+        chain.add(spec.id + (spec.stateFile != File() ? " (" + spec.stateFile.getFileName() + ")" : String()));
+    }
+    logln("processing " << m_files.size() << " file(s) with " << jobs << " job(s), block size " << m_blockSize);
+    logln("chain: " << chain.joinIntoString(" -> "));
+
+    std::vector<Result> results((size_t)m_files.size());
+    std::atomic_int next{0};
+    auto startTime = Time::getMillisecondCounterHiRes();
+
+    std::vector<std::unique_ptr<FnThread>> threads;
+    for (int t = 0; t < jobs; t++) {
+        threads.push_back(std::make_unique<FnThread>(
+            [&] {
+                int num;
+                while ((num = next++) < m_files.size()) {
+                    auto& file = m_files.getReference(num);
+                    auto& res = results[(size_t)num];
+                    res = processFile(file);
+                    if (res.success) {
+                        logln(file.getFileName() << ": " << formatSecs(res.audioSecs) << " of audio in "
+                                                 << formatSecs(res.totalSecs) << ", "
+                                                 << formatRealtime(res.audioSecs, res.totalSecs) << " (chain "
+                                                 << formatRealtime(res.audioSecs, res.processSecs) << ")");
+                    } else {
+                        logln(file.getFileName() << ": error: " << res.error);
+                    }
+                }
+            },
+            "BatchThread", true));
+    }
+    for (auto& t : threads) {
+        t->waitForThreadToExit(-1);
+    }
+
+    auto totalSecs = (Time::getMillisecondCounterHiRes() - startTime) / 1000;
+    double audioSecs = 0.0, processSecs = 0.0;
+    int failed = 0;
+    for (auto& res : results) {
+        if (res.success) {
+            audioSecs += res.audioSecs;
+            processSecs += res.processSecs;
+        } else {
+            failed++;
+        }
+    }
+
+    logln("processed " << (m_files.size() - failed) << " file(s), " << failed << " failed: "
+                       << formatSecs(audioSecs) << " of audio in " << formatSecs(totalSecs) << ", "
+                       << formatRealtime(audioSecs, totalSecs) << " (chain "
+                       << formatRealtime(audioSecs, processSecs) << " per job)");
+
+    return failed;
+}
+
+int BatchProcessor::runBatchProcess(int srvId, const StringArray& args) {
+    setLogTagStatic("batch");
+    traceScope();
+
+    BatchProcessor bp(srvId);
+    if (!bp.parseArgs(args)) {
+        logln(getUsage());
+        return 1;
+    }
+    if (!bp.loadPlugins()) {
+        return 1;
+    }
+    return bp.run() > 0 ? 1 : 0;
+}
+
+}  // namespace e47
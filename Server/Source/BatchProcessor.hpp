@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef BatchProcessor_hpp
+#define BatchProcessor_hpp
+
+#include <JuceHeader.h>
+
+#include "Utils.hpp"
+#include "LayoutCache.hpp"
+
+namespace e47 {
+
+/*
+ * Headless batch mode (-batch), that streams audio files through a chain of plugins as fast as possible without a
+ * DAW. Every file gets its own chain instance and multiple files are processed in parallel. The output is latency
+ * compensated and includes the tail of the chain. The throughput gets reported in multiples of realtime.
+ */
+class BatchProcessor : public LogTag {
+  public:
+    struct PluginSpec {
+        String id;
+        File stateFile;
+    };
+
+    struct Result {
+        bool success = false;
+        String error;
+        double audioSecs = 0.0;
+        double processSecs = 0.0;
+        double totalSecs = 0.0;
+    };
+
+    BatchProcessor(int srvId);
+
+    // Parses the command line, returns false if the parameters are invalid
+    bool parseArgs(const StringArray& args);
+
+    // Processes all files, returns the number of files that failed
+    int run();
+
+    // Entry point of the batch mode, returns the exit code
+    static int runBatchProcess(int srvId, const StringArray& args);
+
+    static String getUsage();
+
+  private:
+    static constexpr double MAX_TAIL_SECS = 30.0;
+
+    int m_srvId;
+    Array<PluginSpec> m_plugins;
+    Array<File> m_files;
+    File m_outDir;
+    String m_suffix = "-processed";
+    int m_blockSize = 512;
+    int m_jobs = 0;
+    bool m_write = true;
+    bool m_tail = true;
+
+    KnownPluginList m_pluginList;
+    std::unique_ptr<LayoutCache> m_layoutCache;
+    StringArray m_settings;
+    std::vector<LayoutCache::Layouts> m_layouts;
+
+    bool loadPlugins();
+    File getOutputFile(const File& in) const;
+    Result processFile(const File& in);
+
+    static String formatSecs(double secs) { return String(secs, 2) + "s"; }
+    static String formatRealtime(double audioSecs, double secs) {
+        return secs > 0.0 ? String(audioSecs / secs, 1) + "x realtime" : String("n/a");
+    }
+};
+
+}  // namespace e47
+
+#endif /* BatchProcessor_hpp */
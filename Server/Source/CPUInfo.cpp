@@ -9,6 +9,9 @@
 
 #if defined(JUCE_MAC)
 #include <mach/mach.h>
+#elif defined(JUCE_LINUX)
+#include <fstream>
+#include <sstream>
 #elif defined(JUCE_WINDOWS)
 #include <windows.h>
 #include <tchar.h>
@@ -44,6 +47,53 @@ typedef DWORD(WINAPI* fpNtQuerySystemInformation)(DWORD infoClass, void* sysInfo
 namespace e47 {
 
 std::atomic<float> CPUInfo::m_usage{0.0f};
+std::atomic<int64> CPUInfo::m_freeMemoryMB{-1};
+
+#if defined(JUCE_LINUX)
+static bool readProcStat(uint64& usageTime, uint64& idleTime) {
+    std::ifstream in("/proc/stat");
+    std::string cpu;
+    uint64 user, nice, system, idle, iowait, irq, softirq, steal;
+    if (!(in >> cpu >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal) || cpu != "cpu") {
+        return false;
+    }
+    usageTime = user + nice + system + irq + softirq + steal;
+    idleTime = idle + iowait;
+    return true;
+}
+#endif
+
+int64 CPUInfo::readFreeMemoryMB() {
+#if defined(JUCE_MAC)
+    vm_statistics64_data_t vmStats;
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    if (host_statistics64(mach_host_self(), HOST_VM_INFO64, (host_info64_t)&vmStats, &count) != KERN_SUCCESS) {
+        return -1;
+    }
+    return (int64)(vmStats.free_count + vmStats.inactive_count) * (int64)vm_page_size / 1024 / 1024;
+#elif defined(JUCE_WINDOWS)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) {
+        return -1;
+    }
+    return (int64)(status.ullAvailPhys / 1024 / 1024);
+#elif defined(JUCE_LINUX)
+    std::ifstream in("/proc/meminfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ss(line);
+        std::string key;
+        int64 kb;
+        if (ss >> key >> kb && key == "MemAvailable:") {
+            return kb / 1024;
+        }
+    }
+    return -1;
+#else
+    return -1;
+#endif
+}
 
 void CPUInfo::run() {
     traceScope();
@@ -142,8 +192,24 @@ void CPUInfo::run() {
         auto usageTime = (float)totalTime - idleTime;
         float usage = usageTime / totalTime * 100;
 #elif defined(JUCE_LINUX)
-        float usage = 0.5;
+        uint64 usageStart, idleStart, usageEnd, idleEnd;
+        if (!readProcStat(usageStart, idleStart)) {
+            logln("failed to read /proc/stat");
+            return;
+        }
+
+        sleep(waitTime);
+
+        if (!readProcStat(usageEnd, idleEnd)) {
+            logln("failed to read /proc/stat");
+            return;
+        }
+
+        float usageTime = (float)(usageEnd - usageStart);
+        float totalTime = usageTime + (float)(idleEnd - idleStart);
+        float usage = totalTime > 0 ? usageTime / totalTime * 100 : 0.0f;
 #endif
+        m_freeMemoryMB = readFreeMemoryMB();
         lastValues[valueIdx++ % lastValues.size()] = usage;
         usage = 0;
         for (auto u : lastValues) {
@@ -24,8 +24,14 @@ class CPUInfo : public Thread, public LogTag, public SharedInstance<CPUInfo> {
 
     static float getUsage() { return m_usage; }
 
+    // Physical memory that is available for new processes, -1 if unknown
+    static int64 getFreeMemoryMB() { return m_freeMemoryMB; }
+
   private:
     static std::atomic<float> m_usage;
+    static std::atomic<int64> m_freeMemoryMB;
+
+    static int64 readFreeMemoryMB();
 };
 
 }  // namespace e47
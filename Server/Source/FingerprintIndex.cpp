@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "FingerprintIndex.hpp"
+#include "Defaults.hpp"
+
+#ifndef JUCE_WINDOWS
+#include <sys/stat.h>
+#endif
+
+namespace e47 {
+
+json FingerprintIndex::Fingerprint::toJson() const {
+    return {{"size", size}, {"mtime", mtime}, {"inode", inode}, {"hash", bundleHash.toStdString()}};
+}
+
+FingerprintIndex::Fingerprint FingerprintIndex::Fingerprint::fromJson(const json& j) {
+    Fingerprint fp;
+    fp.size = jsonGetValue(j, "size", fp.size);
+    fp.mtime = jsonGetValue(j, "mtime", fp.mtime);
+    fp.inode = jsonGetValue(j, "inode", fp.inode);
+    fp.bundleHash = jsonGetValue(j, "hash", fp.bundleHash);
+    return fp;
+}
+
+FingerprintIndex::FingerprintIndex(int serverId) : LogTag("fingerprints"), m_serverId(serverId) {}
+
+void FingerprintIndex::load() {
+    traceScope();
+
+    auto file = Defaults::getConfigFileName(Defaults::PluginFingerprints, {{"id", String(m_serverId)}});
+    if (!File(file).existsAsFile()) {
+        return;
+    }
+
+    auto j = jsonReadFile(file, true);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_index.clear();
+    if (j.is_object()) {
+        try {
+            for (auto it = j.begin(); it != j.end(); it++) {
+                m_index[it.key()] = Fingerprint::fromJson(it.value());
+            }
+        } catch (const json::exception& e) {
+            logln("failed to read fingerprints: " << e.what());
+            m_index.clear();
+        }
+    }
+    m_dirty = false;
+
+    logln("loaded " << m_index.size() << " plugin fingerprints");
+}
+
+void FingerprintIndex::save() {
+    traceScope();
+
+    json j = json::object();
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (!m_dirty) {
+            return;
+        }
+        for (auto& it : m_index) {
+            j[it.first.toStdString()] = it.second.toJson();
+        }
+        m_dirty = false;
+    }
+
+    jsonWriteFile(Defaults::getConfigFileName(Defaults::PluginFingerprints, {{"id", String(m_serverId)}}), j, true);
+}
+
+FingerprintIndex::Fingerprint FingerprintIndex::create(const String& fileOrId) {
+    Fingerprint fp;
+
+    if (!File::isAbsolutePath(fileOrId)) {
+        return fp;
+    }
+
+    File file(fileOrId);
+    if (!file.exists()) {
+        return fp;
+    }
+
+    fp.mtime = file.getLastModificationTime().toMilliseconds();
+
+#ifndef JUCE_WINDOWS
+    struct stat st;
+    if (stat(file.getFullPathName().toRawUTF8(), &st) == 0) {
+        fp.inode = (int64)st.st_ino;
+    }
+#endif
+
+    if (file.isDirectory()) {
+        StringArray paths;
+        for (auto& f : file.findChildFiles(File::findFiles, true)) {
+            fp.size += f.getSize();
+            fp.mtime = jmax(fp.mtime, f.getLastModificationTime().toMilliseconds());
+            // a file replaced by one of the same size within the same second would go unnoticed by the aggregated
+            // values, so each file contributes its own size and modification time to the hash
+            paths.add(f.getRelativePathFrom(file) + ":" + String(f.getSize()) + ":" +
+                      String(f.getLastModificationTime().toMilliseconds()));
+        }
+        paths.sort(false);
+        fp.bundleHash = String::toHexString(paths.joinIntoString("|").hashCode64());
+    } else {
+        fp.size = file.getSize();
+    }
+
+    return fp;
+}
+
+bool FingerprintIndex::isUnchanged(const String& fileOrId) {
+    Fingerprint stored;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        auto it = m_index.find(fileOrId);
+        if (it == m_index.end()) {
+            return false;
+        }
+        stored = it->second;
+    }
+    auto current = create(fileOrId);
+    return current.isValid() && current == stored;
+}
+
+bool FingerprintIndex::contains(const String& fileOrId) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_index.find(fileOrId) != m_index.end();
+}
+
+void FingerprintIndex::update(const String& fileOrId) {
+    auto fp = create(fileOrId);
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (fp.isValid()) {
+        m_index[fileOrId] = fp;
+    } else {
+        m_index.erase(fileOrId);
+    }
+    m_dirty = true;
+}
+
+void FingerprintIndex::remove(const String& fileOrId) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_index.erase(fileOrId) > 0) {
+        m_dirty = true;
+    }
+}
+
+StringArray FingerprintIndex::getFiles() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    StringArray files;
+    for (auto& it : m_index) {
+        files.add(it.first);
+    }
+    return files;
+}
+
+}  // namespace e47
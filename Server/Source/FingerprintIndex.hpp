@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef FingerprintIndex_hpp
+#define FingerprintIndex_hpp
+
+#include <JuceHeader.h>
+#include <unordered_map>
+
+#include "Utils.hpp"
+#include "json.hpp"
+
+namespace e47 {
+
+/*
+ * Remembers the state of every scanned plugin file, so that a rescan only needs to scan new or changed files. A
+ * fingerprint consists of the size, modification time and inode of a file. For bundles the size and the latest
+ * modification time of all contained files are used and a hash over the contained paths, sizes and modification
+ * times is added.
+ */
+class FingerprintIndex : public LogTag {
+  public:
+    struct Fingerprint {
+        int64 size = 0;
+        int64 mtime = 0;
+        int64 inode = 0;
+        String bundleHash;
+
+        bool isValid() const { return mtime > 0; }
+        bool operator==(const Fingerprint& other) const {
+            return size == other.size && mtime == other.mtime && inode == other.inode &&
+                   bundleHash == other.bundleHash;
+        }
+        bool operator!=(const Fingerprint& other) const { return !(*this == other); }
+
+        json toJson() const;
+        static Fingerprint fromJson(const json& j);
+    };
+
+    FingerprintIndex(int serverId);
+
+    void load();
+    void save();
+
+    // Returns an invalid fingerprint for identifiers, that are not files (e.g. AudioUnits)
+    static Fingerprint create(const String& fileOrId);
+
+    // Returns true, if the file has been indexed and did not change since then
+    bool isUnchanged(const String& fileOrId);
+    bool contains(const String& fileOrId);
+
+    void update(const String& fileOrId);
+    void remove(const String& fileOrId);
+
+    StringArray getFiles();
+
+  private:
+    int m_serverId;
+    std::unordered_map<String, Fingerprint> m_index;
+    bool m_dirty = false;
+    std::mutex m_mtx;
+};
+
+}  // namespace e47
+
+#endif /* FingerprintIndex_hpp */
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "LayoutCache.hpp"
+#include "PluginCatalog.hpp"
+
+namespace e47 {
+
+LayoutCache::LayoutCache(const File& file) : LogTag("layoutcache"), m_file(file) {}
+
+bool LayoutCache::load() {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_added.clear();
+    return loadNoLock();
+}
+
+bool LayoutCache::loadNoLock() {
+    traceScope();
+
+    m_data.reset();
+    m_index.clear();
+
+    if (!m_file.existsAsFile()) {
+        logln("no layout cache found");
+        return false;
+    }
+
+    if (!m_file.loadFileAsData(m_data)) {
+        logln("failed to read layout cache " << m_file.getFullPathName());
+        return false;
+    }
+
+    MemoryInputStream in(m_data, false);
+
+    char magic[4];
+    if (in.read(magic, 4) != 4 || memcmp(magic, "AGLC", 4) != 0 || (uint32)in.readInt() != FORMAT_VERSION) {
+        logln("invalid layout cache " << m_file.getFullPathName() << ", ignoring it");
+        m_data.reset();
+        return false;
+    }
+
+    auto count = (uint32)in.readInt();
+    for (uint32 i = 0; i < count && !in.isExhausted(); i++) {
+        auto hash = in.readInt64();
+        IndexEntry e;
+        e.offset = (uint32)in.readInt();
+        e.size = (uint32)in.readInt();
+        if ((size_t)e.offset + e.size > m_data.getSize()) {
+            logln("invalid layout cache index entry, ignoring the cache");
+            m_data.reset();
+            m_index.clear();
+            return false;
+        }
+        m_index[hash] = e;
+    }
+
+    logln("loaded layout cache with " << m_index.size() << " entries");
+
+    return true;
+}
+
+bool LayoutCache::save() {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    if (m_added.empty()) {
+        return true;
+    }
+
+    // Every sandbox process stores the layouts it probes, so the records written by other processes since loading the
+    // file have to be merged
+    InterProcessLock fileLock("AudioGridderLayoutCache" + String::toHexString(m_file.getFullPathName().hashCode64()));
+    InterProcessLock::ScopedLockType scopedLock(fileLock);
+    if (!scopedLock.isLocked()) {
+        logln("failed to lock layout cache " << m_file.getFullPathName());
+        return false;
+    }
+    loadNoLock();
+
+    // merge the existing records with the new ones
+    std::vector<std::pair<String, Layouts>> entries;
+    for (auto& it : m_index) {
+        String key;
+        Layouts layouts;
+        if (readRecord(it.second, key, layouts) && m_added.find(key) == m_added.end()) {
+            entries.emplace_back(key, layouts);
+        }
+    }
+    for (auto& it : m_added) {
+        entries.emplace_back(it.first, it.second);
+    }
+
+    MemoryOutputStream records;
+    std::vector<std::pair<int64, IndexEntry>> index;
+    for (auto& e : entries) {
+        IndexEntry ie;
+        ie.offset = (uint32)records.getDataSize();
+        writeRecord(records, e.first, e.second);
+        ie.size = (uint32)records.getDataSize() - ie.offset;
+        index.emplace_back(e.first.hashCode64(), ie);
+    }
+
+    uint32 headerSize = 12 + (uint32)index.size() * 16;
+
+    MemoryBlock data;
+    {
+        MemoryOutputStream out(data, false);
+        out.write("AGLC", 4);
+        out.writeInt((int)FORMAT_VERSION);
+        out.writeInt((int)index.size());
+        for (auto& ie : index) {
+            out.writeInt64(ie.first);
+            out.writeInt((int)(headerSize + ie.second.offset));
+            out.writeInt((int)ie.second.size);
+        }
+        out.write(records.getData(), records.getDataSize());
+    }
+
+    m_file.getParentDirectory().createDirectory();
+    TemporaryFile tmp(m_file);
+    if (!tmp.getFile().replaceWithData(data.getData(), data.getSize()) || !tmp.overwriteTargetFileWithTemporary()) {
+        logln("failed to write layout cache " << m_file.getFullPathName());
+        return false;
+    }
+
+    // reindex
+    m_data = std::move(data);
+    m_index.clear();
+    for (auto& ie : index) {
+        ie.second.offset += headerSize;
+        m_index[ie.first] = ie.second;
+    }
+    m_added.clear();
+
+    logln("wrote layout cache with " << m_index.size() << " entries");
+
+    return true;
+}
+
+bool LayoutCache::get(const String& id, const String& version, Layouts& layouts) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto key = getKey(id, version);
+    auto itAdded = m_added.find(key);
+    if (itAdded != m_added.end()) {
+        layouts = itAdded->second;
+        return true;
+    }
+    auto it = m_index.find(key.hashCode64());
+    if (it != m_index.end()) {
+        String recordKey;
+        if (readRecord(it->second, recordKey, layouts) && recordKey == key) {
+            return true;
+        }
+        layouts.clear();
+    }
+    return false;
+}
+
+void LayoutCache::put(const String& id, const String& version, const Layouts& layouts) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_added[getKey(id, version)] = layouts;
+}
+
+bool LayoutCache::contains(const String& id, const String& version) {
+    Layouts layouts;
+    return get(id, version, layouts);
+}
+
+size_t LayoutCache::size() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_index.size() + m_added.size();
+}
+
+bool LayoutCache::readRecord(const IndexEntry& e, String& key, Layouts& layouts) const {
+    MemoryInputStream in(static_cast<const char*>(m_data.getData()) + e.offset, e.size, false);
+    key = PluginCatalog::readString(in);
+    int numLayouts = (int)(uint16)in.readShort();
+    for (int i = 0; i < numLayouts && !in.isExhausted(); i++) {
+        AudioProcessor::BusesLayout l;
+        int numIn = (int)(uint8)in.readByte();
+        for (int b = 0; b < numIn; b++) {
+            l.inputBuses.add(AudioChannelSet::fromAbbreviatedString(PluginCatalog::readString(in)));
+        }
+        int numOut = (int)(uint8)in.readByte();
+        for (int b = 0; b < numOut; b++) {
+            l.outputBuses.add(AudioChannelSet::fromAbbreviatedString(PluginCatalog::readString(in)));
+        }
+        layouts.add(l);
+    }
+    return layouts.size() == numLayouts;
+}
+
+void LayoutCache::writeRecord(OutputStream& out, const String& key, const Layouts& layouts) {
+    PluginCatalog::writeString(out, key);
+    out.writeShort((short)layouts.size());
+    for (auto& l : layouts) {
+        out.writeByte((char)l.inputBuses.size());
+        for (auto& bus : l.inputBuses) {
+            PluginCatalog::writeString(out, bus.getSpeakerArrangementAsString());
+        }
+        out.writeByte((char)l.outputBuses.size());
+        for (auto& bus : l.outputBuses) {
+            PluginCatalog::writeString(out, bus.getSpeakerArrangementAsString());
+        }
+    }
+}
+
+}  // namespace e47
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef LayoutCache_hpp
+#define LayoutCache_hpp
+
+#include <JuceHeader.h>
+#include <unordered_map>
+
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Binary cache for the supported I/O layouts of plugins keyed by plugin ID and version. Only the index gets parsed
+ * when loading the file, the layouts of a plugin are decoded on demand. Saving merges the new records with the file
+ * under an inter process lock, as all server and sandbox processes write it.
+ *
+ * Format (little endian):
+ *   header:  "AGLC", uint32 format version, uint32 number of entries
+ *   index:   per entry: int64 key hash, uint32 record offset, uint32 record size
+ *   records: per entry: string key, uint16 number of layouts, per layout: uint8 number of input buses, channel sets,
+ *            uint8 number of output buses, channel sets (strings are stored as uint16 length + UTF8 bytes)
+ */
+class LayoutCache : public LogTag {
+  public:
+    using Layouts = Array<AudioProcessor::BusesLayout>;
+
+    LayoutCache(const File& file);
+
+    bool load();
+    bool save();
+
+    bool get(const String& id, const String& version, Layouts& layouts);
+    void put(const String& id, const String& version, const Layouts& layouts);
+    bool contains(const String& id, const String& version);
+
+    size_t size();
+
+  private:
+    static constexpr uint32 FORMAT_VERSION = 1;
+
+    struct IndexEntry {
+        uint32 offset;
+        uint32 size;
+    };
+
+    File m_file;
+    MemoryBlock m_data;
+    std::unordered_map<int64, IndexEntry> m_index;
+    std::unordered_map<String, Layouts> m_added;
+    std::mutex m_mtx;
+
+    static String getKey(const String& id, const String& version) { return id + "|" + version; }
+
+    bool loadNoLock();
+
+    bool readRecord(const IndexEntry& e, String& key, Layouts& layouts) const;
+    static void writeRecord(OutputStream& out, const String& key, const Layouts& layouts);
+};
+
+}  // namespace e47
+
+#endif /* LayoutCache_hpp */
@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "PluginCatalog.hpp"
+#include "Processor.hpp"
+
+#include <unordered_map>
+
+namespace e47 {
+
+void PluginCatalog::writeString(OutputStream& out, const String& s) {
+    auto len = (int)s.getNumBytesAsUTF8();
+    out.writeShort((short)len);
+    out.write(s.toRawUTF8(), (size_t)len);
+}
+
+String PluginCatalog::readString(MemoryInputStream& in) {
+    auto len = (int)(uint16)in.readShort();
+    if (len == 0 || in.getNumBytesRemaining() < len) {
+        return {};
+    }
+    // decode straight from the mapped memory
+    auto* p = static_cast<const char*>(in.getData()) + in.getPosition();
+    in.skipNextBytes(len);
+    return String::fromUTF8(p, len);
+}
+
+void PluginCatalog::skipString(InputStream& in) { in.skipNextBytes((int64)(uint16)in.readShort()); }
+
+PluginCatalog::PluginCatalog() : LogTag("plugincatalog") {}
+
+bool PluginCatalog::open(const File& file) {
+    traceScope();
+
+    m_block.reset();
+    m_file.reset();
+    m_data = nullptr;
+    m_size = 0;
+
+    if (!file.existsAsFile()) {
+        return false;
+    }
+
+    m_file = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readOnly);
+    if (nullptr == m_file->getData()) {
+        logln("failed to map plugin catalog " << file.getFullPathName());
+        m_file.reset();
+        return false;
+    }
+
+    m_data = static_cast<const char*>(m_file->getData());
+    m_size = m_file->getSize();
+
+    if (!init()) {
+        logln("invalid plugin catalog " << file.getFullPathName() << ", ignoring it");
+        m_file.reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool PluginCatalog::open(MemoryBlock&& data) {
+    traceScope();
+
+    m_file.reset();
+    m_block = std::move(data);
+    m_data = static_cast<const char*>(m_block.getData());
+    m_size = m_block.getSize();
+
+    if (!init()) {
+        logln("invalid plugin catalog data");
+        m_block.reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool PluginCatalog::init() {
+    m_numPlugins = m_numBlocked = m_numSlots = 0;
+
+    if (nullptr == m_data || m_size < HEADER_SIZE || memcmp(m_data, "AGPC", 4) != 0 ||
+        ByteOrder::littleEndianInt(m_data + 4) != FORMAT_VERSION) {
+        m_data = nullptr;
+        m_size = 0;
+        return false;
+    }
+
+    m_numPlugins = ByteOrder::littleEndianInt(m_data + 8);
+    m_numBlocked = ByteOrder::littleEndianInt(m_data + 12);
+    m_numSlots = ByteOrder::littleEndianInt(m_data + 16);
+
+    bool valid = m_numSlots > 0 && isPowerOfTwo(m_numSlots) &&
+                 (uint64)HEADER_SIZE + (uint64)m_numSlots * SLOT_SIZE +
+                         ((uint64)m_numPlugins + m_numBlocked) * ENTRY_SIZE <=
+                     m_size;
+
+    if (!valid) {
+        m_numPlugins = m_numBlocked = m_numSlots = 0;
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    return valid;
+}
+
+bool PluginCatalog::getRecord(uint32 entry, const char*& data, size_t& size) const {
+    if (entry >= m_numPlugins + m_numBlocked) {
+        return false;
+    }
+    auto* e = m_data + HEADER_SIZE + m_numSlots * SLOT_SIZE + entry * ENTRY_SIZE;
+    auto offset = ByteOrder::littleEndianInt(e);
+    size = ByteOrder::littleEndianInt(e + 4);
+    if ((uint64)offset + size > m_size) {
+        return false;
+    }
+    data = m_data + offset;
+    return true;
+}
+
+uint32 PluginCatalog::findEntry(const String& key, bool blocklist, bool* matchedFile) const {
+    if (m_numSlots == 0 || key.isEmpty()) {
+        return 0;
+    }
+
+    auto hash = key.hashCode64();
+    auto mask = m_numSlots - 1;
+    auto slot = (uint32)((uint64)hash & mask);
+
+    for (uint32 i = 0; i < m_numSlots; i++) {
+        auto* s = m_data + HEADER_SIZE + slot * SLOT_SIZE;
+        auto value = ByteOrder::littleEndianInt(s + 8);
+        if (value == 0) {
+            break;
+        }
+
+        bool isBlocklistEntry = (value & BLOCKLIST_FLAG) != 0;
+        if ((int64)ByteOrder::littleEndianInt64(s) == hash && isBlocklistEntry == blocklist) {
+            const char* data;
+            size_t size;
+            if (getRecord((value & ~BLOCKLIST_FLAG) - 1, data, size)) {
+                MemoryInputStream in(data, size, false);
+                if (blocklist) {
+                    if (readString(in) == key) {
+                        return value;
+                    }
+                } else {
+                    bool idMatch = false;
+                    for (int k = 0; k < 3 && !idMatch; k++) {
+                        idMatch = readString(in) == key;
+                    }
+                    if (idMatch || readString(in) == key) {
+                        if (nullptr != matchedFile) {
+                            *matchedFile = !idMatch;
+                        }
+                        return value;
+                    }
+                }
+            }
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return 0;
+}
+
+int PluginCatalog::find(const String& id, bool* matchedFile) const {
+    return (int)findEntry(id, false, matchedFile) - 1;
+}
+
+String PluginCatalog::getPluginId(int idx) const {
+    const char* data;
+    size_t size;
+    if (idx < 0 || idx >= (int)m_numPlugins || !getRecord((uint32)idx, data, size)) {
+        return {};
+    }
+    MemoryInputStream in(data, size, false);
+    return readString(in);
+}
+
+bool PluginCatalog::getDescription(int idx, PluginDescription& desc) const {
+    const char* data;
+    size_t size;
+    if (idx < 0 || idx >= (int)m_numPlugins || !getRecord((uint32)idx, data, size)) {
+        return false;
+    }
+
+    MemoryInputStream in(data, size, false);
+    for (int k = 0; k < 3; k++) {
+        skipString(in);
+    }
+    desc.fileOrIdentifier = readString(in);
+    desc.name = readString(in);
+    desc.descriptiveName = readString(in);
+    desc.pluginFormatName = readString(in);
+    desc.category = readString(in);
+    desc.manufacturerName = readString(in);
+    desc.version = readString(in);
+    if (in.getNumBytesRemaining() < 2 * 8 + 4 * 4 + 1) {
+        return false;
+    }
+    desc.lastFileModTime = Time(in.readInt64());
+    desc.lastInfoUpdateTime = Time(in.readInt64());
+    desc.uniqueId = in.readInt();
+    desc.deprecatedUid = in.readInt();
+    desc.numInputChannels = in.readInt();
+    desc.numOutputChannels = in.readInt();
+    auto flags = (uint8)in.readByte();
+    desc.isInstrument = (flags & INSTRUMENT) != 0;
+    desc.hasSharedContainer = (flags & SHARED_CONTAINER) != 0;
+
+    return true;
+}
+
+bool PluginCatalog::isBlocklisted(const String& fileOrIdentifier) const {
+    return findEntry(fileOrIdentifier, true, nullptr) > 0;
+}
+
+void PluginCatalog::toKnownPluginList(KnownPluginList& plist) const {
+    traceScope();
+
+    for (int i = 0; i < (int)m_numPlugins; i++) {
+        PluginDescription desc;
+        if (!getDescription(i, desc)) {
+            logln("skipping invalid catalog record " << i);
+            continue;
+        }
+        plist.addType(desc);
+    }
+
+    for (uint32 i = 0; i < m_numBlocked; i++) {
+        const char* data;
+        size_t size;
+        if (getRecord(m_numPlugins + i, data, size)) {
+            MemoryInputStream in(data, size, false);
+            plist.addToBlacklist(readString(in));
+        }
+    }
+}
+
+void PluginCatalog::writeRecord(OutputStream& out, const PluginDescription& desc) {
+    writeString(out, Processor::createPluginID(desc));
+    writeString(out, Processor::createPluginIDWithName(desc));
+    writeString(out, Processor::createPluginIDDeprecated(desc));
+    writeString(out, desc.fileOrIdentifier);
+    writeString(out, desc.name);
+    writeString(out, desc.descriptiveName);
+    writeString(out, desc.pluginFormatName);
+    writeString(out, desc.category);
+    writeString(out, desc.manufacturerName);
+    writeString(out, desc.version);
+    out.writeInt64(desc.lastFileModTime.toMilliseconds());
+    out.writeInt64(desc.lastInfoUpdateTime.toMilliseconds());
+    out.writeInt(desc.uniqueId);
+    out.writeInt(desc.deprecatedUid);
+    out.writeInt(desc.numInputChannels);
+    out.writeInt(desc.numOutputChannels);
+    uint8 flags = 0;
+    if (desc.isInstrument) {
+        flags |= INSTRUMENT;
+    }
+    if (desc.hasSharedContainer) {
+        flags |= SHARED_CONTAINER;
+    }
+    out.writeByte((char)flags);
+}
+
+MemoryBlock PluginCatalog::build(const KnownPluginList& plist) {
+    setLogTagStatic("plugincatalog");
+    traceScope();
+
+    MemoryOutputStream records;
+    std::vector<std::pair<uint32, uint32>> entries;
+    std::unordered_map<String, uint32> pluginKeys, blockKeys;
+
+    auto types = plist.getTypes();
+    for (auto& desc : types) {
+        auto offset = (uint32)records.getDataSize();
+        writeRecord(records, desc);
+        entries.emplace_back(offset, (uint32)records.getDataSize() - offset);
+
+        auto value = (uint32)entries.size();
+        // the last plugin with a matching ID wins, the first one with a matching file
+        pluginKeys[Processor::createPluginID(desc)] = value;
+        pluginKeys[Processor::createPluginIDWithName(desc)] = value;
+        pluginKeys[Processor::createPluginIDDeprecated(desc)] = value;
+        pluginKeys.emplace(desc.fileOrIdentifier, value);
+    }
+
+    for (auto& entry : plist.getBlacklistedFiles()) {
+        auto offset = (uint32)records.getDataSize();
+        writeString(records, entry);
+        entries.emplace_back(offset, (uint32)records.getDataSize() - offset);
+        blockKeys[entry] = (uint32)entries.size() | BLOCKLIST_FLAG;
+    }
+
+    auto numSlots = (uint32)nextPowerOfTwo(jmax(16, (int)(pluginKeys.size() + blockKeys.size()) * 2));
+    auto mask = numSlots - 1;
+    std::vector<std::pair<int64, uint32>> slots(numSlots, {0, 0});
+
+    auto addKeys = [&](const std::unordered_map<String, uint32>& keys) {
+        for (auto& k : keys) {
+            if (k.first.isEmpty()) {
+                continue;
+            }
+            auto hash = k.first.hashCode64();
+            auto slot = (uint32)((uint64)hash & mask);
+            while (slots[slot].second != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = {hash, k.second};
+        }
+    };
+    addKeys(pluginKeys);
+    addKeys(blockKeys);
+
+    auto recordsStart = HEADER_SIZE + numSlots * SLOT_SIZE + (uint32)entries.size() * ENTRY_SIZE;
+
+    MemoryBlock data;
+    {
+        MemoryOutputStream out(data, false);
+        out.write("AGPC", 4);
+        out.writeInt((int)FORMAT_VERSION);
+        out.writeInt((int)types.size());
+        out.writeInt((int)(entries.size() - (size_t)types.size()));
+        out.writeInt((int)numSlots);
+        for (auto& s : slots) {
+            out.writeInt64(s.first);
+            out.writeInt((int)s.second);
+        }
+        for (auto& e : entries) {
+            out.writeInt((int)(recordsStart + e.first));
+            out.writeInt((int)e.second);
+        }
+        out.write(records.getData(), records.getDataSize());
+    }
+
+    return data;
+}
+
+bool PluginCatalog::write(const File& file, const KnownPluginList& plist) { return write(file, build(plist)); }
+
+bool PluginCatalog::write(const File& file, const MemoryBlock& data) {
+    setLogTagStatic("plugincatalog");
+    traceScope();
+
+    file.getParentDirectory().createDirectory();
+    TemporaryFile tmp(file);
+    if (!tmp.getFile().replaceWithData(data.getData(), data.getSize()) || !tmp.overwriteTargetFileWithTemporary()) {
+        logln("failed to write plugin catalog " << file.getFullPathName());
+        return false;
+    }
+
+    return true;
+}
+
+MemoryBlock PluginCatalog::importXml(const File& cacheFile) {
+    setLogTagStatic("plugincatalog");
+    traceScope();
+
+    if (!cacheFile.existsAsFile()) {
+        return {};
+    }
+
+    KnownPluginList plist;
+
+    logln("importing plugins cache from " << cacheFile.getFullPathName());
+    if (auto xml = XmlDocument::parse(cacheFile)) {
+        plist.recreateFromXml(*xml);
+    } else {
+        logln("failed to parse plugins cache " << cacheFile.getFullPathName());
+        return {};
+    }
+
+    return build(plist);
+}
+
+}  // namespace e47
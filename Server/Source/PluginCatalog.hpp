@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef PluginCatalog_hpp
+#define PluginCatalog_hpp
+
+#include <JuceHeader.h>
+
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Binary catalog of the known plugins and the blocklist. The file gets memory mapped, nothing is parsed when opening
+ * it. Plugins can be looked up by any of their IDs or their file/identifier via an open addressing hash table,
+ * descriptions are decoded on demand. The I/O layouts of the plugins are kept in the LayoutCache.
+ *
+ * Format (little endian):
+ *   header:  "AGPC", uint32 format version, uint32 number of plugins, uint32 number of blocklist entries,
+ *            uint32 number of hash slots (power of two)
+ *   slots:   per slot: int64 key hash, uint32 entry (0 = empty, entry index + 1, bit 31 set for blocklist entries)
+ *   entries: per plugin and blocklist entry: uint32 record offset, uint32 record size
+ *   records: plugin: string id, string id with name, string deprecated id, string file/identifier, string name,
+ *                    string descriptive name, string format, string category, string manufacturer, string version,
+ *                    int64 file mod time, int64 info update time, int32 uid, int32 deprecated uid,
+ *                    int32 input channels, int32 output channels, uint8 flags
+ *            blocklist: string file/identifier
+ *   (strings are stored as uint16 length + UTF8 bytes)
+ */
+class PluginCatalog : public LogTag {
+  public:
+    PluginCatalog();
+
+    // Memory maps a catalog file
+    bool open(const File& file);
+    // Uses an in memory catalog as created by build()
+    bool open(MemoryBlock&& data);
+
+    static MemoryBlock build(const KnownPluginList& plist);
+    // Writes a new file and renames it, so that processes, that have the old file mapped, are not affected
+    static bool write(const File& file, const KnownPluginList& plist);
+    static bool write(const File& file, const MemoryBlock& data);
+
+    // Creates a catalog from the legacy XML plugin cache
+    static MemoryBlock importXml(const File& cacheFile);
+
+    int getNumPlugins() const { return (int)m_numPlugins; }
+    int getNumBlocklisted() const { return (int)m_numBlocked; }
+
+    // Returns the index of the plugin with the given ID or file/identifier or -1. If matchedFile is passed, it will be
+    // set to true, if the file/identifier matched.
+    int find(const String& id, bool* matchedFile = nullptr) const;
+
+    String getPluginId(int idx) const;
+    bool getDescription(int idx, PluginDescription& desc) const;
+    bool isBlocklisted(const String& fileOrIdentifier) const;
+
+    void toKnownPluginList(KnownPluginList& plist) const;
+
+    // String encoding of the catalog, also used by the layout cache
+    static void writeString(OutputStream& out, const String& s);
+    static String readString(MemoryInputStream& in);
+    static void skipString(InputStream& in);
+
+  private:
+    static constexpr uint32 FORMAT_VERSION = 2;
+    static constexpr uint32 HEADER_SIZE = 20;
+    static constexpr uint32 SLOT_SIZE = 12;
+    static constexpr uint32 ENTRY_SIZE = 8;
+    static constexpr uint32 BLOCKLIST_FLAG = 0x80000000;
+
+    enum Flags : uint8 { INSTRUMENT = 1, SHARED_CONTAINER = 2 };
+
+    std::unique_ptr<MemoryMappedFile> m_file;
+    MemoryBlock m_block;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+    uint32 m_numPlugins = 0;
+    uint32 m_numBlocked = 0;
+    uint32 m_numSlots = 0;
+
+    bool init();
+    bool getRecord(uint32 entry, const char*& data, size_t& size) const;
+    uint32 findEntry(const String& key, bool blocklist, bool* matchedFile) const;
+
+    static void writeRecord(OutputStream& out, const PluginDescription& desc);
+};
+
+}  // namespace e47
+
+#endif /* PluginCatalog_hpp */
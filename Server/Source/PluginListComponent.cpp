@@ -242,6 +242,10 @@ void PluginListComponent::removeMissingPlugins() {
             m_list.removeType(type);
         }
     }
+
+    if (auto srv = getApp()->getServer()) {
+        srv->pluginListChanged();
+    }
 }
 
 void PluginListComponent::removePluginItems(const std::vector<int> indexes) {
@@ -257,6 +261,7 @@ void PluginListComponent::removePluginItems(const std::vector<int> indexes) {
 
     if (auto srv = getApp()->getServer()) {
         srv->saveConfig();
+        srv->pluginListChanged();
     }
 }
 
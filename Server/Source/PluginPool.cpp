@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "PluginPool.hpp"
+#include "Processor.hpp"
+#include "ProcessorChain.hpp"
+#include "AudioWorker.hpp"
+#include "Defaults.hpp"
+
+#if defined(JUCE_MAC)
+#include <mach/mach.h>
+#elif defined(JUCE_WINDOWS)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#endif
+
+namespace e47 {
+
+// Keep track of this many plugins per host for the next session
+static constexpr size_t MAX_SESSION_PLUGINS = 32;
+
+// Assume at least this much memory per instance, as measuring the resident size is not exact
+static constexpr size_t MIN_INSTANCE_BYTES = 1024 * 1024;
+
+PluginPool::Key::Key(const String& i, const String& l, const HandshakeRequest& cfg)
+    : id(i),
+      layout(l == "Default" ? "" : l),
+      sampleRate(cfg.sampleRate),
+      blockSize(cfg.samplesPerBlock),
+      channelsIn(cfg.channelsIn),
+      channelsOut(cfg.channelsOut),
+      channelsSC(cfg.channelsSC),
+      doublePrecision(cfg.doublePrecision) {}
+
+HandshakeRequest PluginPool::Key::toConfig() const {
+    HandshakeRequest cfg = {AG_PROTOCOL_VERSION, channelsIn, channelsOut, channelsSC, sampleRate, blockSize,
+                            doublePrecision, 0, 0, 0, 0, 0};
+    return cfg;
+}
+
+String PluginPool::Key::toString() const {
+    String s;
+    s << id << "|" << layout << "|" << sampleRate << "|" << blockSize << "|" << channelsIn << ":" << channelsOut << ":"
+      << channelsSC << "|" << (doublePrecision ? "d" : "f");
+    return s;
+}
+
+json PluginPool::Key::toJson() const {
+    json j;
+    j["id"] = id.toStdString();
+    j["layout"] = layout.toStdString();
+    j["rate"] = sampleRate;
+    j["samplesPerBlock"] = blockSize;
+    j["channelsIn"] = channelsIn;
+    j["channelsOut"] = channelsOut;
+    j["channelsSC"] = channelsSC;
+    j["doublePrecision"] = doublePrecision;
+    return j;
+}
+
+PluginPool::Key PluginPool::Key::fromJson(const json& j) {
+    Key k;
+    k.id = jsonGetValue(j, "id", k.id);
+    k.layout = jsonGetValue(j, "layout", k.layout);
+    k.sampleRate = jsonGetValue(j, "rate", k.sampleRate);
+    k.blockSize = jsonGetValue(j, "samplesPerBlock", k.blockSize);
+    k.channelsIn = jsonGetValue(j, "channelsIn", k.channelsIn);
+    k.channelsOut = jsonGetValue(j, "channelsOut", k.channelsOut);
+    k.channelsSC = jsonGetValue(j, "channelsSC", k.channelsSC);
+    k.doublePrecision = jsonGetValue(j, "doublePrecision", k.doublePrecision);
+    return k;
+}
+
+PluginPool::PluginPool(int serverId, size_t memoryBudgetMB, const KnownPluginList* pluginList)
+    : Thread("PluginPool"),
+      LogTag("pluginpool"),
+      m_serverId(serverId),
+      m_memoryBudget(memoryBudgetMB * 1024 * 1024),
+      m_pluginList(pluginList) {
+    traceScope();
+    logln("memory budget is " << (int)memoryBudgetMB << " MB");
+    loadSessions();
+    startThread();
+}
+
+PluginPool::~PluginPool() {
+    traceScope();
+    signalThreadShouldExit();
+    m_cv.notify_all();
+    stopThread(-1);
+    std::vector<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        entries.swap(m_entries);
+    }
+    for (auto& e : entries) {
+        release(e);
+    }
+}
+
+void PluginPool::run() {
+    traceScope();
+    while (!threadShouldExit()) {
+        Key key;
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            m_cv.wait_for(lock, std::chrono::seconds(1), [&] { return threadShouldExit() || findNextTarget(key); });
+            if (threadShouldExit() || key.id.isEmpty()) {
+                continue;
+            }
+            m_warming = key.toString();
+        }
+
+        logln("warming up " << key.toString());
+
+        String err;
+        auto memBefore = getResidentMemory();
+        auto inst = warmUp(key, err);
+        auto memAfter = getResidentMemory();
+        auto memBytes = jmax(MIN_INSTANCE_BYTES, memAfter > memBefore ? memAfter - memBefore : 0);
+
+        Entry entry = {key, inst, memBytes, Time::getMillisecondCounter()};
+        std::vector<Entry> evicted;
+        bool keep = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_warming.clear();
+            if (nullptr == inst) {
+                logln("failed to warm up " << key.toString() << ": " << err);
+                m_failed.insert(key.toString());
+            } else if (!makeRoom(memBytes, evicted)) {
+                logln("not enough memory budget left for " << key.toString() << " ("
+                                                           << String((double)memBytes / 1024 / 1024, 1) << " MB)");
+                m_failed.insert(key.toString());
+            } else {
+                m_entries.push_back(entry);
+                keep = true;
+            }
+        }
+        m_cv.notify_all();
+
+        for (auto& e : evicted) {
+            release(e);
+        }
+
+        if (keep) {
+            logln("warm instance ready: " << key.toString() << " (" << String((double)memBytes / 1024 / 1024, 1)
+                                          << " MB)");
+        } else {
+            release(entry);
+        }
+    }
+}
+
+void PluginPool::onClientConnected(const HandshakeRequest& cfg, const String& host) {
+    traceScope();
+    std::vector<Key> keys;
+    auto addKey = [&](const Key& k) {
+        if (std::find(keys.begin(), keys.end(), k) == keys.end()) {
+            keys.push_back(k);
+        }
+    };
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (jsonHasValue(m_sessions, host)) {
+            for (auto& j : m_sessions[host.toStdString()]) {
+                auto k = Key::fromJson(j);
+                addKey(Key(k.id, k.layout, cfg));
+            }
+        }
+    }
+    for (auto& id : AudioWorker::getRecentsIds(host)) {
+        addKey(Key(id, "", cfg));
+    }
+
+    logln("predicted " << (int)keys.size() << " plugin(s) for " << host);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_failed.clear();
+        // the most recent predictions go first
+        for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+            addTarget(*it);
+        }
+    }
+    m_cv.notify_all();
+}
+
+void PluginPool::recordSession(const String& host, const Key& key) {
+    traceScope();
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        auto& session = m_sessions[host.toStdString()];
+        if (!session.is_array()) {
+            session = json::array();
+        }
+        auto keyJson = key.toJson();
+        for (auto it = session.begin(); it != session.end();) {
+            if (Key::fromJson(*it) == key) {
+                it = session.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        session.insert(session.begin(), keyJson);
+        while (session.size() > MAX_SESSION_PLUGINS) {
+            session.erase(session.size() - 1);
+        }
+        addTarget(key);
+        saveSessions(host);
+    }
+    m_cv.notify_all();
+}
+
+std::shared_ptr<AudioPluginInstance> PluginPool::take(const Key& key) {
+    traceScope();
+    auto keyStr = key.toString();
+    std::shared_ptr<AudioPluginInstance> inst;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        // An instance, that is being warmed up right now, is not handed over. Loading could take as long as the warm up
+        // and the caller (AddPlugin) must not be blocked by the pool. The instance stays in the pool for a later load.
+        if (m_warming == keyStr) {
+            logln("instance " << keyStr << " is still warming up");
+        }
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->key.toString() == keyStr) {
+                inst = std::move(it->instance);
+                m_entries.erase(it);
+                break;
+            }
+        }
+    }
+    if (nullptr != inst) {
+        logln("handing over warm instance " << keyStr);
+        // replenish
+        m_cv.notify_all();
+    }
+    return inst;
+}
+
+size_t PluginPool::getNumInstances() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_entries.size();
+}
+
+size_t PluginPool::getMemoryUsage() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    size_t sum = 0;
+    for (auto& e : m_entries) {
+        sum += e.memBytes;
+    }
+    return sum;
+}
+
+bool PluginPool::hasEntry(const Key& key) const {
+    for (auto& e : m_entries) {
+        if (e.key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PluginPool::findNextTarget(Key& key) {
+    size_t used = 0;
+    for (auto& e : m_entries) {
+        used += e.memBytes;
+    }
+    if (used >= m_memoryBudget) {
+        return false;
+    }
+    for (auto& k : m_targets) {
+        if (!hasEntry(k) && m_failed.find(k.toString()) == m_failed.end()) {
+            key = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PluginPool::addTarget(const Key& key) {
+    m_targets.erase(std::remove(m_targets.begin(), m_targets.end(), key), m_targets.end());
+    m_targets.insert(m_targets.begin(), key);
+    while (m_targets.size() > MAX_SESSION_PLUGINS) {
+        m_targets.pop_back();
+    }
+}
+
+std::shared_ptr<AudioPluginInstance> PluginPool::warmUp(const Key& key, String& err) {
+    traceScope();
+    auto plugdesc = nullptr != m_pluginList ? Processor::findPluginDescription(key.id, *m_pluginList)
+                                            : Processor::findPluginDescription(key.id);
+    if (nullptr == plugdesc) {
+        err = "Plugin with ID " + key.id + " not found";
+        return nullptr;
+    }
+
+    // Run the same steps as a worker would run for loading the plugin into a chain with the given config
+    auto cfg = key.toConfig();
+    auto chain = std::make_shared<ProcessorChain>(
+        this, ProcessorChain::createBussesProperties(cfg.channelsIn, cfg.channelsOut, cfg.channelsSC), cfg);
+    if (cfg.doublePrecision && chain->supportsDoublePrecisionProcessing()) {
+        chain->setProcessingPrecision(AudioProcessor::doublePrecision);
+    }
+    chain->updateChannels(cfg.channelsIn, cfg.channelsOut, cfg.channelsSC);
+    chain->prepareToPlay(cfg.sampleRate, cfg.samplesPerBlock);
+
+    auto proc = std::make_shared<Processor>(*chain, key.id, cfg.sampleRate, cfg.samplesPerBlock);
+    // passing the description makes sure, that the processor does not ask the pool for an instance
+    if (!proc->load({}, key.layout, 0, err, plugdesc.get())) {
+        return nullptr;
+    }
+    return proc->detachPlugin();
+}
+
+bool PluginPool::makeRoom(size_t bytes, std::vector<Entry>& evicted) {
+    if (bytes > m_memoryBudget) {
+        return false;
+    }
+    size_t used = 0;
+    for (auto& e : m_entries) {
+        used += e.memBytes;
+    }
+    while (used + bytes > m_memoryBudget && !m_entries.empty()) {
+        // evict instances, that are not predicted anymore first, then the oldest
+        auto victim = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            bool isTarget = std::find(m_targets.begin(), m_targets.end(), it->key) != m_targets.end();
+            bool victimIsTarget = std::find(m_targets.begin(), m_targets.end(), victim->key) != m_targets.end();
+            if ((!isTarget && victimIsTarget) || (isTarget == victimIsTarget && it->created < victim->created)) {
+                victim = it;
+            }
+        }
+        logln("evicting " << victim->key.toString());
+        used -= victim->memBytes;
+        evicted.push_back(std::move(*victim));
+        m_entries.erase(victim);
+    }
+    return used + bytes <= m_memoryBudget;
+}
+
+void PluginPool::release(Entry& e) {
+    if (nullptr != e.instance) {
+        runOnMsgThreadSync([&] { e.instance->releaseResources(); });
+        e.instance.reset();
+    }
+}
+
+void PluginPool::loadSessions() {
+    traceScope();
+    auto file = Defaults::getConfigFileName(Defaults::PluginPoolSessions, {{"id", String(m_serverId)}});
+    if (File(file).existsAsFile()) {
+        m_sessions = configParseFile(file);
+    }
+    if (!m_sessions.is_object()) {
+        m_sessions = json::object();
+    }
+}
+
+void PluginPool::saveSessions(const String& host) {
+    traceScope();
+    auto file = Defaults::getConfigFileName(Defaults::PluginPoolSessions, {{"id", String(m_serverId)}});
+    // The sandboxes of a server share the file, so only the session of the given host gets replaced
+    InterProcessLock fileLock("AudioGridderPluginPool" + String(m_serverId));
+    InterProcessLock::ScopedLockType scopedLock(fileLock);
+    json sessions;
+    if (File(file).existsAsFile()) {
+        sessions = configParseFile(file);
+    }
+    if (!sessions.is_object()) {
+        sessions = json::object();
+    }
+    sessions[host.toStdString()] = m_sessions[host.toStdString()];
+    configWriteFile(file, sessions);
+}
+
+size_t PluginPool::getResidentMemory() {
+#if defined(JUCE_LINUX)
+    auto statm = StringArray::fromTokens(File("/proc/self/statm").loadFileAsString(), " ", "");
+    if (statm.size() > 1) {
+        return (size_t)statm[1].getLargeIntValue() * (size_t)sysconf(_SC_PAGESIZE);
+    }
+#elif defined(JUCE_MAC)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS) {
+        return (size_t)info.resident_size;
+    }
+#elif defined(JUCE_WINDOWS)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return (size_t)pmc.WorkingSetSize;
+    }
+#endif
+    return 0;
+}
+
+}  // namespace e47
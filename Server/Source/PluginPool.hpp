@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef PluginPool_hpp
+#define PluginPool_hpp
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <set>
+
+#include "Utils.hpp"
+#include "Message.hpp"
+#include "json.hpp"
+
+namespace e47 {
+
+/*
+ * Keeps a number of plugin instances instantiated and prepared, so that AddPlugin can hand over a warm instance
+ * instead of loading it. The instances to warm up are predicted from the recents list and the last session of a
+ * host. The pool is bounded by a memory budget. With chain isolation every sandbox runs its own pool, as instances can
+ * only be handed over within the same process.
+ */
+class PluginPool : public Thread, public LogTag {
+  public:
+    struct Key {
+        String id;
+        String layout;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        int channelsIn = 0;
+        int channelsOut = 0;
+        int channelsSC = 0;
+        bool doublePrecision = false;
+
+        Key() {}
+        Key(const String& i, const String& l, const HandshakeRequest& cfg);
+
+        HandshakeRequest toConfig() const;
+        String toString() const;
+        json toJson() const;
+        static Key fromJson(const json& j);
+
+        bool operator==(const Key& other) const { return toString() == other.toString(); }
+    };
+
+    // Plugins get looked up in the given list or in the list of the server, if no list is passed
+    PluginPool(int serverId, size_t memoryBudgetMB, const KnownPluginList* pluginList = nullptr);
+    ~PluginPool() override;
+
+    void run() override;
+
+    // Predict the plugins a client is going to load and start warming them up
+    void onClientConnected(const HandshakeRequest& cfg, const String& host);
+
+    // Remember a loaded plugin for the next session of the given host
+    void recordSession(const String& host, const Key& key);
+
+    // Returns a warm instance or nullptr, if there is none. Never waits for an instance, that is being warmed up.
+    std::shared_ptr<AudioPluginInstance> take(const Key& key);
+
+    size_t getNumInstances();
+    size_t getMemoryUsage();
+
+  private:
+    struct Entry {
+        Key key;
+        std::shared_ptr<AudioPluginInstance> instance;
+        size_t memBytes;
+        uint32 created;
+    };
+
+    int m_serverId;
+    size_t m_memoryBudget;
+    const KnownPluginList* m_pluginList;
+    std::vector<Entry> m_entries;
+    std::vector<Key> m_targets;
+    std::set<String> m_failed;
+    String m_warming;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+
+    json m_sessions;
+
+    bool hasEntry(const Key& key) const;
+    bool findNextTarget(Key& key);
+    void addTarget(const Key& key);
+    std::shared_ptr<AudioPluginInstance> warmUp(const Key& key, String& err);
+    bool makeRoom(size_t bytes, std::vector<Entry>& evicted);
+    static void release(Entry& e);
+
+    void loadSessions();
+    void saveSessions(const String& host);
+
+    static size_t getResidentMemory();
+};
+
+}  // namespace e47
+
+#endif /* PluginPool_hpp */
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "PluginWatcher.hpp"
+
+#if defined(JUCE_LINUX)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#elif defined(JUCE_MAC)
+#include <CoreServices/CoreServices.h>
+#elif defined(JUCE_WINDOWS)
+#include <windows.h>
+#endif
+
+namespace e47 {
+
+/*
+ * Signals changes below the watched folders. A notifier is created for the current set of folders and replaced after
+ * each handled change, so that new sub directories get picked up.
+ */
+class PluginWatcher::Notifier {
+  public:
+    explicit Notifier(const Array<File>& folders);
+    ~Notifier();
+
+    bool isActive() const;
+
+    // Returns true, if a change has been signaled within the timeout
+    bool wait(int timeoutMs);
+
+  private:
+#if defined(JUCE_LINUX)
+    int m_fd = -1;
+    void addWatches(const File& dir, int depth);
+#elif defined(JUCE_MAC)
+    FSEventStreamRef m_stream = nullptr;
+    dispatch_queue_t m_queue = nullptr;
+    WaitableEvent m_event;
+    static void callback(ConstFSEventStreamRef, void* info, size_t, void*, const FSEventStreamEventFlags*,
+                         const FSEventStreamEventId*);
+#elif defined(JUCE_WINDOWS)
+    std::vector<HANDLE> m_handles;
+#endif
+};
+
+#if defined(JUCE_LINUX)
+
+PluginWatcher::Notifier::Notifier(const Array<File>& folders) {
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        return;
+    }
+    for (auto& dir : folders) {
+        addWatches(dir, 0);
+    }
+}
+
+PluginWatcher::Notifier::~Notifier() {
+    if (m_fd > -1) {
+        close(m_fd);
+    }
+}
+
+bool PluginWatcher::Notifier::isActive() const { return m_fd > -1; }
+
+void PluginWatcher::Notifier::addWatches(const File& dir, int depth) {
+    if (!dir.isDirectory()) {
+        return;
+    }
+    // inotify is not recursive, so we add a watch for every directory the signature covers
+    inotify_add_watch(m_fd, dir.getFullPathName().toRawUTF8(),
+                      IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO);
+    for (auto& f : dir.findChildFiles(File::findDirectories, false)) {
+        if (isBundle(f)) {
+            inotify_add_watch(m_fd, f.getFullPathName().toRawUTF8(),
+                              IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO);
+        } else if (depth < MAX_DEPTH) {
+            addWatches(f, depth + 1);
+        }
+    }
+}
+
+bool PluginWatcher::Notifier::wait(int timeoutMs) {
+    pollfd pfd = {m_fd, POLLIN, 0};
+    if (poll(&pfd, 1, timeoutMs) > 0) {
+        char buf[4096];
+        while (read(m_fd, buf, sizeof(buf)) > 0) {
+        }
+        return true;
+    }
+    return false;
+}
+
+#elif defined(JUCE_MAC)
+
+PluginWatcher::Notifier::Notifier(const Array<File>& folders) {
+    auto paths = CFArrayCreateMutable(nullptr, 0, &kCFTypeArrayCallBacks);
+    for (auto& dir : folders) {
+        if (dir.isDirectory()) {
+            auto path = dir.getFullPathName().toCFString();
+            CFArrayAppendValue(paths, path);
+            CFRelease(path);
+        }
+    }
+    if (CFArrayGetCount(paths) > 0) {
+        FSEventStreamContext ctx = {0, this, nullptr, nullptr, nullptr};
+        m_stream = FSEventStreamCreate(nullptr, &callback, &ctx, paths, kFSEventStreamEventIdSinceNow, 1.0,
+                                       kFSEventStreamCreateFlagNoDefer);
+    }
+    CFRelease(paths);
+    if (nullptr != m_stream) {
+        m_queue = dispatch_queue_create("com.e47.audiogridder.pluginwatcher", DISPATCH_QUEUE_SERIAL);
+        FSEventStreamSetDispatchQueue(m_stream, m_queue);
+        if (!FSEventStreamStart(m_stream)) {
+            FSEventStreamInvalidate(m_stream);
+            FSEventStreamRelease(m_stream);
+            m_stream = nullptr;
+        }
+    }
+}
+
+PluginWatcher::Notifier::~Notifier() {
+    if (nullptr != m_stream) {
+        FSEventStreamStop(m_stream);
+        FSEventStreamInvalidate(m_stream);
+        FSEventStreamRelease(m_stream);
+    }
+    if (nullptr != m_queue) {
+        dispatch_release(m_queue);
+    }
+}
+
+bool PluginWatcher::Notifier::isActive() const { return nullptr != m_stream; }
+
+void PluginWatcher::Notifier::callback(ConstFSEventStreamRef, void* info, size_t, void*,
+                                       const FSEventStreamEventFlags*, const FSEventStreamEventId*) {
+    static_cast<Notifier*>(info)->m_event.signal();
+}
+
+bool PluginWatcher::Notifier::wait(int timeoutMs) { return m_event.wait(timeoutMs); }
+
+#elif defined(JUCE_WINDOWS)
+
+PluginWatcher::Notifier::Notifier(const Array<File>& folders) {
+    for (auto& dir : folders) {
+        if (!dir.isDirectory() || m_handles.size() == MAXIMUM_WAIT_OBJECTS) {
+            continue;
+        }
+        auto h = FindFirstChangeNotificationW(dir.getFullPathName().toWideCharPointer(), TRUE,
+                                              FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                                  FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+        if (h != INVALID_HANDLE_VALUE) {
+            m_handles.push_back(h);
+        }
+    }
+}
+
+PluginWatcher::Notifier::~Notifier() {
+    for (auto h : m_handles) {
+        FindCloseChangeNotification(h);
+    }
+}
+
+bool PluginWatcher::Notifier::isActive() const { return !m_handles.empty(); }
+
+bool PluginWatcher::Notifier::wait(int timeoutMs) {
+    auto ret = WaitForMultipleObjects((DWORD)m_handles.size(), m_handles.data(), FALSE, (DWORD)timeoutMs);
+    if (ret >= WAIT_OBJECT_0 && ret < WAIT_OBJECT_0 + m_handles.size()) {
+        FindNextChangeNotification(m_handles[ret - WAIT_OBJECT_0]);
+        return true;
+    }
+    return false;
+}
+
+#else
+
+PluginWatcher::Notifier::Notifier(const Array<File>&) {}
+PluginWatcher::Notifier::~Notifier() {}
+bool PluginWatcher::Notifier::isActive() const { return false; }
+bool PluginWatcher::Notifier::wait(int) { return false; }
+
+#endif
+
+PluginWatcher::PluginWatcher(FoldersFn getFolders, ChangeFn onChange)
+    : Thread("PluginWatcher"), LogTag("pluginwatcher"), m_getFolders(getFolders), m_onChange(onChange) {}
+
+PluginWatcher::~PluginWatcher() {
+    traceScope();
+    stopThread(-1);
+}
+
+void PluginWatcher::run() {
+    traceScope();
+
+    auto last = getSignature();
+    auto notifier = std::make_unique<Notifier>(m_getFolders());
+
+    if (!notifier->isActive()) {
+        logln("file system notifications are not available, polling the plugin folders");
+    }
+
+    while (!threadShouldExit()) {
+        waitForChange(*notifier);
+        if (threadShouldExit()) {
+            break;
+        }
+
+        // notifications are coarse (e.g. unrelated files in the folders), so the signature decides
+        auto sig = getSignature();
+        if (sig == last) {
+            continue;
+        }
+
+        // wait for the changes to settle
+        uint64 settled;
+        do {
+            settled = sig;
+            sleepExitAware(SETTLE_TIME_MS);
+            sig = getSignature();
+        } while (sig != settled && !threadShouldExit());
+
+        if (threadShouldExit()) {
+            break;
+        }
+
+        logln("plugin folders changed, triggering a background scan");
+        m_onChange();
+
+        last = getSignature();
+        notifier = std::make_unique<Notifier>(m_getFolders());
+    }
+}
+
+bool PluginWatcher::waitForChange(Notifier& notifier) {
+    // polling is only a fallback with notifications, e.g. for network shares that do not report changes
+    int timeout = notifier.isActive() ? FALLBACK_INTERVAL_MS : CHECK_INTERVAL_MS;
+    for (int waited = 0; waited < timeout && !threadShouldExit(); waited += WAIT_SLICE_MS) {
+        if (notifier.isActive()) {
+            if (notifier.wait(WAIT_SLICE_MS)) {
+                return true;
+            }
+        } else {
+            sleep(WAIT_SLICE_MS);
+        }
+    }
+    return false;
+}
+
+uint64 PluginWatcher::getSignature() {
+    uint64 sig = 0;
+    for (auto& dir : m_getFolders()) {
+        if (dir.isDirectory()) {
+            addToSignature(dir, 0, sig);
+        }
+    }
+    return sig;
+}
+
+void PluginWatcher::addToSignature(const File& dir, int depth, uint64& sig) {
+    auto add = [&sig](const File& f) {
+        sig = sig * 31 + (uint64)f.getFullPathName().hashCode64();
+        sig = sig * 31 + (uint64)f.getLastModificationTime().toMilliseconds();
+        sig = sig * 31 + (uint64)f.getSize();
+    };
+    add(dir);
+    for (auto& f : dir.findChildFiles(File::findFilesAndDirectories, false)) {
+        add(f);
+        if (f.isDirectory()) {
+            if (isBundle(f)) {
+                // bundles get replaced or updated by installers, the top level is enough to notice that
+                for (auto& c : f.findChildFiles(File::findFilesAndDirectories, false)) {
+                    add(c);
+                }
+            } else if (depth < MAX_DEPTH) {
+                addToSignature(f, depth + 1, sig);
+            }
+        }
+    }
+}
+
+bool PluginWatcher::isBundle(const File& f) { return f.hasFileExtension("vst3;vst;component;lv2;bundle"); }
+
+}  // namespace e47
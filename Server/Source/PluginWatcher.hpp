@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef PluginWatcher_hpp
+#define PluginWatcher_hpp
+
+#include <JuceHeader.h>
+
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Watches the plugin folders for changes and triggers a callback, once the changes settled (e.g. an installer
+ * finished). The watcher wakes up on file system notifications (inotify, FSEvents or change notifications on
+ * windows) and falls back to polling, if notifications are not available. Only directories and the top level of
+ * plugin bundles are checked.
+ */
+class PluginWatcher : public Thread, public LogTag {
+  public:
+    using FoldersFn = std::function<Array<File>()>;
+    using ChangeFn = std::function<void()>;
+
+    PluginWatcher(FoldersFn getFolders, ChangeFn onChange);
+    ~PluginWatcher() override;
+
+    void run() override;
+
+  private:
+    static constexpr int CHECK_INTERVAL_MS = 10000;
+    static constexpr int FALLBACK_INTERVAL_MS = 300000;
+    static constexpr int WAIT_SLICE_MS = 500;
+    static constexpr int SETTLE_TIME_MS = 5000;
+    static constexpr int MAX_DEPTH = 4;
+
+    class Notifier;
+
+    FoldersFn m_getFolders;
+    ChangeFn m_onChange;
+
+    bool waitForChange(Notifier& notifier);
+    uint64 getSignature();
+    static void addToSignature(const File& dir, int depth, uint64& sig);
+    static bool isBundle(const File& f);
+};
+
+}  // namespace e47
+
+#endif /* PluginWatcher_hpp */
@@ -9,6 +9,7 @@
 #include "ProcessorChain.hpp"
 #include "App.hpp"
 #include "Server.hpp"
+#include "PluginPool.hpp"
 
 namespace e47 {
 
@@ -130,6 +131,9 @@ String Processor::convertJUCEtoAGPluginID(const String& id) {
 }
 
 std::unique_ptr<PluginDescription> Processor::findPluginDescription(const String& id, String* idNormalized) {
+    if (auto srv = getApp()->getServer()) {
+        return srv->findPluginDescription(id, idNormalized);
+    }
     return findPluginDescription(id, getApp()->getPluginList(), idNormalized);
 }
 
@@ -162,7 +166,8 @@ std::unique_ptr<PluginDescription> Processor::findPluginDescription(const String
     return plugdesc;
 }
 
-Array<AudioProcessor::BusesLayout> Processor::findSupportedLayouts(std::shared_ptr<AudioPluginInstance> proc) {
+Array<AudioProcessor::BusesLayout> Processor::findSupportedLayouts(std::shared_ptr<AudioPluginInstance> proc,
+                                                                   bool prune) {
     setLogTagStatic("processor");
 
     int busesIn = proc->getBusCount(true);
@@ -274,13 +279,132 @@ Array<AudioProcessor::BusesLayout> Processor::findSupportedLayouts(std::shared_p
 
     logln("trying " << layouts.size() << " layouts...");
 
+    // remember results, so that no layout gets probed twice
+    std::unordered_map<String, bool> probed;
+    auto probe = [&](const AudioProcessor::BusesLayout& l) {
+        auto key = serializeLayout(l);
+        auto it = probed.find(key);
+        if (it != probed.end()) {
+            return it->second;
+        }
+        bool ok = proc->checkBusesLayoutSupported(l);
+        probed[key] = ok;
+        return ok;
+    };
+
+    auto current = proc->getBusesLayout();
+
+    // Probe each bus on its own with the other buses in their current layout. If a bus does not accept a channel set
+    // on its own or mirrored on the main bus of the other direction, no layout that contains it needs to be tried.
+    auto busKey = [](bool isInput, int bus, const AudioChannelSet& set) {
+        String key = isInput ? "i" : "o";
+        key << bus << ":" << set.getSpeakerArrangementAsString();
+        return key;
+    };
+
+    std::set<String> rejected;
+
+    auto probeBus = [&](bool isInput, int bus) {
+        // collect the channel sets in question, every set gets probed, as plugins often support a few surround sets
+        // only (e.g. 5.1 but not 5.0), so a failure says nothing about the bigger sets
+        Array<AudioChannelSet> sets;
+        for (auto& l : layouts) {
+            auto& buses = isInput ? l.inputBuses : l.outputBuses;
+            if (bus < buses.size()) {
+                sets.addIfNotAlreadyThere(buses[bus]);
+            }
+        }
+
+        for (auto& set : sets) {
+            auto l = current;
+            auto& buses = isInput ? l.inputBuses : l.outputBuses;
+            auto& otherBuses = isInput ? l.outputBuses : l.inputBuses;
+            if (bus >= buses.size()) {
+                continue;
+            }
+            buses.getReference(bus) = set;
+
+            bool ok = probe(l);
+            if (!ok && bus == 0 && otherBuses.size() > 0) {
+                otherBuses.getReference(0) = set;
+                ok = probe(l);
+            }
+            if (!ok) {
+                rejected.insert(busKey(isInput, bus, set));
+            }
+        }
+    };
+
+    if (prune) {
+        // common layouts first
+        for (auto& l : getCommonLayouts(busesIn, busesOut)) {
+            probe(l);
+        }
+
+        for (int bus = 0; bus < busesIn; bus++) {
+            probeBus(true, bus);
+        }
+        for (int bus = 0; bus < busesOut; bus++) {
+            probeBus(false, bus);
+        }
+    }
+
+    auto isRejected = [&](const AudioProcessor::BusesLayout& l) {
+        for (int bus = 0; bus < l.inputBuses.size(); bus++) {
+            if (rejected.find(busKey(true, bus, l.inputBuses[bus])) != rejected.end()) {
+                return true;
+            }
+        }
+        for (int bus = 0; bus < l.outputBuses.size(); bus++) {
+            if (rejected.find(busKey(false, bus, l.outputBuses[bus])) != rejected.end()) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    int pruned = 0;
     for (auto& l : layouts) {
-        if (proc->checkBusesLayoutSupported(l)) {
+        if (!(l == current) && isRejected(l)) {
+            pruned++;
+            continue;
+        }
+        if (probe(l)) {
             logln("  " << describeLayout(l) << ": OK");
             ret.add(l);
         }
     }
 
+    logln("probed " << probed.size() << " layouts, pruned " << pruned << " of " << layouts.size());
+
+    return ret;
+}
+
+Array<AudioProcessor::BusesLayout> Processor::getCommonLayouts(int busesIn, int busesOut) {
+    Array<AudioProcessor::BusesLayout> ret;
+    if (busesOut < 1) {
+        return ret;
+    }
+    for (auto& set : {AudioChannelSet::stereo(), AudioChannelSet::mono()}) {
+        AudioProcessor::BusesLayout l;
+        l.outputBuses.add(set);
+        for (int bus = 1; bus < busesOut; bus++) {
+            l.outputBuses.add(AudioChannelSet::stereo());
+        }
+        if (busesIn > 0) {
+            l.inputBuses.add(set);
+            if (busesIn > 1) {
+                // with stereo and mono sidechain
+                l.inputBuses.add(AudioChannelSet::stereo());
+                ret.add(l);
+                l.inputBuses.getReference(1) = AudioChannelSet::mono();
+                for (int bus = 2; bus < busesIn; bus++) {
+                    l.inputBuses.add(AudioChannelSet::stereo());
+                }
+            }
+        }
+        ret.add(l);
+    }
     return ret;
 }
 
@@ -291,14 +415,16 @@ Array<AudioProcessor::BusesLayout> Processor::findSupportedLayouts(Processor* pr
     return {};
 }
 
-const Array<AudioProcessor::BusesLayout>& Processor::getSupportedBusLayouts() const {
+Array<AudioProcessor::BusesLayout> Processor::getSupportedBusLayouts() const {
+    if (!m_supportedLayouts.isEmpty()) {
+        return m_supportedLayouts;
+    }
 #ifndef AG_UNIT_TESTS
     if (auto srv = getApp()->getServer()) {
         return srv->getPluginLayouts(m_idNormalized);
     }
 #endif
-    static Array<AudioProcessor::BusesLayout> ret;
-    return ret;
+    return {};
 }
 
 std::shared_ptr<AudioPluginInstance> Processor::loadPlugin(const PluginDescription& plugdesc, double sampleRate,
@@ -352,6 +478,7 @@ void Processor::setCallbacks(ParamValueChangeCallback valueChangeFn, ParamGestur
 
     if (auto c = getClient()) {
         c->onParamValueChange = [this](int channel, int paramIdx, float value) {
+            markStateDirty();
             onParamValueChange(m_chainIdx, channel, paramIdx, value);
         };
         c->onParamGestureChange = [this](int channel, int paramIdx, bool value) {
@@ -376,7 +503,11 @@ bool Processor::load(const String& settings, const String& layout, uint64 monoCh
 
     if (m_isClient) {
 #ifndef AG_UNIT_TESTS
-        bool found = nullptr != findPluginDescription(m_id, &m_idNormalized);
+        // the plugin does not have to be installed locally, if it runs on another server
+        bool found = m_remoteHost.isNotEmpty() || nullptr != findPluginDescription(m_id, &m_idNormalized);
+        if (m_idNormalized.isEmpty()) {
+            m_idNormalized = m_id;
+        }
 #else
         bool found = true;
         m_idNormalized = m_id;
@@ -385,7 +516,12 @@ bool Processor::load(const String& settings, const String& layout, uint64 monoCh
             std::shared_ptr<ProcessorClient> client;
 
             {
-                client = std::make_shared<ProcessorClient>(m_idNormalized, m_chain.getConfig());
+                client = std::make_shared<ProcessorClient>(m_idNormalized, m_chain.getConfig(), m_remoteHost);
+#ifndef AG_UNIT_TESTS
+                if (auto srv = getApp()->getServer()) {
+                    client->setSnapshotMaxAge((uint32)srv->getSandboxSnapshotMaxAgeSecs() * 1000);
+                }
+#endif
                 std::lock_guard<std::mutex> lock(m_pluginMtx);
                 m_client = client;
             }
@@ -399,7 +535,8 @@ bool Processor::load(const String& settings, const String& layout, uint64 monoCh
                     m_name = client->getName();
                 }
             } else {
-                err = "failed to initialize sandbox";
+                err = m_remoteHost.isNotEmpty() ? "failed to connect to " + m_remoteHost
+                                                : String("failed to initialize sandbox");
                 if (client->getError().isNotEmpty()) {
                     err << ": " << client->getError();
                 }
@@ -433,11 +570,27 @@ bool Processor::load(const String& settings, const String& layout, uint64 monoCh
         m_multiMonoBypassBuffersF.resize((size_t)m_channels);
         m_multiMonoBypassBuffersD.resize((size_t)m_channels);
 
-        std::shared_ptr<AudioPluginInstance> p;
+        std::shared_ptr<AudioPluginInstance> p, warm;
+
+#ifndef AG_UNIT_TESTS
+        // The pool passes a description when warming up instances, so it never asks itself
+        if (m_channels == 1 && nullptr == plugdesc) {
+            if (auto srv = getApp()->getServer()) {
+                if (auto pool = srv->getPluginPool()) {
+                    warm = pool->take(PluginPool::Key(m_id, layout, m_chain.getConfig()));
+                    if (nullptr != warm) {
+                        findPluginDescription(m_id, &m_idNormalized);
+                    }
+                }
+            }
+        }
+#endif
 
         bool loadErr = false;
         for (size_t ch = 0; ch < (size_t)m_channels && !loadErr; ch++) {
-            if (nullptr != plugdesc) {
+            if (nullptr != warm) {
+                p = warm;
+            } else if (nullptr != plugdesc) {
                 p = loadPlugin(*plugdesc, m_sampleRate, m_blockSize, err);
             } else {
                 p = loadPlugin(m_id, m_sampleRate, m_blockSize, err, &m_idNormalized);
@@ -456,7 +609,7 @@ bool Processor::load(const String& settings, const String& layout, uint64 monoCh
             }
         }
 
-        if (!loadErr && m_chain.initPluginInstance(this, m_channels > 1 ? "Mono" : layout, err)) {
+        if (!loadErr && m_chain.initPluginInstance(this, m_channels > 1 ? "Mono" : layout, err, nullptr != warm)) {
             loaded = true;
             loadedCount++;
 
@@ -540,6 +693,30 @@ void Processor::unload() {
     m_name.clear();
 }
 
+std::shared_ptr<AudioPluginInstance> Processor::detachPlugin() {
+    traceScope();
+
+    if (m_isClient || m_channels != 1 || !isLoaded()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<AudioPluginInstance> plugin;
+    std::unique_ptr<Listener> listener;
+    {
+        std::lock_guard<std::mutex> lock(m_pluginMtx);
+        plugin = std::move(m_plugins[0]);
+        listener = std::move(m_listners[0]);
+    }
+    for (auto* param : plugin->getParameters()) {
+        param->removeListener(listener.get());
+    }
+    loadedCount--;
+    m_prepared = false;
+    m_name.clear();
+
+    return plugin;
+}
+
 bool Processor::isLoaded() {
     if (m_isClient) {
         if (auto c = getClient()) {
@@ -686,8 +863,17 @@ void Processor::processBlockBypassedMultiMono(AudioBuffer<double>& buffer, int c
 
 void Processor::prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) {
     traceScope();
+    m_sampleRate = sampleRate;
+    m_blockSize = maximumExpectedSamplesPerBlock;
     if (isLoaded()) {
-        if (!m_isClient) {
+        if (m_isClient) {
+            // the sandbox has been prepared at startup, it only needs to know about changes
+            if (auto c = getClient()) {
+                if (!c->reconfigure(sampleRate, maximumExpectedSamplesPerBlock)) {
+                    logln("failed to reconfigure the sandbox of '" << getName() << "', restarting it");
+                }
+            }
+        } else {
             ChannelSet cs;
             {
                 std::lock_guard<std::mutex> lock(m_monoChannelsMtx);
@@ -895,6 +1081,15 @@ void Processor::setProcessingPrecision(AudioProcessor::ProcessingPrecision prec)
     }
 }
 
+bool Processor::isUsingDoublePrecision() {
+    if (!m_isClient) {
+        if (auto p = getPlugin(0)) {
+            return p->isUsingDoublePrecision();
+        }
+    }
+    return false;
+}
+
 AudioProcessorEditor* Processor::createEditorIfNeeded() {
     traceScope();
     if (auto p = getPlugin(m_activeWindowChannel)) {
@@ -1201,8 +1396,22 @@ void Processor::getStateInformation(String& settings) {
     }
 }
 
+bool Processor::getStateInformationIfChanged(const String& knownHash, String& settings, String& hash) {
+    traceScope();
+    if (!m_stateDirty && knownHash.isNotEmpty() && knownHash == m_stateHash) {
+        return false;
+    }
+    // reset the flag before reading the state, so that changes while reading mark it dirty again
+    m_stateDirty = false;
+    getStateInformation(settings);
+    hash = PluginSettings::getHash(settings);
+    m_stateHash = hash;
+    return hash != knownHash;
+}
+
 void Processor::setStateInformation(const String& settings) {
     traceScope();
+    markStateDirty();
     if (m_isClient) {
         if (auto c = getClient()) {
             c->setStateInformation(settings);
@@ -1325,6 +1534,7 @@ const String Processor::getProgramName(int idx) {
 }
 
 void Processor::setCurrentProgram(int idx, int channel) {
+    markStateDirty();
     if (m_isClient) {
         if (auto c = getClient()) {
             c->setCurrentProgram(idx);
@@ -50,13 +50,29 @@ class Processor : public LogTagDelegate, public std::enable_shared_from_this<Pro
     static std::unique_ptr<PluginDescription> findPluginDescription(const String& id, const KnownPluginList& pluglist,
                                                                     String* idNormalized = nullptr);
 
-    static Array<AudioProcessor::BusesLayout> findSupportedLayouts(std::shared_ptr<AudioPluginInstance> proc);
+    // Probes the I/O layouts a plugin supports. Common layouts are probed first, then each bus on its own to prune
+    // all layouts containing channel sets a bus does not support.
+    // Without pruning every generated layout gets probed
+    static Array<AudioProcessor::BusesLayout> findSupportedLayouts(std::shared_ptr<AudioPluginInstance> proc,
+                                                                   bool prune = true);
     static Array<AudioProcessor::BusesLayout> findSupportedLayouts(Processor* proc);
+    static Array<AudioProcessor::BusesLayout> getCommonLayouts(int busesIn, int busesOut);
 
-    const Array<AudioProcessor::BusesLayout>& getSupportedBusLayouts() const;
+    Array<AudioProcessor::BusesLayout> getSupportedBusLayouts() const;
+    // Overrides the layouts cached by the server, e.g. in batch mode where there is no server
+    void setSupportedBusLayouts(const Array<AudioProcessor::BusesLayout>& layouts) { m_supportedLayouts = layouts; }
 
     bool isClient() const { return m_isClient; }
 
+    // Loads the plugin on the server at the given host ("host:id") instead of this one, has to be called before load
+    void setRemoteHost(const String& host) {
+        m_remoteHost = host;
+        if (host.isNotEmpty()) {
+            m_isClient = true;
+        }
+    }
+    const String& getRemoteHost() const { return m_remoteHost; }
+
     void updateScreenCaptureArea(int val);
     int getAdditionalScreenCapturingSpace();
     bool isFullscreen();
@@ -71,9 +87,14 @@ class Processor : public LogTagDelegate, public std::enable_shared_from_this<Pro
     void unload();
     bool isLoaded();
 
+    // Hands the plugin instance over to the caller, used to fill the plugin pool. Returns nullptr for sandbox
+    // clients and multi-mono processors.
+    std::shared_ptr<AudioPluginInstance> detachPlugin();
+
     void setChainIndex(int idx) { m_chainIdx = idx; }
 
     const String& getPluginId() const { return m_id; }
+    const String& getPluginIdNormalized() const { return m_idNormalized; }
 
     bool processBlock(AudioBuffer<float>& buffer, MidiBuffer& midiMessages, int& latencySamples);
     bool processBlock(AudioBuffer<double>& buffer, MidiBuffer& midiMessages, int& latencySamples);
@@ -88,6 +109,12 @@ class Processor : public LogTagDelegate, public std::enable_shared_from_this<Pro
     void updateLatencyBuffers(int newLatency);
     void enableAllBuses();
     void setProcessingPrecision(AudioProcessor::ProcessingPrecision p);
+    bool isUsingDoublePrecision();
+    void setPrepared(bool b) { m_prepared = b; }
+
+    // A processor is loading, while it is being loaded in the background for an asynchronous insertion
+    bool isLoading() const { return m_loading; }
+    void setLoading(bool b) { m_loading = b; }
     void setMonoChannels(uint64 channels);
     bool isMonoChannelActive(int ch);
 
@@ -152,6 +179,12 @@ class Processor : public LogTagDelegate, public std::enable_shared_from_this<Pro
     double getTailLengthSeconds();
     void getStateInformation(String& settings);
     void setStateInformation(const String& settings);
+
+    // The state is marked dirty by parameter and program changes, state updates and editor interaction. Returns
+    // false, if the state is equal to the state with the given hash, otherwise settings and hash get filled.
+    bool getStateInformationIfChanged(const String& knownHash, String& settings, String& hash);
+    void markStateDirty() { m_stateDirty = true; }
+    bool isStateDirty() const { return m_stateDirty; }
     bool checkBusesLayoutSupported(const AudioProcessor::BusesLayout& layout);
     bool setBusesLayout(const AudioProcessor::BusesLayout& layout);
     AudioProcessor::BusesLayout getBusesLayout();
@@ -178,6 +211,7 @@ class Processor : public LogTagDelegate, public std::enable_shared_from_this<Pro
         Listener(Processor* p, int c) : proc(p), channel(c) {}
 
         void parameterValueChanged(int parameterIndex, float newValue) override {
+            proc->markStateDirty();
             if (proc->onParamValueChange) {
                 proc->onParamValueChange(proc->m_chainIdx, channel, parameterIndex, newValue);
             }
@@ -194,9 +228,11 @@ class Processor : public LogTagDelegate, public std::enable_shared_from_this<Pro
     int m_chainIdx = -1;
     String m_id;
     String m_idNormalized;
+    Array<AudioProcessor::BusesLayout> m_supportedLayouts;
     double m_sampleRate;
     int m_blockSize;
     bool m_isClient;
+    String m_remoteHost;
     std::shared_ptr<ProcessorClient> m_client;
     std::vector<std::shared_ptr<AudioPluginInstance>> m_plugins;
     std::vector<std::shared_ptr<ProcessorWindow>> m_windows;
@@ -208,6 +244,9 @@ class Processor : public LogTagDelegate, public std::enable_shared_from_this<Pro
     int m_additionalScreenSpace = 0;
     bool m_fullscreen = false;
     bool m_prepared = false;
+    std::atomic_bool m_loading{false};
+    std::atomic_bool m_stateDirty{true};
+    String m_stateHash;
     String m_name;
     String m_layout;
     ChannelSet m_monoChannels;
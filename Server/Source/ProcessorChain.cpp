@@ -8,6 +8,7 @@
 #include "ProcessorChain.hpp"
 #include "Processor.hpp"
 #include "App.hpp"
+#include "Server.hpp"
 
 namespace e47 {
 
@@ -16,7 +17,9 @@ void ProcessorChain::prepareToPlay(double sampleRate, int maximumExpectedSamples
     setRateAndBufferSizeDetails(sampleRate, maximumExpectedSamplesPerBlock);
     std::lock_guard<std::mutex> lock(m_processorsMtx);
     for (auto& proc : m_processors) {
-        proc->prepareToPlay(sampleRate, maximumExpectedSamplesPerBlock);
+        if (!proc->isLoading()) {
+            proc->prepareToPlay(sampleRate, maximumExpectedSamplesPerBlock);
+        }
     }
 }
 
@@ -24,7 +27,9 @@ void ProcessorChain::releaseResources() {
     traceScope();
     std::lock_guard<std::mutex> lock(m_processorsMtx);
     for (auto& proc : m_processors) {
-        proc->releaseResources();
+        if (!proc->isLoading()) {
+            proc->releaseResources();
+        }
     }
 }
 
@@ -32,7 +37,9 @@ void ProcessorChain::setPlayHead(AudioPlayHead* ph) {
     AudioProcessor::setPlayHead(ph);
     std::lock_guard<std::mutex> lock(m_processorsMtx);
     for (auto& proc : m_processors) {
-        proc->setPlayHead(ph);
+        if (!proc->isLoading()) {
+            proc->setPlayHead(ph);
+        }
     }
 }
 
@@ -77,12 +84,13 @@ bool ProcessorChain::updateChannels(int channelsIn, int channelsOut, int channel
         logln("failed to set layout");
     }
     std::lock_guard<std::mutex> lock(m_processorsMtx);
-    m_extraChannels = 0;
     m_hasSidechain = channelsSC > 0;
-    m_sidechainDisabled = false;
     for (auto& proc : m_processors) {
-        setProcessorBusesLayout(proc.get(), proc->getLayout());
+        if (!proc->isLoading()) {
+            setProcessorBusesLayout(proc.get(), proc->getLayout());
+        }
     }
+    updateNoLock();
     return true;
 }
 
@@ -110,6 +118,11 @@ bool ProcessorChain::setProcessorBusesLayout(Processor* proc, const String& targ
     if (procLayouts.isEmpty()) {
         logln("no processor layouts cached, checking now...");
         procLayouts = Processor::findSupportedLayouts(proc);
+#ifndef AG_UNIT_TESTS
+        if (auto srv = getApp()->getServer()) {
+            srv->storePluginLayouts(proc->getPluginIdNormalized(), procLayouts);
+        }
+#endif
     }
 
     if (targetOutputLayout.isNotEmpty()) {
@@ -186,12 +199,10 @@ bool ProcessorChain::setProcessorBusesLayout(Processor* proc, const String& targ
         extraInChannels = targetChIn - chIn;
         extraOutChannels = targetChOut - chOut;
 
+        // the chain total gets updated, when the processor becomes active
         proc->setExtraChannels(extraInChannels, extraOutChannels);
 
-        m_extraChannels = jmax(m_extraChannels, extraInChannels, extraOutChannels);
-
-        logln(extraInChannels << " extra input(s), " << extraOutChannels << " extra output(s) -> " << m_extraChannels
-                              << " extra channel(s) in total");
+        logln(extraInChannels << " extra input(s), " << extraOutChannels << " extra output(s)");
 
         logln("setting processor to I/O layout: " << describeLayout(targetLayout));
     } else {
@@ -201,14 +212,11 @@ bool ProcessorChain::setProcessorBusesLayout(Processor* proc, const String& targ
     return found;
 }
 
-int ProcessorChain::getExtraChannels() {
-    traceScope();
-    std::lock_guard<std::mutex> lock(m_processorsMtx);
-    return m_extraChannels;
-}
+int ProcessorChain::getExtraChannels() { return m_extraChannels; }
 
-bool ProcessorChain::initPluginInstance(Processor* proc, const String& layout, String& err) {
+bool ProcessorChain::initPluginInstance(Processor* proc, const String& layout, String& err, bool warm) {
     traceScope();
+    auto warmLayout = proc->getBusesLayout();
     if (!setProcessorBusesLayout(proc, layout)) {
         err = "failed to find a working I/O configuration";
         return false;
@@ -221,6 +229,18 @@ bool ProcessorChain::initPluginInstance(Processor* proc, const String& layout, S
             logln("host wants double precision but plugin '" << proc->getName() << "' does not support it");
         }
     }
+    if (warm) {
+        // a warm instance from the plugin pool has been prepared with the same config already
+        if (proc->getBusesLayout() == warmLayout &&
+            proc->isUsingDoublePrecision() == (prec == AudioProcessor::doublePrecision)) {
+            logln("using warm instance of '" << proc->getName() << "'");
+            proc->setPrepared(true);
+            proc->setPlayHead(getPlayHead());
+            return true;
+        }
+        logln("warm instance of '" << proc->getName() << "' does not match, preparing again");
+        proc->releaseResources();
+    }
     proc->setProcessingPrecision(prec);
     proc->prepareToPlay(getSampleRate(), getBlockSize());
     proc->enableAllBuses();
@@ -243,12 +263,13 @@ bool ProcessorChain::initPluginInstance(Processor* proc, const String& layout, S
 }
 
 bool ProcessorChain::addPluginProcessor(const String& id, const String& settings, const String& layout,
-                                        uint64 monoChannels, String& err) {
+                                        uint64 monoChannels, const String& host, String& err) {
     traceScope();
 
     bool success = false;
 
     auto proc = std::make_shared<Processor>(*this, id, getSampleRate(), getBlockSize());
+    proc->setRemoteHost(host);
     success = proc->load(settings, layout, monoChannels, err);
 
     auto name = proc->getName();
@@ -263,6 +284,51 @@ bool ProcessorChain::addPluginProcessor(const String& id, const String& settings
     return success;
 }
 
+std::shared_ptr<Processor> ProcessorChain::reserveProcessor(const String& id, const String& host) {
+    traceScope();
+    auto proc = std::make_shared<Processor>(*this, id, getSampleRate(), getBlockSize());
+    proc->setRemoteHost(host);
+    proc->setLoading(true);
+    std::lock_guard<std::mutex> lock(m_processorsMtx);
+    proc->setChainIndex((int)m_processors.size());
+    m_processors.push_back(proc);
+    return proc;
+}
+
+int ProcessorChain::spliceProcessor(std::shared_ptr<Processor> proc) {
+    traceScope();
+
+    // allocate the crossfade buffers outside of the audio thread, the dry path gets delayed by the latency of the
+    // new processor
+    int fadeChannels = jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()) +
+                       jmax(getExtraChannels(), proc->getExtraInChannels(), proc->getExtraOutChannels());
+    SpliceFade fade;
+    fade.prepare(fadeChannels, getBlockSize(), proc->isLoaded() ? proc->getLatencySamples() : 0,
+                 (int)lround(getSampleRate() * FADE_IN_MS / 1000), isUsingDoublePrecision());
+
+    std::lock_guard<std::mutex> lock(m_processorsMtx);
+    int idx = 0;
+    for (auto& p : m_processors) {
+        if (p == proc) {
+            break;
+        }
+        idx++;
+    }
+    if ((size_t)idx == m_processors.size()) {
+        // removed while loading
+        return -1;
+    }
+    proc->setChainIndex(idx);
+    proc->setLoading(false);
+    if (proc->isLoaded()) {
+        m_fadeProc = proc.get();
+        // the old buffers get freed after releasing the lock
+        std::swap(m_fade, fade);
+    }
+    updateNoLock();
+    return idx;
+}
+
 void ProcessorChain::addProcessor(std::shared_ptr<Processor> processor) {
     traceScope();
     std::lock_guard<std::mutex> lock(m_processorsMtx);
@@ -277,7 +343,13 @@ void ProcessorChain::delProcessor(int idx) {
     std::lock_guard<std::mutex> lock(m_processorsMtx);
     for (auto it = m_processors.begin(); it < m_processors.end(); it++) {
         if (i++ == idx) {
-            (*it)->unload();
+            // a processor that is still loading gets unloaded by its loader, as it can't be spliced in anymore
+            if (!(*it)->isLoading()) {
+                (*it)->unload();
+            }
+            if (m_fadeProc == it->get()) {
+                m_fadeProc = nullptr;
+            }
             m_processors.erase(it);
             break;
         }
@@ -295,25 +367,28 @@ void ProcessorChain::updateNoLock() {
     traceScope();
     int latency = 0;
     bool supportsDouble = true;
-    m_extraChannels = 0;
-    m_sidechainDisabled = false;
+    int extraChannels = 0;
+    bool sidechainDisabled = false;
     for (auto& proc : m_processors) {
-        if (nullptr != proc) {
+        if (nullptr != proc && !proc->isLoading()) {
             latency += proc->getLatencySamples();
             if (!proc->supportsDoublePrecisionProcessing()) {
                 supportsDouble = false;
             }
-            m_extraChannels = jmax(m_extraChannels, proc->getExtraInChannels(), proc->getExtraOutChannels());
-            m_sidechainDisabled = m_hasSidechain && (m_sidechainDisabled || proc->getNeedsDisabledSidechain());
+            extraChannels = jmax(extraChannels, proc->getExtraInChannels(), proc->getExtraOutChannels());
+            sidechainDisabled = m_hasSidechain && (sidechainDisabled || proc->getNeedsDisabledSidechain());
         }
     }
+    // publish the final values only, the audio thread must not see the intermediate ones
+    m_extraChannels = extraChannels;
+    m_sidechainDisabled = sidechainDisabled;
     if (latency != getLatencySamples()) {
         logln("updating latency samples to " << latency);
         setLatencySamples(latency);
     }
     m_supportsDoublePrecision = supportsDouble;
     auto it = m_processors.rbegin();
-    while (it != m_processors.rend() && (*it)->isSuspended()) {
+    while (it != m_processors.rend() && ((*it)->isLoading() || (*it)->isSuspended())) {
         it++;
     }
     if (it != m_processors.rend()) {
@@ -326,7 +401,16 @@ void ProcessorChain::updateNoLock() {
 std::shared_ptr<Processor> ProcessorChain::getProcessor(int index) {
     traceScope();
     std::lock_guard<std::mutex> lock(m_processorsMtx);
-    if (index > -1 && (size_t)index < m_processors.size()) {
+    if (index > -1 && (size_t)index < m_processors.size() && !m_processors[(size_t)index]->isLoading()) {
+        return m_processors[(size_t)index];
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Processor> ProcessorChain::getLoadingProcessor(int index) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_processorsMtx);
+    if (index > -1 && (size_t)index < m_processors.size() && m_processors[(size_t)index]->isLoading()) {
         return m_processors[(size_t)index];
     }
     return nullptr;
@@ -346,7 +430,8 @@ float ProcessorChain::getParameterValue(int idx, int channel, int paramIdx) {
     traceScope();
     std::lock_guard<std::mutex> lock(m_processorsMtx);
     if (idx > -1 && (size_t)idx < m_processors.size()) {
-        if (auto p = m_processors[(size_t)idx]) {
+        auto p = m_processors[(size_t)idx];
+        if (nullptr != p && !p->isLoading()) {
             return p->getParameterValue(channel, paramIdx);
         }
     }
@@ -358,9 +443,12 @@ void ProcessorChain::clear() {
     releaseResources();
     std::lock_guard<std::mutex> lock(m_processorsMtx);
     for (auto& proc : m_processors) {
-        proc->unload();
+        if (!proc->isLoading()) {
+            proc->unload();
+        }
     }
     m_processors.clear();
+    m_fadeProc = nullptr;
 }
 
 String ProcessorChain::toString() {
@@ -374,7 +462,9 @@ String ProcessorChain::toString() {
         } else {
             first = false;
         }
-        if (proc->isSuspended()) {
+        if (proc->isLoading()) {
+            ret << "<loading>";
+        } else if (proc->isSuspended()) {
             ret << "<bypassed>";
         } else {
             ret << proc->getName();
@@ -397,12 +487,28 @@ void ProcessorChain::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& mi
         std::lock_guard<std::mutex> lock(m_processorsMtx);
         TimeTrace::addTracePoint("chain_lock");
         for (auto& proc : m_processors) {
+            if (proc->isLoading()) {
+                continue;
+            }
             TimeTrace::startGroup();
             int procLatency = 0;
+            bool fade = proc.get() == m_fadeProc && m_fade.isActive();
+            if (fade && !m_fade.copyDry(buffer)) {
+                // the block does not fit the prepared buffers, skip the fade
+                m_fade.stop();
+                m_fadeProc = nullptr;
+                fade = false;
+            }
             if (proc->processBlock(buffer, midiMessages, procLatency)) {
                 latency += procLatency;
             }
-            TimeTrace::finishGroup("chain_process: " + proc->getName());
+            if (fade) {
+                m_fade.apply(buffer);
+                if (!m_fade.isActive()) {
+                    m_fadeProc = nullptr;
+                }
+            }
+            TimeTrace::finishGroup("chain_process: ", proc->getName());
         }
     }
 
@@ -417,7 +523,8 @@ template <typename T>
 void ProcessorChain::preProcessBlocks(Processor* proc) {
     traceScope();
     MidiBuffer midi;
-    int channels = jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()) + m_extraChannels;
+    int channels = jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()) +
+                   jmax(getExtraChannels(), proc->getExtraInChannels(), proc->getExtraOutChannels());
     AudioBuffer<T> buf(channels, getBlockSize());
     buf.clear();
     int samplesProcessed = 0;
@@ -13,6 +13,7 @@
 #include "Utils.hpp"
 #include "Defaults.hpp"
 #include "Message.hpp"
+#include "SpliceFade.hpp"
 
 namespace e47 {
 
@@ -46,6 +47,10 @@ class ProcessorChain : public AudioProcessor, public LogTagDelegate {
     }
 
     const HandshakeRequest& getConfig() const { return m_cfg; }
+    void setConfig(double sampleRate, int samplesPerBlock) {
+        m_cfg.sampleRate = sampleRate;
+        m_cfg.samplesPerBlock = samplesPerBlock;
+    }
 
     bool isSidechainDisabled() const { return m_sidechainDisabled; }
 
@@ -74,12 +79,20 @@ class ProcessorChain : public AudioProcessor, public LogTagDelegate {
     void getStateInformation(juce::MemoryBlock& /* destData */) override {}
     void setStateInformation(const void* /* data */, int /* sizeInBytes */) override {}
 
-    bool initPluginInstance(Processor* proc, const String& layout, String& err);
+    bool initPluginInstance(Processor* proc, const String& layout, String& err, bool warm = false);
     bool addPluginProcessor(const String& id, const String& settings, const String& layout, uint64 monoChannels,
-                            String& err);
+                            const String& host, String& err);
     void addProcessor(std::shared_ptr<Processor> processor);
+
+    // Asynchronous insertion: reserveProcessor adds a placeholder at the end of the chain, that is skipped until the
+    // processor has been loaded in the background and spliced in. Returns the index or -1, if the processor has been
+    // removed in the meantime.
+    std::shared_ptr<Processor> reserveProcessor(const String& id, const String& host);
+    int spliceProcessor(std::shared_ptr<Processor> proc);
     size_t getSize() const { return m_processors.size(); }
     std::shared_ptr<Processor> getProcessor(int index);
+    // Returns the placeholder at the given index, if its plugin is still loading
+    std::shared_ptr<Processor> getLoadingProcessor(int index);
 
     void delProcessor(int idx);
     void exchangeProcessors(int idxA, int idxB);
@@ -97,9 +110,15 @@ class ProcessorChain : public AudioProcessor, public LogTagDelegate {
 
     HandshakeRequest m_cfg;
 
-    int m_extraChannels = 0;
+    // Read by the audio thread, recomputed from the processors and published under m_processorsMtx
+    std::atomic_int m_extraChannels{0};
     bool m_hasSidechain = false;
-    bool m_sidechainDisabled = false;
+    std::atomic_bool m_sidechainDisabled{false};
+
+    // Crossfade state for a processor that has just been spliced in, guarded by m_processorsMtx
+    static constexpr int FADE_IN_MS = 10;
+    Processor* m_fadeProc = nullptr;
+    SpliceFade m_fade;
 
     template <typename T>
     void processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& midiMessages);
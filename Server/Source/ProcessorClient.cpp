@@ -26,11 +26,23 @@ ProcessorClient::~ProcessorClient() {
         std::lock_guard<std::mutex> lock(m_audioMtx);
         m_sockAudio.reset();
     }
+    if (nullptr != m_host) {
+        m_host->leave();
+    }
+    releaseCGroup();
     removeWorkerPort(m_port);
 }
 
 bool ProcessorClient::init() {
     traceScope();
+    if (isRemote()) {
+        if (!connectRemote()) {
+            return false;
+        }
+        m_error.clear();
+        return true;
+    }
+
     if (!startSandbox()) {
         setAndLogError("fatal error: failed to start sandbox process");
         return false;
@@ -38,9 +50,7 @@ bool ProcessorClient::init() {
 
     if (!connectSandbox()) {
         setAndLogError("fatal error: failed to connect to sandbox process");
-        if (m_process.isRunning()) {
-            m_process.kill();
-        }
+        stopSandbox();
         return false;
     }
 
@@ -69,9 +79,7 @@ void ProcessorClient::shutdown() {
             }
         }
 
-        if (m_process.isRunning()) {
-            m_process.kill();
-        }
+        stopSandbox();
     }
 
     {
@@ -90,8 +98,8 @@ bool ProcessorClient::isOk() {
 
     {
         std::lock_guard<std::mutex> lock(m_cmdMtx);
-        ok = m_process.isRunning() && nullptr != m_sockCmdIn && m_sockCmdIn->isConnected() && nullptr != m_sockCmdOut &&
-             m_sockCmdOut->isConnected();
+        ok = (isRemote() || isSandboxRunning()) && nullptr != m_sockCmdIn && m_sockCmdIn->isConnected() &&
+             nullptr != m_sockCmdOut && m_sockCmdOut->isConnected();
     }
 
     {
@@ -121,11 +129,41 @@ bool ProcessorClient::startSandbox() {
     try {
         std::lock_guard<std::mutex> lock(m_cmdMtx);
 
-        if (m_process.isRunning()) {
-            logln("killing already running sandbox");
-            m_process.kill();
-            m_process.waitForProcessToFinish(-1);
+        if (isSandboxRunning()) {
+            logln("stopping already running sandbox");
         }
+        stopSandbox();
+
+#ifndef AG_UNIT_TESTS
+        if (auto srv = getApp()->getServer()) {
+            if (auto groups = srv->getSandboxGroups()) {
+                // let a shared or idle sandbox process host the plugin
+                auto cgroups = srv->getSandboxCGroups();
+                auto group = groups->getGroup(m_id, m_cfg,
+                                              nullptr != cgroups ? cgroups->getSharedKey(m_cfg.clientId) : String());
+                m_host = groups->join(group);
+                if (nullptr == m_host) {
+                    setAndLogError("failed to get a sandbox process");
+                    return false;
+                }
+                String cgroup;
+                if (nullptr != cgroups) {
+                    m_cgroup = cgroups->getKey(m_cfg.clientId, "host-" + String(m_host->getPort()));
+                    cgroup = cgroups->acquire(m_cgroup);
+                }
+                if (!m_host->assign(m_id, m_cfg, m_port, cgroup)) {
+                    setAndLogError("failed to assign plugin to sandbox process");
+                    m_host->leave();
+                    m_host.reset();
+                    releaseCGroup();
+                    return false;
+                }
+                logln("plugin assigned to sandbox process at port "
+                      << m_host->getPort() << (group.isNotEmpty() ? " (group " + group + ")" : String()));
+                return true;
+            }
+        }
+#endif
 
         auto cfgDump = m_cfg.toJson().dump();
         MemoryBlock config(cfgDump.c_str(), cfgDump.size());
@@ -133,24 +171,15 @@ bool ProcessorClient::startSandbox() {
         StringArray args;
 
 #ifndef AG_UNIT_TESTS
-        args.add(File::getSpecialLocation(File::currentExecutableFile).getFullPathName());
+        args.add(SandboxHost::getExecutable().getFullPathName());
         if (auto srv = getApp()->getServer()) {
             args.addArray({"-id", String(srv->getId())});
         } else {
             throw std::runtime_error("no server object");
         }
 #else
-        auto exe = File::getSpecialLocation(File::currentExecutableFile).getParentDirectory();
-#if JUCE_WINDOWS
-        exe = exe.getChildFile("AudioGridderServer.exe");
-#else
-        exe = exe.getChildFile("AudioGridderServer.app")
-                  .getChildFile("Contents")
-                  .getChildFile("MacOS")
-                  .getChildFile("AudioGridderServer");
-#endif
         // args.add("lldb");
-        args.add(exe.getFullPathName());
+        args.add(SandboxHost::getExecutable().getFullPathName());
         // args.addArray({"-o", "process launch --tty", "--"});
         args.addArray({"-id", "999"});
 #endif
@@ -162,7 +191,8 @@ bool ProcessorClient::startSandbox() {
 
         logln("starting sandbox process: " << args.joinIntoString(" "));
 
-        return m_process.start(args, 0);
+        m_process = std::make_unique<ChildProcess>();
+        return m_process->start(args, 0);
     } catch (const std::exception& e) {
         setAndLogError("failed to start sandbox: " + String(e.what()));
     } catch (...) {
@@ -172,6 +202,37 @@ bool ProcessorClient::startSandbox() {
     return false;
 }
 
+bool ProcessorClient::isSandboxRunning() const {
+    if (nullptr != m_host) {
+        return m_host->isRunning();
+    }
+    return m_process->isRunning();
+}
+
+void ProcessorClient::stopSandbox() {
+    if (nullptr != m_host) {
+        // other plugins might live in the same process, it gets killed when the last one leaves
+        m_host->leave();
+        m_host.reset();
+    } else if (m_process->isRunning()) {
+        m_process->kill();
+        m_process->waitForProcessToFinish(-1);
+    }
+    releaseCGroup();
+}
+
+void ProcessorClient::releaseCGroup() {
+    if (m_cgroup.isEmpty()) {
+        return;
+    }
+    if (auto srv = getApp()->getServer()) {
+        if (auto cgroups = srv->getSandboxCGroups()) {
+            cgroups->release(m_cgroup);
+        }
+    }
+    m_cgroup.clear();
+}
+
 bool ProcessorClient::connectSandbox() {
     logln("connecting to sandbox at port " << m_port);
 
@@ -193,7 +254,7 @@ bool ProcessorClient::connectSandbox() {
 
         // let the process come up and bind to the port
         int maxTries = 100;
-        while (!m_sockCmdOut->isConnected() && maxTries-- > 0 && m_process.isRunning()) {
+        while (!m_sockCmdOut->isConnected() && maxTries-- > 0 && isSandboxRunning()) {
             if (hasUnixDomainSockets) {
                 if (!m_sockCmdOut->connect(socketPath, 100)) {
                     sleep(100);
@@ -262,33 +323,166 @@ bool ProcessorClient::connectSandbox() {
     return success;
 }
 
+bool ProcessorClient::connectRemote() {
+    ServerInfo srv(m_remoteHost);
+
+#ifndef AG_UNIT_TESTS
+    // the list of discovered servers might have changed since the plugin got added
+    if (auto server = getApp()->getServer()) {
+        String err;
+        if (!server->isChainHopAllowed(m_remoteHost, err)) {
+            setAndLogError(err);
+            return false;
+        }
+    }
+#endif
+
+    logln("connecting to remote server " << srv.getHostAndID());
+
+    auto sockHandshake = std::make_unique<StreamingSocket>();
+    if (!sockHandshake->connect(srv.getHost(), Defaults::SERVER_PORT + srv.getID(), 1000)) {
+        setAndLogError("failed to connect to remote server " + srv.getHostAndID());
+        return false;
+    }
+
+    // the remote worker hosts the plugin like a sandbox: no screen connection, no plugin list and no session
+    HandshakeRequest cfg = m_cfg;
+    cfg.version = AG_PROTOCOL_VERSION;
+    cfg.flags &= (uint8)~HandshakeRequest::RESUME_SESSION;
+    cfg.setFlag(HandshakeRequest::CHAIN_HOP);
+
+    HandshakeResponse resp;
+    MessageHelper::Error err;
+    if (!send(sockHandshake.get(), reinterpret_cast<const char*>(&cfg), sizeof(cfg)) ||
+        !read(sockHandshake.get(), &resp, sizeof(resp), 5000, &err)) {
+        setAndLogError("handshake with remote server " + srv.getHostAndID() + " failed: " + err.toString());
+        return false;
+    }
+    sockHandshake->close();
+
+    bool success = true;
+
+    {
+        std::lock_guard<std::mutex> lock(m_cmdMtx);
+
+        m_sockCmdOut = std::make_unique<StreamingSocket>();
+        m_sockCmdIn = std::make_unique<StreamingSocket>();
+
+        if (!m_sockCmdOut->connect(srv.getHost(), resp.port, 1000) ||
+            !m_sockCmdIn->connect(srv.getHost(), resp.port, 1000)) {
+            setAndLogError("failed to setup command connections to remote server " + srv.getHostAndID());
+            m_sockCmdOut.reset();
+            m_sockCmdIn.reset();
+            success = false;
+        }
+    }
+
+    if (success) {
+        std::lock_guard<std::mutex> lock(m_audioMtx);
+
+        m_sockAudio = std::make_unique<StreamingSocket>();
+
+        if (m_sockAudio->connect(srv.getHost(), resp.port, 1000)) {
+            m_bytesOutMeter = Metrics::getStatistic<Meter>("NetBytesOut");
+            m_bytesInMeter = Metrics::getStatistic<Meter>("NetBytesIn");
+            m_hopTime = Metrics::getStatistic<TimeStatistic>("ChainHop:" + srv.getHostAndID());
+        } else {
+            setAndLogError("failed to setup audio connection to remote server " + srv.getHostAndID());
+            m_sockAudio.reset();
+            success = false;
+        }
+    }
+
+    if (success) {
+        logln("connected to remote server " << srv.getHostAndID() << " (port " << resp.port << ")");
+    }
+
+    return success;
+}
+
 void ProcessorClient::run() {
     traceScope();
     MessageFactory msgFactory(this);
 
     bool lastOk = true;
+    auto lastSnapshot = Time::getMillisecondCounter();
 
     while (!threadShouldExit()) {
         if (!isOk()) {
             if (lastOk) {
                 lastOk = false;
+                if (m_loaded) {
+                    startRecovery();
+                }
                 if (onStatusChange) {
                     onStatusChange(false, m_error);
                 }
             }
-            if (!init()) {
+            if (m_loaded && !isRemote() && !waitForRespawn()) {
+                failRecovery();
                 return;
             }
+            if (!init()) {
+                if (!isRemote()) {
+                    if (m_loaded) {
+                        // counts as a respawn
+                        continue;
+                    }
+                    return;
+                }
+                // the remote server might be back soon
+                sleepExitAware(1000);
+                continue;
+            }
             if (!isOk()) {
                 sleepExitAware(1000);
                 continue;
             }
             if (m_loaded) {
+                // bring the plugin back with the last known state
                 String err;
-                if (!load(m_lastSettings, m_lastLayout, m_lastMonoChannels, err)) {
+                bool loaded = load(m_lastSettings, m_lastLayout, m_lastMonoChannels, err);
+#ifdef AG_UNIT_TESTS
+                if (loaded && m_failReloads > 0) {
+                    m_failReloads--;
+                    loaded = false;
+                    err = "simulated failure";
+                }
+#endif
+                if (!loaded) {
                     setAndLogError("reload failed: " + err);
+                    {
+                        // make sure the next round starts a new sandbox
+                        std::lock_guard<std::mutex> lock(m_cmdMtx);
+                        if (nullptr != m_sockCmdOut) {
+                            m_sockCmdOut->close();
+                        }
+                    }
+                    if (isRemote()) {
+                        sleepExitAware(1000);
+                    }
+                    continue;
+                } else {
+                    if (m_suspended) {
+                        suspendProcessingRemoteOnly(true);
+                    }
+                    finishRecovery();
                 }
             }
+            lastSnapshot = Time::getMillisecondCounter();
+        }
+
+        // keep a recent copy of the plugin state, so that we can restore it after a crash
+        if (m_loaded && !m_recovering) {
+            auto age = Time::getMillisecondCounter() - lastSnapshot;
+            // getStateInformation blocks the command connection, so by default we only ask after a change
+            uint32 maxAge = m_snapshotMaxAgeMs;
+            if ((m_stateChanged && age >= SNAPSHOT_INTERVAL_MS) || (maxAge > 0 && age >= maxAge)) {
+                m_stateChanged = false;
+                String settings;
+                getStateInformation(settings);
+                lastSnapshot = Time::getMillisecondCounter();
+            }
         }
 
         if (!lastOk) {
@@ -326,6 +520,8 @@ void ProcessorClient::run() {
 
 void ProcessorClient::handleMessage(std::shared_ptr<Message<Key>> msg) {
     traceScope();
+    // typing into the editor can change the state without reporting parameter changes
+    m_stateChanged = true;
     if (nullptr != onKeysFromSandbox) {
         onKeysFromSandbox(*msg);
     }
@@ -333,6 +529,7 @@ void ProcessorClient::handleMessage(std::shared_ptr<Message<Key>> msg) {
 
 void ProcessorClient::handleMessage(std::shared_ptr<Message<ParameterValue>> msg) {
     traceScope();
+    m_stateChanged = true;
     if (nullptr != onParamValueChange) {
         onParamValueChange(pDATA(msg)->channel, pDATA(msg)->paramIdx, pDATA(msg)->value);
     }
@@ -432,7 +629,8 @@ bool ProcessorClient::load(const String& settings, const String& layout, uint64
         try {
             m_name = jresult["name"].get<std::string>();
             m_latency = jresult["latency"].get<int>();
-            m_hasEditor = jresult["hasEditor"].get<bool>();
+            // the editor of a remote plugin would open on the remote screen, that we can't capture
+            m_hasEditor = !isRemote() && jresult["hasEditor"].get<bool>();
             m_scDisabled = jresult["disabledSideChain"].get<bool>();
             m_supportsDoublePrecision = jresult["supportsDoublePrecision"].get<bool>();
             m_tailSeconds = jresult["tailSeconds"].get<double>();
@@ -511,6 +709,9 @@ void ProcessorClient::hideEditor() {
     msg.send(m_sockCmdOut.get());
 
     m_lastScreenBounds = {};
+
+    // edits in the editor don't necessarily come with parameter changes
+    m_stateChanged = true;
 }
 
 bool ProcessorClient::supportsDoublePrecisionProcessing() { return m_supportsDoublePrecision; }
@@ -561,6 +762,8 @@ void ProcessorClient::setStateInformation(const String& settings) {
         logln("setStateInformation failed: can't send payload message");
         return;
     }
+
+    m_lastSettings = settings;
 }
 
 void ProcessorClient::setPlayHead(AudioPlayHead* p) { m_playhead = p; }
@@ -585,6 +788,8 @@ void ProcessorClient::setCurrentProgram(int i) {
     DATA(msg)->idx = 0;
     DATA(msg)->preset = i;
     msg.send(m_sockCmdOut.get());
+
+    m_stateChanged = true;
 }
 
 void ProcessorClient::suspendProcessing(bool b) {
@@ -625,6 +830,14 @@ template <typename T>
 void ProcessorClient::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& midiMessages) {
     traceScope();
 
+    if (m_recovering || m_failed) {
+        // the sandbox is being restarted or gone for good, pass the input through or output silence for instruments
+        if (m_cfg.channelsIn == 0) {
+            buffer.clear();
+        }
+        return;
+    }
+
     AudioPlayHead::PositionInfo posInfo;
     if (nullptr != m_playhead) {
         if (auto optPosInfo = m_playhead->getPosition()) {
@@ -657,10 +870,14 @@ void ProcessorClient::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& m
         if (nullptr != m_sockAudio) {
             TimeTrace::addTracePoint("pc_lock");
 
+            // per hop round trip time, including the processing on the remote server
+            TimeStatistic::Duration hopDuration(m_hopTime);
+
             if (!msg.sendToServer(m_sockAudio.get(), *sendBuffer, midiMessages, posInfo, sendBuffer->getNumChannels(),
                                   sendBuffer->getNumSamples(), &e, *m_bytesOutMeter)) {
                 logln("error while sending audio message to sandbox: " << e.toString());
                 m_sockAudio->close();
+                startRecovery();
                 return;
             }
 
@@ -669,6 +886,11 @@ void ProcessorClient::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& m
             if (!msg.readFromServer(m_sockAudio.get(), *sendBuffer, midiMessages, &e, *m_bytesInMeter)) {
                 logln("error while reading audio message from sandbox: " << e.toString());
                 m_sockAudio->close();
+                startRecovery();
+                if (m_cfg.channelsIn == 0 || sendBuffer == &buffer) {
+                    // the buffer might contain partial data
+                    buffer.clear();
+                }
                 return;
             }
 
@@ -684,6 +906,57 @@ void ProcessorClient::processBlockInternal(AudioBuffer<T>& buffer, MidiBuffer& m
     TimeTrace::addTracePoint("pc_ch_map_reverse");
 }
 
+#ifdef AG_UNIT_TESTS
+void ProcessorClient::killSandbox() {
+    if (nullptr != m_host) {
+        m_host->kill();
+    } else if (m_process->isRunning()) {
+        m_process->kill();
+    }
+}
+#endif
+
+void ProcessorClient::startRecovery() {
+    if (!m_recovering.exchange(true)) {
+        m_recoveryStart = Time::getMillisecondCounterHiRes();
+    }
+}
+
+bool ProcessorClient::waitForRespawn() {
+    auto now = Time::getMillisecondCounter();
+    if (m_respawns == 0 || now - m_firstRespawn > RESPAWN_WINDOW_MS) {
+        m_firstRespawn = now;
+        m_respawns = 0;
+    }
+    if (m_respawns >= MAX_RESPAWNS) {
+        return false;
+    }
+    if (m_respawns > 0) {
+        // give the system some time, if the plugin does not come back right away
+        sleepExitAware(jmin(RESPAWN_BACKOFF_MS << (m_respawns - 1), RESPAWN_BACKOFF_MAX_MS));
+    }
+    m_respawns++;
+    return true;
+}
+
+void ProcessorClient::failRecovery() {
+    m_failed = true;
+    m_recovering = false;
+    setAndLogError("giving up on the plugin after " + String(m_respawns) + " sandbox restarts within " +
+                   String(RESPAWN_WINDOW_MS / 1000) + " seconds");
+    if (onStatusChange) {
+        onStatusChange(false, m_error);
+    }
+}
+
+void ProcessorClient::finishRecovery() {
+    if (m_recovering.exchange(false)) {
+        auto ms = Time::getMillisecondCounterHiRes() - m_recoveryStart;
+        Metrics::getStatistic<TimeStatistic>("SandboxRecovery")->update(ms);
+        logln("recovered from sandbox failure in " << String(ms, 0) << " ms");
+    }
+}
+
 void ProcessorClient::processBlock(AudioBuffer<float>& buffer, MidiBuffer& midiMessages) {
     processBlockInternal(buffer, midiMessages);
 }
@@ -717,6 +990,8 @@ void ProcessorClient::setParameterValue(int channel, int paramIdx, float value)
     DATA(msg)->paramIdx = paramIdx;
     DATA(msg)->value = value;
     msg.send(m_sockCmdOut.get());
+
+    m_stateChanged = true;
 }
 
 float ProcessorClient::getParameterValue(int channel, int paramIdx) {
@@ -782,4 +1057,35 @@ void ProcessorClient::setMonoChannels(uint64 channels) {
     msg.send(m_sockCmdOut.get());
 }
 
+bool ProcessorClient::reconfigure(double sampleRate, int samplesPerBlock) {
+    std::lock_guard<std::mutex> lock(m_cmdMtx);
+
+    if (m_cfg.sampleRate == sampleRate && m_cfg.samplesPerBlock == samplesPerBlock) {
+        return true;
+    }
+
+    m_cfg.sampleRate = sampleRate;
+    m_cfg.samplesPerBlock = samplesPerBlock;
+
+    Message<Reconfigure> msg(this);
+    PLD(msg).setJson({{"sampleRate", sampleRate}, {"samplesPerBlock", samplesPerBlock}});
+    if (!msg.send(m_sockCmdOut.get())) {
+        logln("reconfigure failed: can't send message");
+        m_sockCmdOut->close();
+        return false;
+    }
+
+    MessageHelper::Error e;
+    MessageFactory msgFactory(this);
+    auto result = msgFactory.getResult(m_sockCmdOut.get(), 5, &e);
+    if (nullptr == result || result->getReturnCode() < 0) {
+        logln("reconfigure failed: can't read result message: " << e.toString());
+        m_sockCmdOut->close();
+        return false;
+    }
+
+    m_latency = result->getReturnCode();
+    return true;
+}
+
 }  // namespace e47
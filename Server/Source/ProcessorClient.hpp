@@ -15,17 +15,22 @@
 #include "ParameterValue.hpp"
 #include "ChannelMapper.hpp"
 #include "ChannelSet.hpp"
+#include "SandboxHost.hpp"
 
 namespace e47 {
 
 class ProcessorClient : public Thread, public LogTag {
   public:
-    ProcessorClient(const String& id, HandshakeRequest cfg)
+    // If a remote host is given, the plugin gets loaded by the AudioGridder server on that host instead of a local
+    // sandbox process and the audio is streamed from server to server
+    ProcessorClient(const String& id, HandshakeRequest cfg, const String& remoteHost = {})
         : Thread("ProcessorClient"),
           LogTag("processorclient"),
-          m_port(getWorkerPort()),
+          m_port(remoteHost.isEmpty() ? getWorkerPort() : 0),
           m_id(id),
+          m_remoteHost(remoteHost),
           m_cfg(cfg),
+          m_process(std::make_unique<ChildProcess>()),
           m_activeChannels(cfg.activeChannels, cfg.channelsIn > 0),
           m_channelMapper(this) {
         m_activeChannels.setNumChannels(cfg.channelsIn + cfg.channelsSC, cfg.channelsOut);
@@ -37,6 +42,8 @@ class ProcessorClient : public Thread, public LogTag {
     void shutdown();
     bool isOk();
     const String& getError() const { return m_error; }
+    bool isRemote() const { return m_remoteHost.isNotEmpty(); }
+    const String& getRemoteHost() const { return m_remoteHost; }
 
     void run() override;
 
@@ -75,16 +82,47 @@ class ProcessorClient : public Thread, public LogTag {
     float getParameterValue(int channel, int paramIdx);
     std::vector<Srv::ParameterValue> getAllParameterValues();
     void setMonoChannels(uint64 channels);
+    // Returns false if the sandbox could not be reconfigured, the connection gets closed in that case, so that the
+    // sandbox gets restarted with the new settings
+    bool reconfigure(double sampleRate, int samplesPerBlock);
     int getChannelInstances() const { return m_lastChannelInstances; }
 
+    // Snapshots are taken after state changes, a max age > 0 enables periodic snapshots in addition, e.g. for plugins
+    // that change their state without reporting it
+    void setSnapshotMaxAge(uint32 ms) { m_snapshotMaxAgeMs = ms; }
+    bool isRecovering() const { return m_recovering; }
+    // Set when the sandbox could not be brought back, the plugin passes the audio through from then on
+    bool isFailed() const { return m_failed; }
+
+#ifdef AG_UNIT_TESTS
+    // Simulates a crash of the sandbox process
+    void killSandbox();
+    // Simulates failing reloads after a crash
+    void failReloads(int n) { m_failReloads = n; }
+#endif
+
+    static int getWorkerPort();
+    static void removeWorkerPort(int port);
+
   private:
+    static constexpr uint32 SNAPSHOT_INTERVAL_MS = 5000;
+    // Limits the sandbox restarts after crashes or failed reloads
+    static constexpr int MAX_RESPAWNS = 5;
+    static constexpr uint32 RESPAWN_WINDOW_MS = 60000;
+    static constexpr uint32 RESPAWN_BACKOFF_MS = 500;
+    static constexpr uint32 RESPAWN_BACKOFF_MAX_MS = 4000;
+
     int m_port;
     String m_id;
+    String m_remoteHost;
     HandshakeRequest m_cfg;
-    ChildProcess m_process;
+    std::unique_ptr<ChildProcess> m_process;
+    std::shared_ptr<SandboxHost> m_host;
+    String m_cgroup;
     std::unique_ptr<StreamingSocket> m_sockCmdIn, m_sockCmdOut, m_sockAudio;
     std::mutex m_cmdMtx, m_audioMtx;
     std::shared_ptr<Meter> m_bytesOutMeter, m_bytesInMeter;
+    std::shared_ptr<TimeStatistic> m_hopTime;
     String m_error;
 
     bool m_loaded = false;
@@ -104,6 +142,16 @@ class ProcessorClient : public Thread, public LogTag {
     uint64 m_lastMonoChannels;
     juce::Rectangle<int> m_lastScreenBounds;
     int m_lastChannelInstances = 0;
+    std::atomic_bool m_stateChanged{false};
+    std::atomic<uint32> m_snapshotMaxAgeMs{0};
+    std::atomic_bool m_recovering{false};
+    std::atomic<double> m_recoveryStart{0.0};
+    std::atomic_bool m_failed{false};
+    int m_respawns = 0;
+    uint32 m_firstRespawn = 0;
+#ifdef AG_UNIT_TESTS
+    std::atomic_int m_failReloads{0};
+#endif
 
     ChannelSet m_activeChannels;
     ChannelMapper m_channelMapper;
@@ -111,11 +159,17 @@ class ProcessorClient : public Thread, public LogTag {
     static std::unordered_set<int> m_workerPorts;
     static std::mutex m_workerPortsMtx;
 
-    static int getWorkerPort();
-    static void removeWorkerPort(int port);
-
     bool startSandbox();
+    bool isSandboxRunning() const;
+    void stopSandbox();
+    void releaseCGroup();
     bool connectSandbox();
+    bool connectRemote();
+
+    void startRecovery();
+    void finishRecovery();
+    bool waitForRespawn();
+    void failRecovery();
 
     void setAndLogError(const String& e) {
         m_error = e;
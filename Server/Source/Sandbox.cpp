@@ -55,7 +55,23 @@ void SandboxPeer::read(const MemoryBlock& data) {
     }
 }
 
-SandboxMaster::SandboxMaster(Server& server, const String& i) : SandboxPeer(server), id(i) {}
+SandboxMaster::SandboxMaster(Server& server, const String& i) : SandboxPeer(server), m_id(i) {}
+
+String SandboxMaster::getId() const {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_id;
+}
+
+String SandboxMaster::getCGroup() const {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_cgroup;
+}
+
+void SandboxMaster::assign(const String& i, const String& cgroup) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_id = i;
+    m_cgroup = cgroup;
+}
 
 void SandboxMaster::handleConnectionLost() {
     traceScope();
@@ -71,10 +87,11 @@ void SandboxMaster::handleMessage(const SandboxMessage& msg) {
         return;
     }
     if (msg.type == SandboxMessage::SANDBOX_PORT) {
-        int port = msg.data["port"].get<int>();
-        logln("received port " << port << " from sandbox " << id);
+        int p = msg.data["port"].get<int>();
+        logln("received port " << p << " from sandbox " << getId());
+        port = p;
         if (onPortReceived) {
-            onPortReceived(port);
+            onPortReceived(p);
         }
     } else {
         m_server.handleMessageFromSandbox(*this, msg);
@@ -45,7 +45,13 @@ class SandboxPeer : public LogTagDelegate {
 struct SandboxMaster : ChildProcessCoordinator, SandboxPeer {
     SandboxMaster(Server& server, const String& id);
 
-    String id;
+    // An idle sandbox from the pool gets its id and cgroup when it is assigned to a client, while the IPC thread
+    // might read them already
+    String getId() const;
+    String getCGroup() const;
+    void assign(const String& id, const String& cgroup);
+
+    std::atomic_int port{0};
     std::function<void(int)> onPortReceived;
 
     // ChildProcessMaster
@@ -56,6 +62,11 @@ struct SandboxMaster : ChildProcessCoordinator, SandboxPeer {
     // SandboxPeer
     bool sendMessage(const MemoryBlock& data) override { return sendMessageToWorker(data); }
     void handleMessage(const SandboxMessage&) override;
+
+  private:
+    String m_id;
+    String m_cgroup;
+    mutable std::mutex m_mtx;
 };
 
 struct SandboxSlave : ChildProcessWorker, SandboxPeer {
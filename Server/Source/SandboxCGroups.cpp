@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "SandboxCGroups.hpp"
+#include "Metrics.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#ifdef JUCE_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace e47 {
+
+static const String CGROUP_BASE = "/sys/fs/cgroup";
+static const String CGROUP_SERVER_LEAF = "audiogridder-server";
+
+SandboxCGroups::SandboxCGroups(Scope scope, int cpuWeight, int memoryMaxMB, const String& cpus)
+    : Thread("SandboxCGroups"),
+      LogTag("cgroups"),
+      m_scope(scope),
+      m_cpuWeight(cpuWeight),
+      m_memoryMaxMB(memoryMaxMB),
+      m_cpus(cpus) {
+    traceScope();
+
+    m_enabled = setup();
+
+    if (m_enabled) {
+        logln("sandbox cgroups enabled at " << m_root.getFullPathName() << " ("
+                                            << m_controllers.joinIntoString(",") << "), one per "
+                                            << (m_scope == PER_CLIENT ? "client" : "sandbox") << ", cpu.weight="
+                                            << m_cpuWeight << ", memory.max="
+                                            << (m_memoryMaxMB > 0 ? String(m_memoryMaxMB) + "MB" : "max")
+                                            << ", cpuset.cpus=" << (m_cpus.isNotEmpty() ? m_cpus : "all"));
+        Metrics::getStatistic<Meter>("SandboxCPU")->enableExtData(true);
+        Metrics::getStatistic<Meter>("SandboxMemoryMB")->enableExtData(true);
+        startThread();
+    }
+}
+
+SandboxCGroups::~SandboxCGroups() {
+    traceScope();
+    stopThread(-1);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    for (auto& g : m_groups) {
+        removeStats(g.first);
+        g.second.dir.deleteFile();
+    }
+    for (auto& dir : m_stale) {
+        dir.deleteFile();
+    }
+}
+
+bool SandboxCGroups::isSupported() {
+#ifdef JUCE_LINUX
+    return File(CGROUP_BASE).getChildFile("cgroup.controllers").existsAsFile();
+#else
+    return false;
+#endif
+}
+
+bool SandboxCGroups::setup() {
+    traceScope();
+
+    if (!isSupported()) {
+        logln("cgroup v2 is not available, sandbox resource limits are disabled");
+        return false;
+    }
+
+    auto path = getCGroupPath(readFile(File("/proc/self/cgroup")));
+    if (path.isEmpty()) {
+        logln("failed to find the cgroup of the server process");
+        return false;
+    }
+
+    // we never touch the root cgroup or a cgroup we have not been given, as that would affect the whole system
+    if (path == "/" || path == "/" + CGROUP_SERVER_LEAF) {
+        logln("the server runs in the root cgroup, sandbox resource limits need a delegated cgroup (e.g. a systemd "
+              "unit with Delegate=yes)");
+        return false;
+    }
+
+    m_root = File(CGROUP_BASE + path);
+
+    // the server might have been started from within the leaf already
+    if (m_root.getFileName() == CGROUP_SERVER_LEAF) {
+        m_root = m_root.getParentDirectory();
+    }
+
+    // A cgroup that distributes resources to its children can't have processes itself, so the server process has to
+    // move into a leaf. This only works, if the cgroup has been delegated to us.
+    auto leaf = m_root.getChildFile(CGROUP_SERVER_LEAF);
+    if (!leaf.isDirectory() && !leaf.createDirectory()) {
+        logln("failed to create " << leaf.getFullPathName()
+                                  << ", the cgroup has to be delegated to the server (e.g. Delegate=yes)");
+        return false;
+    }
+    if (File(CGROUP_BASE + path) != leaf && !writeFile(leaf.getChildFile("cgroup.procs"), "0")) {
+        logln("failed to move the server process to " << leaf.getFullPathName()
+                                                      << ", the cgroup has to be delegated to the server");
+        return false;
+    }
+
+    // other processes are none of our business, but they prevent enabling controllers for the sandboxes
+    auto procs = StringArray::fromLines(readFile(m_root.getChildFile("cgroup.procs")));
+    procs.removeEmptyStrings();
+    if (!procs.isEmpty()) {
+        logln("the cgroup " << m_root.getFullPathName() << " contains other processes ("
+                            << procs.joinIntoString(",")
+                            << "), the server needs a delegated cgroup of its own for sandbox resource limits");
+        return false;
+    }
+
+    auto available = StringArray::fromTokens(readFile(m_root.getChildFile("cgroup.controllers")), " \n", "");
+    for (auto* ctrl : {"cpu", "memory", "cpuset"}) {
+        if (available.contains(ctrl) && writeFile(m_root.getChildFile("cgroup.subtree_control"), "+" + String(ctrl))) {
+            m_controllers.add(ctrl);
+        } else {
+            logln("cgroup controller " << ctrl << " is not available");
+        }
+    }
+
+    return !m_controllers.isEmpty();
+}
+
+String SandboxCGroups::getKey(uint64 clientId, const String& sandboxName) const {
+    return m_scope == PER_CLIENT ? "client-" + String::toHexString(clientId) : sandboxName;
+}
+
+String SandboxCGroups::getSharedKey(uint64 clientId) const {
+    return m_enabled && m_scope == PER_CLIENT ? getKey(clientId, {}) : String();
+}
+
+String SandboxCGroups::acquire(const String& key) {
+    traceScope();
+
+    if (!m_enabled || key.isEmpty()) {
+        return {};
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    auto& g = m_groups[key];
+    if (g.refs == 0) {
+        g.dir = m_root.getChildFile("sandbox-" + File::createLegalFileName(key));
+        m_stale.removeAllInstancesOf(g.dir);
+
+        if (!g.dir.isDirectory() && !g.dir.createDirectory()) {
+            logln("failed to create cgroup " << g.dir.getFullPathName());
+            m_groups.erase(key);
+            return {};
+        }
+
+        if (m_controllers.contains("cpu") && m_cpuWeight > 0) {
+            writeFile(g.dir.getChildFile("cpu.weight"), String(jlimit(1, 10000, m_cpuWeight)));
+        }
+        if (m_controllers.contains("memory")) {
+            writeFile(g.dir.getChildFile("memory.max"),
+                      m_memoryMaxMB > 0 ? String((int64)m_memoryMaxMB * 1024 * 1024) : String("max"));
+        }
+        if (m_controllers.contains("cpuset") && m_cpus.isNotEmpty()) {
+            if (!writeFile(g.dir.getChildFile("cpuset.cpus"), m_cpus)) {
+                logln("failed to set cpuset.cpus=" << m_cpus << " for " << g.dir.getFullPathName());
+            }
+        }
+
+        g.usageUsec = getStat(readFile(g.dir.getChildFile("cpu.stat")), "usage_usec");
+        g.usageTime = Time::getMillisecondCounterHiRes();
+        g.oomKills = getStat(readFile(g.dir.getChildFile("memory.events")), "oom_kill");
+
+        logln("created cgroup " << g.dir.getFullPathName());
+    }
+    g.refs++;
+
+    return g.dir.getFullPathName();
+}
+
+void SandboxCGroups::release(const String& key) {
+    traceScope();
+
+    if (!m_enabled || key.isEmpty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    auto it = m_groups.find(key);
+    if (it == m_groups.end() || --it->second.refs > 0) {
+        return;
+    }
+
+    removeStats(key);
+
+    // the processes might still be terminating, removing the cgroup gets retried
+    if (!it->second.dir.deleteFile()) {
+        m_stale.addIfNotAlreadyThere(it->second.dir);
+    }
+
+    m_groups.erase(it);
+}
+
+bool SandboxCGroups::join(const String& path) {
+    setLogTagStatic("cgroups");
+    traceScope();
+
+    if (path.isEmpty()) {
+        return false;
+    }
+
+    // writing 0 moves the writing process
+    if (!writeFile(File(path).getChildFile("cgroup.procs"), "0")) {
+        logln("failed to join cgroup " << path);
+        return false;
+    }
+
+    logln("joined cgroup " << path);
+    return true;
+}
+
+void SandboxCGroups::run() {
+    traceScope();
+
+    while (!threadShouldExit()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+
+            for (auto& g : m_groups) {
+                updateStats(g.first, g.second);
+            }
+
+            for (int i = 0; i < m_stale.size();) {
+                if (m_stale.getReference(i).deleteFile()) {
+                    m_stale.remove(i);
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        sleepExitAware(1000);
+    }
+}
+
+void SandboxCGroups::updateStats(const String& key, Group& g) {
+    auto now = Time::getMillisecondCounterHiRes();
+    auto usage = getStat(readFile(g.dir.getChildFile("cpu.stat")), "usage_usec");
+    if (now > g.usageTime && usage >= g.usageUsec) {
+        // percent of a single core
+        double cpu = (double)(usage - g.usageUsec) / ((now - g.usageTime) * 1000.0) * 100.0;
+        Metrics::getStatistic<Meter>("SandboxCPU")->updateExtRate1min(key, cpu);
+    }
+    g.usageUsec = usage;
+    g.usageTime = now;
+
+    auto mem = (uint64)readFile(g.dir.getChildFile("memory.current")).trim().getLargeIntValue();
+    Metrics::getStatistic<Meter>("SandboxMemoryMB")->updateExtRate1min(key, (double)mem / 1024 / 1024);
+
+    auto oomKills = getStat(readFile(g.dir.getChildFile("memory.events")), "oom_kill");
+    if (oomKills > g.oomKills) {
+        logln("sandbox processes in cgroup " << key << " have been killed for exceeding the memory limit ("
+                                             << (int64)(oomKills - g.oomKills) << ")");
+        g.oomKills = oomKills;
+    }
+}
+
+void SandboxCGroups::removeStats(const String& key) {
+    Metrics::getStatistic<Meter>("SandboxCPU")->removeExtRate1min(key);
+    Metrics::getStatistic<Meter>("SandboxMemoryMB")->removeExtRate1min(key);
+}
+
+String SandboxCGroups::readFile(const File& f) {
+    // cgroup files report a size of 0, so they have to be read until EOF
+    std::ifstream in(f.getFullPathName().toStdString());
+    if (!in.is_open()) {
+        return {};
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+bool SandboxCGroups::writeFile(const File& f, const String& value) {
+#ifdef JUCE_LINUX
+    int fd = ::open(f.getFullPathName().toRawUTF8(), O_WRONLY);
+    if (fd < 0) {
+        return false;
+    }
+    auto data = value.toStdString();
+    bool ok = ::write(fd, data.data(), data.size()) == (ssize_t)data.size();
+    ::close(fd);
+    return ok;
+#else
+    ignoreUnused(f, value);
+    return false;
+#endif
+}
+
+String SandboxCGroups::getCGroupPath(const String& procSelfCGroup) {
+    // cgroup v2 has a single hierarchy with the ID 0
+    for (auto& line : StringArray::fromLines(procSelfCGroup)) {
+        if (line.startsWith("0::")) {
+            auto path = line.substring(3).trim();
+            if (path.startsWith("/") && !path.contains("..")) {
+                return path;
+            }
+            break;
+        }
+    }
+    return {};
+}
+
+uint64 SandboxCGroups::getStat(const String& stats, const String& name) {
+    for (auto& line : StringArray::fromLines(stats)) {
+        auto parts = StringArray::fromTokens(line, " ", "");
+        if (parts.size() == 2 && parts[0] == name) {
+            return (uint64)parts[1].getLargeIntValue();
+        }
+    }
+    return 0;
+}
+
+}  // namespace e47
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef SandboxCGroups_hpp
+#define SandboxCGroups_hpp
+
+#include <JuceHeader.h>
+#include <map>
+
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Places sandbox processes into cgroups (Linux, cgroup v2) with a CPU weight, a memory limit and a cpuset, so that a
+ * single plugin can't starve the audio threads of other clients. The cgroup of the server has to be delegated to the
+ * server (e.g. Delegate=yes for a systemd unit), the root cgroup is never used and only the server process itself
+ * moves into a leaf of it. The usage of each cgroup is fed into the metrics.
+ */
+class SandboxCGroups : public Thread, public LogTag {
+  public:
+    enum Scope : int { PER_CLIENT, PER_SANDBOX };
+
+    SandboxCGroups(Scope scope, int cpuWeight, int memoryMaxMB, const String& cpus);
+    ~SandboxCGroups() override;
+
+    void run() override;
+
+    bool isEnabled() const { return m_enabled; }
+
+    // Returns the key of the cgroup for a sandbox process depending on the scope
+    String getKey(uint64 clientId, const String& sandboxName) const;
+
+    // Returns the key, that all processes of a client share, or an empty string, if the key depends on the process
+    String getSharedKey(uint64 clientId) const;
+
+    // Creates the cgroup for a key or adds a reference to it, returns the path the sandbox process has to join or an
+    // empty string
+    String acquire(const String& key);
+
+    // Drops a reference, the cgroup gets removed after the last reference has been dropped and all processes left
+    void release(const String& key);
+
+    // Moves the calling process into a cgroup, called by the sandbox processes
+    static bool join(const String& path);
+
+    static bool isSupported();
+
+    // Returns the cgroup v2 path from the content of /proc/<pid>/cgroup or an empty string
+    static String getCGroupPath(const String& procSelfCGroup);
+
+    // Returns a value from a flat keyed cgroup file like cpu.stat or memory.events
+    static uint64 getStat(const String& stats, const String& name);
+
+  private:
+    struct Group {
+        File dir;
+        int refs = 0;
+        uint64 usageUsec = 0;
+        double usageTime = 0.0;
+        uint64 oomKills = 0;
+    };
+
+    Scope m_scope;
+    int m_cpuWeight;
+    int m_memoryMaxMB;
+    String m_cpus;
+    bool m_enabled = false;
+    File m_root;
+    StringArray m_controllers;
+    std::map<String, Group> m_groups;
+    Array<File> m_stale;
+    std::mutex m_mtx;
+
+    bool setup();
+    void updateStats(const String& key, Group& g);
+    void removeStats(const String& key);
+
+    static String readFile(const File& f);
+    static bool writeFile(const File& f, const String& value);
+};
+
+}  // namespace e47
+
+#endif /* SandboxCGroups_hpp */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "SandboxGroups.hpp"
+#include "Server.hpp"
+
+namespace e47 {
+
+SandboxGroups::SandboxGroups(Server& server, Policy policy, int maxPerProcess, const StringArray& allowlist)
+    : LogTag("sandboxgroups"),
+      m_server(server),
+      m_policy(policy),
+      m_maxPerProcess(maxPerProcess > 0 ? maxPerProcess : std::numeric_limits<int>::max()),
+      m_allowlist(allowlist) {
+    traceScope();
+    logln("grouping plugins " << getPolicyName(policy)
+                              << (policy != NONE && maxPerProcess > 0 ? ", max " + String(maxPerProcess) : String())
+                              << (policy != NONE ? " per process" : String()));
+    if (policy != NONE) {
+        logln("grouped plugins share a process but keep one audio round trip per plugin and block");
+    }
+}
+
+String SandboxGroups::getGroup(const String& pluginId, const HandshakeRequest& cfg, const String& cgroupKey) {
+    traceScope();
+    return combine(getGroupByPolicy(pluginId, cfg), cgroupKey);
+}
+
+String SandboxGroups::combine(const String& group, const String& cgroupKey) {
+    if (group.isEmpty() || cgroupKey.isEmpty()) {
+        return group;
+    }
+    return group + "@" + cgroupKey;
+}
+
+String SandboxGroups::getGroupByPolicy(const String& pluginId, const HandshakeRequest& cfg) {
+    switch (m_policy) {
+        case VENDOR:
+            if (auto desc = m_server.findPluginDescription(pluginId)) {
+                if (desc->manufacturerName.isNotEmpty()) {
+                    return "vendor:" + desc->manufacturerName;
+                }
+            }
+            break;
+        case ALLOWLIST:
+            if (m_allowlist.contains(pluginId, true)) {
+                return "trusted";
+            }
+            if (auto desc = m_server.findPluginDescription(pluginId)) {
+                if (m_allowlist.contains(desc->name, true) || m_allowlist.contains(desc->manufacturerName, true)) {
+                    return "trusted";
+                }
+            }
+            break;
+        case CLIENT:
+            return "client:" + String::toHexString(cfg.clientId);
+        case COUNT:
+            return "shared";
+        case NONE:
+            break;
+    }
+    return {};
+}
+
+std::shared_ptr<SandboxHost> SandboxGroups::join(const String& group) {
+    traceScope();
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    m_hosts.erase(std::remove_if(m_hosts.begin(), m_hosts.end(),
+                                 [](const std::shared_ptr<SandboxHost>& h) { return !h->isRunning(); }),
+                  m_hosts.end());
+
+    if (group.isNotEmpty()) {
+        for (auto& host : m_hosts) {
+            if (host->getGroup() == group && host->tryJoin(m_maxPerProcess)) {
+                return host;
+            }
+        }
+    }
+
+    std::shared_ptr<SandboxHost> host;
+    if (auto pool = m_server.getSandboxPool()) {
+        host = pool->takePluginSandbox();
+    }
+    if (nullptr == host) {
+        host = std::make_shared<SandboxHost>(m_server.getId());
+        if (!host->start()) {
+            return nullptr;
+        }
+    }
+
+    host->setGroup(group);
+    if (!host->tryJoin(group.isNotEmpty() ? m_maxPerProcess : 1)) {
+        return nullptr;
+    }
+
+    if (group.isNotEmpty()) {
+        logln("new sandbox process for group " << group << " at port " << host->getPort());
+        m_hosts.push_back(host);
+    }
+
+    return host;
+}
+
+String SandboxGroups::getPolicyName(Policy policy) {
+    switch (policy) {
+        case VENDOR:
+            return "by vendor";
+        case ALLOWLIST:
+            return "by allowlist";
+        case CLIENT:
+            return "by client";
+        case COUNT:
+            return "by count";
+        case NONE:
+            break;
+    }
+    return "disabled";
+}
+
+}  // namespace e47
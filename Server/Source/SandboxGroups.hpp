@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef SandboxGroups_hpp
+#define SandboxGroups_hpp
+
+#include <JuceHeader.h>
+
+#include "Utils.hpp"
+#include "Message.hpp"
+#include "SandboxHost.hpp"
+
+namespace e47 {
+
+class Server;
+
+/*
+ * Decides which plugins share a sandbox process in plugin isolation mode. Plugins can be grouped by vendor, by a
+ * trusted allowlist, by client or just N per process. Plugins that don't belong to a group get their own process.
+ *
+ * Grouping reduces the number of processes and their memory, not the per block round trips: every plugin keeps its
+ * own worker and audio connection. Saving the hops would require to run consecutive plugins of a chain as one remote
+ * chain, which moves bypass, parameter, editor and settings handling into the sandbox, so this is not done here.
+ */
+class SandboxGroups : public LogTag {
+  public:
+    enum Policy : int { NONE, VENDOR, ALLOWLIST, CLIENT, COUNT };
+
+    SandboxGroups(Server& server, Policy policy, int maxPerProcess, const StringArray& allowlist);
+
+    // Returns the group of a plugin or an empty string, if the plugin should run in its own process. A process can only
+    // be in one cgroup, so plugins with different cgroup keys never share a process.
+    String getGroup(const String& pluginId, const HandshakeRequest& cfg, const String& cgroupKey = {});
+
+    // Returns a running sandbox process for the group with a free slot, the caller has to leave it when done
+    std::shared_ptr<SandboxHost> join(const String& group);
+
+    static String getPolicyName(Policy policy);
+
+    // Appends the cgroup key to a group, so that only plugins of the same cgroup share a process
+    static String combine(const String& group, const String& cgroupKey);
+
+  private:
+    Server& m_server;
+    Policy m_policy;
+    int m_maxPerProcess;
+    StringArray m_allowlist;
+    std::vector<std::shared_ptr<SandboxHost>> m_hosts;
+    std::mutex m_mtx;
+
+    String getGroupByPolicy(const String& pluginId, const HandshakeRequest& cfg);
+};
+
+}  // namespace e47
+
+#endif /* SandboxGroups_hpp */
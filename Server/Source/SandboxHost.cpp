@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "SandboxHost.hpp"
+#include "ProcessorClient.hpp"
+#include "Defaults.hpp"
+
+namespace e47 {
+
+SandboxHost::SandboxHost(int serverId, bool fullStartup)
+    : LogTag("sandboxhost"), m_serverId(serverId), m_fullStartup(fullStartup) {}
+
+SandboxHost::~SandboxHost() {
+    traceScope();
+    kill();
+    if (m_port > 0) {
+        ProcessorClient::removeWorkerPort(m_port);
+    }
+}
+
+bool SandboxHost::start() {
+    traceScope();
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    if (m_port == 0) {
+        m_port = ProcessorClient::getWorkerPort();
+    }
+
+    StringArray args;
+    args.add(getExecutable().getFullPathName());
+    args.addArray({"-id", String(m_serverId)});
+    args.add("-load");
+    args.add("-host");
+    if (m_fullStartup) {
+        args.add("-fullstartup");
+    }
+    args.addArray({"-workerport", String(m_port)});
+
+    m_process = std::make_unique<ChildProcess>();
+    if (!m_process->start(args, 0)) {
+        logln("failed to start sandbox process at port " << m_port);
+        m_process.reset();
+        return false;
+    }
+
+    logln("started sandbox process at port " << m_port);
+
+    return true;
+}
+
+void SandboxHost::kill() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_closed = true;
+    if (nullptr != m_process && m_process->isRunning()) {
+        logln("killing sandbox process at port " << m_port);
+        m_process->kill();
+    }
+}
+
+bool SandboxHost::isRunning() const {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return !m_closed && nullptr != m_process && m_process->isRunning();
+}
+
+bool SandboxHost::tryJoin(int maxMembers) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_closed || nullptr == m_process || !m_process->isRunning() || m_members >= maxMembers) {
+        return false;
+    }
+    m_members++;
+    return true;
+}
+
+void SandboxHost::leave() {
+    bool last;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        last = --m_members <= 0;
+    }
+    if (last) {
+        kill();
+    }
+}
+
+bool SandboxHost::assign(const String& pluginId, const HandshakeRequest& cfg, int workerPort, const String& cgroup) {
+    traceScope();
+
+    StreamingSocket sock;
+    bool hasUnixDomainSockets = Defaults::unixDomainSocketsSupported();
+    auto socketPath = Defaults::getSocketPath(Defaults::SANDBOX_PLUGIN_SOCK, {{"n", String(m_port)}});
+
+    // the process might still be coming up
+    int maxTries = 100;
+    while (!sock.isConnected() && maxTries-- > 0 && isRunning()) {
+        bool connected = hasUnixDomainSockets ? sock.connect(socketPath, 100) : sock.connect("127.0.0.1", m_port, 100);
+        if (!connected) {
+            Thread::sleep(100);
+        }
+    }
+
+    if (!sock.isConnected()) {
+        logln("failed to connect to sandbox process at port " << m_port);
+        return false;
+    }
+
+    json j = {{"pluginId", pluginId.toStdString()},
+              {"config", cfg.toJson()},
+              {"workerPort", workerPort},
+              {"cgroup", cgroup.toStdString()}};
+    auto data = j.dump();
+    int len = (int)data.size();
+
+    return send(&sock, reinterpret_cast<const char*>(&len), sizeof(len)) && send(&sock, data.c_str(), len);
+}
+
+bool SandboxHost::readAssignment(StreamingSocket* sock, String& pluginId, HandshakeRequest& cfg, int& workerPort,
+                                 String& cgroup) {
+    setLogTagStatic("sandboxhost");
+    traceScope();
+
+    int len = 0;
+    if (!read(sock, &len, sizeof(len), 5000) || len <= 0 || len > 1024 * 1024) {
+        logln("failed to read assignment");
+        return false;
+    }
+
+    std::vector<char> buf((size_t)len);
+    if (!read(sock, buf.data(), len, 5000)) {
+        logln("failed to read assignment");
+        return false;
+    }
+
+    try {
+        auto j = json::parse(buf.begin(), buf.end());
+        pluginId = j["pluginId"].get<std::string>();
+        cfg.fromJson(j["config"]);
+        workerPort = j["workerPort"].get<int>();
+        cgroup = jsonGetValue(j, "cgroup", String());
+    } catch (const json::exception& e) {
+        logln("failed to parse assignment: " << e.what());
+        return false;
+    }
+
+    return true;
+}
+
+File SandboxHost::getExecutable() {
+#ifndef AG_UNIT_TESTS
+    return File::getSpecialLocation(File::currentExecutableFile);
+#else
+    auto exe = File::getSpecialLocation(File::currentExecutableFile).getParentDirectory();
+#if JUCE_WINDOWS
+    return exe.getChildFile("AudioGridderServer.exe");
+#else
+    return exe.getChildFile("AudioGridderServer.app")
+        .getChildFile("Contents")
+        .getChildFile("MacOS")
+        .getChildFile("AudioGridderServer");
+#endif
+#endif
+}
+
+}  // namespace e47
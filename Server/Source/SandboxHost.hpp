@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef SandboxHost_hpp
+#define SandboxHost_hpp
+
+#include <JuceHeader.h>
+
+#include "Utils.hpp"
+#include "Message.hpp"
+
+namespace e47 {
+
+/*
+ * A plugin isolation sandbox process, that hosts the plugins assigned to it via its control port. Each plugin gets
+ * its own worker listening at the port of the ProcessorClient. The process is killed, when the last plugin leaves.
+ */
+class SandboxHost : public LogTag {
+  public:
+    // A full startup runs the same initialization as a server, this is only useful for comparing startup times
+    SandboxHost(int serverId, bool fullStartup = false);
+    ~SandboxHost() override;
+
+    bool start();
+    void kill();
+    bool isRunning() const;
+
+    int getPort() const { return m_port; }
+    const String& getGroup() const { return m_group; }
+    void setGroup(const String& g) { m_group = g; }
+
+    // Adds a member, fails if the process is full, dead or has been closed already
+    bool tryJoin(int maxMembers);
+
+    // Removes a member and kills the process after the last one left
+    void leave();
+
+    // Sends a plugin to the process, the worker for the plugin will listen at workerPort and the process moves to the
+    // given cgroup, if not empty
+    bool assign(const String& pluginId, const HandshakeRequest& cfg, int workerPort, const String& cgroup = {});
+
+    // Receives an assignment in the sandbox process
+    static bool readAssignment(StreamingSocket* sock, String& pluginId, HandshakeRequest& cfg, int& workerPort,
+                               String& cgroup);
+
+    // The binary to run sandbox processes from
+    static File getExecutable();
+
+  private:
+    int m_serverId;
+    bool m_fullStartup;
+    int m_port = 0;
+    String m_group;
+    std::unique_ptr<ChildProcess> m_process;
+    int m_members = 0;
+    bool m_closed = false;
+    mutable std::mutex m_mtx;
+};
+
+}  // namespace e47
+
+#endif /* SandboxHost_hpp */
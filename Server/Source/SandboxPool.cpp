@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "SandboxPool.hpp"
+#include "Server.hpp"
+#include "Defaults.hpp"
+
+namespace e47 {
+
+SandboxPool::SandboxPool(Server& server, bool pluginMode, int maxIdle)
+    : Thread("SandboxPool"), LogTag("sandboxpool"), m_server(server), m_demand(pluginMode, maxIdle) {
+    traceScope();
+    logln("keeping up to " << maxIdle << " idle " << (pluginMode ? "plugin" : "chain") << " sandboxes");
+    startThread();
+}
+
+SandboxPool::~SandboxPool() {
+    traceScope();
+    signalThreadShouldExit();
+    m_cv.notify_all();
+    stopThread(-1);
+    std::vector<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        entries.swap(m_entries);
+    }
+    for (auto& e : entries) {
+        release(e);
+    }
+}
+
+void SandboxPool::run() {
+    traceScope();
+    while (!threadShouldExit()) {
+        Kind next = NUM_KINDS;
+        std::vector<Entry> retired;
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+
+            auto now = Time::getMillisecondCounter();
+
+            // drop dead processes and idle processes, that are not needed anymore
+            for (auto it = m_entries.begin(); it != m_entries.end();) {
+                bool dead = (nullptr != it->host && !it->host->isRunning()) ||
+                            (nullptr != it->chain && it->chain->port == 0 && now - it->created > PORT_TIMEOUT_MS);
+                bool surplus = getNumIdle(it->kind) > getTarget(it->kind) && now - it->created > Demand::BUCKET_MS;
+                if (dead || surplus) {
+                    logln((dead ? "removing dead" : "retiring surplus") << " sandbox");
+                    retired.push_back(std::move(*it));
+                    it = m_entries.erase(it);
+                } else {
+                    it++;
+                }
+            }
+
+            for (int k = 0; k < NUM_KINDS; k++) {
+                if (getNumIdle((Kind)k) < getTarget((Kind)k)) {
+                    next = (Kind)k;
+                    break;
+                }
+            }
+
+            if (next == NUM_KINDS && retired.empty()) {
+                m_cv.wait_for(lock, std::chrono::seconds(1));
+                continue;
+            }
+        }
+
+        for (auto& e : retired) {
+            release(e);
+        }
+
+        if (next != NUM_KINDS && !spawn(next)) {
+            // don't hammer the system, if processes can't be started
+            sleepExitAware(5000);
+        }
+    }
+}
+
+std::shared_ptr<SandboxMaster> SandboxPool::takeChainSandbox(bool isLocal) {
+    traceScope();
+    auto kind = isLocal ? CHAIN_LOCAL : CHAIN_REMOTE;
+    std::shared_ptr<SandboxMaster> ret;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        addDemand(kind);
+        for (auto it = m_entries.begin(); it != m_entries.end(); it++) {
+            if (it->kind == kind && nullptr != it->chain && it->chain->port > 0) {
+                ret = std::move(it->chain);
+                m_entries.erase(it);
+                break;
+            }
+        }
+    }
+    m_cv.notify_one();
+    return ret;
+}
+
+std::shared_ptr<SandboxHost> SandboxPool::takePluginSandbox() {
+    traceScope();
+    std::shared_ptr<SandboxHost> ret;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        addDemand(PLUGIN);
+        for (auto it = m_entries.begin(); it != m_entries.end(); it++) {
+            if (it->kind == PLUGIN && nullptr != it->host && it->host->isRunning()) {
+                ret = std::move(it->host);
+                m_entries.erase(it);
+                break;
+            }
+        }
+    }
+    m_cv.notify_one();
+    return ret;
+}
+
+bool SandboxPool::remove(SandboxMaster& sandbox) {
+    traceScope();
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                               [&sandbox](const Entry& e) { return e.chain.get() == &sandbox; });
+        if (it == m_entries.end()) {
+            return false;
+        }
+        entry = std::move(*it);
+        m_entries.erase(it);
+    }
+    logln("idle sandbox " << sandbox.getId() << " disconnected");
+    release(entry);
+    m_cv.notify_one();
+    return true;
+}
+
+int SandboxPool::getNumIdle() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return (int)m_entries.size();
+}
+
+void SandboxPool::addDemand(Kind kind) { m_demand.add(kind, Time::getMillisecondCounter()); }
+
+int SandboxPool::getTarget(Kind kind) { return m_demand.getTarget(kind, Time::getMillisecondCounter()); }
+
+void SandboxPool::Demand::add(Kind kind, uint32 now) {
+    m_requests.emplace_back(now, kind);
+    m_seen[kind] = true;
+    while (!m_requests.empty() && now - m_requests.front().first > WINDOW_MS) {
+        m_requests.pop_front();
+    }
+}
+
+int SandboxPool::Demand::getTarget(Kind kind, uint32 now) const {
+    if (m_pluginMode != (kind == PLUGIN)) {
+        return 0;
+    }
+
+    // always keep one process for remote clients or plugins, local clients need a different listener, so we wait
+    // until we have seen one
+    int target = kind == CHAIN_LOCAL && !m_seen[kind] ? 0 : 1;
+
+    // the peak number of requests per minute within the demand window
+    int buckets[WINDOW_MS / BUCKET_MS] = {0};
+    for (auto& d : m_requests) {
+        auto idx = (now - d.first) / BUCKET_MS;
+        if (d.second == kind && idx < (uint32)numElementsInArray(buckets)) {
+            target = jmax(target, ++buckets[idx]);
+        }
+    }
+
+    return jmin(target, m_maxIdle);
+}
+
+int SandboxPool::getNumIdle(Kind kind) const {
+    int num = 0;
+    for (auto& e : m_entries) {
+        if (e.kind == kind) {
+            num++;
+        }
+    }
+    return num;
+}
+
+bool SandboxPool::spawn(Kind kind) {
+    traceScope();
+
+    Entry entry;
+    entry.kind = kind;
+    entry.created = Time::getMillisecondCounter();
+
+    if (kind == PLUGIN) {
+        entry.host = std::make_shared<SandboxHost>(m_server.getId());
+        if (!entry.host->start()) {
+            return false;
+        }
+    } else {
+        auto id = "pool-" + String(m_nextId++);
+        entry.chain = std::make_shared<SandboxMaster>(m_server, id);
+        if (!entry.chain->launchWorkerProcess(
+                File::getSpecialLocation(File::currentExecutableFile), Defaults::SANDBOX_CMD_PREFIX,
+                {"-id", String(m_server.getId()), "-islocal", String((int)(kind == CHAIN_LOCAL)), "-clientid", id},
+                3000, 30000)) {
+            logln("failed to launch chain sandbox " << id);
+            return false;
+        }
+        logln("started idle chain sandbox " << id);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_entries.push_back(std::move(entry));
+
+    return true;
+}
+
+void SandboxPool::release(Entry& e) {
+    if (nullptr != e.chain) {
+        m_server.releaseSandbox(std::move(e.chain));
+    }
+    if (nullptr != e.host) {
+        e.host->kill();
+        e.host.reset();
+    }
+}
+
+}  // namespace e47
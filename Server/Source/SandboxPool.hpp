@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef SandboxPool_hpp
+#define SandboxPool_hpp
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <deque>
+
+#include "Utils.hpp"
+#include "Sandbox.hpp"
+#include "SandboxHost.hpp"
+
+namespace e47 {
+
+class Server;
+
+/*
+ * Keeps a number of idle sandbox processes, that have already been started and loaded the plugin list, so that a new
+ * client (chain isolation) or plugin (plugin isolation) only has to send its config to one of them. The number of idle
+ * processes follows the recent demand, taken processes get replaced in the background.
+ */
+class SandboxPool : public Thread, public LogTag {
+  public:
+    enum Kind : int { CHAIN_REMOTE, CHAIN_LOCAL, PLUGIN, NUM_KINDS };
+
+    SandboxPool(Server& server, bool pluginMode, int maxIdle);
+    ~SandboxPool() override;
+
+    void run() override;
+
+    // Returns an idle chain sandbox, that reported its worker port already, or nullptr
+    std::shared_ptr<SandboxMaster> takeChainSandbox(bool isLocal);
+
+    // Returns an idle plugin sandbox process, or nullptr
+    std::shared_ptr<SandboxHost> takePluginSandbox();
+
+    // Called when an idle chain sandbox lost the connection to the master
+    bool remove(SandboxMaster& sandbox);
+
+    int getNumIdle();
+
+    // Tracks the recent requests and derives the number of idle processes to keep per kind
+    class Demand {
+      public:
+        static constexpr uint32 WINDOW_MS = 10 * 60 * 1000;
+        static constexpr uint32 BUCKET_MS = 60 * 1000;
+
+        Demand(bool pluginMode, int maxIdle) : m_pluginMode(pluginMode), m_maxIdle(maxIdle) {}
+
+        void add(Kind kind, uint32 now);
+        int getTarget(Kind kind, uint32 now) const;
+
+      private:
+        bool m_pluginMode;
+        int m_maxIdle;
+        std::deque<std::pair<uint32, Kind>> m_requests;
+        bool m_seen[NUM_KINDS] = {false, false, false};
+    };
+
+  private:
+    struct Entry {
+        Kind kind;
+        std::shared_ptr<SandboxMaster> chain;
+        std::shared_ptr<SandboxHost> host;
+        uint32 created;
+    };
+
+    static constexpr uint32 PORT_TIMEOUT_MS = 60 * 1000;
+
+    Server& m_server;
+    int m_nextId = 0;
+    std::vector<Entry> m_entries;
+    Demand m_demand;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+
+    void addDemand(Kind kind);
+    int getTarget(Kind kind);
+    int getNumIdle(Kind kind) const;
+
+    bool spawn(Kind kind);
+    void release(Entry& e);
+};
+
+}  // namespace e47
+
+#endif /* SandboxPool_hpp */
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "ScanWorker.hpp"
+#include "Server.hpp"
+#include "App.hpp"
+#include "Metrics.hpp"
+
+namespace e47 {
+
+ScanWorker::ScanWorker(int srvId) : LogTag("scanworker"), m_srvId(srvId) {}
+
+ScanWorker::~ScanWorker() {
+    traceScope();
+    stop();
+}
+
+bool ScanWorker::start() {
+    traceScope();
+
+    stop();
+
+    m_pipe = std::make_unique<NamedPipe>();
+    if (!m_pipe->createNewPipe(getPipeName(m_srvId))) {
+        logln("error: can't create pipe " << getPipeName(m_srvId));
+        m_pipe.reset();
+        return false;
+    }
+
+    StringArray args;
+    args.add(File::getSpecialLocation(File::currentExecutableFile).getFullPathName());
+    args.add("-scanworker");
+    args.addArray({"-id", String(m_srvId)});
+
+    m_proc = std::make_unique<ChildProcess>();
+    if (!m_proc->start(args)) {
+        logln("error: failed to start scan worker " << m_srvId);
+        m_proc.reset();
+        m_pipe.reset();
+        return false;
+    }
+
+    logln("scan worker " << m_srvId << " started");
+    m_jobs = 0;
+
+    return true;
+}
+
+void ScanWorker::stop() {
+    traceScope();
+
+    if (nullptr != m_proc && m_proc->isRunning()) {
+        if (nullptr != m_pipe && m_pipe->isOpen()) {
+            ScanPipeHdr hdr;
+            hdr.type = ScanPipeHdr::QUIT;
+            hdr.len = 0;
+            m_pipe->write(&hdr, sizeof(hdr), 100);
+        }
+        if (!m_proc->waitForProcessToFinish(1000)) {
+            m_proc->kill();
+        }
+    }
+
+    m_proc.reset();
+    m_pipe.reset();
+}
+
+ScanWorker::Result ScanWorker::scan(const String& id, const String& name, const String& fmt, bool secondRun,
+                                    ShellFn onShellPlugin) {
+    traceScope();
+
+    if (nullptr == m_proc || !m_proc->isRunning() || m_jobs >= MAX_JOBS) {
+        if (!start()) {
+            return NOT_STARTED;
+        }
+    }
+
+    String job = id;
+    job << "|" << fmt;
+
+    ScanPipeHdr hdr;
+    hdr.type = secondRun ? ScanPipeHdr::JOB_SECOND_RUN : ScanPipeHdr::JOB;
+    hdr.len = (int)job.getNumBytesAsUTF8();
+    if (!hdr.hasValidLen()) {
+        logln("error: job '" << id << "' exceeds the maximum length");
+        return NOT_STARTED;
+    }
+    if (m_pipe->write(&hdr, sizeof(hdr), 1000) != sizeof(hdr) ||
+        m_pipe->write(job.toRawUTF8(), hdr.len, 1000) != hdr.len) {
+        logln("error: failed to send job to scan worker " << m_srvId);
+        stop();
+        return NOT_STARTED;
+    }
+    m_jobs++;
+
+    std::vector<char> buf;
+    std::unique_ptr<TimeStatistic::Timeout> loadTimeout;
+    auto timeout = std::make_unique<TimeStatistic::Timeout>(SECONDS_PER_PLUGIN * 1000);
+    String lastShellName;
+    int numTimeouts = 0;
+    bool finished = false;
+    bool killed = false;
+
+    while (!finished && m_proc->isRunning()) {
+        if (m_pipe->read(&hdr, sizeof(hdr), 100) == sizeof(hdr)) {
+            switch (hdr.type) {
+                case ScanPipeHdr::LOAD_START:
+                    loadTimeout = std::make_unique<TimeStatistic::Timeout>(LOAD_TIMEOUT_MS);
+                    break;
+                case ScanPipeHdr::LOAD_FINISHED:
+                    loadTimeout.reset();
+                    break;
+                case ScanPipeHdr::SHELL:
+                    // the payload has to be consumed completely, otherwise the next header would be read from the
+                    // middle of it, so a bad length or a short read fails the worker
+                    if (!hdr.hasValidLen()) {
+                        logln("error: invalid shell name length " << hdr.len << " from scan worker, killing it");
+                        m_proc->kill();
+                        killed = true;
+                        break;
+                    }
+                    buf.resize((size_t)hdr.len + 1);
+                    if (hdr.len > 0 && m_pipe->read(buf.data(), hdr.len, 1000) != hdr.len) {
+                        logln("error: failed to read shell name from scan worker, killing it");
+                        m_proc->kill();
+                        killed = true;
+                        break;
+                    }
+                    buf[(size_t)hdr.len] = 0;
+                    lastShellName = buf.data();
+                    // let the scanner know, that the current plugin is a shell and has plugins inside
+                    onShellPlugin(lastShellName);
+                    // increase the timeout as there might be mutliple plugins per shell
+                    timeout = std::make_unique<TimeStatistic::Timeout>(SECONDS_PER_PLUGIN * 1000);
+                    logln("    -> shell plugin: " << lastShellName);
+                    break;
+                case ScanPipeHdr::JOB_FINISHED:
+                    finished = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (nullptr != loadTimeout && loadTimeout->getMillisecondsLeft() <= 0) {
+            logln("error: load timeout for '" << (lastShellName.isNotEmpty() ? lastShellName : name)
+                                              << "', killing scan worker");
+            m_proc->kill();
+            loadTimeout.reset();
+            killed = true;
+        }
+
+        if (!finished && !killed && timeout->getMillisecondsLeft() <= 0) {
+            auto* proc = m_proc.get();
+            getApp()->enableCancelScan(m_srvId, [proc] { proc->kill(); });
+
+            numTimeouts++;
+
+            if (!secondRun && numTimeouts > 9) {
+                // In case the load timeout is not able to kill the process (I've seen some waves shells on Windows
+                // hanging the process) our last resort is killing it from here.
+                m_proc->kill();
+                killed = true;
+            }
+
+            timeout = std::make_unique<TimeStatistic::Timeout>(SECONDS_PER_PLUGIN * 1000);
+        }
+    }
+
+    if (numTimeouts > 0) {
+        getApp()->disableCancelScan(m_srvId);
+    }
+
+    if (!finished) {
+        logln("scan worker " << m_srvId << " died while scanning '" << name << "'");
+        m_proc->waitForProcessToFinish(1000);
+        stop();
+        return CRASHED;
+    }
+
+    return FINISHED;
+}
+
+int ScanWorker::runWorkerProcess(int srvId) {
+    setLogTagStatic("scanworker");
+    traceScope();
+
+    NamedPipe pipe;
+    if (!pipe.openExisting(getPipeName(srvId))) {
+        logln("error: can't open pipe " << getPipeName(srvId));
+        return 1;
+    }
+
+    logln("scan worker " << srvId << " ready");
+
+    std::vector<char> buf;
+    int idleMs = 0;
+
+    while (idleMs < IDLE_TIMEOUT_MS) {
+        ScanPipeHdr hdr;
+        int ret = pipe.read(&hdr, sizeof(hdr), 1000);
+        if (ret < 0) {
+            logln("pipe closed");
+            break;
+        }
+        if (ret != sizeof(hdr)) {
+            idleMs += 1000;
+            continue;
+        }
+        idleMs = 0;
+
+        if (hdr.type == ScanPipeHdr::QUIT) {
+            break;
+        }
+
+        if (hdr.type == ScanPipeHdr::JOB || hdr.type == ScanPipeHdr::JOB_SECOND_RUN) {
+            if (!hdr.hasValidLen()) {
+                logln("error: invalid job length " << hdr.len);
+                break;
+            }
+            buf.resize((size_t)hdr.len);
+            if (hdr.len > 0 && pipe.read(buf.data(), hdr.len, 1000) != hdr.len) {
+                logln("error: failed to read job");
+                break;
+            }
+
+            auto parts = StringArray::fromTokens(String::fromUTF8(buf.data(), hdr.len), "|", "");
+            String id = parts[0];
+            String format = "VST";
+            if (parts.size() > 1) {
+                format = parts[1];
+            }
+
+            logln("scan job: format=" << format << " id=" << id);
+            bool success = Server::scanPlugin(id, format, srvId, hdr.type == ScanPipeHdr::JOB_SECOND_RUN, &pipe);
+            logln("..." << (success ? "success" : "failed"));
+
+            ScanPipeHdr res;
+            res.type = ScanPipeHdr::JOB_FINISHED;
+            res.len = success ? 1 : 0;
+            pipe.write(&res, sizeof(res), 1000);
+        }
+    }
+
+    logln("scan worker " << srvId << " finished");
+
+    return 0;
+}
+
+}  // namespace e47
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef ScanWorker_hpp
+#define ScanWorker_hpp
+
+#include <JuceHeader.h>
+
+#include "Utils.hpp"
+
+namespace e47 {
+
+struct ScanPipeHdr {
+    enum Type : uint8 { LOAD_START, LOAD_FINISHED, SHELL, JOB, JOB_SECOND_RUN, JOB_FINISHED, QUIT };
+    // Upper bound for the payload of a message (plugin paths and shell names)
+    static constexpr int MAX_LEN = 8192;
+    Type type;
+    int len;
+
+    bool hasValidLen() const { return len >= 0 && len <= MAX_LEN; }
+};
+
+/*
+ * A long lived scan process, that scans the plugin files it receives via a named pipe one after another. The process
+ * gets respawned for the next file after it crashed or has been killed due to a timeout.
+ */
+class ScanWorker : public LogTag {
+  public:
+    using ShellFn = std::function<void(const String&)>;
+
+    ScanWorker(int srvId);
+    ~ScanWorker() override;
+
+    int getId() const { return m_srvId; }
+
+    enum Result : int { FINISHED, NOT_STARTED, CRASHED };
+
+    // Sends a plugin file to the worker and waits until it has been scanned. Returns NOT_STARTED, if the job could not
+    // be passed to a worker process, and CRASHED, if the worker process died or had to be killed.
+    Result scan(const String& id, const String& name, const String& fmt, bool secondRun, ShellFn onShellPlugin);
+
+    // Entry point of the worker process
+    static int runWorkerProcess(int srvId);
+
+  private:
+    static constexpr int SECONDS_PER_PLUGIN = 30;
+    static constexpr int LOAD_TIMEOUT_MS = 5000;
+    static constexpr int MAX_JOBS = 250;
+    static constexpr int IDLE_TIMEOUT_MS = 60000;
+
+    int m_srvId;
+    std::unique_ptr<ChildProcess> m_proc;
+    std::unique_ptr<NamedPipe> m_pipe;
+    int m_jobs = 0;
+
+    static String getPipeName(int srvId) { return "audiogridderscan." + String(srvId); }
+
+    bool start();
+    void stop();
+};
+
+}  // namespace e47
+
+#endif /* ScanWorker_hpp */
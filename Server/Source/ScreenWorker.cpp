@@ -28,6 +28,7 @@ ScreenWorker::~ScreenWorker() {
 void ScreenWorker::init(std::unique_ptr<StreamingSocket> s) {
     traceScope();
     m_socket = std::move(s);
+    m_wasOk = true;
 }
 
 void ScreenWorker::run() {
@@ -10,11 +10,13 @@
 #include "App.hpp"
 #include "Metrics.hpp"
 #include "ServiceResponder.hpp"
+#include "ServiceReceiver.hpp"
 #include "CPUInfo.hpp"
 #include "WindowPositions.hpp"
 #include "ChannelSet.hpp"
 #include "Sentry.hpp"
 #include "Processor.hpp"
+#include "LowLatencyWait.hpp"
 
 #ifdef JUCE_MAC
 #include <sys/socket.h>
@@ -29,12 +31,6 @@
 
 namespace e47 {
 
-struct ScanPipeHdr {
-    enum Type : uint8 { LOAD_START, LOAD_FINISHED, SHELL };
-    Type type;
-    int len;
-};
-
 Server::Server(const json& opts) : Thread("Server"), LogTag("server"), m_opts(opts) { initAsyncFunctors(); }
 
 void Server::initialize() {
@@ -52,16 +48,23 @@ void Server::initialize() {
     setLogTagName(mode);
     logln("starting " << mode << " (version: " << AUDIOGRIDDER_VERSION << ", build date: " << AUDIOGRIDDER_BUILD_DATE
                       << ")...");
+    // a plugin sandbox only hosts plugins for another process, it has no UI of its own, does not announce itself via
+    // mDNS, does not capture screens and never reports the CPU load or sends a plugin list
+    m_leanStartup = m_sandboxModeRuntime == SANDBOX_PLUGIN && !getOpt("fullStartup", false);
     loadConfig();
     Metrics::initialize();
-    CPUInfo::initialize();
-    WindowPositions::initialize();
+    if (!m_leanStartup) {
+        CPUInfo::initialize();
+        WindowPositions::initialize();
+    }
 
     if (m_sandboxModeRuntime == SANDBOX_NONE) {
         Metrics::getStatistic<TimeStatistic>("audio")->enableExtData(true);
         Metrics::getStatistic<TimeStatistic>("audio")->getMeter().enableExtData(true);
         Metrics::getStatistic<Meter>("NetBytesOut")->enableExtData(true);
         Metrics::getStatistic<Meter>("NetBytesIn")->enableExtData(true);
+        Metrics::getStatistic<Meter>("DeadlineMisses")->enableExtData(true);
+        LowLatencyWait::getJitterStatistic()->enableExtData(true);
     }
 }
 
@@ -161,14 +164,44 @@ void Server::loadConfig() {
     m_screenMouseOffsetY = jsonGetValue(cfg, "ScreenMouseOffsetY", m_screenMouseOffsetY);
     m_pluginWindowsOnTop = jsonGetValue(cfg, "PluginWindowsOnTop", m_pluginWindowsOnTop);
     m_scanForPlugins = jsonGetValue(cfg, "ScanForPlugins", m_scanForPlugins);
+    m_watchPluginFolders = jsonGetValue(cfg, "WatchPluginFolders", m_watchPluginFolders);
     m_crashReporting = jsonGetValue(cfg, "CrashReporting", m_crashReporting);
     m_processingTraceTresholdMs = jsonGetValue(cfg, "ProcessingTraceTresholdMs", m_processingTraceTresholdMs);
+    m_lowLatencyMode = jsonGetValue(cfg, "LowLatencyMode", m_lowLatencyMode);
+    if (m_lowLatencyMode) {
+        logln("low latency mode enabled, audio workers busy poll for incoming blocks");
+    }
     logln("crash reporting is " << (m_crashReporting ? "enabled" : "disabled"));
     m_sandboxMode = (SandboxMode)jsonGetValue(cfg, "SandboxMode", m_sandboxMode);
     logln("sandbox mode is " << (m_sandboxMode == SANDBOX_CHAIN    ? "chain isolation"
                                  : m_sandboxMode == SANDBOX_PLUGIN ? "plugin isolation"
                                                                    : "disabled"));
     m_sandboxLogAutoclean = jsonGetValue(cfg, "SandboxLogAutoclean", m_sandboxLogAutoclean);
+    m_pluginPoolEnabled = jsonGetValue(cfg, "PluginPool", m_pluginPoolEnabled);
+    m_pluginPoolMemoryMB = jsonGetValue(cfg, "PluginPoolMemoryMB", m_pluginPoolMemoryMB);
+    m_sandboxPoolEnabled = jsonGetValue(cfg, "SandboxPool", m_sandboxPoolEnabled);
+    m_sandboxPoolMaxIdle = jsonGetValue(cfg, "SandboxPoolMaxIdle", m_sandboxPoolMaxIdle);
+    m_sandboxGrouping = (SandboxGroups::Policy)jsonGetValue(cfg, "SandboxGrouping", (int)m_sandboxGrouping);
+    m_sandboxGroupSize = jsonGetValue(cfg, "SandboxGroupSize", m_sandboxGroupSize);
+    m_sandboxGroupAllowlist.clear();
+    if (jsonHasValue(cfg, "SandboxGroupAllowlist")) {
+        for (auto& s : cfg["SandboxGroupAllowlist"]) {
+            m_sandboxGroupAllowlist.add(s.get<std::string>());
+        }
+    }
+    m_sandboxSnapshotMaxAgeSecs = jsonGetValue(cfg, "SandboxSnapshotMaxAgeSecs", m_sandboxSnapshotMaxAgeSecs);
+    m_sandboxCGroupsEnabled = jsonGetValue(cfg, "SandboxCGroups", m_sandboxCGroupsEnabled);
+    m_sandboxCGroupScope = (SandboxCGroups::Scope)jsonGetValue(cfg, "SandboxCGroupScope", (int)m_sandboxCGroupScope);
+    m_sandboxCGroupCPUWeight = jsonGetValue(cfg, "SandboxCGroupCPUWeight", m_sandboxCGroupCPUWeight);
+    m_sandboxCGroupMemoryMaxMB = jsonGetValue(cfg, "SandboxCGroupMemoryMaxMB", m_sandboxCGroupMemoryMaxMB);
+    m_sandboxCGroupCPUs = jsonGetValue(cfg, "SandboxCGroupCPUs", m_sandboxCGroupCPUs);
+    m_sessionGraceSecs = jsonGetValue(cfg, "SessionGracePeriodSecs", m_sessionGraceSecs);
+    m_chainHopAllowlist.clear();
+    if (jsonHasValue(cfg, "ChainHopAllowlist")) {
+        for (auto& s : cfg["ChainHopAllowlist"]) {
+            m_chainHopAllowlist.add(s.get<std::string>());
+        }
+    }
     m_pluginExclude.clear();
     if (jsonHasValue(cfg, "ExcludePlugins")) {
         for (auto& s : cfg["ExcludePlugins"]) {
@@ -179,6 +212,7 @@ void Server::loadConfig() {
 
 void Server::saveConfig() {
     traceScope();
+    std::lock_guard<std::recursive_mutex> lock(m_pluginListUpdateMtx);
     json j;
     j["Tracer"] = Tracer::isEnabled();
     j["Logger"] = Logger::isEnabled();
@@ -227,10 +261,33 @@ void Server::saveConfig() {
         j["ExcludePlugins"].push_back(p.toStdString());
     }
     j["ScanForPlugins"] = m_scanForPlugins;
+    j["WatchPluginFolders"] = m_watchPluginFolders;
     j["CrashReporting"] = m_crashReporting;
     j["SandboxMode"] = m_sandboxMode;
     j["SandboxLogAutoclean"] = m_sandboxLogAutoclean;
     j["ProcessingTraceTresholdMs"] = m_processingTraceTresholdMs;
+    j["LowLatencyMode"] = m_lowLatencyMode;
+    j["PluginPool"] = m_pluginPoolEnabled;
+    j["PluginPoolMemoryMB"] = m_pluginPoolMemoryMB;
+    j["SandboxPool"] = m_sandboxPoolEnabled;
+    j["SandboxPoolMaxIdle"] = m_sandboxPoolMaxIdle;
+    j["SandboxGrouping"] = m_sandboxGrouping;
+    j["SandboxGroupSize"] = m_sandboxGroupSize;
+    j["SandboxGroupAllowlist"] = json::array();
+    for (auto& s : m_sandboxGroupAllowlist) {
+        j["SandboxGroupAllowlist"].push_back(s.toStdString());
+    }
+    j["SandboxSnapshotMaxAgeSecs"] = m_sandboxSnapshotMaxAgeSecs;
+    j["SandboxCGroups"] = m_sandboxCGroupsEnabled;
+    j["SandboxCGroupScope"] = m_sandboxCGroupScope;
+    j["SandboxCGroupCPUWeight"] = m_sandboxCGroupCPUWeight;
+    j["SandboxCGroupMemoryMaxMB"] = m_sandboxCGroupMemoryMaxMB;
+    j["SandboxCGroupCPUs"] = m_sandboxCGroupCPUs.toStdString();
+    j["SessionGracePeriodSecs"] = m_sessionGraceSecs;
+    j["ChainHopAllowlist"] = json::array();
+    for (auto& s : m_chainHopAllowlist) {
+        j["ChainHopAllowlist"].push_back(s.toStdString());
+    }
 
     File cfg(Defaults::getConfigFileName(Defaults::ConfigServer, {{"id", String(getId())}}));
     logln("saving config to " << cfg.getFullPathName());
@@ -249,10 +306,31 @@ int Server::getId(bool ignoreOpts) const {
     return getOpt("ID", m_id);
 }
 
+KnownPluginList& Server::getPluginList() {
+    if (m_pluginListDeferred) {
+        std::lock_guard<std::mutex> lock(m_pluginListMtx);
+        if (m_pluginListDeferred) {
+            loadKnownPluginList();
+            if (m_sandboxModeRuntime == SANDBOX_NONE && removeDisabledFormats()) {
+                updatePluginCatalog();
+            }
+            m_pluginList.sort(KnownPluginList::sortAlphabetically, true);
+            m_pluginListDeferred = false;
+        }
+    }
+    return m_pluginList;
+}
+
 void Server::loadKnownPluginList() {
     traceScope();
 
-    loadKnownPluginList(m_pluginList, m_jpluginLayouts, getId());
+    // the layouts get decoded on demand from the layout cache, so only the list is needed here
+    json playouts;
+    bool fromCatalogFile = loadKnownPluginList(m_pluginList, playouts, getId(), false);
+    m_pluginListVersion++;
+    if (fromCatalogFile) {
+        m_pluginCatalogFileVersion = m_pluginListVersion.load();
+    }
 
     std::map<String, PluginDescription> dedupMap;
 
@@ -283,6 +361,7 @@ void Server::loadKnownPluginList() {
             }
             if (shouldExclude(name, desc.fileOrIdentifier)) {
                 m_pluginList.removeType(desc);
+                m_pluginListVersion++;
                 m_jpluginLayouts.erase(pluginId.toStdString());
             }
         }
@@ -296,11 +375,13 @@ void Server::loadKnownPluginList() {
                 // existing one is newer, remove current
                 updateDedupMap = false;
                 m_pluginList.removeType(desc);
+                m_pluginListVersion++;
                 m_jpluginLayouts.erase(pluginId.toStdString());
                 logln("  info: ignoring " << desc.descriptiveName << " (" << desc.version << ") due to newer version");
             } else {
                 // existing one is older, keep current
                 m_pluginList.removeType(descExists);
+                m_pluginListVersion++;
                 m_jpluginLayouts.erase(Processor::createPluginID(descExists).toStdString());
                 logln("  info: ignoring " << descExists.descriptiveName << " (" << descExists.version
                                           << ") due to newer version");
@@ -311,10 +392,44 @@ void Server::loadKnownPluginList() {
             dedupMap[pluginId] = desc;
         }
     }
+
+    updatePluginCatalog();
+}
+
+bool Server::removeDisabledFormats() {
+    bool removed = false;
+    for (auto& type : m_pluginList.getTypes()) {
+        if (!isFormatEnabled(type.pluginFormatName)) {
+            m_pluginList.removeType(type);
+            removed = true;
+        }
+    }
+    if (removed) {
+        m_pluginListVersion++;
+    }
+    return removed;
+}
+
+bool Server::isFormatEnabled(const String& format) const {
+    return !((format == "AudioUnit" && !m_enableAU) || (format == "VST" && !m_enableVST2) ||
+             (format == "VST3" && !m_enableVST3));
 }
 
-bool Server::parsePluginLayouts(const String& id) {
-    if (m_jpluginLayouts.empty() && !m_pluginList.getTypes().isEmpty()) {
+void Server::pluginListChanged() {
+    m_pluginListVersion++;
+    updatePluginCatalog();
+}
+
+bool Server::parsePluginLayouts() {
+    // the layouts get decoded on demand
+    m_layoutCache = std::make_unique<LayoutCache>(
+        File(Defaults::getConfigFileName(Defaults::PluginLayoutsCache, {{"id", String(getId())}})));
+    m_layoutCache->load();
+
+    auto catalog = getPluginCatalog();
+    bool hasPlugins = m_pluginListDeferred ? nullptr != catalog && catalog->getNumPlugins() > 0
+                                           : !m_pluginList.getTypes().isEmpty();
+    if (m_layoutCache->size() == 0 && hasPlugins) {
         if (m_sandboxModeRuntime == SANDBOX_NONE) {
             String msg =
                 "No cached plugin layouts have been found. This can increase plugin loading times and not all "
@@ -322,100 +437,263 @@ bool Server::parsePluginLayouts(const String& id) {
             msg << newLine << newLine << "Do you want to rescan your plugins?";
             if (AlertWindow::showOkCancelBox(AlertWindow::QuestionIcon, "Missing Plugin I/O Layouts", msg, "Yes",
                                              "No")) {
-                m_pluginList.clear();
-                saveKnownPluginList();
+                saveKnownPluginList(true);
                 getApp()->restartServer(true);
                 return false;
             }
         }
-    } else {
-        auto readLayouts = [this](const std::string& key, const auto& jlayouts) {
-            if (jlayouts.is_array()) {
-                for (auto& jlayout : jlayouts) {
-                    auto layout = deserializeLayout(jsonGetValue(jlayout, "layout", String()));
-                    m_pluginLayouts[key].add(layout);
-                }
-            }
-        };
+    }
 
-        try {
-            logln("parsing " << m_jpluginLayouts.size() << " plugin layouts..."
-                             << (id.isNotEmpty() ? " (id=" + id + ")" : String()));
+    return true;
+}
 
-            if (id.isNotEmpty()) {
-                auto it = m_jpluginLayouts.find(id.toStdString());
-                if (it != m_jpluginLayouts.end()) {
-                    readLayouts(it.key(), it.value());
-                }
-            } else {
-                for (auto it = m_jpluginLayouts.begin(); it != m_jpluginLayouts.end(); it++) {
-                    readLayouts(it.key(), it.value());
-                }
+Array<AudioProcessor::BusesLayout> Server::getPluginLayouts(const String& id) {
+    std::lock_guard<std::mutex> lock(m_pluginLayoutsMtx);
+
+    auto it = m_pluginLayouts.find(id);
+    if (it != m_pluginLayouts.end()) {
+        return it->second;
+    }
+
+    if (nullptr != m_layoutCache) {
+        if (auto desc = findPluginDescription(id)) {
+            Array<AudioProcessor::BusesLayout> layouts;
+            if (m_layoutCache->get(id, desc->version, layouts) && !layouts.isEmpty()) {
+                return m_pluginLayouts[id] = layouts;
             }
+        }
+    }
+
+    return {};
+}
+
+void Server::storePluginLayouts(const String& id, const Array<AudioProcessor::BusesLayout>& layouts) {
+    traceScope();
 
-            logln("...ok");
-        } catch (const json::exception& e) {
-            logln("parsing plugin layouts failed: " << e.what());
+    if (layouts.isEmpty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_pluginLayoutsMtx);
+
+    m_pluginLayouts[id] = layouts;
+
+    {
+        std::lock_guard<std::mutex> plock(m_pluginCatalogMtx);
+        m_pluginListPayloads.clear();
+    }
+
+    if (nullptr != m_layoutCache) {
+        if (auto desc = findPluginDescription(id)) {
+            m_layoutCache->put(id, desc->version, layouts);
+            m_layoutCache->save();
         }
     }
-    return true;
 }
 
-const Array<AudioProcessor::BusesLayout>& Server::getPluginLayouts(const String& id) {
-    auto it = m_pluginLayouts.find(id);
-    if (it != m_pluginLayouts.end()) {
-        return it->second;
+std::unique_ptr<PluginDescription> Server::findPluginDescription(const String& id, String* idNormalized) {
+    auto catalog = getPluginCatalog();
+    if (nullptr == catalog) {
+        return Processor::findPluginDescription(id, m_pluginList, idNormalized);
     }
 
-    static Array<AudioProcessor::BusesLayout> vempty;
-    return vempty;
+    bool matchedFile = false;
+    int idx = catalog->find(id, &matchedFile);
+    if (idx < 0) {
+        // the passed ID could be a JUCE ID, lets try to convert it to an AG ID
+        auto convertedId = Processor::convertJUCEtoAGPluginID(id);
+        if (convertedId.isNotEmpty()) {
+            idx = catalog->find(convertedId, &matchedFile);
+        }
+    }
+
+    auto desc = std::make_unique<PluginDescription>();
+    if (idx < 0 || !catalog->getDescription(idx, *desc)) {
+        return nullptr;
+    }
+
+    if (m_pluginListDeferred && m_sandboxModeRuntime == SANDBOX_NONE &&
+        (!isFormatEnabled(desc->pluginFormatName) || shouldExclude(desc->name, desc->fileOrIdentifier))) {
+        // the mapped catalog is not filtered yet
+        return nullptr;
+    }
+
+    if (nullptr != idNormalized) {
+        *idNormalized = matchedFile ? id : catalog->getPluginId(idx);
+    }
+
+    return desc;
 }
 
-void Server::loadKnownPluginList(KnownPluginList& plist, json& playouts, int srvId) {
-    setLogTagStatic("server");
+bool Server::getPluginListPayload(const String& key, MemoryBlock& data) {
+    std::lock_guard<std::mutex> lock(m_pluginCatalogMtx);
+    auto it = m_pluginListPayloads.find(key);
+    if (it != m_pluginListPayloads.end()) {
+        data = it->second;
+        return true;
+    }
+    return false;
+}
+
+void Server::setPluginListPayload(const String& key, const MemoryBlock& data) {
+    std::lock_guard<std::mutex> lock(m_pluginCatalogMtx);
+    m_pluginListPayloads[key] = data;
+}
+
+std::shared_ptr<PluginCatalog> Server::getPluginCatalog() {
+    std::lock_guard<std::mutex> lock(m_pluginCatalogMtx);
+    return m_pluginCatalog;
+}
+
+void Server::updatePluginCatalog() {
     traceScope();
 
-    File cacheFile(Defaults::getConfigFileName(Defaults::ConfigPluginCache, {{"id", String(srvId)}}));
-    File layoutsFile(Defaults::getConfigFileName(Defaults::PluginLayouts, {{"id", String(srvId)}}));
+    auto catalog = std::make_shared<PluginCatalog>();
 
-#ifndef AG_UNIT_TESTS
-    if (!cacheFile.existsAsFile() && srvId < Defaults::SCAN_ID_START) {
-        cacheFile = File(Defaults::getConfigFileName(Defaults::ConfigPluginCache, {{"id", "0"}}));
+    File catalogFile(Defaults::getConfigFileName(Defaults::ConfigPluginCatalog, {{"id", String(getId())}}));
+    if (m_pluginCatalogFileVersion.load() != m_pluginListVersion.load() || !catalog->open(catalogFile)) {
+        // the list has been changed since the catalog file has been written or read, index it in memory
+        catalog->open(PluginCatalog::build(m_pluginList));
     }
-    if (!layoutsFile.existsAsFile() && srvId < Defaults::SCAN_ID_START) {
-        layoutsFile = File(Defaults::getConfigFileName(Defaults::PluginLayouts, {{"id", "0"}}));
+
+    logln("plugin catalog has " << catalog->getNumPlugins() << " plugins and " << catalog->getNumBlocklisted()
+                                << " blocklist entries");
+
+    std::lock_guard<std::mutex> lock(m_pluginCatalogMtx);
+    m_pluginCatalog = catalog;
+    m_pluginListPayloads.clear();
+}
+
+bool Server::openPluginCatalog() {
+    traceScope();
+
+    auto catalog = std::make_shared<PluginCatalog>();
+
+    File catalogFile(Defaults::getConfigFileName(Defaults::ConfigPluginCatalog, {{"id", String(getId())}}));
+    if (!catalog->open(catalogFile)) {
+        return false;
     }
-#endif
 
-    if (cacheFile.existsAsFile()) {
-        logln("loading plugins cache from " << cacheFile.getFullPathName());
-        if (auto xml = XmlDocument::parse(cacheFile)) {
-            plist.recreateFromXml(*xml);
-        } else {
-            logln("failed to parse plugins cache " << cacheFile.getFullPathName());
+    logln("mapped plugin catalog with " << catalog->getNumPlugins() << " plugins");
+
+    std::lock_guard<std::mutex> lock(m_pluginCatalogMtx);
+    m_pluginCatalog = catalog;
+    m_pluginListPayloads.clear();
+    return true;
+}
+
+bool Server::loadKnownPluginList(KnownPluginList& plist, json& playouts, int srvId, bool withLayouts) {
+    setLogTagStatic("server");
+    traceScope();
+
+    bool fromCatalogFile = false;
+
+    auto loadLayouts = [&](const String& id) {
+        LayoutCache cache(File(Defaults::getConfigFileName(Defaults::PluginLayoutsCache, {{"id", id}})));
+        if (!cache.load()) {
+            return;
         }
-    } else {
-        logln("no plugins cache found");
+        for (auto& desc : plist.getTypes()) {
+            Array<AudioProcessor::BusesLayout> layouts;
+            if (cache.get(Processor::createPluginID(desc), desc.version, layouts)) {
+                auto& jlayouts = playouts[Processor::createPluginID(desc).toStdString()];
+                jlayouts = json::array();
+                for (auto& l : layouts) {
+                    jlayouts.push_back({{"description", describeLayout(l).toStdString()},
+                                        {"layout", serializeLayout(l).toStdString()}});
+                }
+            }
+        }
+    };
+
+    auto loadCatalog = [&](const String& id) {
+        File catalogFile(Defaults::getConfigFileName(Defaults::ConfigPluginCatalog, {{"id", id}}));
+        PluginCatalog catalog;
+        if (catalog.open(catalogFile)) {
+            logln("loading plugins catalog from " << catalogFile.getFullPathName());
+            catalog.toKnownPluginList(plist);
+            if (withLayouts) {
+                loadLayouts(id);
+            }
+            fromCatalogFile = id == String(srvId);
+            return true;
+        }
+
+        // import the legacy XML cache
+        File cacheFile(Defaults::getConfigFileName(Defaults::ConfigPluginCache, {{"id", id}}));
+        File layoutsFile(Defaults::getConfigFileName(Defaults::PluginLayouts, {{"id", id}}));
+        auto data = PluginCatalog::importXml(cacheFile);
+        if (data.isEmpty() || !catalog.open(MemoryBlock(data))) {
+            return false;
+        }
+        catalog.toKnownPluginList(plist);
+        if (layoutsFile.existsAsFile()) {
+            logln("importing plugin layouts from " << layoutsFile.getFullPathName());
+            playouts = jsonReadFile(layoutsFile.getFullPathName(), true);
+        }
+        if (id == String(srvId)) {
+            logln("writing plugins catalog to " << catalogFile.getFullPathName());
+            if (PluginCatalog::write(catalogFile, data)) {
+                fromCatalogFile = true;
+                saveKnownPluginLayouts(plist, playouts, srvId);
+                // the legacy files are not updated anymore, move them away, so that they can't be mistaken as current
+                for (auto& f : {cacheFile, layoutsFile}) {
+                    if (f.existsAsFile()) {
+                        auto imported = f.getSiblingFile(f.getFileName() + ".imported");
+                        logln("moving imported file " << f.getFullPathName() << " to " << imported.getFullPathName());
+                        f.moveFileTo(imported);
+                    }
+                }
+            } else {
+                logln("failed to store plugins catalog");
+            }
+        }
+        return true;
+    };
+
+    bool loaded = loadCatalog(String(srvId));
+
+#ifndef AG_UNIT_TESTS
+    if (!loaded && srvId < Defaults::SCAN_ID_START) {
+        loaded = loadCatalog("0");
     }
+#endif
 
-    if (layoutsFile.existsAsFile()) {
-        logln("loading plugin layouts from " << layoutsFile.getFullPathName());
-        playouts = jsonReadFile(layoutsFile.getFullPathName(), true);
-    } else {
-        logln("no plugin layouts found");
+    if (!loaded) {
+        logln("no plugins catalog found");
     }
+
+    return fromCatalogFile;
 }
 
 void Server::saveKnownPluginList(bool wipe) {
     traceScope();
+    std::lock_guard<std::recursive_mutex> updLock(m_pluginListUpdateMtx);
     if (wipe) {
         m_pluginList.clear();
         m_jpluginLayouts.clear();
+        m_pluginListDeferred = false;
+    }
+    {
+        // release the mapped catalog file before replacing it
+        std::lock_guard<std::mutex> lock(m_pluginCatalogMtx);
+        m_pluginCatalog.reset();
+        m_pluginListPayloads.clear();
+    }
+    if (saveKnownPluginList(m_pluginList, m_jpluginLayouts, getId())) {
+        m_pluginCatalogFileVersion = m_pluginListVersion.load();
+    } else {
+        m_pluginListVersion++;
     }
-    saveKnownPluginList(m_pluginList, m_jpluginLayouts, getId());
+    updatePluginCatalog();
+    if (nullptr != m_layoutCache) {
+        m_layoutCache->load();
+    }
+    std::lock_guard<std::mutex> lock(m_pluginLayoutsMtx);
+    m_pluginLayouts.clear();
 }
 
-void Server::saveKnownPluginList(KnownPluginList& plist, json& playouts, int srvId) {
+bool Server::saveKnownPluginList(KnownPluginList& plist, json& playouts, int srvId) {
     setLogTagStatic("server");
     traceScope();
 
@@ -429,16 +707,38 @@ void Server::saveKnownPluginList(KnownPluginList& plist, json& playouts, int srv
         plist.addToBlacklist(entry);
     }
 
-    File cacheFile(Defaults::getConfigFileName(Defaults::ConfigPluginCache, {{"id", String(srvId)}}));
-    logln("writing plugins cache to " << cacheFile.getFullPathName());
-    auto xml = plist.createXml();
-    if (!xml->writeTo(cacheFile)) {
-        logln("failed to store plugin cache");
+    File catalogFile(Defaults::getConfigFileName(Defaults::ConfigPluginCatalog, {{"id", String(srvId)}}));
+    logln("writing plugins catalog to " << catalogFile.getFullPathName());
+    bool ok = PluginCatalog::write(catalogFile, plist);
+    if (!ok) {
+        logln("failed to store plugins catalog");
     }
 
-    auto layoutsFile = Defaults::getConfigFileName(Defaults::PluginLayouts, {{"id", String(srvId)}});
-    logln("writing plugin layouts to " << layoutsFile);
-    jsonWriteFile(layoutsFile, playouts, true);
+    saveKnownPluginLayouts(plist, playouts, srvId);
+
+    return ok;
+}
+
+void Server::saveKnownPluginLayouts(const KnownPluginList& plist, const json& playouts, int srvId) {
+    setLogTagStatic("server");
+    traceScope();
+
+    LayoutCache cache(File(Defaults::getConfigFileName(Defaults::PluginLayoutsCache, {{"id", String(srvId)}})));
+    for (auto& desc : plist.getTypes()) {
+        auto pluginId = Processor::createPluginID(desc);
+        auto it = playouts.find(pluginId.toStdString());
+        if (it == playouts.end() || !it->is_array()) {
+            continue;
+        }
+        Array<AudioProcessor::BusesLayout> layouts;
+        for (auto& jlayout : *it) {
+            layouts.add(deserializeLayout(jsonGetValue(jlayout, "layout", String())));
+        }
+        cache.put(pluginId, desc.version, layouts);
+    }
+    if (!cache.save()) {
+        logln("failed to store plugin layouts");
+    }
 }
 
 Server::~Server() {
@@ -456,8 +756,13 @@ Server::~Server() {
     ScreenRecorder::cleanup();
     Metrics::cleanup();
     ServiceResponder::cleanup();
-    CPUInfo::cleanup();
-    WindowPositions::cleanup();
+    if (m_sandboxModeRuntime == SANDBOX_NONE || m_sandboxModeRuntime == SANDBOX_CHAIN) {
+        ServiceReceiver::cleanup((uint64)getTagId());
+    }
+    if (!m_leanStartup) {
+        CPUInfo::cleanup();
+        WindowPositions::cleanup();
+    }
 
     logln("server terminated");
 
@@ -503,6 +808,11 @@ void Server::shutdownWorkers() {
         w->waitForThreadToExit(-1);
     }
 
+    // resumes stop waiting, when their workers are shutting down
+    while (m_pendingResumes > 0) {
+        Thread::sleep(10);
+    }
+
     m_workers.clear();
 }
 
@@ -513,6 +823,7 @@ bool Server::shouldExclude(const String& name, const String& id) {
 
 bool Server::shouldExclude(const String& name, const String& id, const std::vector<String>& include) {
     traceScope();
+    std::lock_guard<std::recursive_mutex> lock(m_pluginListUpdateMtx);
     if (name.containsIgnoreCase("AGridder") || name.containsIgnoreCase("AudioGridder")) {
         return true;
     }
@@ -537,9 +848,7 @@ void Server::addPlugins(const std::vector<String>& names, std::function<void(boo
     traceScope();
     std::thread([this, names, fn] {
         traceScope();
-        scanForPlugins(names);
-        saveConfig();
-        saveKnownPluginList();
+        rescanPlugins(names, false);
         if (fn) {
             for (auto& name : names) {
                 bool found = false;
@@ -555,7 +864,7 @@ void Server::addPlugins(const std::vector<String>& names, std::function<void(boo
     }).detach();
 }
 
-bool Server::scanPlugin(const String& id, const String& format, int srvId, bool secondRun) {
+bool Server::scanPlugin(const String& id, const String& format, int srvId, bool secondRun, NamedPipe* statusPipe) {
     std::unique_ptr<AudioPluginFormat> fmt;
     if (!format.compare("VST")) {
 #if JUCE_PLUGINHOST_VST
@@ -624,9 +933,13 @@ bool Server::scanPlugin(const String& id, const String& format, int srvId, bool
     logln("...ok");
 
     String pipeName = "audiogridderscan." + String(srvId);
-    NamedPipe pipe;
-    if (!pipe.openExisting(pipeName)) {
-        logln("warning: can't open pipe " << pipeName);
+    NamedPipe ownPipe;
+    auto* pipe = statusPipe;
+    if (nullptr == pipe) {
+        if (!ownPipe.openExisting(pipeName)) {
+            logln("warning: can't open pipe " << pipeName);
+        }
+        pipe = &ownPipe;
     }
 
     auto types = newlist.getTypes();
@@ -636,14 +949,15 @@ bool Server::scanPlugin(const String& id, const String& format, int srvId, bool
         auto pluginIdWithName = Processor::createPluginIDWithName(t);
 
         // update the server process
-        if (types.size() > 1 && pipe.isOpen()) {
+        if (types.size() > 1 && pipe->isOpen()) {
             String out = t.descriptiveName;
             out << " (" << format.toLowerCase() << ")";
             ScanPipeHdr hdr;
             hdr.type = ScanPipeHdr::SHELL;
-            hdr.len = out.length();
-            pipe.write(&hdr, sizeof(hdr), 100);
-            pipe.write(out.toRawUTF8(), hdr.len, 100);
+            // the length is in bytes, non ASCII names would otherwise desync the pipe
+            hdr.len = jmin((int)out.getNumBytesAsUTF8(), ScanPipeHdr::MAX_LEN);
+            pipe->write(&hdr, sizeof(hdr), 100);
+            pipe->write(out.toRawUTF8(), hdr.len, 100);
         }
 
         logln("adding plugin description:");
@@ -667,22 +981,22 @@ bool Server::scanPlugin(const String& id, const String& format, int srvId, bool
             logln("testing I/O layouts...");
 
             // Let the scan master know, that we are loading a plugin now. This might hang, so the master can kill us.
-            if (pipe.isOpen()) {
+            if (pipe->isOpen()) {
                 ScanPipeHdr hdr;
                 hdr.type = ScanPipeHdr::LOAD_START;
                 hdr.len = 0;
-                pipe.write(&hdr, sizeof(hdr), 100);
+                pipe->write(&hdr, sizeof(hdr), 100);
             }
 
             String err;
             if (auto inst = Processor::loadPlugin(t, 48000, 512, err)) {
                 logln("plugin loaded");
 
-                if (pipe.isOpen()) {
+                if (pipe->isOpen()) {
                     ScanPipeHdr hdr;
                     hdr.type = ScanPipeHdr::LOAD_FINISHED;
                     hdr.len = 0;
-                    pipe.write(&hdr, sizeof(hdr), 100);
+                    pipe->write(&hdr, sizeof(hdr), 100);
                 }
 
                 auto layouts = Processor::findSupportedLayouts(inst);
@@ -716,114 +1030,29 @@ bool Server::scanPlugin(const String& id, const String& format, int srvId, bool
     return success;
 }
 
-void Server::scanNextPlugin(const String& id, const String& name, const String& fmt, int srvId,
+void Server::scanNextPlugin(const String& id, const String& name, const String& fmt, ScanWorker& worker,
                             std::function<void(const String&)> onShellPlugin, bool secondRun) {
     traceScope();
-    String fileFmt = id;
-    fileFmt << "|" << fmt;
-    ChildProcess proc;
-    StringArray args;
-    args.add(File::getSpecialLocation(File::currentExecutableFile).getFullPathName());
-    args.addArray({"-scan", fileFmt});
-    args.addArray({"-id", String(srvId)});
-    if (secondRun) {
-        args.add("-secondrun");
-    }
-    String pipeName = "audiogridderscan." + String(srvId);
-    NamedPipe pipe;
-    if (!pipe.createNewPipe(pipeName)) {
-        logln("warning: can't open pipe " << pipeName);
-    }
+    int srvId = worker.getId();
     bool blacklist = false;
-    if (proc.start(args)) {
-        const int secondsPerPlugin = 30;
-        std::atomic_int secondsLeft{secondsPerPlugin};
-
-        FnThread outputReader(
-            [this, &pipe, &proc, &secondsLeft, name, secs = secondsPerPlugin, onShellPlugin] {
-                std::vector<char> buf(256);
-                std::unique_ptr<TimeStatistic::Timeout> loadTimeout;
-                String lastShellName;
-                while (proc.isRunning() && !currentThreadShouldExit()) {
-                    ScanPipeHdr hdr;
-                    if (pipe.read(&hdr, sizeof(hdr), 100) == sizeof(hdr)) {
-                        switch (hdr.type) {
-                            case ScanPipeHdr::LOAD_START:
-                                loadTimeout = std::make_unique<TimeStatistic::Timeout>(5000);
-                                break;
-                            case ScanPipeHdr::LOAD_FINISHED:
-                                loadTimeout.reset();
-                                break;
-                            case ScanPipeHdr::SHELL:
-                                if (pipe.read(buf.data(), hdr.len, 1000) == hdr.len) {
-                                    buf[(size_t)hdr.len] = 0;
-                                    lastShellName = buf.data();
-                                    // let the scanner know, that the current plugin is a shell and has plugins inside
-                                    onShellPlugin(lastShellName);
-                                    // increase the timeout as there might be mutliple plugins per shell
-                                    secondsLeft = secs;
-                                    logln("    -> shell plugin: " << lastShellName);
-                                }
-                                break;
-                        }
-                    }
-                    if (nullptr != loadTimeout && loadTimeout->getMillisecondsLeft() <= 0) {
-                        logln("error: load timeout for '" << (lastShellName.isNotEmpty() ? lastShellName : name)
-                                                          << "', killing process");
-                        proc.kill();
-                        loadTimeout.reset();
-                    }
-                }
-            },
-            "OutputReader", true);
-
-        bool finished;
-        int numTimeouts = 0;
-        do {
-            secondsLeft = secondsPerPlugin;
-
-            while (secondsLeft > 0) {
-                proc.waitForProcessToFinish(1000);
-                secondsLeft--;
-            }
-
-            finished = !proc.isRunning();
 
-            if (!finished) {
-                getApp()->enableCancelScan(srvId, [&proc] { proc.kill(); });
+    auto result = worker.scan(id, name, fmt, secondRun, onShellPlugin);
 
-                numTimeouts++;
+    auto layoutErrFile = File(Defaults::getConfigFileName(Defaults::ScanLayoutError, {{"id", String(srvId)}}));
+    auto errFile = File(Defaults::getConfigFileName(Defaults::ScanError, {{"id", String(srvId)}}));
 
-                if (!secondRun && numTimeouts > 9) {
-                    // In case the timeout thread is not able to kill the process (I've seen some waves shells on
-                    // Windows hanging the process) our last resort is killing it from here.
-                    proc.kill();
-                    finished = true;
-                }
-            }
-
-            if (finished) {
-                auto layoutErrFile =
-                    File(Defaults::getConfigFileName(Defaults::ScanLayoutError, {{"id", String(srvId)}}));
-                auto errFile = File(Defaults::getConfigFileName(Defaults::ScanError, {{"id", String(srvId)}}));
-
-                if (!secondRun && layoutErrFile.existsAsFile()) {
-                    logln("error: scan for '" << name << "' failed while testing layouts, starting second run");
-                    layoutErrFile.deleteFile();
-                    scanNextPlugin(id, name, fmt, srvId, onShellPlugin, true);
-                } else {
-                    if (errFile.existsAsFile()) {
-                        logln("error: scan for '" << name << "' failed, as the plugin crashed the scanner probably");
-                        errFile.deleteFile();
-                        blacklist = true;
-                    }
-                }
-
-                getApp()->disableCancelScan(srvId);
-            }
-        } while (!finished);
-    } else {
-        logln("error: failed to start scan process");
+    if (!secondRun && layoutErrFile.existsAsFile()) {
+        logln("error: scan for '" << name << "' failed while testing layouts, starting second run");
+        layoutErrFile.deleteFile();
+        scanNextPlugin(id, name, fmt, worker, onShellPlugin, true);
+    } else if (errFile.existsAsFile()) {
+        logln("error: scan for '" << name << "' failed, as the plugin crashed the scanner probably");
+        errFile.deleteFile();
+        blacklist = true;
+    } else if (result == ScanWorker::CRASHED) {
+        logln("error: scan for '" << name << "' (" << id << ") failed, the scan worker crashed without an error file");
+    } else if (result == ScanWorker::NOT_STARTED) {
+        logln("error: scan for '" << name << "' failed, the scan worker could not be started");
     }
 
     if (blacklist) {
@@ -836,59 +1065,119 @@ void Server::scanNextPlugin(const String& id, const String& name, const String&
     }
 }
 
+void Server::rescanPlugins(const std::vector<String>& include, bool background) {
+    traceScope();
+    // workers and the UI read the list while the scan updates it, so scanning and persisting the results must not
+    // interleave with other updates
+    std::lock_guard<std::recursive_mutex> lock(m_pluginListUpdateMtx);
+    scanForPlugins(include, background);
+    saveConfig();
+    saveKnownPluginList();
+}
+
 void Server::scanForPlugins() {
     traceScope();
     scanForPlugins({});
 }
 
-void Server::scanForPlugins(const std::vector<String>& include) {
-    traceScope();
-    logln("scanning for plugins...");
+std::vector<std::unique_ptr<AudioPluginFormat>> Server::getPluginFormats() {
     std::vector<std::unique_ptr<AudioPluginFormat>> fmts;
-    size_t fmtAU = 0, fmtVST = 0, fmtVST3 = 0, fmtLV2 = 0;
-
 #if JUCE_MAC
     if (m_enableAU) {
-        fmtAU = fmts.size();
         fmts.push_back(std::make_unique<AudioUnitPluginFormat>());
     }
 #endif
     if (m_enableVST3) {
-        fmtVST3 = fmts.size();
         fmts.push_back(std::make_unique<VST3PluginFormat>());
     }
 #if JUCE_PLUGINHOST_VST
     if (m_enableVST2) {
-        fmtVST = fmts.size();
         fmts.push_back(std::make_unique<VSTPluginFormat>());
     }
 #endif
 #if JUCE_PLUGINHOST_LV2
     if (m_enableLV2) {
-        fmtLV2 = fmts.size();
         fmts.push_back(std::make_unique<LV2PluginFormat>());
     }
 #endif
+    return fmts;
+}
+
+FileSearchPath Server::getSearchPaths(AudioPluginFormat& fmt) {
+    FileSearchPath searchPaths;
+    if (fmt.getName() != "AudioUnit" && (!fmt.getName().startsWith("VST") || !m_vstNoStandardFolders)) {
+        searchPaths = fmt.getDefaultLocationsToSearch();
+    }
+    if (fmt.getName() == "VST3") {
+        for (auto& f : m_vst3Folders) {
+            searchPaths.addIfNotAlreadyThere(f);
+        }
+    } else if (fmt.getName() == "VST") {
+        for (auto& f : m_vst2Folders) {
+            searchPaths.addIfNotAlreadyThere(f);
+        }
+    } else if (fmt.getName() == "LV2") {
+        for (auto& f : m_lv2Folders) {
+            searchPaths.addIfNotAlreadyThere(f);
+        }
+    }
+    searchPaths.removeRedundantPaths();
+    searchPaths.removeNonExistentPaths();
+    return searchPaths;
+}
+
+void Server::scanForPlugins(const std::vector<String>& include, bool background) {
+    traceScope();
+    std::lock_guard<std::mutex> scanLock(m_scanMtx);
+    logln("scanning for plugins..." << (background ? " (background)" : ""));
+
+    auto fmts = getPluginFormats();
+    auto getFormat = [&fmts](const String& type) -> AudioPluginFormat* {
+        String name = type == "au"     ? "AudioUnit"
+                      : type == "vst3" ? "VST3"
+                      : type == "vst"  ? "VST"
+                      : type == "lv2"  ? "LV2"
+                                       : "";
+        for (auto& fmt : fmts) {
+            if (fmt->getName() == name) {
+                return fmt.get();
+            }
+        }
+        return nullptr;
+    };
 
     std::set<String> neverSeenList = m_pluginExclude;
     std::set<String> newBlacklistedPlugins;
 
-    loadKnownPluginList();
+    if (!background) {
+        loadKnownPluginList();
+    } else {
+        // a background scan works on the decoded list
+        getPluginList();
+    }
+
+    if (nullptr == m_fingerprints) {
+        m_fingerprints = std::make_unique<FingerprintIndex>(getId());
+        m_fingerprints->load();
+    }
 
     // check for scan results after a crash
     for (int i = Defaults::SCAN_ID_START; i < Defaults::SCAN_ID_START + Defaults::SCAN_WORKERS; i++) {
         processScanResults(i, newBlacklistedPlugins);
     }
+    updatePluginCatalog();
 
     struct ScanThread : FnThread {
-        int id;
+        std::unique_ptr<ScanWorker> worker;
     };
 
+    // the scan workers are long lived processes, so the number of workers can scale with the available cores
+    int numWorkers = jlimit(2, Defaults::SCAN_WORKERS, SystemStats::getNumCpus());
     int scanId = Defaults::SCAN_ID_START;
-    std::vector<ScanThread> scanThreads(Defaults::SCAN_WORKERS);
+    std::vector<ScanThread> scanThreads((size_t)numWorkers);
     StringArray inProgressNames;
     for (auto& t : scanThreads) {
-        t.id = scanId++;
+        t.worker = std::make_unique<ScanWorker>(scanId++);
         inProgressNames.add("");
     }
 
@@ -896,51 +1185,41 @@ void Server::scanForPlugins(const std::vector<String>& include) {
     std::atomic<float> progress{0};
 
     StringArray fileOrIds;
-    KnownPluginList pluginList;
+    std::vector<String> scannedFiles;
+    int numScanned = 0, numUnchanged = 0;
 
     for (auto& fmt : fmts) {
-        FileSearchPath searchPaths;
-        if (fmt->getName() != "AudioUnit" && (!fmt->getName().startsWith("VST") || !m_vstNoStandardFolders)) {
-            searchPaths = fmt->getDefaultLocationsToSearch();
-        }
-        if (fmt->getName() == "VST3") {
-            for (auto& f : m_vst3Folders) {
-                searchPaths.addIfNotAlreadyThere(f);
-            }
-        } else if (fmt->getName() == "VST") {
-            for (auto& f : m_vst2Folders) {
-                searchPaths.addIfNotAlreadyThere(f);
-            }
-        } else if (fmt->getName() == "LV2") {
-            for (auto& f : m_lv2Folders) {
-                searchPaths.addIfNotAlreadyThere(f);
-            }
-        }
-        searchPaths.removeRedundantPaths();
-        searchPaths.removeNonExistentPaths();
-        fileOrIds.addArray(fmt->searchPathsForPlugins(searchPaths, true));
+        fileOrIds.addArray(fmt->searchPathsForPlugins(getSearchPaths(*fmt), true));
     }
 
     for (int idx = 0; idx < fileOrIds.size(); idx++) {
         auto& fileOrId = fileOrIds.getReference(idx);
-        auto pluginDesc = m_pluginList.getTypeForFile(fileOrId);
+        auto pluginDesc = findPluginDescription(fileOrId);
         auto name = getPluginName(fileOrId, pluginDesc.get(), false);
         auto type = getPluginType(fileOrId, pluginDesc.get());
 
-        auto* fmt = type == "au"     ? fmts[fmtAU].get()
-                    : type == "vst3" ? fmts[fmtVST3].get()
-                    : type == "vst"  ? fmts[fmtVST].get()
-                    : type == "lv2"  ? fmts[fmtLV2].get()
-                                     : nullptr;
+        auto* fmt = getFormat(type);
 
         if (nullptr == fmt) {
             logln("error: can't detect plugin format for " << fileOrId);
             continue;
         }
 
+        // the fingerprint tells us if a file changed, for plugins without a fingerprint we ask the format
+        bool hasFingerprint = m_fingerprints->contains(fileOrId);
+        bool changed = hasFingerprint ? !m_fingerprints->isUnchanged(fileOrId)
+                                      : nullptr == pluginDesc || fmt->pluginNeedsRescanning(*pluginDesc);
+        bool blacklisted = m_pluginList.getBlacklistedFiles().contains(fileOrId);
+
+        if (blacklisted && hasFingerprint && changed) {
+            logln("  " << name << " has been updated, removing it from the blacklist");
+            m_pluginList.removeFromBlacklist(fileOrId);
+            m_pluginListVersion++;
+            blacklisted = false;
+        }
+
         bool excluded = shouldExclude(name, fileOrId, include);
-        if ((nullptr == pluginDesc || fmt->pluginNeedsRescanning(*pluginDesc)) &&
-            !m_pluginList.getBlacklistedFiles().contains(fileOrId) && newBlacklistedPlugins.count(fileOrId) == 0 &&
+        if ((nullptr == pluginDesc || changed) && !blacklisted && newBlacklistedPlugins.count(fileOrId) == 0 &&
             !excluded) {
             ScanThread* scanThread = nullptr;
             String* inProgressName = nullptr;
@@ -976,15 +1255,23 @@ void Server::scanForPlugins(const std::vector<String>& include) {
 
             updateSplash(splashName);
 
-            scanThread->fn = [this, fileOrId, pluginName = name, fmtName = fmt->getName(), srvId = scanThread->id,
-                              updateSplash] {
-                scanNextPlugin(fileOrId, pluginName, fmtName, srvId, [&](const String& n) { updateSplash(n); });
+            scanThread->fn = [this, fileOrId, pluginName = name, fmtName = fmt->getName(),
+                              worker = scanThread->worker.get(), updateSplash] {
+                scanNextPlugin(fileOrId, pluginName, fmtName, *worker, [&](const String& n) { updateSplash(n); });
                 updateSplash("");
             };
 
             scanThread->startThread();
+            scannedFiles.push_back(fileOrId);
+            numScanned++;
         } else {
-            logln("  (skipping: " << name << (excluded ? " excluded" : "") << ")");
+            if (!excluded && !hasFingerprint) {
+                scannedFiles.push_back(fileOrId);
+            }
+            if (!changed) {
+                numUnchanged++;
+            }
+            traceln("  (skipping: " << name << (excluded ? " excluded" : "") << ")");
         }
         neverSeenList.erase(fileOrId);
     }
@@ -993,9 +1280,54 @@ void Server::scanForPlugins(const std::vector<String>& include) {
         while (t.isThreadRunning()) {
             sleep(50);
         }
-        processScanResults(t.id, newBlacklistedPlugins);
+        t.worker.reset();
+    }
+    for (int i = Defaults::SCAN_ID_START; i < Defaults::SCAN_ID_START + numWorkers; i++) {
+        processScanResults(i, newBlacklistedPlugins);
+    }
+
+    logln("scanned " << numScanned << " plugin files, skipped " << numUnchanged << " unchanged ones");
+
+    for (auto& f : scannedFiles) {
+        m_fingerprints->update(f);
+    }
+
+    if (include.empty()) {
+        // prune plugins that have been removed
+        std::set<String> found;
+        for (auto& f : fileOrIds) {
+            found.insert(f);
+        }
+        auto isRemoved = [&](const String& fileOrId) {
+            if (found.count(fileOrId) > 0) {
+                return false;
+            }
+            // don't prune plugins from unmounted drives
+            return !File::isAbsolutePath(fileOrId) || File(fileOrId).getParentDirectory().isDirectory();
+        };
+        for (auto& desc : m_pluginList.getTypes()) {
+            bool formatScanned = false;
+            for (auto& fmt : fmts) {
+                formatScanned = formatScanned || fmt->getName() == desc.pluginFormatName;
+            }
+            if (formatScanned && isRemoved(desc.fileOrIdentifier)) {
+                logln("  removing " << desc.name << " (" << desc.fileOrIdentifier << "), as it has been uninstalled");
+                m_pluginList.removeType(desc);
+                m_pluginListVersion++;
+                m_jpluginLayouts.erase(Processor::createPluginID(desc).toStdString());
+            }
+        }
+        for (auto& f : m_fingerprints->getFiles()) {
+            if (isRemoved(f)) {
+                m_fingerprints->remove(f);
+                m_pluginList.removeFromBlacklist(f);
+                m_pluginListVersion++;
+            }
+        }
     }
 
+    m_fingerprints->save();
+
     m_pluginList.sort(KnownPluginList::sortAlphabetically, true);
 
     getApp()->setSplashInfo("Scanning finished.");
@@ -1022,19 +1354,23 @@ void Server::scanForPlugins(const std::vector<String>& include) {
         }
         msg << newLine << newLine;
         msg << "You can force a rescan via Plugin Manager.";
-        AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Failed Plugins", msg, "OK");
+        if (background) {
+            logln(msg);
+        } else {
+            AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Failed Plugins", msg, "OK");
+        }
     }
 }
 
 void Server::processScanResults(int id, std::set<String>& newBlacklistedPlugins) {
-    File cacheFile(Defaults::getConfigFileName(Defaults::ConfigPluginCache, {{"id", String(id)}}));
-    File layoutsFile(Defaults::getConfigFileName(Defaults::PluginLayouts, {{"id", String(id)}}));
+    File catalogFile(Defaults::getConfigFileName(Defaults::ConfigPluginCatalog, {{"id", String(id)}}));
     File deadmanFile(Defaults::getConfigFileName(Defaults::ConfigDeadMan, {{"id", String(id)}}));
 
-    if (cacheFile.existsAsFile()) {
+    if (catalogFile.existsAsFile()) {
         KnownPluginList plist;
         json playouts;
         loadKnownPluginList(plist, playouts, id);
+        m_pluginListVersion++;
 
         for (auto& p : plist.getBlacklistedFiles()) {
             if (!m_pluginList.getBlacklistedFiles().contains(p)) {
@@ -1046,14 +1382,16 @@ void Server::processScanResults(int id, std::set<String>& newBlacklistedPlugins)
 
         for (auto p : plist.getTypes()) {
             m_pluginList.addType(p);
+            std::lock_guard<std::mutex> lock(m_pluginLayoutsMtx);
+            m_pluginLayouts.erase(Processor::createPluginID(p));
         }
 
         for (auto it = playouts.begin(); it != playouts.end(); it++) {
             m_jpluginLayouts[it.key()] = it.value();
         }
 
-        cacheFile.deleteFile();
-        layoutsFile.deleteFile();
+        catalogFile.deleteFile();
+        File(Defaults::getConfigFileName(Defaults::PluginLayoutsCache, {{"id", String(id)}})).deleteFile();
     }
 
     if (deadmanFile.existsAsFile()) {
@@ -1134,12 +1472,17 @@ void Server::runServer() {
 
     if ((m_scanForPlugins || getOpt("ScanForPlugins", false)) && !getOpt("NoScanForPlugins", false)) {
         scanForPlugins();
+    } else if (openPluginCatalog()) {
+        // Plugin lookups go directly to the mapped catalog, the list gets decoded when it is needed first
+        m_pluginListDeferred = true;
     } else {
         loadKnownPluginList();
         m_pluginList.sort(KnownPluginList::sortAlphabetically, true);
     }
     saveConfig();
-    saveKnownPluginList();
+    if (!m_pluginListDeferred) {
+        saveKnownPluginList();
+    }
 
     getApp()->setSplashInfo("Loading plugin layouts...");
     if (!parsePluginLayouts()) {
@@ -1150,11 +1493,8 @@ void Server::runServer() {
         Sentry::initialize();
     }
 
-    for (auto& type : m_pluginList.getTypes()) {
-        if ((type.pluginFormatName == "AudioUnit" && !m_enableAU) ||
-            (type.pluginFormatName == "VST" && !m_enableVST2) || (type.pluginFormatName == "VST3" && !m_enableVST3)) {
-            m_pluginList.removeType(type);
-        }
+    if (!m_pluginListDeferred && removeDisabledFormats()) {
+        updatePluginCatalog();
     }
 
     getApp()->hideSplashWindow(1000);
@@ -1166,6 +1506,8 @@ void Server::runServer() {
     setNonBlocking(m_masterSocket.getRawSocketHandle());
 
     ServiceResponder::initialize(m_port + getId(), getId(), m_name, m_uuid, getScreenLocalMode());
+    // chain hops can target other servers on the network
+    ServiceReceiver::initialize((uint64)getTagId());
 
     if (m_name.isEmpty()) {
         m_name = ServiceResponder::getHostName();
@@ -1187,6 +1529,43 @@ void Server::runServer() {
 
     m_sandboxDeleter = std::make_unique<SandboxDeleter>();
 
+    // Warm instances can only be handed over within the same process, chain sandboxes run their own pool
+    if (m_pluginPoolEnabled && m_sandboxMode == SANDBOX_NONE) {
+        m_pluginPool = std::make_unique<PluginPool>(getId(), (size_t)jmax(0, m_pluginPoolMemoryMB));
+    }
+
+    // Resource limits for sandboxes, this has to be set up before any sandbox process gets started
+    if (m_sandboxCGroupsEnabled && m_sandboxMode != SANDBOX_NONE) {
+        m_sandboxCGroups = std::make_unique<SandboxCGroups>(m_sandboxCGroupScope, m_sandboxCGroupCPUWeight,
+                                                            m_sandboxCGroupMemoryMaxMB, m_sandboxCGroupCPUs);
+    }
+
+    // Idle sandboxes, so that clients and plugins don't have to wait for a process to start up
+    if (m_sandboxPoolEnabled && m_sandboxPoolMaxIdle > 0 && m_sandboxMode != SANDBOX_NONE) {
+        m_sandboxPool = std::make_unique<SandboxPool>(*this, m_sandboxMode == SANDBOX_PLUGIN, m_sandboxPoolMaxIdle);
+    }
+
+    if (m_sandboxMode == SANDBOX_PLUGIN) {
+        m_sandboxGroups = std::make_unique<SandboxGroups>(*this, m_sandboxGrouping, m_sandboxGroupSize,
+                                                          m_sandboxGroupAllowlist);
+    }
+
+    if (m_watchPluginFolders) {
+        m_pluginWatcher = std::make_unique<PluginWatcher>(
+            [this] {
+                Array<File> folders;
+                for (auto& fmt : getPluginFormats()) {
+                    auto paths = getSearchPaths(*fmt);
+                    for (int i = 0; i < paths.getNumPaths(); i++) {
+                        folders.add(paths[i]);
+                    }
+                }
+                return folders;
+            },
+            [this] { rescanPlugins({}, true); });
+        m_pluginWatcher->startThread();
+    }
+
     checkPort();
 
     // some time could have passed by until we reach that point, lets check if the user decided to quit
@@ -1262,6 +1641,9 @@ void Server::runServer() {
                         logln("  doublePrecision          = " << static_cast<int>(cfg.doublePrecision));
                         logln("  flags.NoPluginListFilter  = "
                               << (int)cfg.isFlag(HandshakeRequest::NO_PLUGINLIST_FILTER));
+                        logln("  flags.OfflineRender       = " << (int)cfg.isFlag(HandshakeRequest::OFFLINE_RENDER));
+                        logln("  flags.ResumeSession       = " << (int)cfg.isFlag(HandshakeRequest::RESUME_SESSION));
+                        logln("  flags.ChainHop            = " << (int)cfg.isFlag(HandshakeRequest::CHAIN_HOP));
                     } else {
                         logln("client " << clnt->getHostName() << " with old protocol version");
                         handshakeOk = false;
@@ -1270,6 +1652,11 @@ void Server::runServer() {
                     handshakeOk = false;
                 }
 
+                uint64 sessionToken = 0;
+                if (handshakeOk && cfg.isFlag(HandshakeRequest::RESUME_SESSION)) {
+                    handshakeOk = clnt->read(&sessionToken, sizeof(sessionToken), true) == sizeof(sessionToken);
+                }
+
                 if (!handshakeOk) {
                     clnt->close();
                     delete clnt;
@@ -1284,7 +1671,47 @@ void Server::runServer() {
                         num++;
                         id = String::toHexString(cfg.clientId) + "-" + String(num);
                     }
-                    auto sandbox = std::make_shared<SandboxMaster>(*this, id);
+                    std::shared_ptr<SandboxMaster> sandbox;
+                    if (nullptr != m_sandboxPool) {
+                        sandbox = m_sandboxPool->takeChainSandbox(isLocal);
+                    }
+                    auto jcfg = cfg.toJson();
+                    jcfg["host"] = clnt->getHostName().toStdString();
+                    // the discovery of the sandbox starts from scratch, so it gets the servers known by now for
+                    // chain hops
+                    json jservers = json::array();
+                    for (auto& srv : ServiceReceiver::getServers()) {
+                        jservers.push_back({{"host", srv.getHost().toStdString()}, {"id", srv.getID()}});
+                    }
+                    jcfg["chainHopServers"] = jservers;
+                    String cgroupKey;
+                    if (nullptr != m_sandboxCGroups) {
+                        cgroupKey = m_sandboxCGroups->getKey(cfg.clientId, id);
+                        jcfg["cgroup"] = m_sandboxCGroups->acquire(cgroupKey).toStdString();
+                    }
+                    if (nullptr != sandbox) {
+                        // The idle sandbox is up and listening already, it just needs the client config
+                        logln("assigning idle sandbox " << sandbox->getId() << " as " << id);
+                        sandbox->assign(id, cgroupKey);
+                        if (sandbox->send(SandboxMessage(SandboxMessage::CONFIG, jcfg), nullptr, true)) {
+                            m_sandboxes[id] = sandbox;
+                            if (!sendHandshakeResponse(clnt, true, sandbox->port)) {
+                                logln("failed to send handshake response for sandbox " << id);
+                                std::shared_ptr<SandboxMaster> deleter;
+                                if (m_sandboxes.getAndRemove(id, deleter)) {
+                                    releaseSandbox(std::move(deleter));
+                                }
+                            }
+                        } else {
+                            logln("failed to send message to sandbox");
+                            releaseSandbox(std::move(sandbox));
+                        }
+                        clnt->close();
+                        delete clnt;
+                        continue;
+                    }
+                    sandbox = std::make_shared<SandboxMaster>(*this, id);
+                    sandbox->assign(id, cgroupKey);
                     logln("creating sandbox " << id);
                     if (sandbox->launchWorkerProcess(
                             File::getSpecialLocation(File::currentExecutableFile), Defaults::SANDBOX_CMD_PREFIX,
@@ -1295,20 +1722,23 @@ void Server::runServer() {
                                 logln("failed to send handshake response for sandbox " << id);
                                 std::shared_ptr<SandboxMaster> deleter;
                                 if (m_sandboxes.getAndRemove(id, deleter)) {
-                                    deleter->terminate();
-                                    m_sandboxDeleter->add(std::move(deleter));
+                                    releaseSandbox(std::move(deleter));
                                 }
                             }
                             clnt->close();
                             delete clnt;
                         };
-                        if (sandbox->send(SandboxMessage(SandboxMessage::CONFIG, cfg.toJson()), nullptr, true)) {
+                        if (sandbox->send(SandboxMessage(SandboxMessage::CONFIG, jcfg), nullptr, true)) {
                             m_sandboxes[id] = std::move(sandbox);
                         } else {
                             logln("failed to send message to sandbox");
+                            releaseSandbox(std::move(sandbox));
                         }
                     } else {
                         logln("failed to launch sandbox");
+                        if (nullptr != m_sandboxCGroups) {
+                            m_sandboxCGroups->release(cgroupKey);
+                        }
                     }
                 } else {
                     auto workerMasterSocket = std::make_shared<StreamingSocket>();
@@ -1327,19 +1757,59 @@ void Server::runServer() {
                         continue;
                     }
 
+                    // Hand the connection to the worker of a disconnected session, that still has the chain loaded
+                    if (sessionToken != 0) {
+                        std::shared_ptr<Worker> worker;
+                        for (auto& w : m_workers) {
+                            if (w->claimSession(sessionToken, cfg)) {
+                                worker = w;
+                                break;
+                            }
+                        }
+                        if (nullptr != worker) {
+                            logln("resuming session");
+                            // the old connection has to go down first, don't block other clients meanwhile
+                            m_pendingResumes++;
+                            std::thread([this, worker, workerMasterSocket, clnt, workerPort, sessionToken] {
+                                traceScope();
+                                if (worker->resume(workerMasterSocket)) {
+                                    if (!sendHandshakeResponse(clnt, false, workerPort, sessionToken, true)) {
+                                        logln("failed to send handshake response");
+                                    }
+                                } else {
+                                    // the client retries and gets a new worker, once the old one is gone
+                                    logln("session can't be resumed, dropping the connection");
+                                }
+                                clnt->close();
+                                delete clnt;
+                                m_pendingResumes--;
+                            }).detach();
+                            continue;
+                        }
+                        logln("session can't be resumed");
+                    }
+
                     // Create a new worker thread for a new client
                     logln("creating worker");
-                    if (!sendHandshakeResponse(clnt, false, workerPort)) {
+                    // an upstream server reloads its plugins itself, when a chain hop gets disconnected
+                    sessionToken =
+                        m_sessionGraceSecs > 0 && !cfg.isFlag(HandshakeRequest::CHAIN_HOP) ? newSessionToken() : 0;
+                    if (!sendHandshakeResponse(clnt, false, workerPort, sessionToken)) {
                         logln("failed to send handshake response");
                         clnt->close();
                         delete clnt;
                         continue;
                     }
 
+                    if (nullptr != m_pluginPool) {
+                        m_pluginPool->onClientConnected(cfg, clnt->getHostName());
+                    }
+
                     clnt->close();
                     delete clnt;
 
                     auto w = std::make_shared<Worker>(workerMasterSocket, cfg);
+                    w->setSession(sessionToken, m_sessionGraceSecs);
                     w->startThread();
                     m_workers.add(w);
                     // lazy cleanup
@@ -1360,6 +1830,9 @@ void Server::runServer() {
 
         shutdownWorkers();
 
+        m_pluginWatcher.reset();
+        m_pluginPool.reset();
+
         if (m_sandboxes.size() > 0) {
             for (auto pair : m_sandboxes) {
                 pair.second->terminate();
@@ -1385,8 +1858,12 @@ void Server::runServer() {
         });
     }
 
+    m_sandboxGroups.reset();
+    m_sandboxPool.reset();
+
     logln("waiting for sandboxes to terminate");
     m_sandboxDeleter->stopThread(-1);
+    m_sandboxCGroups.reset();
 }
 
 void Server::runSandboxChain() {
@@ -1405,6 +1882,9 @@ void Server::runSandboxChain() {
         return;
     }
 
+    // the worker runs here, so chain hops to servers, that get discovered later, have to be checked here as well
+    ServiceReceiver::initialize((uint64)getTagId());
+
     auto workerMasterSocket = std::make_shared<StreamingSocket>();
 
 #ifndef JUCE_WINDOWS
@@ -1433,9 +1913,14 @@ void Server::runSandboxChain() {
         return;
     }
 
-    loadKnownPluginList();
+    // Plugin lookups go directly to the mapped catalog, the list gets decoded when a client asks for it
+    if (openPluginCatalog()) {
+        m_pluginListDeferred = true;
+    } else {
+        loadKnownPluginList();
+        m_pluginList.sort(KnownPluginList::sortAlphabetically, true);
+    }
     parsePluginLayouts();
-    m_pluginList.sort(KnownPluginList::sortAlphabetically, true);
 
     logln("sandbox (chain isolation) started: PORT=" << m_port << ", NAME=" << m_name);
 
@@ -1445,6 +1930,12 @@ void Server::runSandboxChain() {
     }
 
     if (!threadShouldExit()) {
+        if (m_pluginPoolEnabled) {
+            // the sandbox serves a single client, so start warming up its plugins right away
+            m_pluginPool = std::make_unique<PluginPool>(getId(), (size_t)jmax(0, m_pluginPoolMemoryMB));
+            m_pluginPool->onClientConnected(m_sandboxConfig, m_sandboxClientHost);
+        }
+
         logln("creating worker");
         auto w = std::make_shared<Worker>(workerMasterSocket, m_sandboxConfig);
         w->startThread();
@@ -1454,6 +1945,8 @@ void Server::runSandboxChain() {
             auto audioTime = Metrics::getStatistic<TimeStatistic>("audio");
             auto bytesOutMeter = Metrics::getStatistic<Meter>("NetBytesOut");
             auto bytesInMeter = Metrics::getStatistic<Meter>("NetBytesIn");
+            auto deadlineMisses = Metrics::getStatistic<Meter>("DeadlineMisses");
+            auto wakeupJitter = LowLatencyWait::getJitterStatistic();
 
             while (!w->waitForThreadToExit(1000) && !threadShouldExit()) {
                 json jmetrics;
@@ -1461,11 +1954,17 @@ void Server::runSandboxChain() {
                 jmetrics["NetBytesOut"] = bytesOutMeter->rate_1min();
                 jmetrics["NetBytesIn"] = bytesInMeter->rate_1min();
                 jmetrics["RPS"] = audioTime->getMeter().rate_1min();
+                jmetrics["DeadlineMisses"] = deadlineMisses->rate_1min();
                 json jtimes = json::array();
                 for (auto& hist : audioTime->get1minValues()) {
                     jtimes.push_back(hist.toJson());
                 }
                 jmetrics["audio"] = jtimes;
+                json jjitter = json::array();
+                for (auto& hist : wakeupJitter->get1minValues()) {
+                    jjitter.push_back(hist.toJson());
+                }
+                jmetrics["WakeupJitter"] = jjitter;
                 m_sandboxController->send(SandboxMessage(SandboxMessage::METRICS, jmetrics), nullptr, true);
             }
 
@@ -1473,6 +1972,8 @@ void Server::runSandboxChain() {
         } else {
             logln("failed to start worker thread");
         }
+
+        m_pluginPool.reset();
     }
 
     logln("terminating sandbox connection to master");
@@ -1498,7 +1999,9 @@ void Server::runSandboxPlugin() {
     setsockopt(workerMasterSocket->getRawSocketHandle(), SOL_SOCKET, SO_NOSIGPIPE, nullptr, 0);
 #endif
 
-    if (!jsonHasValue(m_opts, "config")) {
+    bool isHost = getOpt("host", false);
+
+    if (!isHost && !jsonHasValue(m_opts, "config")) {
         logln("missing parameter config");
         getApp()->prepareShutdown(App::EXIT_SANDBOX_PARAM_ERROR);
         return;
@@ -1512,47 +2015,41 @@ void Server::runSandboxPlugin() {
         return;
     }
 
-    bool hasUnixDomainSockets = Defaults::unixDomainSocketsSupported();
-    File socketPath;
+    if (!createSandboxPluginListener(workerMasterSocket, m_port)) {
+        logln("failed to create worker listener");
+        getApp()->prepareShutdown(App::EXIT_SANDBOX_BIND_ERROR);
+        return;
+    }
 
-    if (hasUnixDomainSockets) {
-        socketPath = Defaults::getSocketPath(Defaults::SANDBOX_PLUGIN_SOCK, {{"n", String(m_port)}}, true);
-        if (!workerMasterSocket->createListener(socketPath)) {
-            logln("failed to create worker listener");
-            getApp()->prepareShutdown(App::EXIT_SANDBOX_BIND_ERROR);
-            return;
-        }
-    } else {
-        if (!workerMasterSocket->createListener6(m_port, m_host)) {
-            logln("failed to create worker listener");
-            getApp()->prepareShutdown(App::EXIT_SANDBOX_BIND_ERROR);
-            return;
-        }
+    // The master has written the catalog already and a plugin sandbox never sends a plugin list, so there is no need
+    // to build the list and check every plugin file, lookups go directly to the mapped catalog.
+    if (!m_leanStartup || !openPluginCatalog()) {
+        loadKnownPluginList();
     }
 
-    loadKnownPluginList();
-    parsePluginLayouts(getOpt("pluginId", String()));
-    m_pluginList.sort(KnownPluginList::sortAlphabetically, true);
+    if (isHost) {
+        runSandboxPluginHost(workerMasterSocket);
+    } else {
+        parsePluginLayouts();
 
-    logln("sandbox (plugin isolation) started: "
-          << (hasUnixDomainSockets ? "PATH=" + socketPath.getFullPathName() : "PORT=" + String(m_port))
-          << ", NAME=" << m_name);
+        logln("sandbox (plugin isolation) started: PORT=" << m_port << ", NAME=" << m_name);
 
-    m_sandboxConfig.fromJson(m_opts["config"]);
+        m_sandboxConfig.fromJson(m_opts["config"]);
 
-    logln("creating worker");
-    auto w = std::make_shared<Worker>(workerMasterSocket, m_sandboxConfig, m_sandboxModeRuntime);
-    w->startThread();
-    if (w->isThreadRunning()) {
-        m_workers.add(w);
+        logln("creating worker");
+        auto w = std::make_shared<Worker>(workerMasterSocket, m_sandboxConfig, m_sandboxModeRuntime);
+        w->startThread();
+        if (w->isThreadRunning()) {
+            m_workers.add(w);
 
-        while (w->isThreadRunning() && !threadShouldExit()) {
-            sleepExitAware(100);
-        }
+            while (w->isThreadRunning() && !threadShouldExit()) {
+                sleepExitAware(100);
+            }
 
-        shutdownWorkers();
-    } else {
-        logln("failed to start worker thread");
+            shutdownWorkers();
+        } else {
+            logln("failed to start worker thread");
+        }
     }
 
     logln("run finished");
@@ -1562,19 +2059,175 @@ void Server::runSandboxPlugin() {
     }
 }
 
-bool Server::sendHandshakeResponse(StreamingSocket* sock, bool sandboxEnabled, int port) {
+void Server::runSandboxPluginHost(std::shared_ptr<StreamingSocket> ctrlSocket) {
+    traceScope();
+
+    logln("sandbox (plugin isolation) host started: PORT=" << m_port << ", NAME=" << m_name);
+
+    bool layoutsReady = false, hadWorkers = false;
+    auto lastActive = Time::getMillisecondCounter();
+
+    while (!threadShouldExit()) {
+        std::unique_ptr<StreamingSocket> clnt(accept(ctrlSocket.get(), 1000, [this] { return threadShouldExit(); }));
+        if (nullptr != clnt) {
+            String pluginId;
+            HandshakeRequest cfg;
+            String cgroup;
+            int workerPort = 0;
+            if (SandboxHost::readAssignment(clnt.get(), pluginId, cfg, workerPort, cgroup)) {
+                logln("plugin " << pluginId << " assigned, PORT=" << workerPort);
+
+                if (cgroup.isNotEmpty()) {
+                    SandboxCGroups::join(cgroup);
+                }
+
+                if (!layoutsReady) {
+                    parsePluginLayouts();
+                    layoutsReady = true;
+                }
+
+                auto workerMasterSocket = std::make_shared<StreamingSocket>();
+
+#ifndef JUCE_WINDOWS
+                setsockopt(workerMasterSocket->getRawSocketHandle(), SOL_SOCKET, SO_NOSIGPIPE, nullptr, 0);
+#endif
+
+                if (createSandboxPluginListener(workerMasterSocket, workerPort)) {
+                    auto w = std::make_shared<Worker>(workerMasterSocket, cfg, m_sandboxModeRuntime);
+                    w->startThread();
+                    if (w->isThreadRunning()) {
+                        m_workers.add(w);
+                        hadWorkers = true;
+                    } else {
+                        logln("failed to start worker thread");
+                    }
+                } else {
+                    logln("failed to create worker listener");
+                }
+            }
+        }
+
+        for (int i = 0; i < m_workers.size();) {
+            if (!m_workers.getReference(i)->isThreadRunning()) {
+                m_workers.remove(i);
+            } else {
+                i++;
+            }
+        }
+
+        if (m_workers.size() > 0) {
+            lastActive = Time::getMillisecondCounter();
+        } else if (hadWorkers) {
+            logln("all plugins have been removed");
+            break;
+        } else if (Time::getMillisecondCounter() - lastActive > 30 * 60 * 1000) {
+            // nobody needed us for a while, the master starts a new one if needed
+            logln("no plugin assigned");
+            break;
+        }
+    }
+
+    shutdownWorkers();
+}
+
+bool Server::createSandboxPluginListener(std::shared_ptr<StreamingSocket> sock, int port) {
+    traceScope();
+    if (Defaults::unixDomainSocketsSupported()) {
+        auto socketPath = Defaults::getSocketPath(Defaults::SANDBOX_PLUGIN_SOCK, {{"n", String(port)}}, true);
+        return sock->createListener(socketPath);
+    }
+    return sock->createListener6(port, m_host);
+}
+
+bool Server::sendHandshakeResponse(StreamingSocket* sock, bool sandboxEnabled, int port, uint64 sessionToken,
+                                   bool resumed) {
     traceScope();
     HandshakeResponse resp = {AG_PROTOCOL_VERSION, 0, 0, 0, 0, 0, 0, 0, 0};
+    resp.setFlag(HandshakeResponse::ASYNC_ADD_PLUGIN);
+    resp.setFlag(HandshakeResponse::INCREMENTAL_SETTINGS);
+    resp.setFlag(HandshakeResponse::CHUNKED_SETTINGS);
+    resp.setFlag(HandshakeResponse::BATCH_RESTORE);
+    resp.setFlag(HandshakeResponse::OFFLINE_RENDER);
+    resp.setFlag(HandshakeResponse::RECONFIGURE);
     if (sandboxEnabled) {
         resp.setFlag(HandshakeResponse::SANDBOX_ENABLED);
+        logln("aux buses are not available, the chains run isolated in sandboxes");
+    } else {
+        // buses are shared within a process, chains isolated in sandboxes can't reach each other
+        resp.setFlag(HandshakeResponse::AUX_BUSES);
     }
     if (m_screenLocalMode) {
         resp.setFlag(HandshakeResponse::LOCAL_MODE);
     }
+    if (resumed) {
+        resp.setFlag(HandshakeResponse::SESSION_RESUMED);
+    }
+    resp.setSessionToken(sessionToken);
     resp.port = port;
     return send(sock, reinterpret_cast<const char*>(&resp), sizeof(resp));
 }
 
+bool Server::isChainHopAllowed(const String& host, String& err) {
+    auto discovered = ServiceReceiver::getServers();
+    {
+        std::lock_guard<std::mutex> lock(m_sandboxChainHopMtx);
+        discovered.addArray(m_sandboxChainHopServers);
+    }
+    return isChainHopAllowed(ServerInfo(host), getId(), discovered, m_chainHopAllowlist, err);
+}
+
+bool Server::isChainHopAllowed(const ServerInfo& target, int selfId, const Array<ServerInfo>& discovered,
+                               const StringArray& allowlist, String& err) {
+    if (target.getHost().isEmpty()) {
+        err = "invalid chain hop target";
+        return false;
+    }
+    if (target.getID() == selfId && isLocalHost(target.getHost())) {
+        err = "a chain hop can't target the server itself";
+        return false;
+    }
+    for (auto& srv : discovered) {
+        if (srv.getHost().equalsIgnoreCase(target.getHost()) && srv.getID() == target.getID()) {
+            return true;
+        }
+    }
+    for (auto& entry : allowlist) {
+        ServerInfo allowed(entry);
+        if (allowed.getHost().equalsIgnoreCase(target.getHost()) && allowed.getID() == target.getID()) {
+            return true;
+        }
+    }
+    err = "chain hop target " + target.getHostAndID() + " has neither been discovered nor been allowed";
+    return false;
+}
+
+bool Server::isLocalHost(const String& host) {
+    if (host.equalsIgnoreCase("localhost") || host.equalsIgnoreCase(SystemStats::getComputerName())) {
+        return true;
+    }
+    IPAddress addr(host);
+    if (addr.isNull()) {
+        return false;
+    }
+    if (addr == IPAddress::local(addr.isIPv6) || (!addr.isIPv6 && addr.address[0] == 127)) {
+        return true;
+    }
+    for (auto& local : IPAddress::getAllAddresses(addr.isIPv6)) {
+        if (local == addr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64 Server::newSessionToken() {
+    uint64 token = 0;
+    while (token == 0) {
+        token = (uint64)Random::getSystemRandom().nextInt64();
+    }
+    return token;
+}
+
 bool Server::createWorkerListener(std::shared_ptr<StreamingSocket> sock, bool isLocal, int& workerPort) {
     traceScope();
     int workerPortMax = getOpt("workerPortMax", Defaults::CLIENT_PORT + 1000);
@@ -1600,14 +2253,15 @@ bool Server::createWorkerListener(std::shared_ptr<StreamingSocket> sock, bool is
 
 void Server::handleMessageFromSandbox(SandboxMaster& sandbox, const SandboxMessage& msg) {
     traceScope();
+    auto id = sandbox.getId();
     if (msg.type == SandboxMessage::SHOW_EDITOR) {
-        if (!m_screenLocalMode && m_sandboxHasScreen.isNotEmpty() && m_sandboxHasScreen != sandbox.id) {
+        if (!m_screenLocalMode && m_sandboxHasScreen.isNotEmpty() && m_sandboxHasScreen != id) {
             if (auto sb = m_sandboxes[m_sandboxHasScreen]) {
                 sb->send(SandboxMessage(SandboxMessage::HIDE_EDITOR, {}));
             }
         }
-        m_sandboxHasScreen = sandbox.id;
-    } else if (msg.type == SandboxMessage::HIDE_EDITOR && m_sandboxHasScreen == sandbox.id) {
+        m_sandboxHasScreen = id;
+    } else if (msg.type == SandboxMessage::HIDE_EDITOR && m_sandboxHasScreen == id) {
         m_sandboxHasScreen.clear();
     } else if (msg.type == SandboxMessage::METRICS) {
         std::vector<TimeStatistic::Histogram> hists;
@@ -1618,30 +2272,54 @@ void Server::handleMessageFromSandbox(SandboxMaster& sandbox, const SandboxMessa
             }
         }
 
-        updateSandboxNetworkStats(sandbox.id, jsonGetValue(msg.data, "LoadedCount", (uint32)0),
+        updateSandboxNetworkStats(id, jsonGetValue(msg.data, "LoadedCount", (uint32)0),
                                   jsonGetValue(msg.data, "NetBytesIn", 0.0), jsonGetValue(msg.data, "NetBytesOut", 0.0),
-                                  jsonGetValue(msg.data, "RPS", 0.0), hists);
+                                  jsonGetValue(msg.data, "RPS", 0.0), jsonGetValue(msg.data, "DeadlineMisses", 0.0),
+                                  hists);
+
+        std::vector<TimeStatistic::Histogram> jitterHists;
+        if (msg.data.find("WakeupJitter") != msg.data.end()) {
+            for (auto& hist : msg.data["WakeupJitter"]) {
+                jitterHists.emplace_back(hist);
+            }
+        }
+        LowLatencyWait::getJitterStatistic()->updateExt1minValues(id, jitterHists);
     } else {
-        logln("received unhandled message from sandbox " << sandbox.id);
+        logln("received unhandled message from sandbox " << id);
     }
 }
 
 void Server::handleDisconnectFromSandbox(SandboxMaster& sandbox) {
     traceScope();
 
+    if (nullptr != m_sandboxPool && m_sandboxPool->remove(sandbox)) {
+        return;
+    }
+
+    auto id = sandbox.getId();
     std::shared_ptr<SandboxMaster> deleter;
-    if (m_sandboxes.getAndRemove(sandbox.id, deleter)) {
-        logln("disconnected from sandbox " << sandbox.id);
-        m_sandboxLoadedCount.remove(sandbox.id);
-        Metrics::getStatistic<TimeStatistic>("audio")->removeExt1minValues(sandbox.id);
-        Metrics::getStatistic<TimeStatistic>("audio")->getMeter().removeExtRate1min(sandbox.id);
-        Metrics::getStatistic<Meter>("NetBytesOut")->removeExtRate1min(sandbox.id);
-        Metrics::getStatistic<Meter>("NetBytesIn")->removeExtRate1min(sandbox.id);
-        deleter->terminate();
-        m_sandboxDeleter->add(std::move(deleter));
+    if (m_sandboxes.getAndRemove(id, deleter)) {
+        logln("disconnected from sandbox " << id);
+        m_sandboxLoadedCount.remove(id);
+        Metrics::getStatistic<TimeStatistic>("audio")->removeExt1minValues(id);
+        Metrics::getStatistic<TimeStatistic>("audio")->getMeter().removeExtRate1min(id);
+        Metrics::getStatistic<Meter>("NetBytesOut")->removeExtRate1min(id);
+        Metrics::getStatistic<Meter>("NetBytesIn")->removeExtRate1min(id);
+        Metrics::getStatistic<Meter>("DeadlineMisses")->removeExtRate1min(id);
+        LowLatencyWait::getJitterStatistic()->removeExt1minValues(id);
+        releaseSandbox(std::move(deleter));
     }
 }
 
+void Server::releaseSandbox(std::shared_ptr<SandboxMaster> sandbox) {
+    traceScope();
+    if (nullptr != m_sandboxCGroups) {
+        m_sandboxCGroups->release(sandbox->getCGroup());
+    }
+    sandbox->terminate();
+    m_sandboxDeleter->add(std::move(sandbox));
+}
+
 void Server::handleConnectedToMaster() {
     logln("connected to sandbox master");
     m_sandboxConnectedToMaster = true;
@@ -1661,6 +2339,16 @@ void Server::handleMessageFromMaster(const SandboxMessage& msg) {
     if (msg.type == SandboxMessage::CONFIG) {
         logln("config message from sandbox master: " << msg.data.dump());
         m_sandboxConfig.fromJson(msg.data);
+        m_sandboxClientHost = jsonGetValue(msg.data, "host", String());
+        if (jsonHasValue(msg.data, "chainHopServers")) {
+            std::lock_guard<std::mutex> lock(m_sandboxChainHopMtx);
+            m_sandboxChainHopServers.clear();
+            for (auto& jsrv : msg.data["chainHopServers"]) {
+                m_sandboxChainHopServers.add(ServerInfo(jsonGetValue(jsrv, "host", String()), String(), false,
+                                                        jsonGetValue(jsrv, "id", 0), Uuid(), 0.0f, false));
+            }
+        }
+        SandboxCGroups::join(jsonGetValue(msg.data, "cgroup", String()));
         m_sandboxReady = true;
     } else if (msg.type == SandboxMessage::HIDE_EDITOR) {
         if (m_workers.size() > 0) {
@@ -1687,12 +2375,14 @@ void Server::sandboxHideEditor() {
 }
 
 void Server::updateSandboxNetworkStats(const String& key, uint32 loaded, double bytesIn, double bytesOut, double rps,
+                                       double deadlineMisses,
                                        const std::vector<TimeStatistic::Histogram>& audioHists) {
     traceScope();
     m_sandboxLoadedCount.set(key, loaded);
     Metrics::getStatistic<Meter>("NetBytesIn")->updateExtRate1min(key, bytesIn);
     Metrics::getStatistic<Meter>("NetBytesOut")->updateExtRate1min(key, bytesOut);
     Metrics::getStatistic<TimeStatistic>("audio")->getMeter().updateExtRate1min(key, rps);
+    Metrics::getStatistic<Meter>("DeadlineMisses")->updateExtRate1min(key, deadlineMisses);
     Metrics::getStatistic<TimeStatistic>("audio")->updateExt1minValues(key, audioHists);
 }
 
@@ -19,6 +19,15 @@
 #include "json.hpp"
 #include "ScreenRecorder.hpp"
 #include "Sandbox.hpp"
+#include "PluginPool.hpp"
+#include "SandboxPool.hpp"
+#include "SandboxGroups.hpp"
+#include "SandboxCGroups.hpp"
+#include "LayoutCache.hpp"
+#include "PluginCatalog.hpp"
+#include "FingerprintIndex.hpp"
+#include "PluginWatcher.hpp"
+#include "ScanWorker.hpp"
 #include "ServerSettings/TabCommon.h"
 
 namespace e47 {
@@ -82,6 +91,8 @@ class Server : public Thread, public LogTag {
     void setPluginWindowsOnTop(bool b) { m_pluginWindowsOnTop = b; }
     bool getScanForPlugins() const { return m_scanForPlugins; }
     void setScanForPlugins(bool b) { m_scanForPlugins = b; }
+    bool getWatchPluginFolders() const { return m_watchPluginFolders; }
+    void setWatchPluginFolders(bool b) { m_watchPluginFolders = b; }
     SandboxMode getSandboxMode() const { return m_sandboxMode; }
     SandboxMode getSandboxModeRuntime() const { return m_sandboxModeRuntime; }
     void setSandboxMode(SandboxMode m) { m_sandboxMode = m; }
@@ -106,21 +117,34 @@ class Server : public Thread, public LogTag {
                  m_screenJpgQuality };
     }
 
-    const KnownPluginList& getPluginList() const { return m_pluginList; }
-    KnownPluginList& getPluginList() { return m_pluginList; }
-    const Array<AudioProcessor::BusesLayout>& getPluginLayouts(const String& id);
+    // The list gets decoded from the catalog on first use, if the server started without a scan
+    KnownPluginList& getPluginList();
+    // Has to be called after changing the list returned by getPluginList(), so that lookups don't use a stale catalog
+    void pluginListChanged();
+    // Looks up a plugin by ID or file/identifier in the plugin catalog
+    std::unique_ptr<PluginDescription> findPluginDescription(const String& id, String* idNormalized = nullptr);
+    // Encoded plugin list payloads are cached per client channel config until the plugin list changes
+    bool getPluginListPayload(const String& key, MemoryBlock& data);
+    void setPluginListPayload(const String& key, const MemoryBlock& data);
+    Array<AudioProcessor::BusesLayout> getPluginLayouts(const String& id);
+    // Stores layouts, that have been probed at load time, so that the next load does not need to probe again
+    void storePluginLayouts(const String& id, const Array<AudioProcessor::BusesLayout>& layouts);
 
     bool shouldExclude(const String& name, const String& id);
     bool shouldExclude(const String& name, const String& id, const std::vector<String>& include);
     auto& getExcludeList() { return m_pluginExclude; }
     void addPlugins(const std::vector<String>& names, std::function<void(bool, const String&)> fn);
 
-    static void loadKnownPluginList(KnownPluginList& plist, json& playouts, int srvId);
-    static void saveKnownPluginList(KnownPluginList& plist, json& playouts, int srvId);
+    // Returns true, if the list has been read from or written to the catalog file of the given server
+    static bool loadKnownPluginList(KnownPluginList& plist, json& playouts, int srvId, bool withLayouts = true);
+    static bool saveKnownPluginList(KnownPluginList& plist, json& playouts, int srvId);
+    static void saveKnownPluginLayouts(const KnownPluginList& plist, const json& playouts, int srvId);
 
     void saveKnownPluginList(bool wipe = false);
+    void rescanPlugins(const std::vector<String>& include, bool background);
 
-    static bool scanPlugin(const String& id, const String& format, int srvId, bool secondRun = false);
+    static bool scanPlugin(const String& id, const String& format, int srvId, bool secondRun = false,
+                           NamedPipe* statusPipe = nullptr);
 
     void sandboxShowEditor();
     void sandboxHideEditor();
@@ -128,6 +152,7 @@ class Server : public Thread, public LogTag {
     // SandboxMaster
     void handleMessageFromSandbox(SandboxMaster&, const SandboxMessage&);
     void handleDisconnectFromSandbox(SandboxMaster&);
+    void releaseSandbox(std::shared_ptr<SandboxMaster> sandbox);
 
     // SandboxSlave
     void handleMessageFromMaster(const SandboxMessage&);
@@ -144,11 +169,52 @@ class Server : public Thread, public LogTag {
     }
 
     void updateSandboxNetworkStats(const String& key, uint32 loaded, double bytesIn, double bytesOut, double rps,
-                                   const std::vector<TimeStatistic::Histogram>& audioHists);
+                                   double deadlineMisses, const std::vector<TimeStatistic::Histogram>& audioHists);
+
+    // Number of connected clients, each client has its own sandbox in chain isolation mode
+    int getNumClients() { return m_sandboxMode == SANDBOX_CHAIN ? getNumSandboxes() : (int)Worker::runCount; }
 
     double getProcessingTraceTresholdMs() const { return m_processingTraceTresholdMs; }
     void setProcessingTraceTresholdMs(double d) { m_processingTraceTresholdMs = d; }
 
+    // Audio workers spin on their sockets instead of blocking, meant for servers with dedicated cores
+    bool getLowLatencyMode() const { return m_lowLatencyMode; }
+    void setLowLatencyMode(bool b) { m_lowLatencyMode = b; }
+
+    bool getPluginPoolEnabled() const { return m_pluginPoolEnabled; }
+    void setPluginPoolEnabled(bool b) { m_pluginPoolEnabled = b; }
+    int getPluginPoolMemoryMB() const { return m_pluginPoolMemoryMB; }
+    void setPluginPoolMemoryMB(int mb) { m_pluginPoolMemoryMB = mb; }
+    PluginPool* getPluginPool() const { return m_pluginPool.get(); }
+
+    bool getSandboxPoolEnabled() const { return m_sandboxPoolEnabled; }
+    void setSandboxPoolEnabled(bool b) { m_sandboxPoolEnabled = b; }
+    int getSandboxPoolMaxIdle() const { return m_sandboxPoolMaxIdle; }
+    void setSandboxPoolMaxIdle(int n) { m_sandboxPoolMaxIdle = n; }
+    SandboxPool* getSandboxPool() const { return m_sandboxPool.get(); }
+
+    SandboxGroups::Policy getSandboxGrouping() const { return m_sandboxGrouping; }
+    void setSandboxGrouping(SandboxGroups::Policy p) { m_sandboxGrouping = p; }
+    int getSandboxGroupSize() const { return m_sandboxGroupSize; }
+    void setSandboxGroupSize(int n) { m_sandboxGroupSize = n; }
+    SandboxGroups* getSandboxGroups() const { return m_sandboxGroups.get(); }
+
+    int getSandboxSnapshotMaxAgeSecs() const { return m_sandboxSnapshotMaxAgeSecs; }
+    void setSandboxSnapshotMaxAgeSecs(int n) { m_sandboxSnapshotMaxAgeSecs = n; }
+
+    bool getSandboxCGroupsEnabled() const { return m_sandboxCGroupsEnabled; }
+    void setSandboxCGroupsEnabled(bool b) { m_sandboxCGroupsEnabled = b; }
+    SandboxCGroups* getSandboxCGroups() const { return m_sandboxCGroups.get(); }
+
+    // Chain hops make this server connect to other servers on behalf of a client. Allowed targets are servers
+    // discovered via mDNS and the allowlist entries ("host[:id]"), but never the server itself.
+    const StringArray& getChainHopAllowlist() const { return m_chainHopAllowlist; }
+    void setChainHopAllowlist(const StringArray& l) { m_chainHopAllowlist = l; }
+    bool isChainHopAllowed(const String& host, String& err);
+    static bool isChainHopAllowed(const ServerInfo& target, int selfId, const Array<ServerInfo>& discovered,
+                                  const StringArray& allowlist, String& err);
+    static bool isLocalHost(const String& host);
+
     template <typename T>
     inline T getOpt(const String& name, T def) const {
         return jsonGetValue(m_opts, name, def);
@@ -170,10 +236,25 @@ class Server : public Thread, public LogTag {
     StreamingSocket m_masterSocket, m_masterSocketLocal;
     using WorkerList = Array<std::shared_ptr<Worker>>;
     WorkerList m_workers;
+    std::atomic_int m_pendingResumes{0};
     KnownPluginList m_pluginList;
+    std::atomic_bool m_pluginListDeferred{false};
+    // Changes of the list bump the version, the catalog file is used for lookups as long as it has been written or
+    // read for the current version
+    std::atomic<uint32> m_pluginListVersion{1};
+    std::atomic<uint32> m_pluginCatalogFileVersion{0};
+    std::mutex m_pluginListMtx;
     json m_jpluginLayouts;
     std::unordered_map<String, Array<AudioProcessor::BusesLayout>> m_pluginLayouts;
+    std::mutex m_pluginLayoutsMtx;
+    std::unique_ptr<LayoutCache> m_layoutCache;
+    std::shared_ptr<PluginCatalog> m_pluginCatalog;
+    std::unordered_map<String, MemoryBlock> m_pluginListPayloads;
+    std::mutex m_pluginCatalogMtx;
     std::set<String> m_pluginExclude;
+    // Serializes updates of the plugin list, the layouts, the exclude list and the files they get persisted to, as
+    // the plugin watcher and addPlugins update them from background threads
+    std::recursive_mutex m_pluginListUpdateMtx;
     bool m_enableAU = true;
     bool m_enableVST3 = true;
     bool m_enableVST2 = true;
@@ -197,10 +278,38 @@ class Server : public Thread, public LogTag {
     StringArray m_lv2Folders;
     bool m_vstNoStandardFolders;
     bool m_scanForPlugins = true;
+    bool m_watchPluginFolders = true;
+    std::unique_ptr<FingerprintIndex> m_fingerprints;
+    std::unique_ptr<PluginWatcher> m_pluginWatcher;
+    std::mutex m_scanMtx;
     bool m_crashReporting = true;
     SandboxMode m_sandboxMode = SANDBOX_CHAIN, m_sandboxModeRuntime = SANDBOX_NONE;
+    bool m_leanStartup = false;
     bool m_sandboxLogAutoclean = true;
     double m_processingTraceTresholdMs = 0.0;
+    bool m_lowLatencyMode = false;
+    bool m_pluginPoolEnabled = false;
+    int m_pluginPoolMemoryMB = Defaults::PLUGIN_POOL_MEMORY_MB;
+    std::unique_ptr<PluginPool> m_pluginPool;
+    bool m_sandboxPoolEnabled = true;
+    int m_sandboxPoolMaxIdle = Defaults::SANDBOX_POOL_MAX_IDLE;
+    std::unique_ptr<SandboxPool> m_sandboxPool;
+    SandboxGroups::Policy m_sandboxGrouping = SandboxGroups::NONE;
+    int m_sandboxGroupSize = Defaults::SANDBOX_GROUP_SIZE;
+    StringArray m_sandboxGroupAllowlist;
+    std::unique_ptr<SandboxGroups> m_sandboxGroups;
+    int m_sandboxSnapshotMaxAgeSecs = 0;
+    bool m_sandboxCGroupsEnabled = false;
+    SandboxCGroups::Scope m_sandboxCGroupScope = SandboxCGroups::PER_CLIENT;
+    int m_sandboxCGroupCPUWeight = 100;
+    int m_sandboxCGroupMemoryMaxMB = 0;
+    String m_sandboxCGroupCPUs;
+    std::unique_ptr<SandboxCGroups> m_sandboxCGroups;
+    int m_sessionGraceSecs = Defaults::SESSION_GRACE_SECS;
+    StringArray m_chainHopAllowlist;
+    // servers, that the master has discovered, when it started this chain sandbox
+    Array<ServerInfo> m_sandboxChainHopServers;
+    std::mutex m_sandboxChainHopMtx;
 
     SafeHashMap<String, std::shared_ptr<SandboxMaster>> m_sandboxes;
 
@@ -211,6 +320,7 @@ class Server : public Thread, public LogTag {
     std::atomic_bool m_sandboxReady{false};
     std::atomic_bool m_sandboxConnectedToMaster{false};
     HandshakeRequest m_sandboxConfig;
+    String m_sandboxClientHost;
     String m_sandboxHasScreen;
 
     struct SandboxDeleter : Thread {
@@ -248,22 +358,33 @@ class Server : public Thread, public LogTag {
 
     std::unique_ptr<SandboxDeleter> m_sandboxDeleter;
 
-    void scanNextPlugin(const String& id, const String& name, const String& fmt, int srvId,
+    void scanNextPlugin(const String& id, const String& name, const String& fmt, ScanWorker& worker,
                         std::function<void(const String&)> onShellPlugin, bool secondRun = false);
     void scanForPlugins();
-    void scanForPlugins(const std::vector<String>& include);
+    void scanForPlugins(const std::vector<String>& include, bool background = false);
+    std::vector<std::unique_ptr<AudioPluginFormat>> getPluginFormats();
+    FileSearchPath getSearchPaths(AudioPluginFormat& fmt);
 
     void processScanResults(int id, std::set<String>& newBlacklistedPlugins);
 
     void loadKnownPluginList();
-    bool parsePluginLayouts(const String& id = {});
+    bool removeDisabledFormats();
+    bool isFormatEnabled(const String& format) const;
+    bool parsePluginLayouts();
+    void updatePluginCatalog();
+    bool openPluginCatalog();
+    std::shared_ptr<PluginCatalog> getPluginCatalog();
 
     void checkPort();
     void runServer();
     void runSandboxChain();
     void runSandboxPlugin();
+    void runSandboxPluginHost(std::shared_ptr<StreamingSocket> ctrlSocket);
+    bool createSandboxPluginListener(std::shared_ptr<StreamingSocket> sock, int port);
 
-    bool sendHandshakeResponse(StreamingSocket* sock, bool sandboxEnabled = false, int sandboxPort = 0);
+    static uint64 newSessionToken();
+    bool sendHandshakeResponse(StreamingSocket* sock, bool sandboxEnabled = false, int sandboxPort = 0,
+                               uint64 sessionToken = 0, bool resumed = false);
     bool createWorkerListener(std::shared_ptr<StreamingSocket> sock, bool isLocal, int& workerPort);
     void shutdownWorkers();
 
@@ -12,6 +12,10 @@
 #include "CPUInfo.hpp"
 #include "json.hpp"
 #include "Version.hpp"
+#include "Metrics.hpp"
+#include "Message.hpp"
+#include "App.hpp"
+#include "Server.hpp"
 
 using json = nlohmann::json;
 
@@ -124,6 +128,12 @@ int ServiceResponder::handleRecord(int sock, const struct sockaddr* from, size_t
             j["LM"] = m_localMode;
             j["LOAD"] = CPUInfo::getUsage();
             j["V"] = AUDIOGRIDDER_VERSION;
+            j["PV"] = AG_PROTOCOL_VERSION;
+            j["MEM"] = CPUInfo::getFreeMemoryMB();
+            j["DM"] = lround(Metrics::getStatistic<Meter>("DeadlineMisses")->rate_1min() * 60);
+            if (auto srv = getApp()->getServer()) {
+                j["CL"] = srv->getNumClients();
+            }
 
             String txtInfoRecord;
 
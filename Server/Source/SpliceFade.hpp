@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef SpliceFade_hpp
+#define SpliceFade_hpp
+
+#include <JuceHeader.h>
+
+namespace e47 {
+
+/*
+ * Cross-fades from the dry signal to the output of a processor, that has just been spliced into a running chain. The
+ * dry signal gets delayed by the latency of the new processor, so that both paths are aligned while fading. The delay
+ * line has no history when the fade starts, so the dry signal passes through undelayed until the delay line is filled.
+ */
+class SpliceFade {
+  public:
+    // Allocates the buffers, must not be called on the audio thread
+    void prepare(int channels, int blockSize, int latency, int fadeSamples, bool doublePrecision) {
+        m_latency = jmax(0, latency);
+        m_samplesTotal = m_samplesLeft = jmax(1, fadeSamples);
+        m_primeLeft = m_latency;
+        m_delayPos = 0;
+        int delaySize = m_latency > 0 ? m_latency + blockSize : 0;
+        if (doublePrecision) {
+            m_dryD.setSize(channels, blockSize);
+            m_delayD.setSize(channels, delaySize);
+            m_delayD.clear();
+        } else {
+            m_dryF.setSize(channels, blockSize);
+            m_delayF.setSize(channels, delaySize);
+            m_delayF.clear();
+        }
+    }
+
+    bool isActive() const { return m_samplesLeft > 0; }
+    void stop() { m_samplesLeft = 0; }
+
+    // Keeps the dry signal of the current block, returns false if the block does not fit the buffers
+    template <typename T>
+    bool copyDry(const AudioBuffer<T>& buffer) {
+        auto& dry = getDry<T>();
+        if (dry.getNumChannels() < buffer.getNumChannels() || dry.getNumSamples() < buffer.getNumSamples()) {
+            return false;
+        }
+        for (int ch = 0; ch < buffer.getNumChannels(); ch++) {
+            dry.copyFrom(ch, 0, buffer, ch, 0, buffer.getNumSamples());
+        }
+        return true;
+    }
+
+    // Mixes the processed block with the dry signal, that has been kept by copyDry
+    template <typename T>
+    void apply(AudioBuffer<T>& wet) {
+        auto& dry = getDry<T>();
+        auto& delay = getDelay<T>();
+        int delaySize = delay.getNumSamples();
+        int primeLeft = m_primeLeft, samplesLeft = m_samplesLeft, delayPos = m_delayPos;
+        for (int ch = 0; ch < wet.getNumChannels(); ch++) {
+            auto* w = wet.getWritePointer(ch);
+            auto* d = dry.getReadPointer(ch);
+            auto* line = m_latency > 0 ? delay.getWritePointer(ch) : nullptr;
+            primeLeft = m_primeLeft;
+            samplesLeft = m_samplesLeft;
+            delayPos = m_delayPos;
+            for (int i = 0; i < wet.getNumSamples() && samplesLeft > 0; i++) {
+                T old = d[i];
+                if (nullptr != line) {
+                    line[delayPos] = d[i];
+                    int readPos = delayPos - m_latency;
+                    if (readPos < 0) {
+                        readPos += delaySize;
+                    }
+                    if (++delayPos == delaySize) {
+                        delayPos = 0;
+                    }
+                    old = line[readPos];
+                }
+                if (primeLeft > 0) {
+                    primeLeft--;
+                    w[i] = d[i];
+                    continue;
+                }
+                auto gain = (T)(m_samplesTotal - samplesLeft) / (T)m_samplesTotal;
+                w[i] = old + (w[i] - old) * gain;
+                samplesLeft--;
+            }
+        }
+        m_primeLeft = primeLeft;
+        m_samplesLeft = samplesLeft;
+        m_delayPos = delayPos;
+    }
+
+  private:
+    int m_latency = 0;
+    int m_samplesTotal = 0;
+    int m_samplesLeft = 0;
+    int m_primeLeft = 0;
+    int m_delayPos = 0;
+    AudioBuffer<float> m_dryF, m_delayF;
+    AudioBuffer<double> m_dryD, m_delayD;
+
+    template <typename T>
+    AudioBuffer<T>& getDry();
+
+    template <typename T>
+    AudioBuffer<T>& getDelay();
+};
+
+template <>
+inline AudioBuffer<float>& SpliceFade::getDry() {
+    return m_dryF;
+}
+
+template <>
+inline AudioBuffer<double>& SpliceFade::getDry() {
+    return m_dryD;
+}
+
+template <>
+inline AudioBuffer<float>& SpliceFade::getDelay() {
+    return m_delayF;
+}
+
+template <>
+inline AudioBuffer<double>& SpliceFade::getDelay() {
+    return m_delayD;
+}
+
+}  // namespace e47
+
+#endif /* SpliceFade_hpp */
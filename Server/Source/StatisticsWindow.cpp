@@ -11,6 +11,7 @@
 #include "Processor.hpp"
 #include "CPUInfo.hpp"
 #include "Metrics.hpp"
+#include "LowLatencyWait.hpp"
 #include "WindowPositions.hpp"
 
 namespace e47 {
@@ -22,12 +23,14 @@ StatisticsWindow::StatisticsWindow(App* app)
       LogTag("statistics"),
       m_app(app),
       m_sandboxing(false),
+      m_cgroups(false),
       m_updater(this) {
     traceScope();
     setUsingNativeTitleBar(true);
 
     if (auto srv = m_app->getServer()) {
         m_sandboxing = srv->getSandboxMode() == Server::SANDBOX_CHAIN;
+        m_cgroups = nullptr != srv->getSandboxCGroups() && srv->getSandboxCGroups()->isEnabled();
     }
 
     int totalWidth = 400;
@@ -62,6 +65,22 @@ StatisticsWindow::StatisticsWindow(App* app)
 
     row++;
 
+    if (m_cgroups) {
+        addLabel("Sandbox CPU (cgroups):", getLabelBounds(row));
+        m_sandboxCpu.setBounds(getFieldBounds(row));
+        m_sandboxCpu.setJustificationType(Justification::right);
+        addChildAndSetID(&m_sandboxCpu, "sandboxcpu");
+
+        row++;
+
+        addLabel("Sandbox memory (cgroups):", getLabelBounds(row));
+        m_sandboxMemory.setBounds(getFieldBounds(row));
+        m_sandboxMemory.setJustificationType(Justification::right);
+        addChildAndSetID(&m_sandboxMemory, "sandboxmemory");
+
+        row++;
+    }
+
     auto line = std::make_unique<HirozontalLine>(getLineBounds(row++));
     addChildAndSetID(line.get(), "line");
     m_components.push_back(std::move(line));
@@ -155,15 +174,31 @@ StatisticsWindow::StatisticsWindow(App* app)
 
     row++;
 
+    addLabel("Wakeup jitter (95th percentile):", getLabelBounds(row, 15));
+    m_audioWakeupJitter.setBounds(getFieldBounds(row));
+    m_audioWakeupJitter.setJustificationType(Justification::right);
+    addChildAndSetID(&m_audioWakeupJitter, "netjitter");
+
+    row++;
+
     totalHeight += row * rowHeight;
 
     auto audioTime = Metrics::getStatistic<TimeStatistic>("audio");
     auto bytesOutMeter = Metrics::getStatistic<Meter>("NetBytesOut");
     auto bytesInMeter = Metrics::getStatistic<Meter>("NetBytesIn");
+    auto sandboxCpuMeter = Metrics::getStatistic<Meter>("SandboxCPU");
+    auto sandboxMemoryMeter = Metrics::getStatistic<Meter>("SandboxMemoryMB");
+    auto wakeupJitter = LowLatencyWait::getJitterStatistic();
 
-    m_updater.set([this, audioTime, bytesOutMeter, bytesInMeter] {
+    m_updater.set([this, audioTime, bytesOutMeter, bytesInMeter, sandboxCpuMeter, sandboxMemoryMeter, wakeupJitter] {
         traceScope();
         m_cpu.setText(String(CPUInfo::getUsage(), 2) + "%", NotificationType::dontSendNotification);
+        if (m_cgroups) {
+            m_sandboxCpu.setText(String(sandboxCpuMeter->getExtRate1min(), 2) + "%",
+                                 NotificationType::dontSendNotification);
+            m_sandboxMemory.setText(String(sandboxMemoryMeter->getExtRate1min(), 1) + " MB",
+                                    NotificationType::dontSendNotification);
+        }
         if (m_sandboxing) {
             if (auto srv = m_app->getServer()) {
                 m_totalWorkers.setText(String(srv->getNumSandboxes()), NotificationType::dontSendNotification);
@@ -205,6 +240,8 @@ StatisticsWindow::StatisticsWindow(App* app)
         }
         m_audioBytesOut.setText(String(netOut, 2) + dataUnitOut, NotificationType::dontSendNotification);
         m_audioBytesIn.setText(String(netIn, 2) + dataUnitIn, NotificationType::dontSendNotification);
+        m_audioWakeupJitter.setText(String(wakeupJitter->get1minHistogram().nintyFifth, 3) + " ms",
+                                    NotificationType::dontSendNotification);
     });
     m_updater.startThread();
 
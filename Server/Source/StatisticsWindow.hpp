@@ -33,8 +33,9 @@ class StatisticsWindow : public DocumentWindow, public LogTag {
     App* m_app;
     std::vector<std::unique_ptr<Component>> m_components;
     Label m_cpu, m_totalWorkers, m_activeWorkers, m_plugins, m_audioRPS, m_audioPTavg, m_audioPTmin, m_audioPTmax,
-        m_audioPT95th, m_audioBytesOut, m_audioBytesIn;
+        m_audioPT95th, m_audioBytesOut, m_audioBytesIn, m_audioWakeupJitter, m_sandboxCpu, m_sandboxMemory;
     bool m_sandboxing;
+    bool m_cgroups;
 
     class Updater : public Thread, public LogTagDelegate {
       public:
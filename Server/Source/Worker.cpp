@@ -45,6 +45,7 @@ Worker::Worker(std::shared_ptr<StreamingSocket> masterSocket, const HandshakeReq
 Worker::~Worker() {
     traceScope();
     stopAsyncFunctors();
+    shutdown();
     if (nullptr != m_cmdIn && m_cmdIn->isConnected()) {
         m_cmdIn->close();
     }
@@ -71,24 +72,56 @@ void Worker::run() {
 
     m_noPluginListFilter = m_cfg.isFlag(HandshakeRequest::NO_PLUGINLIST_FILTER);
 
+    bool connected = false;
+    do {
+        if (!connectClient(connected)) {
+            // a resuming client might try again
+            continue;
+        }
+        connected = true;
+        processMessages();
+        disconnectClient();
+    } while (connected && waitForResume());
+
+    getApp()->setWorkerErrorCallback(getThreadId(), nullptr);
+
+    if (nullptr != m_audio) {
+        m_audio->clear();
+    }
+
+    logln("command processor terminated");
+    runCount--;
+}
+
+bool Worker::connectClient(bool resumed) {
+    traceScope();
+
     // set master socket non-blocking
     if (!setNonBlocking(m_masterSocket->getRawSocketHandle())) {
         logln("failed to set master socket non-blocking");
     }
 
-    m_cmdIn.reset(accept(m_masterSocket.get(), 5000));
+    {
+        // a resume closes the command socket from another thread
+        std::unique_ptr<StreamingSocket> cmdIn(accept(m_masterSocket.get(), 5000));
+        std::lock_guard<std::mutex> lock(m_sessionMtx);
+        m_cmdIn = std::move(cmdIn);
+    }
     if (nullptr != m_cmdIn && m_cmdIn->isConnected()) {
         logln("client connected " << m_cmdIn->getHostName());
     } else {
         logln("no client, giving up");
-        return;
+        return false;
     }
 
     // command sending socket
-    m_cmdOut.reset(accept(m_masterSocket.get(), 2000));
+    {
+        std::lock_guard<std::mutex> lock(m_cmdOutMtx);
+        m_cmdOut.reset(accept(m_masterSocket.get(), 2000));
+    }
     if (nullptr == m_cmdIn || !m_cmdIn->isConnected()) {
         logln("failed to establish command connection");
-        return;
+        return false;
     }
 
     std::unique_ptr<StreamingSocket> sock;
@@ -96,7 +129,11 @@ void Worker::run() {
     // start audio processing
     sock.reset(accept(m_masterSocket.get(), 2000));
     if (nullptr != sock && sock->isConnected()) {
-        m_audio->init(std::move(sock), m_cfg);
+        if (resumed) {
+            m_audio->resume(std::move(sock));
+        } else {
+            m_audio->init(std::move(sock), m_cfg);
+        }
         RealtimeOptions opts;
         opts.workDurationMs = (uint32)lround(m_cfg.samplesPerBlock / m_cfg.sampleRate * 1000) - 1;
         m_audio->startRealtimeThread(opts);
@@ -104,8 +141,11 @@ void Worker::run() {
         logln("failed to establish audio connection");
     }
 
+    // plugin sandboxes and chain hops are driven by another server, that does not need screens or a plugin list
+    bool isUpstreamServer = m_sandboxModeRuntime == Server::SANDBOX_PLUGIN || m_cfg.isFlag(HandshakeRequest::CHAIN_HOP);
+
     // start screen capturing
-    if (m_sandboxModeRuntime != Server::SANDBOX_PLUGIN) {
+    if (!isUpstreamServer) {
         sock.reset(accept(m_masterSocket.get(), 2000));
         if (nullptr != sock && sock->isConnected()) {
             m_screen->init(std::move(sock));
@@ -119,11 +159,16 @@ void Worker::run() {
     m_masterSocket.reset();
 
     // send list of plugins
-    if (m_sandboxModeRuntime != Server::SANDBOX_PLUGIN) {
+    if (!isUpstreamServer) {
         auto msgPL = std::make_shared<Message<PluginList>>(this);
         handleMessage(msgPL);
     }
 
+    return true;
+}
+
+void Worker::processMessages() {
+    traceScope();
     // enter message loop
     logln("command processor started");
     while (!threadShouldExit() && nullptr != m_cmdIn && m_cmdIn->isConnected() && m_audio->isOkNoLock() &&
@@ -139,6 +184,9 @@ void Worker::run() {
                 case AddPlugin::Type:
                     handleMessage(Message<Any>::convert<AddPlugin>(msg));
                     break;
+                case RestorePlugins::Type:
+                    handleMessage(Message<Any>::convert<RestorePlugins>(msg));
+                    break;
                 case DelPlugin::Type:
                     handleMessage(Message<Any>::convert<DelPlugin>(msg));
                     break;
@@ -157,6 +205,15 @@ void Worker::run() {
                 case GetPluginSettings::Type:
                     handleMessage(Message<Any>::convert<GetPluginSettings>(msg));
                     break;
+                case GetPluginSettingsIfChanged::Type:
+                    handleMessage(Message<Any>::convert<GetPluginSettingsIfChanged>(msg));
+                    break;
+                case GetPluginSettingsChunk::Type:
+                    handleMessage(Message<Any>::convert<GetPluginSettingsChunk>(msg));
+                    break;
+                case PluginSettingsChunk::Type:
+                    handleMessage(Message<Any>::convert<PluginSettingsChunk>(msg));
+                    break;
                 case SetPluginSettings::Type:
                     handleMessage(Message<Any>::convert<SetPluginSettings>(msg));
                     break;
@@ -208,6 +265,12 @@ void Worker::run() {
                 case SetMonoChannels::Type:
                     handleMessage(Message<Any>::convert<SetMonoChannels>(msg));
                     break;
+                case Reconfigure::Type:
+                    handleMessage(Message<Any>::convert<Reconfigure>(msg));
+                    break;
+                case SetAuxBuses::Type:
+                    handleMessage(Message<Any>::convert<SetAuxBuses>(msg));
+                    break;
                 default:
                     logln("unknown message type " << msg->getType());
             }
@@ -216,12 +279,14 @@ void Worker::run() {
             break;
         }
     }
+}
 
-    getApp()->setWorkerErrorCallback(getThreadId(), nullptr);
-
+void Worker::disconnectClient() {
+    traceScope();
     if (nullptr != m_screen) {
         if (m_activeEditorIdx > -1) {
             m_screen->hideEditor();
+            m_activeEditorIdx = -1;
         }
         m_screen->shutdown();
         m_screen->waitForThreadToExit(-1);
@@ -232,13 +297,95 @@ void Worker::run() {
         m_audio->waitForThreadToExit(-1);
     }
 
-    logln("command processor terminated");
-    runCount--;
+    if (nullptr != m_cmdIn) {
+        m_cmdIn->close();
+    }
+    std::lock_guard<std::mutex> lock(m_cmdOutMtx);
+    if (nullptr != m_cmdOut) {
+        m_cmdOut->close();
+    }
+}
+
+bool Worker::waitForResume() {
+    traceScope();
+    if (m_sessionToken == 0 || m_sessionGraceSecs <= 0 || threadShouldExit()) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(m_sessionMtx);
+    logln("client disconnected, keeping the session for " << m_sessionGraceSecs << " seconds");
+    m_detached = true;
+    m_sessionCv.notify_all();
+    m_sessionCv.wait_for(lock, std::chrono::seconds(m_sessionGraceSecs),
+                         [this] { return !m_detached || threadShouldExit(); });
+    if (m_detached) {
+        m_detached = false;
+        logln("session expired");
+        return false;
+    }
+    if (threadShouldExit()) {
+        return false;
+    }
+    logln("resuming session");
+    return true;
+}
+
+bool Worker::claimSession(uint64 token, const HandshakeRequest& cfg) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_sessionMtx);
+    if (token == 0 || token != m_sessionToken || !isThreadRunning() || threadShouldExit()) {
+        return false;
+    }
+    if (m_resuming) {
+        logln("can't resume session: the session is being resumed already");
+        return false;
+    }
+    if (cfg.clientId != m_cfg.clientId || cfg.channelsIn != m_cfg.channelsIn || cfg.channelsOut != m_cfg.channelsOut ||
+        cfg.channelsSC != m_cfg.channelsSC || cfg.sampleRate != m_cfg.sampleRate ||
+        cfg.samplesPerBlock != m_cfg.samplesPerBlock || cfg.doublePrecision != m_cfg.doublePrecision ||
+        cfg.activeChannels != m_cfg.activeChannels) {
+        logln("can't resume session: the client config has changed");
+        return false;
+    }
+    m_resuming = true;
+    return true;
+}
+
+bool Worker::resume(std::shared_ptr<StreamingSocket> masterSocket) {
+    traceScope();
+    std::unique_lock<std::mutex> lock(m_sessionMtx);
+    if (!m_resuming) {
+        logln("can't resume session: the session has not been claimed");
+        return false;
+    }
+    if (!m_detached) {
+        // the client noticed the disconnect before we did, the old connection might stay open until the socket
+        // timeouts hit, so close it to make the worker detach
+        logln("closing the old connection of the session");
+        if (nullptr != m_cmdIn) {
+            m_cmdIn->close();
+        }
+        if (nullptr != m_audio) {
+            m_audio->closeSocket();
+        }
+    }
+    m_sessionCv.wait_for(lock, std::chrono::seconds(Defaults::SESSION_RESUME_TIMEOUT_SECS),
+                         [this] { return m_detached || threadShouldExit() || !isThreadRunning(); });
+    m_resuming = false;
+    if (!m_detached || threadShouldExit()) {
+        logln("can't resume session: the worker did not detach from the old connection");
+        return false;
+    }
+    m_masterSocket = masterSocket;
+    m_detached = false;
+    m_sessionCv.notify_all();
+    return true;
 }
 
 void Worker::shutdown() {
     traceScope();
     signalThreadShouldExit();
+    std::lock_guard<std::mutex> lock(m_sessionMtx);
+    m_sessionCv.notify_all();
 }
 
 void Worker::handleMessage(std::shared_ptr<Message<Quit>> /* msg */) {
@@ -253,12 +400,52 @@ void Worker::handleMessage(std::shared_ptr<Message<AddPlugin>> msg) {
     auto settings = jsonGetValue(jmsg, "settings", String());
     auto layout = jsonGetValue(jmsg, "layout", String());
     auto monoChannels = jsonGetValue(jmsg, "monoChannels", 0ull);
+    auto host = jsonGetValue(jmsg, "host", String());
+    auto async = jsonGetValue(jmsg, "async", false);
+    auto settingsChunks = jsonGetValue(jmsg, "settingsChunks", 0);
 
-    logln("adding plugin " << id << "...");
+    if (settingsChunks > 0 && !readSettingsChunks(settingsChunks, settings)) {
+        logln("failed to read settings for plugin " << id);
+        m_cmdIn->close();
+        return;
+    }
+
+    logln("adding plugin " << id << (host.isNotEmpty() ? " on " + host : String())
+                           << (async ? " in the background" : "") << "...");
 
     String err;
     bool wasSidechainDisabled = m_audio->isSidechainDisabled();
-    bool success = m_audio->addPlugin(id, settings, layout, monoChannels, err);
+
+    if (!isChainHopAllowed(host, err)) {
+        logln("error: " << err);
+        Message<AddPluginResult> msgResult(this);
+        PLD(msgResult).setJson({{"success", false}, {"err", err.toStdString()}});
+        if (!msgResult.send(m_cmdIn.get())) {
+            logln("failed to send result");
+            m_cmdIn->close();
+        }
+        return;
+    }
+
+    if (async) {
+        int idx = m_audio->addPluginAsync(
+            id, settings, layout, monoChannels, host,
+            [this, ctx = getAsyncContext(), id, layout, wasSidechainDisabled](
+                std::shared_ptr<Processor> proc, int procIdx, bool procSuccess, const String& procErr) mutable {
+                ctx.execute([&] {
+                    sendPluginLoaded(proc, procIdx, procSuccess, procErr, id, layout, wasSidechainDisabled);
+                });
+            });
+        Message<AddPluginResult> msgResult(this);
+        PLD(msgResult).setJson({{"success", true}, {"pending", true}, {"idx", idx}, {"err", ""}});
+        if (!msgResult.send(m_cmdIn.get())) {
+            logln("failed to send result");
+            m_cmdIn->close();
+        }
+        return;
+    }
+
+    bool success = m_audio->addPlugin(id, settings, layout, monoChannels, host, err);
     if (!success) {
         logln("error: " << err);
     }
@@ -268,37 +455,8 @@ void Worker::handleMessage(std::shared_ptr<Message<AddPlugin>> msg) {
     jresult["err"] = err.toStdString();
     if (success) {
         if ((proc = m_audio->getProcessor(m_audio->getSize() - 1))) {
-            jresult["latency"] = m_audio->getLatencySamples();
-            jresult["disabledSideChain"] = !wasSidechainDisabled && m_audio->isSidechainDisabled();
-            jresult["name"] = proc->getName().toStdString();
-            jresult["hasEditor"] = proc->hasEditor();
-            jresult["supportsDoublePrecision"] = proc->supportsDoublePrecisionProcessing();
-            jresult["channelInstances"] = proc->getChannelInstances();
-            auto ts = proc->getTailLengthSeconds();
-            if (ts == std::numeric_limits<double>::infinity()) {
-                ts = 0.0;
-            }
-            jresult["tailSeconds"] = ts;
-            jresult["numOutputChannels"] = proc->getTotalNumOutputChannels();
-            proc->setCallbacks(
-                [this, ctx = getAsyncContext()](int idx, int channel, int paramIdx, float val) mutable {
-                    ctx.execute(
-                        [this, idx, channel, paramIdx, val] { sendParamValueChange(idx, channel, paramIdx, val); });
-                },
-                [this, ctx = getAsyncContext()](int idx, int channel, int paramIdx, bool gestureIsStarting) mutable {
-                    ctx.execute([this, idx, channel, paramIdx, gestureIsStarting] {
-                        sendParamGestureChange(idx, channel, paramIdx, gestureIsStarting);
-                    });
-                },
-                [this, ctx = getAsyncContext()](Message<Key>& m) mutable {
-                    ctx.execute([this, &m] {
-                        std::lock_guard<std::mutex> lock(m_cmdOutMtx);
-                        m.send(m_cmdOut.get());
-                    });
-                },
-                [this, ctx = getAsyncContext()](int idx, bool ok, const String& procErr) mutable {
-                    ctx.execute([this, idx, ok, &procErr] { sendStatusChange(idx, ok, procErr); });
-                });
+            addPluginInfo(jresult, proc, wasSidechainDisabled);
+            setProcessorCallbacks(proc);
         } else {
             logln("error: getProcessor returned nullptr");
             jresult["success"] = success = false;
@@ -317,18 +475,8 @@ void Worker::handleMessage(std::shared_ptr<Message<AddPlugin>> msg) {
         return;
     }
     logln("sending presets...");
-    String presets;
-    bool first = true;
-    for (int i = 0; i < proc->getNumPrograms(); i++) {
-        if (first) {
-            first = false;
-        } else {
-            presets << "|";
-        }
-        presets << proc->getProgramName(i);
-    }
     Message<Presets> msgPresets(this);
-    msgPresets.payload.setString(presets);
+    msgPresets.payload.setString(getPresets(proc));
     if (!msgPresets.send(m_cmdIn.get())) {
         logln("failed to send Presets message");
         m_cmdIn->close();
@@ -344,7 +492,146 @@ void Worker::handleMessage(std::shared_ptr<Message<AddPlugin>> msg) {
         return;
     }
     logln("...ok");
+    addToRecents(id, layout);
+}
+
+void Worker::addPluginInfo(json& jresult, std::shared_ptr<Processor> proc, bool wasSidechainDisabled) {
+    traceScope();
+    jresult["latency"] = m_audio->getLatencySamples();
+    jresult["disabledSideChain"] = !wasSidechainDisabled && m_audio->isSidechainDisabled();
+    jresult["name"] = proc->getName().toStdString();
+    jresult["hasEditor"] = proc->hasEditor();
+    jresult["supportsDoublePrecision"] = proc->supportsDoublePrecisionProcessing();
+    jresult["channelInstances"] = proc->getChannelInstances();
+    auto ts = proc->getTailLengthSeconds();
+    if (ts == std::numeric_limits<double>::infinity()) {
+        ts = 0.0;
+    }
+    jresult["tailSeconds"] = ts;
+    jresult["numOutputChannels"] = proc->getTotalNumOutputChannels();
+}
+
+String Worker::getPresets(std::shared_ptr<Processor> proc) {
+    traceScope();
+    String presets;
+    bool first = true;
+    for (int i = 0; i < proc->getNumPrograms(); i++) {
+        if (first) {
+            first = false;
+        } else {
+            presets << "|";
+        }
+        presets << proc->getProgramName(i);
+    }
+    return presets;
+}
+
+void Worker::setProcessorCallbacks(std::shared_ptr<Processor> proc) {
+    traceScope();
+    proc->setCallbacks(
+        [this, ctx = getAsyncContext()](int idx, int channel, int paramIdx, float val) mutable {
+            ctx.execute([this, idx, channel, paramIdx, val] { sendParamValueChange(idx, channel, paramIdx, val); });
+        },
+        [this, ctx = getAsyncContext()](int idx, int channel, int paramIdx, bool gestureIsStarting) mutable {
+            ctx.execute([this, idx, channel, paramIdx, gestureIsStarting] {
+                sendParamGestureChange(idx, channel, paramIdx, gestureIsStarting);
+            });
+        },
+        [this, ctx = getAsyncContext()](Message<Key>& m) mutable {
+            ctx.execute([this, &m] {
+                std::lock_guard<std::mutex> lock(m_cmdOutMtx);
+                m.send(m_cmdOut.get());
+            });
+        },
+        [this, ctx = getAsyncContext()](int idx, bool ok, const String& procErr) mutable {
+            ctx.execute([this, idx, ok, &procErr] { sendStatusChange(idx, ok, procErr); });
+        });
+}
+
+bool Worker::isChainHopAllowed(const String& host, String& err) {
+    if (host.isEmpty()) {
+        return true;
+    }
+    if (auto srv = getApp()->getServer()) {
+        return srv->isChainHopAllowed(host, err);
+    }
+    err = "chain hops are not available";
+    return false;
+}
+
+void Worker::addToRecents(const String& id, const String& layout) {
+    traceScope();
     m_audio->addToRecentsList(id, m_cmdIn->getHostName());
+    if (auto srv = getApp()->getServer()) {
+        if (auto pool = srv->getPluginPool()) {
+            pool->recordSession(m_cmdIn->getHostName(), PluginPool::Key(id, layout, m_cfg));
+        }
+    }
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<RestorePlugins>> msg) {
+    traceScope();
+    auto jmsg = pPLD(msg).getJson();
+    std::vector<AudioWorker::PluginSpec> plugins;
+    if (jsonHasValue(jmsg, "plugins")) {
+        for (auto& jplug : jmsg["plugins"]) {
+            AudioWorker::PluginSpec spec;
+            spec.id = jsonGetValue(jplug, "id", String());
+            spec.settings = jsonGetValue(jplug, "settings", String());
+            spec.layout = jsonGetValue(jplug, "layout", String());
+            spec.monoChannels = jsonGetValue(jplug, "monoChannels", 0ull);
+            spec.host = jsonGetValue(jplug, "host", String());
+            if (!isChainHopAllowed(spec.host, spec.err)) {
+                logln("error: " << spec.err);
+            }
+            auto settingsChunks = jsonGetValue(jplug, "settingsChunks", 0);
+            if (settingsChunks > 0 && !readSettingsChunks(settingsChunks, spec.settings)) {
+                logln("failed to read settings for plugin " << spec.id);
+                m_cmdIn->close();
+                return;
+            }
+            plugins.push_back(std::move(spec));
+        }
+    }
+
+    logln("restoring " << plugins.size() << " plugins...");
+
+    bool wasSidechainDisabled = m_audio->isSidechainDisabled();
+    std::vector<String> errors(plugins.size());
+    int done = 0;
+
+    // the callback is serialized by the audio worker, so it's safe to send from here
+    auto procs = m_audio->restorePlugins(
+        plugins, [&](int num, std::shared_ptr<Processor> proc, bool success, const String& err) {
+            errors[(size_t)num] = err;
+            Message<RestorePluginsProgress> msgProgress(this);
+            PLD(msgProgress)
+                .setJson({{"num", num},
+                          {"name", proc->getName().toStdString()},
+                          {"success", success},
+                          {"err", err.toStdString()},
+                          {"done", ++done},
+                          {"total", (int)plugins.size()}});
+            msgProgress.send(m_cmdIn.get());
+        });
+
+    auto jplugs = json::array();
+    for (size_t i = 0; i < procs.size(); i++) {
+        auto& proc = procs[i];
+        json jplug = {{"success", proc->isLoaded()}, {"err", errors[i].toStdString()}};
+        if (proc->isLoaded()) {
+            addPluginInfo(jplug, proc, wasSidechainDisabled);
+            jplug["presets"] = getPresets(proc).toStdString();
+            jplug["parameters"] = proc->getParameters();
+            setProcessorCallbacks(proc);
+            addToRecents(plugins[i].id, plugins[i].layout);
+        }
+        jplugs.push_back(jplug);
+    }
+
+    Message<RestorePluginsResult> msgResult(this);
+    PLD(msgResult).setJson({{"plugins", jplugs}, {"latency", m_audio->getLatencySamples()}});
+    msgResult.send(m_cmdIn.get());
 }
 
 void Worker::handleMessage(std::shared_ptr<Message<DelPlugin>> msg) {
@@ -356,6 +643,9 @@ void Worker::handleMessage(std::shared_ptr<Message<DelPlugin>> msg) {
         }
         m_screen->hideEditor();
         m_clipboardTracker->stop();
+        if (auto proc = m_audio->getProcessor(m_activeEditorIdx)) {
+            proc->markStateDirty();
+        }
         m_activeEditorIdx = -1;
     }
     m_audio->delPlugin(idx);
@@ -367,6 +657,7 @@ void Worker::handleMessage(std::shared_ptr<Message<EditPlugin>> msg) {
     traceScope();
     int idx = pDATA(msg)->index;
     if (auto proc = m_audio->getProcessor(idx)) {
+        proc->markStateDirty();
         if (auto srv = getApp()->getServer()) {
             srv->sandboxShowEditor();
             m_screen->showEditor(getThreadId(), proc, pDATA(msg)->channel, pDATA(msg)->x, pDATA(msg)->y,
@@ -470,22 +761,155 @@ void Worker::handleMessage(std::shared_ptr<Message<GetPluginSettings>> msg) {
     ret.send(m_cmdIn.get());
 }
 
+void Worker::handleMessage(std::shared_ptr<Message<GetPluginSettingsIfChanged>> msg) {
+    traceScope();
+    auto jreq = pPLD(msg).getJson();
+    int idx = jsonGetValue(jreq, "idx", -1);
+    String knownHash = jsonGetValue(jreq, "hash", String());
+    String settings, hash;
+    bool changed = false;
+    if (auto proc = m_audio->getProcessor(idx)) {
+        if (idx == m_activeEditorIdx) {
+            // the user might be changing things in the editor, that do not show up as parameter changes
+            proc->markStateDirty();
+        }
+        changed = proc->getStateInformationIfChanged(knownHash, settings, hash);
+    } else {
+        logln("error: failed to read plugin settings: invalid index " << idx);
+        changed = true;
+    }
+    Message<PluginSettingsState> ret(this);
+    json jret = {{"changed", changed}, {"hash", (changed ? hash : knownHash).toStdString()}};
+    bool chunked = jsonGetValue(jreq, "chunked", false);
+    if (changed && chunked) {
+        // the client fetches the chunks one by one, so that other commands can go in between
+        int transfer = m_settingsTransfers.addOutgoing(idx, settings);
+        jret["transfer"] = transfer;
+        jret["chunks"] = m_settingsTransfers.getNumChunks(transfer);
+        traceln("settings transfer " << transfer << " for idx " << idx << " started");
+    }
+    PLD(ret).setJson(jret);
+    if (!ret.send(m_cmdIn.get())) {
+        return;
+    }
+    if (changed && !chunked) {
+        Message<PluginSettings> retSettings(this);
+        PLD(retSettings).setString(settings);
+        retSettings.send(m_cmdIn.get());
+    }
+}
+
 void Worker::handleMessage(std::shared_ptr<Message<SetPluginSettings>> msg) {
     traceScope();
-    if (auto proc = m_audio->getProcessor(pPLD(msg).getNumber())) {
-        Message<PluginSettings> msgSettings(this);
-        if (!msgSettings.read(m_cmdIn.get())) {
-            logln("failed to read PluginSettings message");
-            m_cmdIn->close();
+    Message<PluginSettings> msgSettings(this);
+    if (!msgSettings.read(m_cmdIn.get())) {
+        logln("failed to read PluginSettings message");
+        m_cmdIn->close();
+        return;
+    }
+    setPluginSettings(pPLD(msg).getNumber(), PLD(msgSettings).getString());
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<GetPluginSettingsChunk>> msg) {
+    traceScope();
+    int idx = pDATA(msg)->idx;
+    int transfer = pDATA(msg)->transfer;
+    int seq = pDATA(msg)->seq;
+    Message<PluginSettingsChunk> ret(this);
+    if (!m_settingsTransfers.getChunk(transfer, idx, seq, PLD(ret))) {
+        logln("error: no settings chunk " << seq << " of transfer " << transfer << " for idx " << idx);
+        PLD(ret).setChunk(idx, transfer, seq, 0, nullptr, 0);
+    }
+    ret.send(m_cmdIn.get());
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<PluginSettingsChunk>> msg) {
+    traceScope();
+    if (!pPLD(msg).isValid()) {
+        logln("error: invalid settings chunk");
+        return;
+    }
+    String settings, err;
+    switch (m_settingsTransfers.addIncoming(pPLD(msg), settings, err)) {
+        case SettingsTransfers::COMPLETE:
+            setPluginSettings(pPLD(msg).hdr->idx, settings);
+            break;
+        case SettingsTransfers::FAILED:
+            logln("error: " << err);
+            sendError("failed to set plugin settings: " + err);
+            break;
+        case SettingsTransfers::PENDING:
+            break;
+    }
+}
+
+void Worker::setPluginSettings(int idx, const String& settings) {
+    traceScope();
+    if (settings.isEmpty()) {
+        logln("warning: empty settings for idx " << idx);
+        return;
+    }
+    {
+        // a plugin, that is loading in the background, gets the settings as soon as it has been loaded
+        std::lock_guard<std::mutex> lock(m_settingsPendingMtx);
+        if (auto proc = m_audio->getLoadingProcessor(idx)) {
+            logln("plugin " << idx << " is still loading, setting the state later");
+            m_settingsPending[proc] = settings;
             return;
         }
-        auto settings = PLD(msgSettings).getString();
-        if (settings.length() > 0) {
-            proc->setStateInformation(settings);
-        } else {
-            logln("warning: empty settings message");
+    }
+    if (auto proc = m_audio->getProcessor(idx)) {
+        proc->setStateInformation(settings);
+    } else {
+        logln("error: failed to set plugin settings: invalid index " << idx);
+        sendError("failed to set plugin settings: invalid index " + String(idx));
+    }
+}
+
+void Worker::applyPendingSettings(std::shared_ptr<Processor> proc, bool loaded) {
+    traceScope();
+    String settings;
+    {
+        std::lock_guard<std::mutex> lock(m_settingsPendingMtx);
+        auto it = m_settingsPending.find(proc);
+        if (it == m_settingsPending.end()) {
+            return;
+        }
+        settings = it->second;
+        m_settingsPending.erase(it);
+    }
+    if (loaded) {
+        proc->setStateInformation(settings);
+    } else {
+        logln("error: dropping the settings of a plugin, that failed to load");
+    }
+}
+
+bool Worker::readSettingsChunks(int numChunks, String& settings) {
+    traceScope();
+    if (numChunks > PluginSettingsChunk::MAX_CHUNKS) {
+        logln("too many settings chunks: " << numChunks);
+        return false;
+    }
+    MemoryBlock block;
+    for (int i = 0; i < numChunks; i++) {
+        Message<PluginSettingsChunk> msg(this);
+        MessageHelper::Error err;
+        if (!msg.read(m_cmdIn.get(), &err)) {
+            logln("failed to read settings chunk " << i << ": " << err.toString());
+            return false;
+        }
+        if (!PLD(msg).isValid() || PLD(msg).hdr->seq != i || PLD(msg).hdr->total != numChunks) {
+            logln("invalid settings chunk " << i << "/" << numChunks);
+            return false;
         }
+        block.append(PLD(msg).data, (size_t)PLD(msg).hdr->size);
     }
+    if (!PluginSettingsChunk::decompress(block, settings)) {
+        logln("settings exceed the size limit");
+        return false;
+    }
+    return true;
 }
 
 void Worker::handleMessage(std::shared_ptr<Message<BypassPlugin>> msg) {
@@ -591,6 +1015,17 @@ void Worker::handleMessage(std::shared_ptr<Message<PluginList>> msg) {
 
     auto srv = getApp()->getServer();
 
+    // the list only depends on the channel config, so it can be reused for other clients
+    String payloadKey;
+    payloadKey << m_cfg.channelsIn << ":" << m_cfg.channelsOut << ":" << (int)m_noPluginListFilter;
+
+    MemoryBlock payload;
+    if (nullptr != srv && srv->getPluginListPayload(payloadKey, payload)) {
+        pPLD(msg).setData((const char*)payload.getData(), (int)payload.getSize());
+        msg->send(m_cmdIn.get());
+        return;
+    }
+
     if (nullptr != srv) {
         bool isFxChain = m_cfg.channelsIn > 0;
 
@@ -602,7 +1037,7 @@ void Worker::handleMessage(std::shared_ptr<Message<PluginList>> msg) {
             bool hasMono = false;
 
             // add layouts, that match the number of output channels
-            auto& layouts = srv->getPluginLayouts(pluginId);
+            auto layouts = srv->getPluginLayouts(pluginId);
             StringArray slayouts;
             for (auto& l : layouts) {
                 int chIn = getLayoutNumChannels(l, true);
@@ -670,6 +1105,9 @@ void Worker::handleMessage(std::shared_ptr<Message<PluginList>> msg) {
     }
 
     pPLD(msg).setJson({{"plugins", jlist}});
+    if (nullptr != srv) {
+        srv->setPluginListPayload(payloadKey, MemoryBlock(pPLD(msg).data, (size_t)*pPLD(msg).size));
+    }
     msg->send(m_cmdIn.get());
 }
 
@@ -715,6 +1153,29 @@ void Worker::handleMessage(std::shared_ptr<Message<SetMonoChannels>> msg) {
     }
 }
 
+void Worker::handleMessage(std::shared_ptr<Message<Reconfigure>> msg) {
+    traceScope();
+    auto j = pPLD(msg).getJson();
+    auto sampleRate = jsonGetValue(j, "sampleRate", 0.0);
+    auto samplesPerBlock = jsonGetValue(j, "samplesPerBlock", 0);
+    if (sampleRate <= 0.0 || samplesPerBlock <= 0) {
+        logln("invalid reconfigure request: " << j.dump());
+        m_msgFactory.sendResult(m_cmdIn.get(), -1);
+        return;
+    }
+    m_audio->reconfigure(sampleRate, samplesPerBlock);
+    m_cfg.sampleRate = sampleRate;
+    m_cfg.samplesPerBlock = samplesPerBlock;
+    m_msgFactory.sendResult(m_cmdIn.get(), m_audio->getLatencySamples());
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<SetAuxBuses>> msg) {
+    traceScope();
+    auto j = pPLD(msg).getJson();
+    m_audio->setAuxBuses(jsonGetValue(j, "send", String()), jsonGetValue(j, "sendLevel", 1.0f),
+                         jsonGetValue(j, "receive", String()));
+}
+
 void Worker::sendKeys(const std::vector<uint16_t>& keysToPress) {
     Message<Key> msg(this);
     PLD(msg).setData(reinterpret_cast<const char*>(keysToPress.data()),
@@ -893,6 +1354,35 @@ void Worker::sendStatusChange(int idx, bool ok, const String& err) {
     msg.send(m_cmdOut.get());
 }
 
+void Worker::sendPluginLoaded(std::shared_ptr<Processor> proc, int idx, bool success, const String& err,
+                              const String& id, const String& layout, bool wasSidechainDisabled) {
+    traceScope();
+    applyPendingSettings(proc, success && idx > -1);
+    if (idx < 0) {
+        return;
+    }
+    json jresult;
+    jresult["idx"] = idx;
+    jresult["success"] = success;
+    jresult["err"] = err.toStdString();
+    if (success) {
+        addPluginInfo(jresult, proc, wasSidechainDisabled);
+        jresult["presets"] = getPresets(proc).toStdString();
+        jresult["parameters"] = proc->getParameters();
+        setProcessorCallbacks(proc);
+    }
+    logln("sending plugin loaded (index=" << idx << ", success=" << (int)success << ", err=" << err << ")");
+    Message<PluginLoaded> msg(this);
+    PLD(msg).setJson(jresult);
+    {
+        std::lock_guard<std::mutex> lock(m_cmdOutMtx);
+        msg.send(m_cmdOut.get());
+    }
+    if (success) {
+        addToRecents(id, layout);
+    }
+}
+
 void Worker::sendHideEditor(int idx) {
     logln("sending hide editor (index=" << idx << ")");
     Message<HidePlugin> msg(this);
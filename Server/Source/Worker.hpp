@@ -10,11 +10,14 @@
 
 #include <JuceHeader.h>
 #include <thread>
+#include <unordered_map>
+#include <condition_variable>
 
 #include "AudioWorker.hpp"
 #include "Message.hpp"
 #include "ScreenWorker.hpp"
 #include "Utils.hpp"
+#include "SettingsTransfers.hpp"
 
 namespace e47 {
 
@@ -32,15 +35,34 @@ class Worker : public Thread, public LogTag {
 
     void shutdown();
 
+    // A session survives a disconnect of the client for the grace period, so that the client can resume it without
+    // reloading the chain
+    void setSession(uint64 token, int graceSecs) {
+        m_sessionToken = token;
+        m_sessionGraceSecs = graceSecs;
+    }
+    uint64 getSessionToken() const { return m_sessionToken; }
+
+    // Reserves the session for a new connection of the same client, fails if the config has changed
+    bool claimSession(uint64 token, const HandshakeRequest& cfg);
+
+    // Closes the old connection of a claimed session, if the client noticed the disconnect before we did, and hands
+    // the new connection to the worker. This waits for the worker to detach, so don't call it on the accept thread.
+    bool resume(std::shared_ptr<StreamingSocket> masterSocket);
+
     void handleMessage(std::shared_ptr<Message<Quit>> msg);
     void handleMessage(std::shared_ptr<Message<AddPlugin>> msg);
+    void handleMessage(std::shared_ptr<Message<RestorePlugins>> msg);
     void handleMessage(std::shared_ptr<Message<DelPlugin>> msg);
     void handleMessage(std::shared_ptr<Message<EditPlugin>> msg);
     void handleMessage(std::shared_ptr<Message<HidePlugin>> msg, bool fromMaster = false);
     void handleMessage(std::shared_ptr<Message<Mouse>> msg);
     void handleMessage(std::shared_ptr<Message<Key>> msg);
     void handleMessage(std::shared_ptr<Message<GetPluginSettings>> msg);
+    void handleMessage(std::shared_ptr<Message<GetPluginSettingsIfChanged>> msg);
     void handleMessage(std::shared_ptr<Message<SetPluginSettings>> msg);
+    void handleMessage(std::shared_ptr<Message<GetPluginSettingsChunk>> msg);
+    void handleMessage(std::shared_ptr<Message<PluginSettingsChunk>> msg);
     void handleMessage(std::shared_ptr<Message<BypassPlugin>> msg);
     void handleMessage(std::shared_ptr<Message<UnbypassPlugin>> msg);
     void handleMessage(std::shared_ptr<Message<ExchangePlugins>> msg);
@@ -57,6 +79,8 @@ class Worker : public Thread, public LogTag {
     void handleMessage(std::shared_ptr<Message<GetScreenBounds>> msg);
     void handleMessage(std::shared_ptr<Message<Clipboard>> msg);
     void handleMessage(std::shared_ptr<Message<SetMonoChannels>> msg);
+    void handleMessage(std::shared_ptr<Message<Reconfigure>> msg);
+    void handleMessage(std::shared_ptr<Message<SetAuxBuses>> msg);
 
   private:
     std::shared_ptr<StreamingSocket> m_masterSocket;
@@ -71,6 +95,18 @@ class Worker : public Thread, public LogTag {
     bool m_noPluginListFilter = false;
     int m_sandboxModeRuntime = 0;
 
+    uint64 m_sessionToken = 0;
+    int m_sessionGraceSecs = 0;
+    bool m_detached = false;
+    bool m_resuming = false;
+    std::mutex m_sessionMtx;
+    std::condition_variable m_sessionCv;
+
+    SettingsTransfers m_settingsTransfers;
+    // Settings for plugins, that are loading in the background
+    std::unordered_map<std::shared_ptr<Processor>, String> m_settingsPending;
+    std::mutex m_settingsPendingMtx;
+
     struct KeyWatcher : KeyListener {
         Worker* worker;
         KeyWatcher(Worker* w) : worker(w) {}
@@ -99,11 +135,29 @@ class Worker : public Thread, public LogTag {
     std::unique_ptr<KeyWatcher> m_keyWatcher;
     std::unique_ptr<ClipboardTracker> m_clipboardTracker;
 
+    bool connectClient(bool resumed);
+    void processMessages();
+    void disconnectClient();
+    bool waitForResume();
+
+    // Plugins on other servers make this server connect to them, see Server::isChainHopAllowed
+    bool isChainHopAllowed(const String& host, String& err);
+
+    void addPluginInfo(json& jresult, std::shared_ptr<Processor> proc, bool wasSidechainDisabled);
+    String getPresets(std::shared_ptr<Processor> proc);
+    void setProcessorCallbacks(std::shared_ptr<Processor> proc);
+    void addToRecents(const String& id, const String& layout);
+    bool readSettingsChunks(int numChunks, String& settings);
+    void setPluginSettings(int idx, const String& settings);
+    void applyPendingSettings(std::shared_ptr<Processor> proc, bool loaded);
+
     void sendKeys(const std::vector<uint16_t>& keysToPress);
     void sendClipboard(const String& val);
     void sendParamValueChange(int idx, int channel, int paramIdx, float val);
     void sendParamGestureChange(int idx, int channel, int paramIdx, bool guestureIsStarting);
     void sendStatusChange(int idx, bool ok, const String& err);
+    void sendPluginLoaded(std::shared_ptr<Processor> proc, int idx, bool success, const String& err, const String& id,
+                          const String& layout, bool wasSidechainDisabled);
     void sendHideEditor(int idx);
     void sendError(const String& error);
 
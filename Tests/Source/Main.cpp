@@ -14,11 +14,27 @@
 #include "Server/ScanPluginsTest.hpp"
 #include "Server/ProcessorChainTest.hpp"
 #include "Server/SandboxPluginTest.hpp"
+#include "Server/SandboxStartupTest.hpp"
+#include "Server/SandboxRecoveryTest.hpp"
 #include "Server/MultiMonoTest.hpp"
+#include "Server/AuxBusTest.hpp"
+#include "Server/PluginPoolTest.hpp"
+#include "Server/LayoutCacheTest.hpp"
+#include "Server/SandboxCGroupsTest.hpp"
+#include "Server/BatchProcessorTest.hpp"
+#include "Server/ReconfigureTest.hpp"
+#include "Server/SessionResumeTest.hpp"
+#include "Server/ChainHopTest.hpp"
+#include "Server/LowLatencyWaitTest.hpp"
+#include "Server/PluginSettingsTest.hpp"
+#include "Server/SandboxPoolTest.hpp"
 #endif
 
 #ifdef AG_UNIT_TEST_PLUGIN_FX
 #include "Plugin/AudioStreamerTest.hpp"
+#include "Plugin/AudioConcealerTest.hpp"
+#include "Plugin/ServerSelectionTest.hpp"
+#include "Plugin/MigrationTest.hpp"
 #endif
 
 namespace e47 {
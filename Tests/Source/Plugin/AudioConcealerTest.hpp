@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _AUDIOCONCEALERTEST_HPP_
+#define _AUDIOCONCEALERTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "AudioConcealer.hpp"
+
+namespace e47 {
+
+class AudioConcealerTest : UnitTest {
+  public:
+    AudioConcealerTest() : UnitTest("AudioConcealer") {}
+
+    void runTest() override {
+        double sampleRate = 48000;
+        int blockSize = 64;
+
+        beginTest("Dry");
+        {
+            AudioConcealer<float> c;
+            c.prepare(1, sampleRate, blockSize, blockSize * 2);
+            AudioBuffer<float> buf(1, blockSize);
+            for (int i = 1; i <= 4; i++) {
+                for (int s = 0; s < blockSize; s++) {
+                    buf.setSample(0, s, (float)i);
+                }
+                c.pushInput(buf);
+            }
+            c.conceal(buf, CONCEAL_DRY, blockSize * 2);
+            expectEquals(buf.getSample(0, 0), 2.0f, "Dry signal is not latency matched");
+            expectEquals(buf.getSample(0, blockSize - 1), 2.0f, "Dry signal is not latency matched");
+        }
+
+        beginTest("Extrapolate");
+        {
+            int period = 100;
+            auto sine = [&](int pos) { return (float)std::sin(MathConstants<double>::twoPi * pos / period); };
+
+            AudioConcealer<float> c;
+            c.prepare(1, sampleRate, blockSize, 0);
+            AudioBuffer<float> buf(1, blockSize);
+            int pos = 0;
+            for (int i = 0; i < 40; i++) {
+                for (int s = 0; s < blockSize; s++) {
+                    buf.setSample(0, s, sine(pos++));
+                }
+                c.received(buf, 0);
+            }
+            c.conceal(buf, CONCEAL_EXTRAPOLATE, 0);
+            float maxErr = 0.0f;
+            for (int s = 0; s < blockSize; s++) {
+                maxErr = jmax(maxErr, std::abs(buf.getSample(0, s) - sine(pos++)));
+            }
+            expectLessThan(maxErr, 0.05f, "Extrapolated signal does not continue the waveform");
+        }
+
+        beginTest("Extrapolate multichannel");
+        {
+            // the period search only looks at the front channels
+            int period = 100, otherPeriod = 77;
+            auto sine = [&](int pos, int p) { return (float)std::sin(MathConstants<double>::twoPi * pos / p); };
+
+            AudioConcealer<float> c;
+            c.prepare(6, sampleRate, blockSize, 0);
+            AudioBuffer<float> buf(6, blockSize);
+            int pos = 0;
+            for (int i = 0; i < 40; i++) {
+                for (int s = 0; s < blockSize; s++, pos++) {
+                    for (int ch = 0; ch < buf.getNumChannels(); ch++) {
+                        buf.setSample(ch, s, sine(pos, ch < 2 ? period : otherPeriod));
+                    }
+                }
+                c.received(buf, 0);
+            }
+            c.conceal(buf, CONCEAL_EXTRAPOLATE, 0);
+            float maxErr = 0.0f;
+            for (int s = 0; s < blockSize; s++) {
+                maxErr = jmax(maxErr, std::abs(buf.getSample(0, s) - sine(pos++, period)));
+            }
+            expectLessThan(maxErr, 0.05f, "Extrapolated signal does not continue the waveform of the front channels");
+        }
+
+        beginTest("Fade out");
+        {
+            AudioConcealer<float> c;
+            c.prepare(1, sampleRate, blockSize, 0);
+            AudioBuffer<float> buf(1, blockSize);
+            for (int s = 0; s < blockSize; s++) {
+                buf.setSample(0, s, 0.5f);
+            }
+            c.received(buf, 0);
+            c.conceal(buf, CONCEAL_REPEAT, 0);
+            expectEquals(buf.getSample(0, 0), 0.5f, "Block is not repeated");
+            for (int i = 0; i < 100; i++) {
+                c.conceal(buf, CONCEAL_REPEAT, 0);
+            }
+            expectEquals(buf.getMagnitude(0, blockSize), 0.0f, "Repeated block does not fade out");
+        }
+    }
+};
+
+static AudioConcealerTest audioConcealerTest;
+
+}  // namespace e47
+
+#endif  // _AUDIOCONCEALERTEST_HPP_
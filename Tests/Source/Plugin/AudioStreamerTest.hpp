@@ -49,6 +49,7 @@ class AudioStreamerTest : public UnitTest {
                                 if (workerMasterSocket->createListener(socketPath)) {
                                     HandshakeResponse resp = {AG_PROTOCOL_VERSION, 0, 0};
                                     resp.setFlag(HandshakeResponse::LOCAL_MODE);
+                                    resp.setFlag(HandshakeResponse::OFFLINE_RENDER);
                                     resp.port = workerPort;
                                     send(clnt, (const char*)&resp, sizeof(resp));
 
@@ -189,6 +190,24 @@ class AudioStreamerTest : public UnitTest {
         sendReadAndCheck(0.0f, 0.0f, 384);  // 1024
         sendReadAndCheck(0.0f, 1.0f, 128);
 
+        beginTest("Send + Receive - Offline render");
+
+        // blocks get pipelined, but the latency has to stay the same
+        proc.setNonRealtime(true);
+
+        sendReadAndCheck(1.0f, 0.0f, blockSize);  // 512
+        sendReadAndCheck(0.0f, 0.0f, blockSize);  // 1024
+        sendReadAndCheck(0.0f, 1.0f, blockSize);
+        for (int i = 0; i < 100; i++) {
+            sendReadAndCheck((float)(i + 1), i < 2 ? 0.0f : (float)(i - 1), blockSize);
+        }
+
+        proc.setNonRealtime(false);
+
+        sendReadAndCheck(1.0f, 99.0f, blockSize);
+        sendReadAndCheck(0.0f, 100.0f, blockSize);
+        sendReadAndCheck(0.0f, 1.0f, blockSize);
+
         proc.releaseResources();
 
         mock.stopThread(-1);
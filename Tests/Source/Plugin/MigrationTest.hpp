@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _MIGRATIONTEST_HPP_
+#define _MIGRATIONTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "TestsHelper.hpp"
+#include "PluginProcessor.hpp"
+
+namespace e47 {
+
+class MigrationTest : UnitTest {
+  public:
+    MigrationTest() : UnitTest("Migration") {}
+
+    void runTest() override {
+        beginTest("Crossfade");
+        {
+            int blockSize = 64, fadeSamples = 160;
+            AudioBuffer<float> buf(2, blockSize), target(2, blockSize);
+            int fadePos = 0, blocks = 0;
+            float last = 0.0f;
+            bool done = false;
+            while (!done && blocks < 10) {
+                setBufferSamples(buf, 0.0f);
+                setBufferSamples(target, 1.0f);
+                done = PluginProcessor::crossfade(buf, target, fadePos, fadeSamples);
+                blocks++;
+                // the target fades in continuously across the block boundaries
+                for (int s = 0; s < blockSize; s++) {
+                    auto v = buf.getSample(0, s);
+                    expect(v >= last && v <= 1.0f, "The fade is not monotonic");
+                    expectEquals(buf.getSample(1, s), v, "The channels fade differently");
+                    last = v;
+                }
+            }
+            expect(done, "The fade did not finish");
+            expectEquals(blocks, 3, "The fade took the wrong number of blocks");
+            expectEquals(buf.getSample(0, blockSize - 1), 1.0f);
+            expectEquals(fadePos, blocks * blockSize);
+        }
+
+        beginTest("Crossfade (double)");
+        {
+            AudioBuffer<double> buf(1, 100), target(1, 100);
+            setBufferSamples(buf, 1.0);
+            setBufferSamples(target, 0.0);
+            int fadePos = 0;
+            expect(PluginProcessor::crossfade(buf, target, fadePos, 100));
+            expectEquals(buf.getSample(0, 0), 1.0);
+            expectWithinAbsoluteError(buf.getSample(0, 50), 0.5, 0.0001);
+        }
+
+        PluginProcessor proc(AudioProcessor::wrapperType_Undefined);
+        auto& client = proc.getClient();
+
+        beginTest("State machine");
+        {
+            expectEquals(client.getMigrationState(), (int)Client::MIGRATE_NONE);
+            expect(!client.isMigrating());
+
+            // only a pending switch can be completed by the audio thread
+            client.setMigrationSwitched();
+            expectEquals(client.getMigrationState(), (int)Client::MIGRATE_NONE);
+
+            client.setMigrationState(Client::MIGRATE_PREROLL);
+            expect(client.isMigrating());
+            client.setMigrationSwitched();
+            expectEquals(client.getMigrationState(), (int)Client::MIGRATE_PREROLL, "Switched during the preroll");
+
+            client.setMigrationState(Client::MIGRATE_SWITCH);
+            client.setMigrationSwitched();
+            expectEquals(client.getMigrationState(), (int)Client::MIGRATE_DONE);
+            client.setMigrationSwitched();
+            expectEquals(client.getMigrationState(), (int)Client::MIGRATE_DONE);
+
+            client.setMigrationState(Client::MIGRATE_NONE);
+            expect(!client.isMigrating());
+        }
+
+        beginTest("Retired streamers");
+        {
+            // the audio thread still holds the streamer, it must not be released yet
+            auto inUse = std::make_shared<int>(1);
+            std::weak_ptr<int> weak = inUse;
+            client.retireStreamer(inUse);
+            client.releaseRetiredStreamers();
+            expect(!weak.expired(), "A streamer in use has been released");
+
+            inUse.reset();
+            expect(!weak.expired(), "The streamer has been destroyed by the last user");
+            client.releaseRetiredStreamers();
+            expect(weak.expired(), "The streamer has not been released");
+
+            client.retireStreamer(nullptr);
+            client.releaseRetiredStreamers();
+        }
+    }
+};
+
+static MigrationTest migrationTest;
+
+}  // namespace e47
+
+#endif  // _MIGRATIONTEST_HPP_
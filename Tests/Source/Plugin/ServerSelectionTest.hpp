@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _SERVERSELECTIONTEST_HPP_
+#define _SERVERSELECTIONTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "Utils.hpp"
+#include "Client.hpp"
+
+namespace e47 {
+
+class ServerSelectionTest : UnitTest {
+  public:
+    ServerSelectionTest() : UnitTest("ServerSelection") {}
+
+    void runTest() override {
+        beginTest("Order");
+        {
+            auto a = server("a", 10.0f, 3, 0);
+            auto b = server("b", 11.0f, 1, 0);
+            auto c = server("c", 30.0f, 0, 0);
+            auto d = server("d", 0.0f, 0, 5);
+            // same bucket, fewer clients win
+            expectEquals(Client::compareServerLoad(b, a), -1);
+            // a lower bucket wins over fewer clients
+            expectEquals(Client::compareServerLoad(a, c), -1);
+            // deadline misses go last
+            expectEquals(Client::compareServerLoad(c, d), -1);
+            expectEquals(Client::compareServerLoad(a, a), 0);
+        }
+
+        beginTest("Transitivity");
+        {
+            // loads within 5% of their neighbours used to chain up into a cycle
+            Array<ServerInfo> servers;
+            Random rnd(4711);
+            for (int i = 0; i < 40; i++) {
+                int misses = rnd.nextInt(10) < 2 ? 1 : 0;
+                servers.add(server("s" + String(i), rnd.nextFloat() * 20.0f, rnd.nextInt(4), misses));
+            }
+            int violations = 0;
+            for (auto& x : servers) {
+                for (auto& y : servers) {
+                    expectEquals(Client::compareServerLoad(x, y), -Client::compareServerLoad(y, x));
+                    for (auto& z : servers) {
+                        if (Client::compareServerLoad(x, y) < 0 && Client::compareServerLoad(y, z) < 0 &&
+                            Client::compareServerLoad(x, z) >= 0) {
+                            violations++;
+                        }
+                    }
+                }
+            }
+            expectEquals(violations, 0, "The order is not transitive");
+        }
+
+        beginTest("Sort");
+        {
+            Array<ServerInfo> servers = {server("a", 1.0f, 2, 0), server("b", 4.0f, 0, 0), server("c", 8.0f, 0, 0),
+                                         server("d", 2.0f, 1, 0)};
+            struct Comp {
+                static int compareElements(const ServerInfo& lhs, const ServerInfo& rhs) {
+                    return Client::compareServerLoad(lhs, rhs);
+                }
+            } comp;
+            servers.sort(comp, true);
+            expectEquals(servers[0].getName(), String("b"));
+            expectEquals(servers[1].getName(), String("d"));
+            expectEquals(servers[2].getName(), String("a"));
+            expectEquals(servers[3].getName(), String("c"));
+        }
+
+        beginTest("Rtt");
+        {
+            // the rtt comes from the reachable checks, the stats of an mDNS answer must not reset it
+            auto a = server("a", 1.0f, 0, 0);
+            expectLessThan(a.getRttMs(), 0.0);
+            a.setRttMs(0.5);
+            ServerInfo copy = a;
+            expectWithinAbsoluteError(copy.getRttMs(), 0.5, 0.0001);
+            auto answer = server("a", 2.0f, 1, 0);
+            copy.refresh(answer);
+            expectWithinAbsoluteError(copy.getRttMs(), 0.5, 0.0001, "An mDNS answer reset the rtt");
+            expectEquals(copy.getClients(), 1);
+        }
+    }
+
+    static ServerInfo server(const String& name, float load, int clients, int deadlineMisses) {
+        ServerInfo s("127.0.0.1", name, false, 1, Uuid(), load, false);
+        s.setClients(clients);
+        s.setDeadlineMisses(deadlineMisses);
+        return s;
+    }
+};
+
+static ServerSelectionTest serverSelectionTest;
+
+}  // namespace e47
+
+#endif  // _SERVERSELECTIONTEST_HPP_
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _AUXBUSTEST_HPP_
+#define _AUXBUSTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "AuxBus.hpp"
+
+namespace e47 {
+
+class AuxBusTest : UnitTest {
+  public:
+    AuxBusTest() : UnitTest("AuxBus") {}
+
+    void runTest() override {
+        int blockSize = 64;
+        double sampleRate = 48000.0;
+
+        // buses live as long as they are referenced, keep the registrations across the tests
+        auto testBus = AuxBus::getBus("test");
+
+        beginTest("Mix");
+        {
+            auto bus = AuxBus::getBus("test");
+            expect(bus == AuxBus::getBus("test"), "Bus is not shared");
+            expect(bus->addReceiver(100, blockSize, sampleRate));
+            expect(bus->addSender(1, 2, blockSize, sampleRate));
+            expect(bus->addSender(2, 1, blockSize, sampleRate));
+
+            AudioBuffer<float> a(2, blockSize), b(1, blockSize), out(2, blockSize);
+            fill(a, 0.25f);
+            fill(b, 0.5f);
+            bus->send(1, a, 2, 1.0f);
+            bus->send(2, b, 1, 0.5f);
+
+            fill(out, 0.1f);
+            bus->receive(100, out, 2);
+            // the mono sender feeds both channels
+            expectBuffer(out, 0.1f + 0.25f + 0.25f);
+
+            // nothing has been sent since, the input stays untouched
+            fill(out, 0.1f);
+            bus->receive(100, out, 2);
+            expectBuffer(out, 0.1f);
+        }
+
+        beginTest("Unregistered");
+        {
+            auto bus = AuxBus::getBus("test");
+            AudioBuffer<float> in(2, blockSize), out(2, blockSize);
+            fill(in, 1.0f);
+            // senders have to be registered up front, the audio thread must not allocate their FIFOs
+            bus->send(3, in, 2, 1.0f);
+            out.clear();
+            bus->receive(100, out, 2);
+            expectBuffer(out, 0.0f);
+
+            bus->send(1, in, 2, 1.0f);
+            out.clear();
+            bus->receive(101, out, 2);
+            expectBuffer(out, 0.0f);
+        }
+
+        beginTest("Sample rate");
+        {
+            auto bus = AuxBus::getBus("test");
+            expect(!bus->addSender(4, 2, blockSize, 44100.0), "Sender with a different sample rate accepted");
+            expect(!bus->addReceiver(101, blockSize, 44100.0), "Receiver with a different sample rate accepted");
+
+            // the only client of a bus can change its rate
+            auto other = AuxBus::getBus("test-rate");
+            expect(other->addSender(1, 2, blockSize, sampleRate));
+            expect(other->addSender(1, 2, blockSize, 44100.0));
+            expect(other->addReceiver(100, blockSize, 44100.0));
+        }
+
+        beginTest("Latency");
+        {
+            auto bus = AuxBus::getBus("test-latency");
+            expect(bus->addReceiver(100, blockSize, sampleRate));
+            expect(bus->addSender(1, 2, blockSize, sampleRate));
+            AudioBuffer<double> in(2, blockSize), out(2, blockSize);
+            // a sender running ahead must not add more than a few blocks of latency
+            for (int i = 0; i < 10; i++) {
+                fill(in, (double)i);
+                bus->send(1, in, 2, 1.0f);
+            }
+            out.clear();
+            bus->receive(100, out, 2);
+            expectBuffer(out, 8.0);
+        }
+
+        beginTest("Receiver block size");
+        {
+            // the receiver processes larger blocks than the sender, the FIFO has to hold enough of them
+            int readerBlockSize = blockSize * 16;
+            auto bus = AuxBus::getBus("test-blocksize");
+            expect(bus->addSender(1, 1, blockSize, sampleRate));
+            expect(bus->addReceiver(100, readerBlockSize, sampleRate));
+            AudioBuffer<float> in(1, blockSize), out(1, readerBlockSize);
+            for (int i = 0; i < 16; i++) {
+                fill(in, (float)i);
+                bus->send(1, in, 1, 1.0f);
+            }
+            auto underruns = bus->getUnderruns();
+            out.clear();
+            bus->receive(100, out, 1);
+            expectEquals((int)(bus->getUnderruns() - underruns), 0);
+            for (int i = 0; i < readerBlockSize; i += blockSize) {
+                expectWithinAbsoluteError(out.getSample(0, i), (float)(i / blockSize), 0.0001f);
+            }
+        }
+
+        beginTest("Multiple receivers");
+        {
+            auto bus = AuxBus::getBus("test-receivers");
+            expect(bus->addSender(1, 2, blockSize, sampleRate));
+            expect(bus->addReceiver(100, blockSize, sampleRate));
+            expect(bus->addReceiver(101, blockSize, sampleRate));
+            AudioBuffer<float> in(2, blockSize), out(2, blockSize);
+            fill(in, 0.5f);
+            bus->send(1, in, 2, 1.0f);
+            // every receiver gets the full signal
+            out.clear();
+            bus->receive(100, out, 2);
+            expectBuffer(out, 0.5f);
+            out.clear();
+            bus->receive(101, out, 2);
+            expectBuffer(out, 0.5f);
+
+            bus->removeReceiver(101);
+            bus->send(1, in, 2, 1.0f);
+            out.clear();
+            bus->receive(101, out, 2);
+            expectBuffer(out, 0.0f);
+        }
+
+        beginTest("Remove sender");
+        {
+            auto bus = AuxBus::getBus("test");
+            AudioBuffer<float> in(2, blockSize), out(2, blockSize);
+            fill(in, 1.0f);
+            bus->send(1, in, 2, 1.0f);
+            bus->removeSender(1);
+            out.clear();
+            bus->receive(100, out, 2);
+            expectBuffer(out, 0.0f);
+        }
+    }
+
+  private:
+    template <typename T>
+    void fill(AudioBuffer<T>& buf, T val) {
+        for (int ch = 0; ch < buf.getNumChannels(); ch++) {
+            FloatVectorOperations::fill(buf.getWritePointer(ch), val, buf.getNumSamples());
+        }
+    }
+
+    template <typename T>
+    void expectBuffer(const AudioBuffer<T>& buf, T val) {
+        for (int ch = 0; ch < buf.getNumChannels(); ch++) {
+            for (int i = 0; i < buf.getNumSamples(); i++) {
+                if (std::abs(buf.getSample(ch, i) - val) > (T)0.0001) {
+                    expect(false, "Sample " + String(i) + " of channel " + String(ch) + " is " +
+                                      String(buf.getSample(ch, i)) + ", expected " + String(val));
+                    return;
+                }
+            }
+        }
+    }
+};
+
+static AuxBusTest auxBusTest;
+
+}  // namespace e47
+
+#endif  // _AUXBUSTEST_HPP_
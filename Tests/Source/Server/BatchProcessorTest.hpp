@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _BATCHPROCESSORTEST_HPP_
+#define _BATCHPROCESSORTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "Server.hpp"
+#include "Processor.hpp"
+#include "BatchProcessor.hpp"
+#include "LayoutCache.hpp"
+#include "Defaults.hpp"
+
+namespace e47 {
+
+class BatchProcessorTest : UnitTest {
+  public:
+    BatchProcessorTest() : UnitTest("BatchProcessor") {}
+
+    void runTest() override {
+        KnownPluginList pl;
+        json playouts;
+        Server::loadKnownPluginList(pl, playouts, 999);
+
+        if (pl.getNumTypes() == 0) {
+            logMessage("No plugins available, skipping");
+            return;
+        }
+
+        auto desc = pl.getTypes()[0];
+        auto id = Processor::createPluginID(desc);
+
+        auto dir = File::getSpecialLocation(File::tempDirectory).getChildFile("agbatchtest-" + Uuid().toString());
+        dir.createDirectory();
+        auto in = dir.getChildFile("in.wav");
+        auto outDir = dir.getChildFile("out");
+        const int channels = 2, length = 48000 + 100;
+
+        expect(writeSine(in, channels, length), "Failed to write the input file");
+
+        beginTest("Arguments");
+        {
+            expectEquals(BatchProcessor::runBatchProcess(999, StringArray("-batch", in.getFullPathName())), 1,
+                         "No plugin given");
+            expectEquals(BatchProcessor::runBatchProcess(999, StringArray("-batch", "-plugin", id)), 1,
+                         "No file given");
+            expectEquals(BatchProcessor::runBatchProcess(999, StringArray("-batch", "-plugin", id, "-suffix", "",
+                                                                          in.getFullPathName())),
+                         1, "Input files would be replaced");
+        }
+
+        beginTest("Process");
+        {
+            auto ret = BatchProcessor::runBatchProcess(
+                999, StringArray("-batch", "-plugin", id, "-outdir", outDir.getFullPathName(), "-notail", "-jobs", "1",
+                                 in.getFullPathName()));
+            expectEquals(ret, 0, "Batch processing failed");
+
+            AudioFormatManager formats;
+            formats.registerBasicFormats();
+            std::unique_ptr<AudioFormatReader> reader(
+                formats.createReaderFor(outDir.getChildFile("in-processed.wav")));
+            expect(nullptr != reader, "No output file");
+            if (nullptr != reader) {
+                expectEquals((int)reader->numChannels, channels);
+                expectEquals((int)reader->lengthInSamples, length, "Output is not latency compensated");
+            }
+
+            // the probed layouts end up in the cache of the server
+            LayoutCache cache(
+                File(Defaults::getConfigFileName(Defaults::PluginLayoutsCache, {{"id", String(999)}})));
+            expect(cache.load() && cache.contains(id, desc.version), "Layouts have not been cached");
+        }
+
+        dir.deleteRecursively();
+    }
+
+    bool writeSine(const File& file, int channels, int length) {
+        WavAudioFormat wav;
+        auto stream = std::make_unique<FileOutputStream>(file);
+        if (stream->failedToOpen()) {
+            return false;
+        }
+        std::unique_ptr<AudioFormatWriter> writer(
+            wav.createWriterFor(stream.get(), 48000.0, (unsigned int)channels, 24, {}, 0));
+        if (nullptr == writer) {
+            return false;
+        }
+        stream.release();
+        AudioBuffer<float> buf(channels, length);
+        for (int c = 0; c < channels; c++) {
+            for (int s = 0; s < length; s++) {
+                buf.setSample(c, s, 0.5f * (float)std::sin(MathConstants<double>::twoPi * 440.0 * s / 48000.0));
+            }
+        }
+        return writer->writeFromAudioSampleBuffer(buf, 0, length);
+    }
+};
+
+static BatchProcessorTest batchProcessorTest;
+
+}  // namespace e47
+
+#endif  // _BATCHPROCESSORTEST_HPP_
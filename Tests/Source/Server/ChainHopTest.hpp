@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _CHAINHOPTEST_HPP_
+#define _CHAINHOPTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "TestsHelper.hpp"
+#include "Defaults.hpp"
+#include "Server.hpp"
+#include "SandboxHost.hpp"
+#include "Processor.hpp"
+#include "ProcessorChain.hpp"
+#include "ProcessorClient.hpp"
+#include "ChannelSet.hpp"
+#include "ServiceReceiver.hpp"
+
+#include "PluginProcessor.hpp"
+
+namespace e47 {
+
+class ChainHopTest : UnitTest {
+  public:
+    ChainHopTest() : UnitTest("Chain Hop") {}
+
+    const String remoteHost = "127.0.0.1:999";
+
+    void runTest() override {
+        runTestPolicy();
+        runTestHop();
+        runTestSandbox();
+    }
+
+    void runTestPolicy() {
+        beginTest("Policy");
+
+        String err;
+        Array<ServerInfo> discovered;
+        discovered.add(ServerInfo("192.0.2.10", "a", false, 1, Uuid(), 0.0f, false));
+
+        expect(Server::isLocalHost("127.0.0.1"));
+        expect(Server::isLocalHost("localhost"));
+        expect(!Server::isLocalHost("192.0.2.10"));
+
+        expect(Server::isChainHopAllowed(ServerInfo("192.0.2.10:1"), 0, discovered, {}, err), err);
+        expect(!Server::isChainHopAllowed(ServerInfo("192.0.2.10:2"), 0, discovered, {}, err),
+               "a server with another id has been allowed");
+        expect(!Server::isChainHopAllowed(ServerInfo("192.0.2.11"), 0, discovered, {}, err),
+               "an unknown host has been allowed");
+        expect(Server::isChainHopAllowed(ServerInfo("192.0.2.11"), 0, discovered, StringArray({"192.0.2.11"}), err),
+               err);
+        expect(!Server::isChainHopAllowed(ServerInfo("127.0.0.1:3"), 3, discovered, StringArray({"127.0.0.1:3"}), err),
+               "the server itself has been allowed");
+        expect(Server::isChainHopAllowed(ServerInfo("127.0.0.1:4"), 3, discovered, StringArray({"127.0.0.1:4"}), err),
+               "another server on the same host has been rejected: " + err);
+        expect(!Server::isChainHopAllowed(ServerInfo(""), 0, discovered, {}, err), "an empty host has been allowed");
+    }
+
+    void runTestHop() {
+        logMessage("Setting up server config");
+        auto serverConfig = Defaults::getConfigFileName(Defaults::ConfigServer, {{"id", "999"}});
+        configWriteFile(serverConfig, {{"ID", 999},
+                                       {"NAME", "Test"},
+                                       {"CrashReporting", false},
+                                       {"SandboxMode", Server::SANDBOX_NONE},
+                                       {"ScanForPlugins", false},
+                                       {"ScreenCapturingOff", true},
+                                       {"Tracer", true}});
+
+        ChildProcess server;
+        if (!startServer(server)) {
+            expect(false, "the remote server did not come up");
+            return;
+        }
+
+        double sampleRate = 48000.0;
+        int blockSize = 512, chIn = 2, chOut = 2;
+        ChannelSet activeChannels;
+        activeChannels.setNumChannels(chIn, chOut);
+        activeChannels.setRangeActive();
+        HandshakeRequest cfg = {AG_PROTOCOL_VERSION,    chIn, chOut, 0, sampleRate, blockSize, false, 0, 0, 0,
+                                activeChannels.toInt(), 0};
+
+        LogTag testTag("test");
+
+        auto pc =
+            std::make_unique<ProcessorChain>(&testTag, ProcessorChain::createBussesProperties(chIn, chOut, 0), cfg);
+        pc->setProcessingPrecision(AudioProcessor::singlePrecision);
+        pc->updateChannels(chIn, chOut, 0);
+        pc->prepareToPlay(sampleRate, blockSize);
+
+        TestsHelper::TestPlayHead phead;
+        pc->setPlayHead(&phead);
+
+        KnownPluginList pl;
+        json playouts;
+        Server::loadKnownPluginList(pl, playouts, 999);
+
+        beginTest("Latency");
+        std::shared_ptr<Processor> proc;
+        for (auto desc : pl.getTypes()) {
+            String err;
+            auto local = Processor::loadPlugin(desc, sampleRate, blockSize, err);
+            if (nullptr == local) {
+                continue;
+            }
+            int localLatency = local->getLatencySamples();
+            runOnMsgThreadSync([&] { local.reset(); });
+
+            auto p = std::make_shared<Processor>(*pc, Processor::createPluginID(desc), sampleRate, blockSize);
+            p->setRemoteHost(remoteHost);
+            expect(p->load({}, {}, 0, err, &desc), "Remote load failed: " + err);
+            if (!p->isLoaded()) {
+                continue;
+            }
+            // the remote plugin has to add its latency to the chain, as the hop is part of the block
+            expectEquals(p->getLatencySamples(), localLatency, "Wrong latency of " + desc.descriptiveName);
+            if (localLatency == 0 && nullptr == proc) {
+                proc = p;
+            } else {
+                p->unload();
+            }
+        }
+
+        if (nullptr == proc) {
+            logMessage("No plugin without latency available, skipping");
+            server.kill();
+            return;
+        }
+
+        pc->addProcessor(proc);
+        auto client = proc->getClient();
+        expect(client->isRemote());
+        client->suspendProcessingRemoteOnly(true);
+
+        AudioBuffer<float> buf(chIn, blockSize);
+        MidiBuffer midi;
+
+        beginTest("Hop");
+        {
+            setBufferSamples(buf, 0.5f);
+            pc->processBlock(buf, midi);
+            checkBufferSamples(buf, 0.5f);
+            expectEquals(pc->getLatencySamples(), 0);
+        }
+
+        beginTest("Reconnect");
+        {
+            server.kill();
+            expect(waitFor([&] {
+                       setBufferSamples(buf, 0.5f);
+                       pc->processBlock(buf, midi);
+                       return client->isRecovering();
+                   }),
+                   "The lost hop has not been detected");
+
+            // the blocks in between pass through
+            setBufferSamples(buf, 0.5f);
+            pc->processBlock(buf, midi);
+            checkBufferSamples(buf, 0.5f);
+
+            expect(startServer(server), "the remote server did not come back");
+            expect(waitFor([&] { return !client->isRecovering(); }), "The hop has not been reconnected");
+            expect(client->isLoaded());
+            expect(client->isSuspended(), "The bypass state has not been restored");
+
+            setBufferSamples(buf, 0.5f);
+            pc->processBlock(buf, midi);
+            checkBufferSamples(buf, 0.5f);
+        }
+
+        while (pc->getSize() > 0) {
+            pc->delProcessor(0);
+        }
+        pc->releaseResources();
+        server.kill();
+    }
+
+    void runTestSandbox() {
+        beginTest("Sandbox");
+
+        // the worker runs in the chain sandbox, the hop check has to know the servers discovered by the master
+        auto writeConfig = [](int id, int sandboxMode) {
+            auto serverConfig = Defaults::getConfigFileName(Defaults::ConfigServer, {{"id", String(id)}});
+            configWriteFile(serverConfig, {{"ID", id},
+                                           {"NAME", "Test" + String(id)},
+                                           {"CrashReporting", false},
+                                           {"SandboxMode", sandboxMode},
+                                           {"ScanForPlugins", false},
+                                           {"ScreenCapturingOff", true},
+                                           {"Tracer", true}});
+        };
+        writeConfig(998, Server::SANDBOX_NONE);
+        writeConfig(999, Server::SANDBOX_CHAIN);
+
+        ChildProcess target, server;
+        if (!startServer(target, 998) || !startServer(server, 999)) {
+            expect(false, "the servers did not come up");
+            target.kill();
+            server.kill();
+            return;
+        }
+
+        LogTag testTag("test");
+        ServiceReceiver::initialize((uint64)testTag.getTagId());
+        ServerInfo targetInfo;
+        bool discovered = waitFor([&] {
+            for (auto& srv : ServiceReceiver::getServers()) {
+                if (srv.getID() == 998) {
+                    targetInfo = srv;
+                    return true;
+                }
+            }
+            return false;
+        });
+        ServiceReceiver::cleanup((uint64)testTag.getTagId());
+
+        if (!discovered) {
+            logMessage("The target server has not been discovered via mDNS, skipping");
+        } else {
+            PluginProcessor proc(AudioProcessor::wrapperType_Undefined);
+            proc.getClient().setServer(String("127.0.0.1:999:test:0:0:0"));
+            proc.prepareToPlay(48000.0, 512);
+            expect(waitFor([&] { return proc.getClient().isReadyLockFree(); }), "client not ready");
+
+            auto addPlugin = [&](const String& host, String& err) {
+                StringArray presets;
+                Client::ParameterByChannelList params;
+                bool hasEditor, scDisabled;
+                return proc.getClient().addPlugin("test", presets, params, hasEditor, scDisabled, {}, {}, 0, host,
+                                                  err);
+            };
+            auto isRejected = [](const String& err) { return err.contains("neither been discovered"); };
+
+            String err;
+            expect(!addPlugin("192.0.2.1:5", err) && isRejected(err), "an unknown server has been allowed: " + err);
+
+            // the master might have discovered the target a bit later than we did
+            expect(waitFor([&] {
+                       addPlugin(targetInfo.getHostAndID(), err);
+                       return !isRejected(err);
+                   }),
+                   "the discovered server has been rejected in the sandbox: " + err);
+
+            proc.releaseResources();
+        }
+
+        server.kill();
+        target.kill();
+    }
+
+    bool startServer(ChildProcess& server, int id = 999) {
+        if (!server.start(StringArray({SandboxHost::getExecutable().getFullPathName(), "-server", "-id", String(id)}),
+                          0)) {
+            return false;
+        }
+        return waitFor([&] {
+            StreamingSocket sock;
+            return sock.connect("127.0.0.1", Defaults::SERVER_PORT + id, 100);
+        });
+    }
+
+    bool waitFor(std::function<bool()> fn) {
+        for (int i = 0; i < 300; i++) {
+            if (fn()) {
+                return true;
+            }
+            Thread::sleep(100);
+        }
+        return false;
+    }
+};
+
+static ChainHopTest chainHopTest;
+
+}  // namespace e47
+
+#endif  // _CHAINHOPTEST_HPP_
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _LAYOUTCACHETEST_HPP_
+#define _LAYOUTCACHETEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "Server.hpp"
+#include "Processor.hpp"
+#include "LayoutCache.hpp"
+
+namespace e47 {
+
+class LayoutCacheTest : UnitTest {
+  public:
+    LayoutCacheTest() : UnitTest("LayoutCache") {}
+
+    void runTest() override {
+        runTestPruning();
+        runTestPruningSurround();
+        runTestMerge();
+    }
+
+    void runTestPruning() {
+        beginTest("Pruned layouts");
+
+        KnownPluginList pl;
+        json playouts;
+        Server::loadKnownPluginList(pl, playouts, 999);
+
+        for (auto& desc : pl.getTypes()) {
+            String err;
+            auto inst = Processor::loadPlugin(desc, 48000.0, 512, err);
+            expect(nullptr != inst, "Load failed: " + err);
+            if (nullptr == inst) {
+                continue;
+            }
+            auto pruned = Processor::findSupportedLayouts(inst, true);
+            auto full = Processor::findSupportedLayouts(inst, false);
+            expect(pruned == full, "Pruning changed the layouts of " + desc.descriptiveName);
+        }
+    }
+
+    void runTestPruningSurround() {
+        beginTest("Pruned layouts with gaps");
+
+        // 3.0, 4.0 and 5.0 fail, but 5.1 must still be found
+        auto inst = std::make_shared<SurroundMockPlugin>();
+        auto pruned = Processor::findSupportedLayouts(inst, true);
+        auto full = Processor::findSupportedLayouts(inst, false);
+        expect(pruned == full, "Pruning changed the layouts of the mock plugin");
+
+        AudioProcessor::BusesLayout surround;
+        surround.inputBuses.add(AudioChannelSet::create5point1());
+        surround.outputBuses.add(AudioChannelSet::create5point1());
+        expect(pruned.contains(surround), "5.1 has been pruned");
+        expectEquals(pruned.size(), 2);
+    }
+
+    void runTestMerge() {
+        beginTest("Merge");
+
+        TemporaryFile tmp(".layoutcache");
+        auto file = tmp.getFile();
+
+        AudioProcessor::BusesLayout stereo, mono;
+        stereo.inputBuses.add(AudioChannelSet::stereo());
+        stereo.outputBuses.add(AudioChannelSet::stereo());
+        mono.inputBuses.add(AudioChannelSet::mono());
+        mono.outputBuses.add(AudioChannelSet::mono());
+
+        // two processes loading the cache and storing different plugins must not lose each others records
+        LayoutCache a(file), b(file);
+        a.load();
+        b.load();
+        a.put("a", "1.0", {stereo});
+        expect(a.save());
+        b.put("b", "1.0", {mono, stereo});
+        expect(b.save());
+
+        LayoutCache c(file);
+        expect(c.load());
+        expectEquals((int)c.size(), 2);
+
+        LayoutCache::Layouts layouts;
+        expect(c.get("a", "1.0", layouts) && layouts.size() == 1 && layouts[0] == stereo, "Record a has been lost");
+        layouts.clear();
+        expect(c.get("b", "1.0", layouts) && layouts.size() == 2 && layouts[0] == mono, "Record b is wrong");
+        expect(!c.contains("a", "2.0"), "Version is not part of the key");
+    }
+
+  private:
+    // Supports stereo and 5.1 with matching inputs and outputs only
+    class SurroundMockPlugin : public AudioPluginInstance {
+      public:
+        SurroundMockPlugin()
+            : AudioPluginInstance(BusesProperties()
+                                      .withInput("Input", AudioChannelSet::stereo())
+                                      .withOutput("Output", AudioChannelSet::stereo())) {}
+
+        bool isBusesLayoutSupported(const BusesLayout& l) const override {
+            auto in = l.getMainInputChannelSet();
+            return in == l.getMainOutputChannelSet() &&
+                   (in == AudioChannelSet::stereo() || in == AudioChannelSet::create5point1());
+        }
+
+        void fillInPluginDescription(PluginDescription& d) const override { d.name = getName(); }
+        const String getName() const override { return "SurroundMock"; }
+        void prepareToPlay(double, int) override {}
+        void releaseResources() override {}
+        void processBlock(AudioBuffer<float>&, MidiBuffer&) override {}
+        double getTailLengthSeconds() const override { return 0.0; }
+        bool acceptsMidi() const override { return false; }
+        bool producesMidi() const override { return false; }
+        AudioProcessorEditor* createEditor() override { return nullptr; }
+        bool hasEditor() const override { return false; }
+        int getNumPrograms() override { return 1; }
+        int getCurrentProgram() override { return 0; }
+        void setCurrentProgram(int) override {}
+        const String getProgramName(int) override { return {}; }
+        void changeProgramName(int, const String&) override {}
+        void getStateInformation(MemoryBlock&) override {}
+        void setStateInformation(const void*, int) override {}
+    };
+};
+
+static LayoutCacheTest layoutCacheTest;
+
+}  // namespace e47
+
+#endif  // _LAYOUTCACHETEST_HPP_
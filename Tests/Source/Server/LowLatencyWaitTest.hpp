@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _LOWLATENCYWAITTEST_HPP_
+#define _LOWLATENCYWAITTEST_HPP_
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <thread>
+
+#include "LowLatencyWait.hpp"
+
+namespace e47 {
+
+class LowLatencyWaitTest : UnitTest {
+  public:
+    LowLatencyWaitTest() : UnitTest("LowLatencyWait") {}
+
+    void runTest() override {
+        beginTest("Spin window");
+        {
+            LowLatencyWait w;
+            expectWithinAbsoluteError(w.getSpinMicros(), 10.0, 0.001);
+            int blockingWaits = 0;
+            for (int i = 0; i < 200; i++) {
+                bool blocked = false;
+                expect(w.wait(true, 100, eventAfter(300, blocked)));
+                if (i >= 180 && blocked) {
+                    blockingWaits++;
+                }
+            }
+            // the window follows the average wait and covers it
+            expectGreaterThan(w.getSpinMicros(), 300.0);
+            expectLessThan(w.getSpinMicros(), 2000.0);
+            expectLessThan(blockingWaits, 5, "Waits within the spin window are still blocking");
+        }
+
+        beginTest("Long waits");
+        {
+            LowLatencyWait w;
+            for (int i = 0; i < 100; i++) {
+                bool blocked = false;
+                expect(w.wait(true, 100, eventAfter(5000, blocked)));
+            }
+            // spinning for waits this long would only burn CPU
+            expectWithinAbsoluteError(w.getSpinMicros(), 10.0, 0.001);
+        }
+
+        beginTest("Timeout");
+        {
+            LowLatencyWait w;
+            auto start = Time::getMillisecondCounterHiRes();
+            expect(!w.wait(true, 20, [](int timeoutMs) {
+                Thread::sleep(timeoutMs);
+                return false;
+            }));
+            expectGreaterOrEqual(Time::getMillisecondCounterHiRes() - start, 19.0);
+            expectWithinAbsoluteError(w.getSpinMicros(), 10.0, 0.001, "A timeout changed the spin window");
+        }
+
+        beginTest("Jitter");
+        {
+            // the statistic is shared, each run overwrites all of its recent values
+            auto jitter = LowLatencyWait::getJitterStatistic();
+
+            LowLatencyWait regular(true);
+            for (int i = 0; i < 40; i++) {
+                bool blocked = false;
+                regular.wait(false, 100, eventAfter(2000, blocked));
+            }
+            auto regularJitter = jitter->getMostRecentAverage();
+
+            // alternating intervals of 1ms and 5ms deviate by about 2ms from their average
+            LowLatencyWait irregular(true);
+            for (int i = 0; i < 40; i++) {
+                bool blocked = false;
+                irregular.wait(false, 100, eventAfter(i % 2 == 0 ? 1000 : 5000, blocked));
+            }
+            auto irregularJitter = jitter->getMostRecentAverage();
+
+            expectLessThan(regularJitter, 1.0);
+            expectGreaterThan(irregularJitter, 1.0);
+            expectGreaterThan(irregularJitter, regularJitter);
+        }
+
+        for (int blockSize : {32, 64}) {
+            beginTest("Round trip " + String(blockSize) + " samples");
+            {
+                auto blocking = measureRoundTrips(false, blockSize);
+                auto spinning = measureRoundTrips(true, blockSize);
+                logMessage("  blocking: " + blocking.toString());
+                logMessage("  spinning: " + spinning.toString());
+                expectEquals(blocking.count, ROUND_TRIPS, "Round trips failed");
+                expectEquals(spinning.count, ROUND_TRIPS, "Round trips failed");
+                // the gain depends on the machine, spinning must not make things worse though
+                expectLessThan(spinning.median, blocking.median * 1.5 + 50.0, "Spinning slowed down the round trip");
+            }
+        }
+    }
+
+  private:
+    static constexpr int ROUND_TRIPS = 500;
+    static constexpr int WARMUP = 50;
+    static constexpr int CHANNELS = 2;
+
+    struct RoundTrips {
+        int count = 0;
+        double median = 0.0, p95 = 0.0;
+
+        String toString() const {
+            return String(count) + " round trips, median=" + String(median, 1) + "us, p95=" + String(p95, 1) + "us";
+        }
+    };
+
+    // Sends blocks of the given size at the pace of a 48kHz stream to an echo thread over a loopback connection and
+    // measures the time until each block is back. Both ends wait with spinning enabled or disabled.
+    RoundTrips measureRoundTrips(bool spin, int blockSize) {
+        RoundTrips ret;
+        StreamingSocket listener;
+        if (!listener.createListener(0, "127.0.0.1")) {
+            return ret;
+        }
+
+        int bytes = (int)sizeof(float) * CHANNELS * blockSize;
+
+        std::thread echo([&listener, spin, bytes] {
+            std::unique_ptr<StreamingSocket> sock(listener.waitForNextConnection());
+            if (nullptr == sock) {
+                return;
+            }
+            std::vector<char> buf((size_t)bytes);
+            LowLatencyWait w;
+            while (true) {
+                if (!w.wait(spin, 100, [&](int timeoutMs) { return sock->waitUntilReady(true, timeoutMs) != 0; })) {
+                    continue;
+                }
+                if (sock->read(buf.data(), bytes, true) != bytes || sock->write(buf.data(), bytes) != bytes) {
+                    break;
+                }
+            }
+        });
+
+        std::vector<double> rtts;
+        StreamingSocket sock;
+        if (sock.connect("127.0.0.1", listener.getBoundPort(), 1000)) {
+            std::vector<char> buf((size_t)bytes);
+            LowLatencyWait w;
+            auto period = Time::secondsToHighResolutionTicks(blockSize / 48000.0);
+            auto next = Time::getHighResolutionTicks();
+            for (int i = 0; i < ROUND_TRIPS + WARMUP; i++) {
+                while (Time::getHighResolutionTicks() < next) {
+                    std::this_thread::yield();
+                }
+                next += period;
+                auto start = Time::getHighResolutionTicks();
+                if (sock.write(buf.data(), bytes) != bytes ||
+                    !w.wait(spin, 1000, [&](int timeoutMs) { return sock.waitUntilReady(true, timeoutMs) != 0; }) ||
+                    sock.read(buf.data(), bytes, true) != bytes) {
+                    break;
+                }
+                // let the spin windows adapt first
+                if (i >= WARMUP) {
+                    rtts.push_back(Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) *
+                                   1000000);
+                }
+            }
+        }
+
+        sock.close();
+        listener.close();
+        echo.join();
+
+        if (!rtts.empty()) {
+            std::sort(rtts.begin(), rtts.end());
+            ret.count = (int)rtts.size();
+            ret.median = rtts[rtts.size() / 2];
+            ret.p95 = rtts[rtts.size() * 95 / 100];
+        }
+        return ret;
+    }
+
+    // Returns an isReady function for an event, that happens the given time after the wait started
+    std::function<bool(int)> eventAfter(int micros, bool& blocked) {
+        auto eventTicks = Time::getHighResolutionTicks() + Time::secondsToHighResolutionTicks(micros / 1000000.0);
+        return [eventTicks, &blocked](int timeoutMs) {
+            if (timeoutMs > 0) {
+                blocked = true;
+                while (Time::getHighResolutionTicks() < eventTicks) {
+                    std::this_thread::yield();
+                }
+            }
+            return Time::getHighResolutionTicks() >= eventTicks;
+        };
+    }
+};
+
+static LowLatencyWaitTest lowLatencyWaitTest;
+
+}  // namespace e47
+
+#endif  // _LOWLATENCYWAITTEST_HPP_
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _PLUGINPOOLTEST_HPP_
+#define _PLUGINPOOLTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "Server.hpp"
+#include "PluginPool.hpp"
+#include "Processor.hpp"
+
+namespace e47 {
+
+class PluginPoolTest : UnitTest {
+  public:
+    PluginPoolTest() : UnitTest("PluginPool") {}
+
+    void runTest() override {
+        KnownPluginList pl;
+        json playouts;
+        Server::loadKnownPluginList(pl, playouts, 999);
+
+        if (pl.getNumTypes() == 0) {
+            logMessage("No plugins available, skipping");
+            return;
+        }
+
+        auto id = Processor::createPluginID(pl.getTypes()[0]);
+        HandshakeRequest cfg = {AG_PROTOCOL_VERSION, 2, 2, 0, 48000.0, 512, false, 0, 0, 0, 0, 0};
+        PluginPool::Key key(id, "", cfg);
+
+        PluginPool pool(999, 1024, &pl);
+
+        beginTest("Take while warming");
+        {
+            pool.recordSession("pooltest", key);
+            auto start = Time::getMillisecondCounterHiRes();
+            pool.take(key);
+            expectLessThan(Time::getMillisecondCounterHiRes() - start, 100.0, "Take waited for the warm up");
+        }
+
+        beginTest("Take");
+        {
+            // a taken instance gets replenished, as the key stays a target
+            expect(waitForInstance(pool), "No instance has been warmed up");
+            auto inst = pool.take(key);
+            expect(nullptr != inst, "No warm instance has been handed over");
+            expect(nullptr == pool.take(key), "The same instance has been handed over twice");
+
+            HandshakeRequest otherCfg = cfg;
+            otherCfg.sampleRate = 44100.0;
+            expect(waitForInstance(pool), "The instance has not been replenished");
+            expect(nullptr == pool.take(PluginPool::Key(id, "", otherCfg)), "Instance with a different config");
+
+            runOnMsgThreadSync([&] { inst->releaseResources(); });
+        }
+    }
+
+    bool waitForInstance(PluginPool& pool) {
+        for (int i = 0; i < 300 && pool.getNumInstances() == 0; i++) {
+            Thread::sleep(100);
+        }
+        return pool.getNumInstances() > 0;
+    }
+};
+
+static PluginPoolTest pluginPoolTest;
+
+}  // namespace e47
+
+#endif  // _PLUGINPOOLTEST_HPP_
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _PLUGINSETTINGSTEST_HPP_
+#define _PLUGINSETTINGSTEST_HPP_
+
+#include <JuceHeader.h>
+#include <thread>
+
+#include "Defaults.hpp"
+#include "Server.hpp"
+#include "SandboxHost.hpp"
+#include "SettingsTransfers.hpp"
+
+#include "PluginProcessor.hpp"
+
+namespace e47 {
+
+class PluginSettingsTest : UnitTest {
+  public:
+    PluginSettingsTest() : UnitTest("Plugin Settings") {}
+
+    void runTest() override {
+        runTestHash();
+        runTestTransfers();
+        runTestServer();
+    }
+
+    void runTestHash() {
+        beginTest("Settings hash");
+        auto a = createSettings(1, 64 * 1024);
+        auto b = a;
+        expect(PluginSettings::getHash(a) == PluginSettings::getHash(b), "equal settings have different hashes");
+        expect(PluginSettings::getHash(String()).isEmpty(), "empty settings have a hash");
+
+        // a single change of the same length must be detected anywhere in the settings
+        for (int pos : {0, a.length() / 2, a.length() - 1}) {
+            auto c = a.substring(0, pos) + (a[pos] == 'x' ? "y" : "x") + a.substring(pos + 1);
+            expectEquals(c.length(), a.length());
+            expect(PluginSettings::getHash(a) != PluginSettings::getHash(c), "change at " + String(pos) + " missed");
+        }
+    }
+
+    void runTestTransfers() {
+        // big enough for more than one chunk after compression
+        auto a = createSettings(1, 3 * PluginSettingsChunk::CHUNK_SIZE);
+        auto b = createSettings(2, 3 * PluginSettingsChunk::CHUNK_SIZE);
+
+        beginTest("Transfer round trip");
+        {
+            SettingsTransfers server, client;
+            int transfer = server.addOutgoing(0, a);
+            expectGreaterThan(server.getNumChunks(transfer), 1);
+            String settings;
+            expect(fetch(server, client, transfer, 0, settings), "transfer failed");
+            expect(settings == a, "settings changed in transfer");
+            expectEquals((int)server.getNumOutgoing(), 0);
+            expectEquals((int)client.getNumIncoming(), 0);
+        }
+
+        beginTest("Interleaved transfers");
+        {
+            // a second request for the same plugin comes in between the chunks of the first one
+            SettingsTransfers server, clientA, clientB;
+            int ta = server.addOutgoing(0, a);
+            String settingsA, settingsB, err;
+            PluginSettingsChunk chunk;
+            expect(server.getChunk(ta, 0, 0, chunk));
+            expect(clientA.addIncoming(chunk, settingsA, err) == SettingsTransfers::PENDING, err);
+
+            int tb = server.addOutgoing(0, b);
+            expect(ta != tb, "transfer ids are not unique");
+            expect(!server.getChunk(ta, 1, 1, chunk), "chunk of another plugin handed out");
+            expect(fetch(server, clientB, tb, 0, settingsB), "second transfer failed");
+            expect(fetch(server, clientA, ta, 0, settingsA, 1), "first transfer failed");
+            expect(settingsA == a, "first transfer mixed up");
+            expect(settingsB == b, "second transfer mixed up");
+        }
+
+        beginTest("Interleaved incoming transfers");
+        {
+            SettingsTransfers clientA, clientB, server;
+            int ta = clientA.addOutgoing(0, a);
+            int tb = clientB.addOutgoing(0, b) + 100;
+            int chunksA = clientA.getNumChunks(ta);
+            int chunksB = clientB.getNumChunks(tb - 100);
+            String settings, err;
+            int completed = 0;
+            for (int seq = 0; seq < jmax(chunksA, chunksB); seq++) {
+                PluginSettingsChunk ca, cb;
+                if (seq < chunksA) {
+                    expect(clientA.getChunk(ta, 0, seq, ca));
+                    auto res = server.addIncoming(ca, settings, err);
+                    expect(res != SettingsTransfers::FAILED, err);
+                    if (res == SettingsTransfers::COMPLETE) {
+                        expect(settings == a, "first incoming transfer mixed up");
+                        completed++;
+                    }
+                }
+                if (seq < chunksB) {
+                    expect(clientB.getChunk(tb - 100, 0, seq, cb));
+                    cb.hdr->transfer = tb;
+                    auto res = server.addIncoming(cb, settings, err);
+                    expect(res != SettingsTransfers::FAILED, err);
+                    if (res == SettingsTransfers::COMPLETE) {
+                        expect(settings == b, "second incoming transfer mixed up");
+                        completed++;
+                    }
+                }
+            }
+            expectEquals(completed, 2);
+        }
+
+        beginTest("Unknown transfer");
+        {
+            SettingsTransfers server, client;
+            PluginSettingsChunk chunk;
+            expect(!server.getChunk(1, 0, 0, chunk));
+            int transfer = client.addOutgoing(0, a);
+            expect(client.getChunk(transfer, 0, 1, chunk));
+            String settings, err;
+            expect(server.addIncoming(chunk, settings, err) == SettingsTransfers::FAILED,
+                   "chunk without a started transfer accepted");
+        }
+    }
+
+    void runTestServer() {
+        KnownPluginList pl;
+        json playouts;
+        Server::loadKnownPluginList(pl, playouts, 999);
+        if (pl.getNumTypes() == 0) {
+            logMessage("No plugins available, skipping");
+            return;
+        }
+
+        auto serverConfig = Defaults::getConfigFileName(Defaults::ConfigServer, {{"id", "999"}});
+        configWriteFile(serverConfig, {{"ID", 999},
+                                       {"NAME", "Test"},
+                                       {"CrashReporting", false},
+                                       {"SandboxMode", Server::SANDBOX_NONE},
+                                       {"ScanForPlugins", false},
+                                       {"ScreenCapturingOff", true},
+                                       {"Tracer", true}});
+
+        ChildProcess server;
+        if (!server.start(StringArray({SandboxHost::getExecutable().getFullPathName(), "-server", "-id", "999"}), 0) ||
+            !waitFor([] {
+                StreamingSocket sock;
+                return sock.connect("127.0.0.1", Defaults::SERVER_PORT + 999, 100);
+            })) {
+            expect(false, "the server did not come up");
+            server.kill();
+            return;
+        }
+
+        {
+            PluginProcessor proc(AudioProcessor::wrapperType_Undefined);
+            auto& client = proc.getClient();
+            client.setServer(String("127.0.0.1:999:test:0:0:0"));
+            proc.prepareToPlay(48000.0, 512);
+            expect(waitFor([&] { return client.isReadyLockFree(); }), "client not ready");
+
+            auto id = Processor::createPluginID(pl.getTypes()[0]);
+            StringArray presets;
+            Client::ParameterByChannelList params;
+            bool hasEditor, scDisabled;
+            String err;
+            expect(client.addPlugin(id, presets, params, hasEditor, scDisabled, {}, {}, 0, {}, err), err);
+
+            beginTest("Server round trip");
+            auto settings = client.getPluginSettings(0, String());
+            expect(settings.isNotEmpty(), "no settings received");
+            client.setPluginSettings(0, settings);
+            expect(client.getPluginSettings(0, String()) == settings, "settings changed in the round trip");
+
+            beginTest("Server changed detection");
+            {
+                expect(client.getPluginSettings(0, settings) == settings, "unchanged settings replaced");
+                auto changed = settings.substring(0, settings.length() - 1) + (settings.endsWith("A") ? "B" : "A");
+                expect(client.getPluginSettings(0, changed) == settings, "changed settings not detected");
+            }
+
+            beginTest("Server interleaved requests");
+            {
+                // the chunk fetches of both threads go in between each other
+                std::atomic_int failures{0};
+                auto fn = [&] {
+                    for (int i = 0; i < 20; i++) {
+                        if (client.getPluginSettings(0, String()) != settings) {
+                            failures++;
+                        }
+                    }
+                };
+                std::thread t1(fn), t2(fn);
+                t1.join();
+                t2.join();
+                expectEquals(failures.load(), 0, "interleaved transfers got mixed up");
+            }
+
+            beginTest("Set while loading");
+            {
+                // the settings get applied, when the background load has finished
+                expect(client.addPluginAsync(id, {}, {}, 0, err), err);
+                client.setPluginSettings(1, settings);
+                expect(waitFor([&] { return client.getPluginSettings(1, String()).isNotEmpty(); }),
+                       "the plugin did not load");
+                expect(client.getPluginSettings(1, String()) == settings, "the settings got lost while loading");
+            }
+
+            proc.releaseResources();
+        }
+
+        server.kill();
+    }
+
+  private:
+    static String createSettings(int seed, int len) {
+        Random rnd(seed);
+        String s;
+        s.preallocateBytes((size_t)len);
+        while (s.length() < len) {
+            s << String::toHexString(rnd.nextInt64());
+        }
+        return s;
+    }
+
+    // Moves all chunks starting at seq from one side to the other
+    bool fetch(SettingsTransfers& from, SettingsTransfers& to, int transfer, int idx, String& settings, int seq = 0) {
+        String err;
+        int chunks = from.getNumChunks(transfer);
+        for (; seq < chunks; seq++) {
+            PluginSettingsChunk chunk;
+            if (!from.getChunk(transfer, idx, seq, chunk)) {
+                return false;
+            }
+            auto res = to.addIncoming(chunk, settings, err);
+            if (res == SettingsTransfers::FAILED) {
+                logMessage(err);
+                return false;
+            }
+            if (res == SettingsTransfers::COMPLETE) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool waitFor(std::function<bool()> fn) {
+        for (int i = 0; i < 300; i++) {
+            if (fn()) {
+                return true;
+            }
+            Thread::sleep(100);
+        }
+        return false;
+    }
+};
+
+static PluginSettingsTest pluginSettingsTest;
+
+}  // namespace e47
+
+#endif  // _PLUGINSETTINGSTEST_HPP_
@@ -9,11 +9,14 @@
 #define _PROCESSORCHAINTEST_HPP_
 
 #include <JuceHeader.h>
+#include <thread>
 
 #include "TestsHelper.hpp"
 #include "Server.hpp"
 #include "ProcessorChain.hpp"
 #include "Processor.hpp"
+#include "ChannelMapper.hpp"
+#include "SpliceFade.hpp"
 
 namespace e47 {
 
@@ -24,6 +27,9 @@ class ProcessorChainTest : UnitTest {
     void runTest() override {
         runTestBasic();
         runLoadPlugins();
+        runTestSpliceFade();
+        runTestAsyncAdd();
+        runTestRealtime();
     }
 
     void runTestBasic() {
@@ -88,6 +94,168 @@ class ProcessorChainTest : UnitTest {
             pc->delProcessor(0);
         }
     }
+
+    void runTestSpliceFade() {
+        beginTest("Splice fade");
+
+        // the new processor delays the signal, the old path has to be delayed by the same amount while fading, so
+        // that both paths add up to the delayed signal
+        int blockSize = 64, latency = 100, fadeSamples = 480;
+        SpliceFade fade;
+        fade.prepare(1, blockSize, latency, fadeSamples, false);
+
+        std::vector<float> history;
+        AudioBuffer<float> buf(1, blockSize);
+        int pos = 0, maxErrPos = -1;
+        float maxErr = 0.0f;
+        while (fade.isActive()) {
+            for (int i = 0; i < blockSize; i++) {
+                auto s = std::sin((float)(pos + i) * 0.05f);
+                history.push_back(s);
+                buf.setSample(0, i, s);
+            }
+            expect(fade.copyDry(buf));
+            // the processor: a pure delay
+            for (int i = 0; i < blockSize; i++) {
+                int src = pos + i - latency;
+                buf.setSample(0, i, src >= 0 ? history[(size_t)src] : 0.0f);
+            }
+            fade.apply(buf);
+            for (int i = 0; i < blockSize; i++) {
+                if (pos + i < latency) {
+                    // no history yet, the dry signal passes through
+                    expectWithinAbsoluteError(buf.getSample(0, i), history[(size_t)(pos + i)], 1e-6f);
+                } else {
+                    auto err = std::abs(buf.getSample(0, i) - history[(size_t)(pos + i - latency)]);
+                    if (err > maxErr) {
+                        maxErr = err;
+                        maxErrPos = pos + i;
+                    }
+                }
+            }
+            pos += blockSize;
+        }
+        expect(maxErr < 1e-5f, "the paths are not aligned, error " + String(maxErr) + " at " + String(maxErrPos));
+        expectGreaterOrEqual(pos, latency + fadeSamples);
+    }
+
+    void runTestAsyncAdd() {
+        beginTest("Async add");
+
+        double sampleRate = 48000.0;
+        int blockSize = 512, chIn = 2, chOut = 2, chSc = 0;
+
+        LogTag testTag("test");
+
+        auto pc = std::make_unique<ProcessorChain>(&testTag, ProcessorChain::createBussesProperties(chIn, chOut, chSc),
+                                                   HandshakeRequest());
+        pc->setProcessingPrecision(AudioProcessor::singlePrecision);
+        pc->updateChannels(chIn, chOut, chSc);
+        pc->prepareToPlay(sampleRate, blockSize);
+
+        TestsHelper::TestPlayHead phead;
+        pc->setPlayHead(&phead);
+
+        KnownPluginList pl;
+        json playouts;
+        Server::loadKnownPluginList(pl, playouts, 999);
+        if (pl.getNumTypes() == 0) {
+            logMessage("No plugins available, skipping");
+            return;
+        }
+        auto desc = pl.getTypes()[0];
+
+        AudioBuffer<float> buf(chIn, blockSize);
+        MidiBuffer midi;
+
+        // the placeholder passes the audio through while the plugin loads
+        auto proc = pc->reserveProcessor(Processor::createPluginID(desc), {});
+        expect(proc->isLoading());
+        expectEquals((int)pc->getSize(), 1);
+        setBufferSamples(buf, 0.5f);
+        pc->processBlock(buf, midi);
+        checkBufferSamples(buf, 0.5f);
+
+        String err;
+        expect(proc->load({}, {}, 0, err, &desc), "Load failed: " + err);
+
+        // audio keeps flowing while the plugin gets spliced in
+        std::atomic_bool done{false};
+        std::thread audio([&] {
+            AudioBuffer<float> abuf(chIn, blockSize);
+            MidiBuffer amidi;
+            while (!done) {
+                setBufferSamples(abuf, 0.5f);
+                pc->processBlock(abuf, amidi);
+            }
+        });
+
+        beginTest("Async swap");
+        expectEquals(pc->spliceProcessor(proc), 0);
+        expect(!proc->isLoading());
+
+        // process past the fade
+        Thread::sleep(200);
+        done = true;
+        audio.join();
+
+        setBufferSamples(buf, 0.5f);
+        pc->processBlock(buf, midi);
+        bool finite = true;
+        for (int ch = 0; ch < buf.getNumChannels(); ch++) {
+            for (int i = 0; i < buf.getNumSamples(); i++) {
+                finite = finite && std::isfinite(buf.getSample(ch, i));
+            }
+        }
+        expect(finite, "the spliced plugin produced invalid samples");
+        expectEquals(pc->getLatencySamples(), proc->getLatencySamples());
+
+        beginTest("Async removed while loading");
+        {
+            auto p = pc->reserveProcessor(Processor::createPluginID(desc), {});
+            pc->delProcessor(1);
+            expect(p->load({}, {}, 0, err, &desc), "Load failed: " + err);
+            expectEquals(pc->spliceProcessor(p), -1);
+            p->unload();
+        }
+
+        while (pc->getSize() > 0) {
+            pc->delProcessor(0);
+        }
+        pc->releaseResources();
+    }
+
+    void runTestRealtime() {
+        beginTest("Realtime safety");
+
+        if (!RealtimeCheck::isEnabled()) {
+            logMessage("Realtime checks disabled, skipping");
+            return;
+        }
+
+        std::vector<int> v;
+        RealtimeCheck::reset();
+        {
+            RealtimeCheck::Scope rtScope;
+            v.resize(1024);
+        }
+        expect(v.size() == 1024 && RealtimeCheck::getViolationCount() > 0, "allocation has not been detected");
+
+        LogTag testTag("test");
+        ChannelSet activeChannels(0, 4, 4);
+        activeChannels.setInputActive(0);
+        activeChannels.setInputActive(2);
+        activeChannels.setOutputActive(0);
+        activeChannels.setOutputActive(2);
+        ChannelMapper mapper(&testTag);
+        mapper.createServerMapping(activeChannels);
+
+        AudioBuffer<float> src(2, 512), dst(4, 512);
+        expectRealtimeSafe({
+            mapper.map(&src, &dst);
+            mapper.mapReverse(&dst, &src);
+        });
+    }
 };
 
 static ProcessorChainTest processorChainTest;
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _RECONFIGURETEST_HPP_
+#define _RECONFIGURETEST_HPP_
+
+#include <JuceHeader.h>
+#include <thread>
+
+#include "TestsHelper.hpp"
+#include "Defaults.hpp"
+#include "Message.hpp"
+#include "Server.hpp"
+#include "Processor.hpp"
+#include "ProcessorChain.hpp"
+#include "ProcessorClient.hpp"
+#include "ChannelSet.hpp"
+
+namespace e47 {
+
+class ReconfigureTest : UnitTest {
+  public:
+    ReconfigureTest() : UnitTest("Reconfigure") {}
+
+    void runTest() override {
+        beginTest("Message");
+        {
+            // the type is part of the protocol, older servers answer unknown types with nothing
+            expectEquals(Reconfigure::Type, 140);
+            Message<Reconfigure> msg;
+            PLD(msg).setJson({{"sampleRate", 44100.0}, {"samplesPerBlock", 256}});
+            auto j = PLD(msg).getJson();
+            expectEquals(jsonGetValue(j, "sampleRate", 0.0), 44100.0);
+            expectEquals(jsonGetValue(j, "samplesPerBlock", 0), 256);
+        }
+
+        logMessage("Setting up server config");
+        auto serverConfig = Defaults::getConfigFileName(Defaults::ConfigServer, {{"id", "999"}});
+        configWriteFile(serverConfig, {{"ID", 999},
+                                       {"NAME", "Test"},
+                                       {"CrashReporting", false},
+                                       {"SandboxMode", Server::SANDBOX_PLUGIN},
+                                       {"Tracer", true}});
+
+        double sampleRate = 48000.0;
+        int blockSize = 512, chIn = 2, chOut = 2;
+        ChannelSet activeChannels;
+        activeChannels.setNumChannels(chIn, chOut);
+        activeChannels.setRangeActive();
+        HandshakeRequest cfg = {AG_PROTOCOL_VERSION,    chIn, chOut, 0, sampleRate, blockSize, false, 0, 0, 0,
+                                activeChannels.toInt(), 0};
+
+        LogTag testTag("test");
+
+        auto pc =
+            std::make_unique<ProcessorChain>(&testTag, ProcessorChain::createBussesProperties(chIn, chOut, 0), cfg);
+        pc->setProcessingPrecision(AudioProcessor::singlePrecision);
+        pc->updateChannels(chIn, chOut, 0);
+        pc->prepareToPlay(sampleRate, blockSize);
+
+        TestsHelper::TestPlayHead phead;
+        pc->setPlayHead(&phead);
+
+        KnownPluginList pl;
+        json playouts;
+        Server::loadKnownPluginList(pl, playouts, 999);
+
+        // a plugin without latency, so that the bypassed plugin passes the input through unchanged
+        std::shared_ptr<Processor> proc;
+        for (auto desc : pl.getTypes()) {
+            auto p = std::make_shared<Processor>(*pc, Processor::createPluginID(desc), sampleRate, blockSize, true);
+            String err;
+            if (p->load({}, {}, 0, err, &desc) && p->getLatencySamples() == 0) {
+                proc = p;
+                break;
+            }
+            p->unload();
+        }
+
+        if (nullptr == proc) {
+            logMessage("No plugin without latency available, skipping");
+            return;
+        }
+
+        pc->addProcessor(proc);
+        auto client = proc->getClient();
+        client->suspendProcessingRemoteOnly(true);
+
+        AudioBuffer<float> buf(chIn, 256);
+        MidiBuffer midi;
+
+        beginTest("Reconfigure");
+        {
+            expect(client->reconfigure(44100.0, 256), "Reconfigure failed");
+            expect(client->isOk(), "Reconfigure broke the connection: " + client->getError());
+            expectGreaterOrEqual(client->getLatencySamples(), 0);
+
+            setBufferSamples(buf, 0.5f);
+            client->processBlock(buf, midi);
+            checkBufferSamples(buf, 0.5f);
+        }
+
+        beginTest("Reconfigure while processing");
+        {
+            std::atomic_bool stop{false};
+            std::atomic_int blocks{0}, failed{0};
+            int failedReconfigures = 0;
+
+            std::thread audio([&] {
+                AudioBuffer<float> abuf(chIn, 256);
+                MidiBuffer amidi;
+                while (!stop) {
+                    setBufferSamples(abuf, 0.5f);
+                    client->processBlock(abuf, amidi);
+                    if (abuf.getSample(0, 0) != 0.5f || abuf.getSample(chIn - 1, 255) != 0.5f) {
+                        failed++;
+                    }
+                    blocks++;
+                    Thread::sleep(5);
+                }
+            });
+
+            for (int i = 0; i < 10; i++) {
+                if (!client->reconfigure(i % 2 == 0 ? 48000.0 : 44100.0, 256)) {
+                    failedReconfigures++;
+                }
+                Thread::sleep(50);
+            }
+
+            stop = true;
+            audio.join();
+
+            expect(client->isOk(), "Reconfigure broke the connection: " + client->getError());
+            expect(!client->isRecovering(), "The sandbox has been restarted");
+            expectEquals(failedReconfigures, 0, "Reconfigure failed");
+            expectGreaterThan(blocks.load(), 0);
+            expectEquals(failed.load(), 0, "Blocks have not been passed through");
+        }
+
+        while (pc->getSize() > 0) {
+            pc->delProcessor(0);
+        }
+        pc->releaseResources();
+    }
+};
+
+static ReconfigureTest reconfigureTest;
+
+}  // namespace e47
+
+#endif  // _RECONFIGURETEST_HPP_
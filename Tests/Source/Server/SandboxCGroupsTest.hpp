@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _SANDBOXCGROUPSTEST_HPP_
+#define _SANDBOXCGROUPSTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "SandboxCGroups.hpp"
+#include "SandboxGroups.hpp"
+
+namespace e47 {
+
+class SandboxCGroupsTest : UnitTest {
+  public:
+    SandboxCGroupsTest() : UnitTest("SandboxCGroups") {}
+
+    void runTest() override {
+        beginTest("Stats");
+        {
+            String cpuStat = "usage_usec 1234567\nuser_usec 1000000\nsystem_usec 234567\nnr_periods 0\n";
+            expectEquals((int64)SandboxCGroups::getStat(cpuStat, "usage_usec"), (int64)1234567);
+            expectEquals((int64)SandboxCGroups::getStat(cpuStat, "system_usec"), (int64)234567);
+            expectEquals((int64)SandboxCGroups::getStat(cpuStat, "usage"), (int64)0, "Prefix matched a key");
+            expectEquals((int64)SandboxCGroups::getStat(cpuStat, "missing"), (int64)0);
+
+            String memEvents = "low 0\nhigh 0\nmax 12\noom 3\noom_kill 2\n";
+            expectEquals((int64)SandboxCGroups::getStat(memEvents, "oom_kill"), (int64)2);
+            expectEquals((int64)SandboxCGroups::getStat(memEvents, "oom"), (int64)3);
+            expectEquals((int64)SandboxCGroups::getStat({}, "oom_kill"), (int64)0);
+            expectEquals((int64)SandboxCGroups::getStat("oom_kill", "oom_kill"), (int64)0, "Value missing");
+        }
+
+        beginTest("Path");
+        {
+            expectEquals(SandboxCGroups::getCGroupPath("0::/system.slice/audiogridder.service\n"),
+                         String("/system.slice/audiogridder.service"));
+            expectEquals(SandboxCGroups::getCGroupPath("12:cpu:/legacy\n0::/user.slice\n"), String("/user.slice"));
+            expectEquals(SandboxCGroups::getCGroupPath("0::/\n"), String("/"));
+            expect(SandboxCGroups::getCGroupPath("12:cpu:/legacy\n").isEmpty(), "cgroup v1 path accepted");
+            expect(SandboxCGroups::getCGroupPath("0::/a/../b\n").isEmpty(), "Relative path accepted");
+            expect(SandboxCGroups::getCGroupPath({}).isEmpty());
+        }
+
+        beginTest("Grouping");
+        {
+            // a shared sandbox process can only join one cgroup, so only plugins with the same key share a process
+            auto a1 = SandboxGroups::combine("vendor:A", "client-1");
+            auto a2 = SandboxGroups::combine("vendor:A", "client-2");
+            expect(a1 != a2, "plugins with different cgroups share a process");
+            expectEquals(a1, SandboxGroups::combine("vendor:A", "client-1"), "plugins with the same cgroup are split");
+            expect(a1 != SandboxGroups::combine("vendor:B", "client-1"), "the policy group got lost");
+            expectEquals(SandboxGroups::combine("shared", {}), String("shared"), "plugins without cgroups are split");
+            expect(SandboxGroups::combine({}, "client-1").isEmpty(), "a cgroup key created a group");
+        }
+    }
+};
+
+static SandboxCGroupsTest sandboxCGroupsTest;
+
+}  // namespace e47
+
+#endif  // _SANDBOXCGROUPSTEST_HPP_
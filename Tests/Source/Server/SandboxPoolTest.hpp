@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _SANDBOXPOOLTEST_HPP_
+#define _SANDBOXPOOLTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "SandboxPool.hpp"
+
+namespace e47 {
+
+class SandboxPoolTest : UnitTest {
+  public:
+    SandboxPoolTest() : UnitTest("SandboxPool") {}
+
+    void runTest() override {
+        using Demand = SandboxPool::Demand;
+
+        beginTest("Idle");
+        {
+            Demand d(false, 4);
+            expectEquals(d.getTarget(SandboxPool::CHAIN_REMOTE, 0), 1);
+            expectEquals(d.getTarget(SandboxPool::CHAIN_LOCAL, 0), 0, "no local client has been seen yet");
+            expectEquals(d.getTarget(SandboxPool::PLUGIN, 0), 0, "plugin sandboxes in chain mode");
+        }
+
+        beginTest("Grow");
+        {
+            Demand d(false, 4);
+            uint32 now = 1000;
+            // three clients within a minute
+            for (int i = 0; i < 3; i++) {
+                d.add(SandboxPool::CHAIN_LOCAL, now);
+                now += 5000;
+            }
+            expectEquals(d.getTarget(SandboxPool::CHAIN_LOCAL, now), 3);
+            expectEquals(d.getTarget(SandboxPool::CHAIN_REMOTE, now), 1, "the demand of another kind counts");
+
+            // a burst above the limit
+            for (int i = 0; i < 10; i++) {
+                d.add(SandboxPool::CHAIN_LOCAL, now);
+            }
+            expectEquals(d.getTarget(SandboxPool::CHAIN_LOCAL, now), 4, "the limit is exceeded");
+        }
+
+        beginTest("Shrink");
+        {
+            Demand d(true, 4);
+            uint32 now = 1000;
+            for (int i = 0; i < 3; i++) {
+                d.add(SandboxPool::PLUGIN, now);
+            }
+            expectEquals(d.getTarget(SandboxPool::PLUGIN, now), 3);
+
+            // the peak stays for the demand window
+            now += Demand::WINDOW_MS - Demand::BUCKET_MS;
+            expectEquals(d.getTarget(SandboxPool::PLUGIN, now), 3);
+
+            // a single request after the window, the target goes back down
+            now += 2 * Demand::BUCKET_MS;
+            d.add(SandboxPool::PLUGIN, now);
+            expectEquals(d.getTarget(SandboxPool::PLUGIN, now), 1);
+        }
+
+        beginTest("Timer wrap");
+        {
+            Demand d(true, 4);
+            uint32 now = std::numeric_limits<uint32>::max() - 1000;
+            d.add(SandboxPool::PLUGIN, now);
+            d.add(SandboxPool::PLUGIN, now);
+            now += 2000;
+            expectEquals(d.getTarget(SandboxPool::PLUGIN, now), 2, "requests before the timer wrapped got lost");
+        }
+    }
+};
+
+static SandboxPoolTest sandboxPoolTest;
+
+}  // namespace e47
+
+#endif  // _SANDBOXPOOLTEST_HPP_
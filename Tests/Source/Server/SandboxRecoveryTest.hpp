@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _SANDBOXRECOVERYTEST_HPP_
+#define _SANDBOXRECOVERYTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "TestsHelper.hpp"
+#include "Defaults.hpp"
+#include "Server.hpp"
+#include "Processor.hpp"
+#include "ProcessorChain.hpp"
+#include "ProcessorClient.hpp"
+#include "ChannelSet.hpp"
+
+namespace e47 {
+
+class SandboxRecoveryTest : UnitTest {
+  public:
+    SandboxRecoveryTest() : UnitTest("Sandbox (Recovery)") {}
+
+    void runTest() override {
+        logMessage("Setting up server config");
+        auto serverConfig = Defaults::getConfigFileName(Defaults::ConfigServer, {{"id", "999"}});
+        configWriteFile(serverConfig, {{"ID", 999},
+                                       {"NAME", "Test"},
+                                       {"CrashReporting", false},
+                                       {"SandboxMode", Server::SANDBOX_PLUGIN},
+                                       {"Tracer", true}});
+
+        double sampleRate = 48000.0;
+        int blockSize = 512, chIn = 2, chOut = 2;
+        ChannelSet activeChannels;
+        activeChannels.setNumChannels(chIn, chOut);
+        activeChannels.setRangeActive();
+        HandshakeRequest cfg = {AG_PROTOCOL_VERSION,    chIn, chOut, 0, sampleRate, blockSize, false, 0, 0, 0,
+                                activeChannels.toInt(), 0};
+
+        LogTag testTag("test");
+
+        auto pc =
+            std::make_unique<ProcessorChain>(&testTag, ProcessorChain::createBussesProperties(chIn, chOut, 0), cfg);
+        pc->setProcessingPrecision(AudioProcessor::singlePrecision);
+        pc->updateChannels(chIn, chOut, 0);
+        pc->prepareToPlay(sampleRate, blockSize);
+
+        TestsHelper::TestPlayHead phead;
+        pc->setPlayHead(&phead);
+
+        KnownPluginList pl;
+        json playouts;
+        Server::loadKnownPluginList(pl, playouts, 999);
+
+        // a plugin without latency, so that the bypassed plugin and the pass through look the same
+        std::shared_ptr<Processor> proc;
+        for (auto desc : pl.getTypes()) {
+            auto p = std::make_shared<Processor>(*pc, Processor::createPluginID(desc), sampleRate, blockSize, true);
+            String err;
+            if (p->load({}, {}, 0, err, &desc) && p->getLatencySamples() == 0) {
+                proc = p;
+                break;
+            }
+            p->unload();
+        }
+
+        if (nullptr == proc) {
+            logMessage("No plugin without latency available, skipping");
+            return;
+        }
+
+        pc->addProcessor(proc);
+        auto client = proc->getClient();
+        client->suspendProcessingRemoteOnly(true);
+
+        AudioBuffer<float> buf(chIn, blockSize);
+        MidiBuffer midi;
+
+        beginTest("Crash");
+        {
+            setBufferSamples(buf, 0.5f);
+            pc->processBlock(buf, midi);
+            checkBufferSamples(buf, 0.5f);
+
+            client->killSandbox();
+            expect(waitFor([&] {
+                       // the audio path notices the crash as well as the client thread
+                       setBufferSamples(buf, 0.5f);
+                       pc->processBlock(buf, midi);
+                       return client->isRecovering();
+                   }),
+                   "The crash has not been detected");
+        }
+
+        beginTest("Pass through");
+        {
+            // the sandbox process takes a while to come back, the blocks in between must not touch the sockets
+            if (client->isRecovering()) {
+                setBufferSamples(buf, 0.5f);
+                pc->processBlock(buf, midi);
+                checkBufferSamples(buf, 0.5f);
+            } else {
+                logMessage("Recovered too fast to check the pass through");
+            }
+        }
+
+        beginTest("Reload");
+        {
+            expect(waitFor([&] { return !client->isRecovering(); }), "The sandbox has not been recovered");
+            expect(client->isLoaded());
+            expect(client->isSuspended(), "The bypass state has not been restored");
+
+            setBufferSamples(buf, 0.5f);
+            pc->processBlock(buf, midi);
+            checkBufferSamples(buf, 0.5f);
+        }
+
+        beginTest("Failed reload");
+        {
+            // the first reload fails, the client has to start another sandbox and try again
+            client->failReloads(1);
+            client->killSandbox();
+            expect(waitFor([&] { return client->isRecovering(); }), "The crash has not been detected");
+            expect(waitFor([&] { return !client->isRecovering(); }), "The sandbox has not been recovered");
+            expect(!client->isFailed(), "The client gave up after one failed reload");
+
+            setBufferSamples(buf, 0.5f);
+            pc->processBlock(buf, midi);
+            checkBufferSamples(buf, 0.5f);
+        }
+
+        beginTest("Respawn limit");
+        {
+            // reloads keep failing, the client has to give up instead of staying in recovery forever
+            client->failReloads(1000);
+            client->killSandbox();
+            expect(waitFor([&] { return client->isFailed(); }), "The client did not give up");
+            expect(!client->isRecovering(), "The client is still recovering");
+
+            setBufferSamples(buf, 0.5f);
+            pc->processBlock(buf, midi);
+            checkBufferSamples(buf, 0.5f);
+        }
+
+        while (pc->getSize() > 0) {
+            pc->delProcessor(0);
+        }
+        pc->releaseResources();
+    }
+
+    bool waitFor(std::function<bool()> fn) {
+        for (int i = 0; i < 300; i++) {
+            if (fn()) {
+                return true;
+            }
+            Thread::sleep(100);
+        }
+        return false;
+    }
+};
+
+static SandboxRecoveryTest sandboxRecoveryTest;
+
+}  // namespace e47
+
+#endif  // _SANDBOXRECOVERYTEST_HPP_
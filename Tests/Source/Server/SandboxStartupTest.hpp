@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _SANDBOXSTARTUPTEST_HPP_
+#define _SANDBOXSTARTUPTEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "TestsHelper.hpp"
+#include "Defaults.hpp"
+#include "Server.hpp"
+#include "SandboxHost.hpp"
+#include "ProcessorClient.hpp"
+
+namespace e47 {
+
+class SandboxStartupTest : UnitTest {
+  public:
+    SandboxStartupTest() : UnitTest("Sandbox (Startup)") {}
+
+    void runTest() override {
+        logMessage("Setting up server config");
+        auto serverConfig = Defaults::getConfigFileName(Defaults::ConfigServer, {{"id", "999"}});
+        configWriteFile(serverConfig, {{"ID", 999},
+                                       {"NAME", "Test"},
+                                       {"CrashReporting", false},
+                                       {"SandboxMode", Server::SANDBOX_PLUGIN},
+                                       {"Tracer", true}});
+
+        beginTest("Startup time");
+
+        HandshakeRequest cfg = {AG_PROTOCOL_VERSION, 2, 2, 0, 48000.0, 512, false, 0, 0, 0, 0, 0};
+
+        const int runs = 5;
+        Stats lean, full, leanRss, fullRss;
+
+        // alternate between the lean and the full startup, so that both see the same system load and caches
+        for (int i = 0; i < runs; i++) {
+            measure(cfg, false, lean, leanRss);
+            measure(cfg, true, full, fullRss);
+        }
+
+        logMessage("Sandbox startup (lean): " + lean.toString());
+        logMessage("Sandbox startup (full): " + full.toString());
+
+        expect(lean.getAvg() < 5000.0, "sandbox startup takes too long: " + String(lean.getAvg(), 1) + " ms");
+        expect(lean.getAvg() < full.getAvg(), "lean startup is not faster than the full startup: " +
+                                                   String(lean.getAvg(), 1) + " ms vs " + String(full.getAvg(), 1) +
+                                                   " ms");
+
+        beginTest("Startup memory");
+
+        if (leanRss.runs == runs && fullRss.runs == runs) {
+            logMessage("Sandbox RSS (lean): " + leanRss.toString("KB"));
+            logMessage("Sandbox RSS (full): " + fullRss.toString("KB"));
+            expect(leanRss.getAvg() <= fullRss.getAvg(), "lean startup uses more memory than the full startup");
+        } else {
+            logMessage("RSS of the sandbox processes not available, skipping");
+        }
+    }
+
+    struct Stats {
+        int runs = 0;
+        double total = 0.0, minMs = std::numeric_limits<double>::max(), maxMs = 0.0;
+
+        void add(double ms) {
+            runs++;
+            total += ms;
+            minMs = jmin(minMs, ms);
+            maxMs = jmax(maxMs, ms);
+        }
+
+        double getAvg() const { return runs > 0 ? total / runs : 0.0; }
+
+        String toString(const String& unit = "ms") const {
+            return "avg=" + String(getAvg(), 1) + " " + unit + ", min=" + String(minMs, 1) + " " + unit +
+                   ", max=" + String(maxMs, 1) + " " + unit;
+        }
+    };
+
+    // Measures the time from spawning a process until it serves a plugin worker and the RSS of the process by then
+    void measure(const HandshakeRequest& cfg, bool fullStartup, Stats& time, Stats& rss) {
+        auto start = Time::getMillisecondCounterHiRes();
+
+        SandboxHost host(999, fullStartup);
+        expect(host.start(), "failed to start sandbox process");
+        expect(host.tryJoin(1));
+
+        int workerPort = ProcessorClient::getWorkerPort();
+        expect(host.assign("benchmark", cfg, workerPort), "failed to assign plugin");
+
+        bool ready = false;
+        StreamingSocket sock;
+        auto socketPath = Defaults::getSocketPath(Defaults::SANDBOX_PLUGIN_SOCK, {{"n", String(workerPort)}});
+        while (!ready && host.isRunning() && Time::getMillisecondCounterHiRes() - start < 30000) {
+            ready = Defaults::unixDomainSocketsSupported() ? sock.connect(socketPath, 100)
+                                                           : sock.connect("127.0.0.1", workerPort, 100);
+            if (!ready) {
+                Thread::sleep(5);
+            }
+        }
+
+        auto ms = Time::getMillisecondCounterHiRes() - start;
+        expect(ready, "sandbox process did not start a worker");
+
+        auto kb = getRssKB(host.getPort());
+
+        sock.close();
+        host.kill();
+        ProcessorClient::removeWorkerPort(workerPort);
+
+        logMessage("  " + String(fullStartup ? "full" : "lean") + ": " + String(ms, 1) + " ms, " +
+                   (kb > 0 ? String(kb) + " KB" : String("unknown")) + " RSS");
+
+        time.add(ms);
+        if (kb > 0) {
+            rss.add((double)kb);
+        }
+    }
+
+    // Returns the resident set size of the sandbox process listening at the given port or 0
+    int64 getRssKB(int port) {
+#ifdef JUCE_WINDOWS
+        ignoreUnused(port);
+        return 0;
+#else
+        ChildProcess ps;
+        if (!ps.start(StringArray({"ps", "-eo", "rss=,args="}), ChildProcess::wantStdOut)) {
+            return 0;
+        }
+        auto lines = StringArray::fromLines(ps.readAllProcessOutput());
+        for (auto& line : lines) {
+            if (line.contains(" -host") && line.contains("-workerport " + String(port))) {
+                return line.trim().upToFirstOccurrenceOf(" ", false, false).getLargeIntValue();
+            }
+        }
+        return 0;
+#endif
+    }
+};
+
+static SandboxStartupTest sandboxStartupTest;
+
+}  // namespace e47
+
+#endif  // _SANDBOXSTARTUPTEST_HPP_
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef _SESSIONRESUMETEST_HPP_
+#define _SESSIONRESUMETEST_HPP_
+
+#include <JuceHeader.h>
+
+#include "TestsHelper.hpp"
+#include "Defaults.hpp"
+#include "Message.hpp"
+#include "Server.hpp"
+#include "SandboxHost.hpp"
+
+namespace e47 {
+
+class SessionResumeTest : UnitTest {
+  public:
+    SessionResumeTest() : UnitTest("Session (Resume)") {}
+
+    static constexpr int GRACE_SECS = 2;
+
+    // A client connection with all the sockets a plugin opens
+    struct Connection {
+        HandshakeResponse resp;
+        std::unique_ptr<StreamingSocket> cmdOut, cmdIn, audio, screen;
+
+        void close() {
+            for (auto* s : {cmdOut.get(), cmdIn.get(), audio.get(), screen.get()}) {
+                if (nullptr != s) {
+                    s->close();
+                }
+            }
+        }
+    };
+
+    void runTest() override {
+        logMessage("Setting up server config");
+        auto serverConfig = Defaults::getConfigFileName(Defaults::ConfigServer, {{"id", "999"}});
+        configWriteFile(serverConfig, {{"ID", 999},
+                                       {"NAME", "Test"},
+                                       {"CrashReporting", false},
+                                       {"SandboxMode", Server::SANDBOX_NONE},
+                                       {"ScanForPlugins", false},
+                                       {"ScreenCapturingOff", true},
+                                       {"SessionGracePeriodSecs", GRACE_SECS},
+                                       {"Tracer", true}});
+
+        ChildProcess server;
+        expect(server.start(StringArray({SandboxHost::getExecutable().getFullPathName(), "-server", "-id", "999"}), 0),
+               "failed to start the server");
+
+        HandshakeRequest cfg = {AG_PROTOCOL_VERSION, 2, 2, 0, 48000.0, 512, false, 0x4711, 0, 0, 0, 0};
+
+        Connection first;
+        bool up = false;
+        for (int i = 0; i < 300 && !up; i++) {
+            up = connect(cfg, 0, first);
+            if (!up) {
+                Thread::sleep(100);
+            }
+        }
+        expect(up, "the server did not come up");
+        if (!up) {
+            server.kill();
+            return;
+        }
+
+        auto token = first.resp.getSessionToken();
+        expect(token != 0, "no session token");
+        expect(!first.resp.isFlag(HandshakeResponse::SESSION_RESUMED));
+
+        beginTest("Resume");
+        {
+            first.close();
+            Thread::sleep(200);
+
+            Connection conn;
+            expect(connect(cfg, token, conn), "reconnect failed");
+            expect(conn.resp.isFlag(HandshakeResponse::SESSION_RESUMED), "the session has not been resumed");
+            expectEquals(conn.resp.getSessionToken(), token);
+            first = std::move(conn);
+        }
+
+        beginTest("Resume before the server noticed the disconnect");
+        {
+            // the old connection stays open, the server has to drop it instead of waiting for it to time out
+            Connection conn;
+            auto start = Time::getMillisecondCounterHiRes();
+            expect(connect(cfg, token, conn), "reconnect failed");
+            auto elapsedMs = Time::getMillisecondCounterHiRes() - start;
+            expect(conn.resp.isFlag(HandshakeResponse::SESSION_RESUMED), "the session has not been resumed");
+            expectLessThan(elapsedMs, Defaults::SESSION_RESUME_TIMEOUT_SECS * 1000.0, "resume waited for the timeout");
+
+            // the server never writes to the audio socket unasked, so it can only get ready by being closed
+            char c;
+            expect(first.audio->waitUntilReady(true, 2000) != 0 && first.audio->read(&c, 1, false) <= 0,
+                   "the old connection is still open");
+            first.close();
+            first = std::move(conn);
+        }
+
+        beginTest("Resume with a different config");
+        {
+            auto otherCfg = cfg;
+            otherCfg.sampleRate = 44100.0;
+            Connection conn;
+            expect(connect(otherCfg, token, conn), "connect failed");
+            expect(!conn.resp.isFlag(HandshakeResponse::SESSION_RESUMED), "the session has been resumed");
+            expect(conn.resp.getSessionToken() != token, "the token has been reused");
+            conn.close();
+        }
+
+        beginTest("Grace period");
+        {
+            first.close();
+            Thread::sleep(GRACE_SECS * 1000 + 1500);
+
+            Connection conn;
+            expect(connect(cfg, token, conn), "reconnect failed");
+            expect(!conn.resp.isFlag(HandshakeResponse::SESSION_RESUMED), "the expired session has been resumed");
+            expect(conn.resp.getSessionToken() != token, "the token of the expired session has been reused");
+            conn.close();
+        }
+
+        server.kill();
+    }
+
+    bool connect(HandshakeRequest cfg, uint64 token, Connection& conn) {
+        int port = Defaults::SERVER_PORT + 999;
+        conn.cmdOut = std::make_unique<StreamingSocket>();
+        if (!conn.cmdOut->connect("127.0.0.1", port, 1000)) {
+            return false;
+        }
+        if (token != 0) {
+            cfg.setFlag(HandshakeRequest::RESUME_SESSION);
+        }
+        if (!send(conn.cmdOut.get(), reinterpret_cast<const char*>(&cfg), sizeof(cfg)) ||
+            (token != 0 && !send(conn.cmdOut.get(), reinterpret_cast<const char*>(&token), sizeof(token)))) {
+            return false;
+        }
+        MessageHelper::Error err;
+        if (!read(conn.cmdOut.get(), &conn.resp, sizeof(conn.resp), 20000, &err)) {
+            logMessage("handshake error: " + err.toString());
+            return false;
+        }
+        conn.cmdOut->close();
+
+        auto connectWorker = [&](std::unique_ptr<StreamingSocket>& sock) {
+            sock = std::make_unique<StreamingSocket>();
+            return sock->connect("127.0.0.1", conn.resp.port);
+        };
+
+        return connectWorker(conn.cmdOut) && connectWorker(conn.cmdIn) && connectWorker(conn.audio) &&
+               connectWorker(conn.screen);
+    }
+};
+
+static SessionResumeTest sessionResumeTest;
+
+}  // namespace e47
+
+#endif  // _SESSIONRESUMETEST_HPP_
@@ -10,6 +10,8 @@
 
 #include <JuceHeader.h>
 
+#include "RealtimeCheck.hpp"
+
 #ifndef AG_TESTS_DATA
 #define AG_TESTS_DATA ""
 #endif
@@ -68,6 +70,22 @@ struct TestPlayHead : AudioPlayHead {
         }                                                                                                          \
     } while (0)
 
+// Runs the given code on the calling thread, that gets marked as realtime for the duration, and expects the
+// RealtimeCheck to record no allocations or locks. The tracer is disabled meanwhile, as it allocates by design. Without
+// AG_ENABLE_RT_CHECKS nothing gets recorded and the expectation always passes.
+#define expectRealtimeSafe(code)                                                                                 \
+    do {                                                                                                         \
+        bool __tracer = Tracer::isEnabled();                                                                     \
+        Tracer::setEnabled(false);                                                                               \
+        RealtimeCheck::reset();                                                                                  \
+        {                                                                                                        \
+            RealtimeCheck::Scope __rtScope;                                                                      \
+            code;                                                                                                \
+        }                                                                                                        \
+        Tracer::setEnabled(__tracer);                                                                            \
+        expect(RealtimeCheck::getViolationCount() == 0, RealtimeCheck::describeViolations());                    \
+    } while (0)
+
 }  // namespace TestsHelper
 }  // namespace e47
 